@@ -42,6 +42,12 @@
 
 //TODO: Fill flag macros
 
+//CPUID_INFO_AND_FEATURE, ECX
+#define CPUID_INFO_AND_FEATURE_ECX_PCID                 FLAG32(17)
+
+//CPUID_EXTENDED_FEATURED1, EBX
+#define CPUID_EXTENDED_FEATURED1_EBX_INVPCID            FLAG32(10)
+
 //AuthenticAMD
 #define CPUID_SIGNATURE_AMD_EBX         0x68747541
 #define CPUID_SIGNATURE_AMD_ECX         0x444D4163
@@ -546,4 +546,35 @@ __BSR_FUNC(16)
 __BSR_FUNC(32)
 __BSR_FUNC(64)
 
+static inline __attribute__((always_inline)) void invlpg(void* v) {
+    asm volatile(
+        "invlpg (%0)"
+        :
+        : "r"(v)
+        : "memory"
+    );
+}
+
+#define INVPCID_TYPE_INDIVIDUAL_ADDRESS     0
+#define INVPCID_TYPE_SINGLE_CONTEXT         1
+#define INVPCID_TYPE_ALL_CONTEXT_GLOBAL     2
+#define INVPCID_TYPE_ALL_CONTEXT            3
+
+static inline __attribute__((always_inline)) void invpcid(Uint64 type, Uint16 pcid, void* v) {
+    struct {
+        Uint64 pcid;
+        Uint64 address;
+    } __attribute__((packed)) descriptor = {
+        .pcid       = pcid,
+        .address    = (Uint64)v
+    };
+
+    asm volatile(
+        "invpcid %0, %1"
+        :
+        : "m"(descriptor), "r"(type)
+        : "memory"
+    );
+}
+
 #endif // __REAL_SIMPLEASMLINES_H
@@ -3,8 +3,12 @@
 #include<devices/charDevice.h>
 #include<devices/device.h>
 #include<devices/terminal/tty.h>
+#include<memory/memory.h>
+#include<multitask/locks/lockProfile.h>
 #include<print.h>
+#include<algorithms.h>
 #include<kit/bit.h>
+#include<kit/config.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<error.h>
@@ -24,6 +28,24 @@ static DeviceOperations __pseudo_nullDevice_operations = (DeviceOperations) {
 static CharDevice _pseudo_nullDevice;
 static TeletypeDevice _pseudo_teletypeDevice;
 
+#if defined(CONFIG_LOCK_PROFILE)
+
+static void __pseudo_lockstatDevice_operations_readUnits(Device* device, Index64 unitIndex, void* buffer, Size unitN);
+
+static void __pseudo_lockstatDevice_operations_writeUnits(Device* device, Index64 unitIndex, const void* buffer, Size unitN);
+
+static DeviceOperations __pseudo_lockstatDevice_operations = (DeviceOperations) {
+    .readUnits  = __pseudo_lockstatDevice_operations_readUnits,
+    .writeUnits = __pseudo_lockstatDevice_operations_writeUnits,
+    .flush      = __pseudo_nullDevice_operations_flush
+};
+
+static CharDevice _pseudo_lockstatDevice;
+static char _pseudo_lockstatReport[LOCK_PROFILE_REPORT_SIZE];
+static Size _pseudo_lockstatReportLength = 0;
+
+#endif
+
 void pseudoDevice_init() {
     MajorDeviceID major = device_allocMajor();
     if (major == DEVICE_INVALID_ID) {
@@ -57,6 +79,23 @@ void pseudoDevice_init() {
     device_registerDevice(&_pseudo_teletypeDevice.device.device);
     ERROR_GOTO_IF_ERROR(0);
 
+#if defined(CONFIG_LOCK_PROFILE)
+    minor = device_allocMinor(major);
+    if (minor == DEVICE_INVALID_ID) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    args.deviceInitArgs.id          = DEVICE_BUILD_ID(major, minor);
+    args.deviceInitArgs.name        = "lockstat";
+    args.deviceInitArgs.flags       = EMPTY_FLAGS;
+    args.deviceInitArgs.operations  = &__pseudo_lockstatDevice_operations;
+
+    charDevice_initStruct(&_pseudo_lockstatDevice, &args);
+    device_registerDevice(&_pseudo_lockstatDevice.device);
+    ERROR_GOTO_IF_ERROR(0);
+#endif
+
     return;
     ERROR_FINAL_BEGIN(0);
 }
@@ -69,4 +108,22 @@ static void __pseudo_nullDevice_operations_writeUnits(Device* device, Index64 un
 }
 
 static void __pseudo_nullDevice_operations_flush(Device* device) {
-}
\ No newline at end of file
+}
+
+#if defined(CONFIG_LOCK_PROFILE)
+
+static void __pseudo_lockstatDevice_operations_readUnits(Device* device, Index64 unitIndex, void* buffer, Size unitN) {
+    if (unitIndex == 0) {   //Take a new snapshot when reading from beginning, later reads continue on same snapshot
+        _pseudo_lockstatReportLength = lockProfile_report(_pseudo_lockstatReport, sizeof(_pseudo_lockstatReport));
+    }
+
+    Size copyN = unitIndex < _pseudo_lockstatReportLength ? algorithms_umin64(unitN, _pseudo_lockstatReportLength - unitIndex) : 0;
+    memory_memcpy(buffer, _pseudo_lockstatReport + unitIndex, copyN);
+    memory_memset(buffer + copyN, 0, unitN - copyN);    //Reads beyond report get 0
+}
+
+static void __pseudo_lockstatDevice_operations_writeUnits(Device* device, Index64 unitIndex, const void* buffer, Size unitN) {
+    lockProfile_reset();    //Any write clears statistics
+}
+
+#endif
\ No newline at end of file
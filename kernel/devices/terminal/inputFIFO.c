@@ -1,11 +1,13 @@
 #include<devices/terminal/inputFIFO.h>
 
+#include<fs/poll.h>
 #include<multitask/locks/semaphore.h>
 #include<structs/fifo.h>
 
 void inputFIFO_initStruct(InputFIFO* fifo) {
     fifo_initStruct(&fifo->fifo);
     semaphore_initStruct(&fifo->lineNumSema, 0);
+    pollWaitQueue_initStruct(&fifo->pollQueue);
 }
 
 void inputFIFO_inputChar(InputFIFO* fifo, char ch) {
@@ -15,6 +17,7 @@ void inputFIFO_inputChar(InputFIFO* fifo, char ch) {
         fifo_write(&fifo->fifo, &ch, 1);
         if (ch == '\n') {
             semaphore_up(&fifo->lineNumSema);
+            pollWaitQueue_wakeup(&fifo->pollQueue, POLL_EVENTS_IN);
         }
     }
 }
@@ -3,6 +3,7 @@
 #include<devices/display/display.h>
 #include<devices/terminal/virtualTTY.h>
 #include<devices/terminal/bootTTY.h>
+#include<fs/poll.h>
 #include<kit/types.h>
 #include<system/pageTable.h>
 #include<memory/memory.h>
@@ -19,6 +20,8 @@ static void __teletypeDevice_writeUnits(Device* device, Index64 unitIndex, const
 
 static void __teletypeDevice_flush(Device* device);
 
+static PollEvents __teletypeDevice_poll(Device* device, PollTable* table);
+
 static int __tty_print(ConstCstring buffer, Size n, Object arg);
 
 //TODO: Bad naming
@@ -73,7 +76,8 @@ PrintHandler* tty_getPrintHandler() {
 static DeviceOperations _teletypeDevice_operations = {
     .readUnits = __teletypeDevice_readUnits,
     .writeUnits = __teletypeDevice_writeUnits,
-    .flush = __teletypeDevice_flush
+    .flush = __teletypeDevice_flush,
+    .poll = __teletypeDevice_poll
 };
 
 void teletypeDevice_initStruct(TeletypeDevice* device, Teletype* tty) {
@@ -127,6 +131,17 @@ static void __teletypeDevice_flush(Device* device) {
     teletype_rawFlush(tty);
 }
 
+static PollEvents __teletypeDevice_poll(Device* device, PollTable* table) {
+    TeletypeDevice* teletypeDevice = HOST_POINTER(device, TeletypeDevice, device.device);
+    Teletype* tty = teletypeDevice->tty;
+
+    if (tty->operations->poll == NULL) {
+        return POLL_EVENTS_OUT;
+    }
+
+    return tty->operations->poll(tty, table);
+}
+
 static int __tty_print(ConstCstring buffer, Size n, Object arg) {
     Teletype* tty = (Teletype*)arg;
     teletype_rawWrite(tty, buffer, n);
@@ -4,6 +4,7 @@
 #include<devices/terminal/inputFIFO.h>
 #include<devices/terminal/textBuffer.h>
 #include<devices/terminal/tty.h>
+#include<fs/poll.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/memory.h>
@@ -18,6 +19,8 @@ static Size __virtualTTY_write(Teletype* tty, const void* buffer, Size n);
 
 static void __virtualTTY_flush(Teletype* tty);
 
+static PollEvents __virtualTTY_poll(Teletype* tty, PollTable* table);
+
 static void __virtualTTY_switchCursor(VirtualTeletype* tty, bool enable);
 
 static void __virtualTTY_putCharacter(VirtualTeletype* tty, char ch);
@@ -45,7 +48,8 @@ static void __virtualTTY_scrollWindowToRow(VirtualTeletype* tty, Index16 row);
 static TeletypeOperations _virtualTTY_teletypeOperations = {
     .read = __virtualTTY_read,
     .write = __virtualTTY_write,
-    .flush = __virtualTTY_flush
+    .flush = __virtualTTY_flush,
+    .poll = __virtualTTY_poll
 };
 
 void virtualTeletype_initStruct(VirtualTeletype* tty, DisplayContext* displayContext, Size lineCapacity) {
@@ -141,6 +145,21 @@ static Size __virtualTTY_read(Teletype* tty, void* buffer, Size n) {
     return ret;
 }
 
+static PollEvents __virtualTTY_poll(Teletype* tty, PollTable* table) {
+    VirtualTeletype* virtualTeletype = HOST_POINTER(tty, VirtualTeletype, tty);
+    poll_wait(table, &virtualTeletype->input.pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    PollEvents ret = POLL_EVENTS_OUT;   //Output only blocks shortly during input
+    if (inputFIFO_hasLine(&virtualTeletype->input)) {
+        SET_FLAG_BACK(ret, POLL_EVENTS_IN);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
+
 static Size __virtualTTY_write(Teletype* tty, const void* buffer, Size n) {
     if (n == 0) {
         return 0;
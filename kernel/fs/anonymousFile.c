@@ -0,0 +1,155 @@
+#include<fs/anonymousFile.h>
+
+typedef struct AnonymousFileVnode AnonymousFileVnode;
+
+#include<devices/device.h>
+#include<fs/directoryEntry.h>
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/fscore.h>
+#include<fs/fsNode.h>
+#include<fs/vnode.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<structs/refCounter.h>
+#include<debug.h>
+#include<error.h>
+
+typedef struct AnonymousFileVnode {
+    vNode                       vnode;      //Valid only when opened
+    fsNode*                     dummyNode;
+    fsEntryOperations*          operations;
+    AnonymousFileReleaseFunc    release;
+    Object                      object;
+} AnonymousFileVnode;
+
+static vNode* __anonymousFile_fscore_openVnode(FScore* fscore, fsNode* node);
+
+static void __anonymousFile_fscore_closeVnode(FScore* fscore, vNode* vnode);
+
+static fsEntry* __anonymousFile_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags);
+
+static vNodeOperations _anonymousFile_vnode_operations = {  //Data never goes through vnode, see operations of each kind of object
+    .readData = NULL,
+    .writeData = NULL,
+    .resize = NULL,
+    .addDirectoryEntry = NULL,
+    .removeDirectoryEntry = NULL,
+    .renameDirectoryEntry = NULL,
+    .readDirectoryEntries = NULL
+};
+
+static FScoreOperations _anonymousFile_fscore_operations = {
+    .openVnode = __anonymousFile_fscore_openVnode,
+    .closeVnode = __anonymousFile_fscore_closeVnode,
+    .sync = NULL,
+    .openFSentry = __anonymousFile_fscore_openFSentry,
+    .closeFSentry = fscore_genericCloseFSentry,
+    .mount = NULL,
+    .unmount = NULL
+};
+
+static FScore _anonymousFile_fscore = {
+    .blockDevice = NULL,
+    .rootFSnode = NULL,
+    .operations = &_anonymousFile_fscore_operations
+};
+
+fsEntry* anonymousFile_create(ConstCstring name, fsEntryOperations* operations, AnonymousFileReleaseFunc release, Object object, FCNTLopenFlags flags) {
+    AnonymousFileVnode* anonymousVnode = mm_allocate(sizeof(AnonymousFileVnode));
+    if (anonymousVnode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    DirectoryEntry entry;
+    memory_memset(&entry, 0, sizeof(DirectoryEntry));
+    entry.name = name;
+    entry.pointsTo = (Uint64)anonymousVnode;
+    entry.type = FS_ENTRY_TYPE_ANONYMOUS;
+    entry.vnodeID = INVALID_ID;
+
+    FSnodeAttribute attribute;
+    memory_memset(&attribute, 0, sizeof(FSnodeAttribute));
+
+    anonymousVnode->dummyNode = fsnode_create(&entry, 0, &attribute, NULL);
+    if (anonymousVnode->dummyNode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+    anonymousVnode->operations = operations;
+    anonymousVnode->release = release;
+    anonymousVnode->object = object;
+
+    vNode* vnode = fscore_getVnode(&_anonymousFile_fscore, anonymousVnode->dummyNode, false);
+    ERROR_GOTO_IF_ERROR(2);
+    fsEntry* ret = fscore_rawOpenFSentry(&_anonymousFile_fscore, vnode, flags);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        anonymousVnode->release = NULL; //Object belongs to caller until created
+        fscore_releaseVnode(vnode);     //Releases node and vnode
+        ERROR_GOTO(0);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(2);
+    fsnode_derefer(anonymousVnode->dummyNode);
+    ERROR_FINAL_BEGIN(1);
+    mm_free(anonymousVnode);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+Object anonymousFile_getObject(fsEntry* entry, fsEntryOperations* operations) {
+    vNode* vnode = entry->vnode;
+    if (vnode->fscore != &_anonymousFile_fscore) {
+        return OBJECT_NULL;
+    }
+
+    AnonymousFileVnode* anonymousVnode = HOST_POINTER(vnode, AnonymousFileVnode, vnode);
+    return anonymousVnode->operations == operations ? anonymousVnode->object : OBJECT_NULL;
+}
+
+static vNode* __anonymousFile_fscore_openVnode(FScore* fscore, fsNode* node) {
+    AnonymousFileVnode* anonymousVnode = (AnonymousFileVnode*)node->entry.pointsTo;   //Allocated with object, only initialized here
+    vNode* vnode = &anonymousVnode->vnode;
+
+    vNodeInitArgs args = {
+        .vnodeID = INVALID_ID,
+        .tokenSpaceSize = 0,
+        .size = 0,
+        .fscore = &_anonymousFile_fscore,
+        .operations = &_anonymousFile_vnode_operations,
+        .fsNode = node,
+        .deviceID = DEVICE_INVALID_ID
+    };
+
+    vNode_initStruct(vnode, &args);
+
+    return vnode;
+}
+
+static void __anonymousFile_fscore_closeVnode(FScore* fscore, vNode* vnode) {
+    DEBUG_ASSERT_SILENT(REF_COUNTER_GET(vnode->refCounter) == 0);
+    AnonymousFileVnode* anonymousVnode = HOST_POINTER(vnode, AnonymousFileVnode, vnode);
+
+    if (anonymousVnode->release != NULL) {
+        anonymousVnode->release(anonymousVnode->object);
+    }
+
+    fsnode_derefer(anonymousVnode->dummyNode);
+    mm_free(anonymousVnode);
+}
+
+static fsEntry* __anonymousFile_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags) {
+    fsEntry* ret = fscore_genericOpenFSentry(fscore, vnode, flags);
+    ERROR_GOTO_IF_ERROR(0);
+
+    ret->operations = HOST_POINTER(vnode, AnonymousFileVnode, vnode)->operations;
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
\ No newline at end of file
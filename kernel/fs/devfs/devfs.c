@@ -5,6 +5,7 @@
 #include<fs/fsEntry.h>
 #include<fs/fsNode.h>
 #include<fs/fscore.h>
+#include<fs/poll.h>
 #include<fs/devfs/vnode.h>
 #include<kit/types.h>
 #include<kit/util.h>
@@ -23,6 +24,8 @@ static void __devfs_fscore_sync(FScore* fscore);
 
 static fsEntry* __devfs_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags);
 
+static PollEvents __devfs_fsEntry_poll(fsEntry* entry, PollTable* table);
+
 static ConstCstring __devfs_name = "DEVFS";
 static FScoreOperations __devfs_fscoreOperations = {
     .openVnode      = __devfs_fscore_openVnode,
@@ -37,7 +40,8 @@ static FScoreOperations __devfs_fscoreOperations = {
 static fsEntryOperations _devfs_fsEntryOperations = {
     .seek           = fsEntry_genericSeek,
     .read           = fsEntry_genericRead,
-    .write          = fsEntry_genericWrite
+    .write          = fsEntry_genericWrite,
+    .poll           = __devfs_fsEntry_poll
 };
 
 static Vector _devfs_storageMapping;
@@ -231,4 +235,21 @@ static fsEntry* __devfs_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLop
     return ret;
     ERROR_FINAL_BEGIN(0);
     return NULL;
+}
+
+static PollEvents __devfs_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    vNode* vnode = entry->vnode;
+    if (vnode->fsNode->entry.type != FS_ENTRY_TYPE_DEVICE) {
+        return POLL_EVENTS_DEFAULT;
+    }
+
+    Device* device = device_getDevice(vnode->deviceID);
+    if (device == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return device_poll(device, table);
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
 }
\ No newline at end of file
@@ -33,6 +33,8 @@ static void __devfs_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
 
 static void __devfs_vNode_readDirectoryEntries(vNode* vnode);
 
+static Index64 __devfs_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);
+
 static vNodeOperations _devfs_vNodeOperations = {
     .readData                   = __devfs_vNode_readData,
     .writeData                  = __devfs_vNode_writeData,
@@ -40,7 +42,8 @@ static vNodeOperations _devfs_vNodeOperations = {
     .addDirectoryEntry          = __devfs_vNode_addDirectoryEntry,
     .removeDirectoryEntry       = __devfs_vNode_removeDirectoryEntry,
     .renameDirectoryEntry       = __devfs_vNode_renameDirectoryEntry,
-    .readDirectoryEntries       = __devfs_vNode_readDirectoryEntries
+    .readDirectoryEntries       = __devfs_vNode_readDirectoryEntries,
+    .iterateDirectoryEntries    = __devfs_vNode_iterateDirectoryEntries
 };
 
 void devfsDirectoryEntry_initStruct(DevfsDirectoryEntry* entry, ConstCstring name, fsEntryType type, Index64 mappingIndex, Object pointsTo, FSnodeAttribute* attribute) {
@@ -344,9 +347,6 @@ static void __devfs_vNode_readDirectoryEntries(vNode* vnode) {
     DEBUG_ASSERT_SILENT(nodeEntry->type == FS_ENTRY_TYPE_DIRECTORY);
     DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(vnode->fsNode);
 
-    DEBUG_ASSERT_SILENT(dirNode->dirPart.childrenNum == FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM);
-    dirNode->dirPart.childrenNum = 0;
-
     DevfsVnode* devfsVnode = HOST_POINTER(vnode, DevfsVnode, vnode);
 
     Size currentPointer = 0;
@@ -371,4 +371,21 @@ static void __devfs_vNode_readDirectoryEntries(vNode* vnode) {
 
     return;
     ERROR_FINAL_BEGIN(0);
+}
+
+static Index64 __devfs_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) {    //Cookie is offset of entry in directory
+    DEBUG_ASSERT_SILENT(vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+    DEBUG_ASSERT_SILENT(vnode->size % sizeof(DevfsDirectoryEntry) == 0);
+
+    DevfsVnode* devfsVnode = HOST_POINTER(vnode, DevfsVnode, vnode);
+
+    Index64 currentPointer = ALIGN_UP(cookie, sizeof(DevfsDirectoryEntry));
+    for (; currentPointer < vnode->size; currentPointer += sizeof(DevfsDirectoryEntry)) {   //Entries are in memory, passed without copying
+        DevfsDirectoryEntry* devfsDirectoryEntry = devfs_vNode_getDataPointer(devfsVnode, currentPointer);
+        if (!func(arg, devfsDirectoryEntry->name.data, devfsDirectoryEntry->name.length, devfsDirectoryEntry->type, (ID)devfsDirectoryEntry, currentPointer + sizeof(DevfsDirectoryEntry))) {
+            break;
+        }
+    }
+
+    return currentPointer;
 }
\ No newline at end of file
@@ -0,0 +1,489 @@
+#include<fs/epoll.h>
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fs.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/locks/mutex.h>
+#include<multitask/locks/spinlock.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<algorithms.h>
+#include<debug.h>
+#include<error.h>
+
+typedef struct __EpollItem {
+    LinkedListNode  node;       //Node in interest list
+    LinkedListNode  readyNode;  //Node in ready list, valid only when isReady
+    bool            isReady;    //Protected by readyLock
+    Epoll*          epoll;
+    int             fd;
+    fsEntry*        target;     //Watched entry, item is removed when it is closed
+    LinkedListNode  targetNode; //Node in epollItems of target, protected by _epoll_globalLock
+    fsEntry         entry;      //Copy of target for polling, its vnode is referred until item deleted
+    Uint32          events;
+    Uint64          data;
+    PollTable       table;
+} __EpollItem;
+
+static ConstCstring _epoll_fsEntry_name = "epoll";
+
+static Mutex _epoll_globalLock; //Held while adding or deleting items and releasing epolls, so two adds cannot close a loop together and closing entries always finds living epolls
+
+static void __epoll_initStruct(Epoll* epoll);
+
+static void __epoll_clearStruct(Epoll* epoll);
+
+static void __epoll_release(Object object);
+
+static __EpollItem* __epoll_findItem(Epoll* epoll, int fd, fsEntry* target);
+
+static void __epoll_addItem(Epoll* epoll, int fd, fsEntry* target, EpollEvent* event);
+
+static Uint32 __epoll_getUpwardDepth(Epoll* epoll);
+
+static Uint32 __epoll_getDownwardDepth(Epoll* epoll, Epoll* watcher, Uint32 maxDepth);
+
+static void __epoll_removeItem(Epoll* epoll, __EpollItem* item);
+
+static void __epoll_markReady(__EpollItem* item);
+
+static void __epoll_itemWakeup(PollTableEntry* pollEntry, PollEvents events);
+
+static Size __epoll_collectEvents(Epoll* epoll, EpollEvent* events, Size maxEventN);
+
+static inline bool __epoll_isItemDisabled(__EpollItem* item) {
+    return CLEAR_FLAG(item->events, EPOLL_EVENTS_PRIVATE) == 0; //Oneshot item reported already
+}
+
+static Index64 __epoll_fsEntry_seek(fsEntry* entry, Index64 seekTo);
+
+static Size __epoll_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __epoll_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __epoll_fsEntry_poll(fsEntry* entry, PollTable* table);
+
+static fsEntryOperations _epoll_fsEntry_operations = {
+    .seek   = __epoll_fsEntry_seek,
+    .read   = __epoll_fsEntry_read,
+    .write  = __epoll_fsEntry_write,
+    .poll   = __epoll_fsEntry_poll
+};
+
+void epoll_init() {
+    mutex_initStruct(&_epoll_globalLock, EMPTY_FLAGS);
+}
+
+fsEntry* epoll_create() {
+    Epoll* epoll = mm_allocate(sizeof(Epoll));
+    if (epoll == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    __epoll_initStruct(epoll);
+
+    fsEntry* ret = anonymousFile_create(_epoll_fsEntry_name, &_epoll_fsEntry_operations, __epoll_release, (Object)epoll, FCNTL_OPEN_READ_WRITE);
+    ERROR_GOTO_IF_ERROR(1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    __epoll_release((Object)epoll);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+Epoll* epoll_getFromFSentry(fsEntry* entry) {
+    return (Epoll*)anonymousFile_getObject(entry, &_epoll_fsEntry_operations);
+}
+
+void epoll_closeFSentry(fsEntry* entry) {
+    if (linkedList_isEmpty(&entry->epollItems)) {   //Not watched, closed entry is not reachable for adding anymore
+        return;
+    }
+
+    mutex_acquire(&_epoll_globalLock);
+    while (!linkedList_isEmpty(&entry->epollItems)) {
+        __EpollItem* item = HOST_POINTER(linkedListNode_getNext(&entry->epollItems), __EpollItem, targetNode);
+        Epoll* epoll = item->epoll;
+
+        mutex_acquire(&epoll->lock);
+        __epoll_removeItem(epoll, item);    //Never drops the last reference, entry still refers its vnode
+        mutex_release(&epoll->lock);
+    }
+    mutex_release(&_epoll_globalLock);
+}
+
+void epoll_control(Epoll* epoll, int op, int fd, fsEntry* target, EpollEvent* event) {
+    Epoll* targetEpoll = epoll_getFromFSentry(target);
+    if (targetEpoll == epoll) { //Watching itself never ends
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    bool isGlobalLocked = (op != EPOLL_CONTROL_MODIFY); //Items added or deleted
+    if (isGlobalLocked) {
+        mutex_acquire(&_epoll_globalLock);
+    }
+
+    if (op == EPOLL_CONTROL_ADD && targetEpoll != NULL) {
+        Uint32 upwardDepth = __epoll_getUpwardDepth(epoll);
+        if (upwardDepth >= EPOLL_MAX_NEST_DEPTH || __epoll_getDownwardDepth(targetEpoll, epoll, EPOLL_MAX_NEST_DEPTH - upwardDepth) > EPOLL_MAX_NEST_DEPTH - upwardDepth) {
+            ERROR_THROW(ERROR_ID_LOOP, 1);
+        }
+    }
+
+    mutex_acquire(&epoll->lock);
+
+    __EpollItem* item = __epoll_findItem(epoll, fd, target);
+    switch (op) {
+        case EPOLL_CONTROL_ADD:
+            if (item != NULL) {
+                ERROR_THROW(ERROR_ID_ALREADY_EXIST, 2);
+            }
+
+            __epoll_addItem(epoll, fd, target, event);
+            ERROR_GOTO_IF_ERROR(2);
+            break;
+        case EPOLL_CONTROL_MODIFY:
+            if (item == NULL) {
+                ERROR_THROW(ERROR_ID_NOT_FOUND, 2);
+            }
+
+            item->events = event->events;
+            item->data = event->data;
+
+            PollEvents revents = fs_filePoll(&item->entry, NULL);
+            ERROR_GOTO_IF_ERROR(2);
+            if ((revents & (item->events | POLL_EVENTS_ALWAYS)) != EMPTY_FLAGS) {
+                __epoll_markReady(item);
+            }
+            break;
+        case EPOLL_CONTROL_DELETE:
+            if (item == NULL) {
+                ERROR_THROW(ERROR_ID_NOT_FOUND, 2);
+            }
+
+            __epoll_removeItem(epoll, item);
+            break;
+        default:
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 2);
+    }
+
+    mutex_release(&epoll->lock);
+    if (isGlobalLocked) {
+        mutex_release(&_epoll_globalLock);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(2);
+    mutex_release(&epoll->lock);
+    ERROR_FINAL_BEGIN(1);
+    if (isGlobalLocked) {
+        mutex_release(&_epoll_globalLock);
+    }
+    ERROR_FINAL_BEGIN(0);
+}
+
+Size epoll_wait(Epoll* epoll, EpollEvent* events, Size maxEventN, Int64 timeout) {
+    if (maxEventN == 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    PollWaiter waiter;
+    pollWaiter_initStruct(&waiter, timeout);
+    if (timeout != 0) {
+        poll_wait(&waiter.table, &epoll->pollQueue);    //Only epoll itself is waited, items wake it up
+        ERROR_GOTO_IF_ERROR(1);
+    }
+
+    Size ret = 0;
+    while (true) {
+        ret = __epoll_collectEvents(epoll, events, maxEventN);
+        ERROR_GOTO_IF_ERROR(1);
+
+        if (ret > 0 || !pollWaiter_sleep(&waiter)) {
+            break;
+        }
+    }
+
+    pollWaiter_clearStruct(&waiter);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    pollWaiter_clearStruct(&waiter);
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static void __epoll_initStruct(Epoll* epoll) {
+    mutex_initStruct(&epoll->lock, EMPTY_FLAGS);
+    linkedList_initStruct(&epoll->items);
+    epoll->readyLock = SPINLOCK_UNLOCKED;
+    linkedList_initStruct(&epoll->readyList);
+    pollWaitQueue_initStruct(&epoll->pollQueue);
+}
+
+static void __epoll_clearStruct(Epoll* epoll) {
+    DEBUG_ASSERT_SILENT(linkedList_isEmpty(&epoll->pollQueue.entries));
+
+    mutex_acquire(&epoll->lock);
+    while (!linkedList_isEmpty(&epoll->items)) {
+        __epoll_removeItem(epoll, HOST_POINTER(linkedListNode_getNext(&epoll->items), __EpollItem, node));
+    }
+    mutex_release(&epoll->lock);
+}
+
+static void __epoll_release(Object object) {
+    Epoll* epoll = (Epoll*)object;
+    mutex_acquire(&_epoll_globalLock);
+    __epoll_clearStruct(epoll);
+    mutex_release(&_epoll_globalLock);
+    mm_free(epoll);
+}
+
+static __EpollItem* __epoll_findItem(Epoll* epoll, int fd, fsEntry* target) {
+    for (LinkedListNode* node = linkedListNode_getNext(&epoll->items); node != &epoll->items; node = linkedListNode_getNext(node)) {
+        __EpollItem* item = HOST_POINTER(node, __EpollItem, node);
+        if (item->fd == fd && item->target == target) {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+static void __epoll_addItem(Epoll* epoll, int fd, fsEntry* target, EpollEvent* event) {
+    __EpollItem* item = mm_allocate(sizeof(__EpollItem));
+    if (item == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    linkedListNode_initStruct(&item->node);
+    linkedListNode_initStruct(&item->readyNode);
+    linkedListNode_initStruct(&item->targetNode);
+    item->isReady = false;
+    item->epoll = epoll;
+    item->fd = fd;
+    item->target = target;
+    memory_memcpy(&item->entry, target, sizeof(fsEntry));
+    REF_COUNTER_REFER(target->vnode->refCounter);
+    item->events = event->events;
+    item->data = event->data;
+    pollTable_initStruct(&item->table, __epoll_itemWakeup);
+
+    linkedListNode_insertFront(&epoll->items, &item->node);
+    linkedListNode_insertFront(&target->epollItems, &item->targetNode);
+
+    PollEvents revents = fs_filePoll(&item->entry, &item->table);   //Registered to wait queues of target here
+    ERROR_GOTO_IF_ERROR(0);
+    if ((revents & (item->events | POLL_EVENTS_ALWAYS)) != EMPTY_FLAGS) {
+        __epoll_markReady(item);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (item != NULL) {
+        __epoll_removeItem(epoll, item);
+    }
+}
+
+static Uint32 __epoll_getUpwardDepth(Epoll* epoll) {
+    Uint32 ret = 1;
+
+    PollWaitQueue* queue = &epoll->pollQueue;
+    bool interruptEnabled = spinlock_lockIrqSave(&queue->lock);  //Same lock order as wakeup, which walks up the chain too
+    for (LinkedListNode* node = linkedListNode_getNext(&queue->entries); node != &queue->entries; node = linkedListNode_getNext(node)) {
+        PollTable* table = HOST_POINTER(node, PollTableEntry, node)->table;
+        if (table->wakeup != __epoll_itemWakeup) {  //Not watched by an epoll
+            continue;
+        }
+
+        __EpollItem* item = HOST_POINTER(table, __EpollItem, table);
+        ret = algorithms_umax32(ret, __epoll_getUpwardDepth(item->epoll) + 1);
+    }
+    spinlock_unlockIrqRestore(&queue->lock, interruptEnabled);
+
+    return ret;
+}
+
+static Uint32 __epoll_getDownwardDepth(Epoll* epoll, Epoll* watcher, Uint32 maxDepth) {
+    if (epoll == watcher) { //Watcher reachable, adding it closes a loop
+        return INFINITE;
+    }
+
+    if (maxDepth == 0) {    //Too deep already, no need to look further
+        return 1;
+    }
+
+    Uint32 ret = 1;
+
+    mutex_acquire(&epoll->lock);
+    for (LinkedListNode* node = linkedListNode_getNext(&epoll->items); node != &epoll->items && ret <= maxDepth; node = linkedListNode_getNext(node)) {
+        Epoll* nested = epoll_getFromFSentry(&HOST_POINTER(node, __EpollItem, node)->entry);
+        if (nested == NULL) {
+            continue;
+        }
+
+        Uint32 depth = __epoll_getDownwardDepth(nested, watcher, maxDepth - 1);
+        ret = depth == (Uint32)INFINITE ? INFINITE : algorithms_umax32(ret, depth + 1);
+    }
+    mutex_release(&epoll->lock);
+
+    return ret;
+}
+
+static void __epoll_removeItem(Epoll* epoll, __EpollItem* item) {
+    pollTable_clearStruct(&item->table);    //No wakeup after this
+
+    bool interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    if (item->isReady) {
+        linkedListNode_delete(&item->readyNode);
+        item->isReady = false;
+    }
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    linkedListNode_delete(&item->node);
+    linkedListNode_delete(&item->targetNode);
+    fscore_releaseVnode(item->entry.vnode);
+    mm_free(item);
+}
+
+static void __epoll_markReady(__EpollItem* item) {
+    Epoll* epoll = item->epoll;
+
+    bool interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    bool added = !item->isReady;
+    if (added) {
+        linkedListNode_insertFront(&epoll->readyList, &item->readyNode);
+        item->isReady = true;
+    }
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    if (added) {
+        pollWaitQueue_wakeup(&epoll->pollQueue, POLL_EVENTS_IN);
+    }
+}
+
+static void __epoll_itemWakeup(PollTableEntry* pollEntry, PollEvents events) {
+    __EpollItem* item = HOST_POINTER(pollEntry->table, __EpollItem, table);
+    if (__epoll_isItemDisabled(item)) {
+        return;
+    }
+
+    if (events != EMPTY_FLAGS && (events & (item->events | POLL_EVENTS_ALWAYS)) == EMPTY_FLAGS) {   //Not interested
+        return;
+    }
+
+    __epoll_markReady(item);
+}
+
+static Size __epoll_collectEvents(Epoll* epoll, EpollEvent* events, Size maxEventN) {
+    LinkedList list;
+    linkedList_initStruct(&list);
+
+    mutex_acquire(&epoll->lock);    //Items are not deleted during collecting
+
+    bool interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    if (!linkedList_isEmpty(&epoll->readyList)) {  //Take whole ready list, items stay marked ready so wakers skip them
+        list.next = epoll->readyList.next;
+        list.prev = epoll->readyList.prev;
+        list.next->prev = &list;
+        list.prev->next = &list;
+        linkedList_initStruct(&epoll->readyList);
+    }
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    Size ret = 0;
+    while (!linkedList_isEmpty(&list) && ret < maxEventN) {
+        __EpollItem* item = HOST_POINTER(linkedListNode_getNext(&list), __EpollItem, readyNode);
+
+        interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+        linkedListNode_delete(&item->readyNode);
+        item->isReady = false;  //Events after this point put it back
+        spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+        if (__epoll_isItemDisabled(item)) {
+            continue;
+        }
+
+        PollEvents revents = fs_filePoll(&item->entry, NULL) & (item->events | POLL_EVENTS_ALWAYS);
+        ERROR_GOTO_IF_ERROR(0);
+        if (revents == EMPTY_FLAGS) {   //Not ready anymore
+            continue;
+        }
+
+        events[ret].events = revents;
+        events[ret].data = item->data;
+        ++ret;
+
+        if (TEST_FLAGS(item->events, EPOLL_EVENTS_ONESHOT)) {
+            item->events = VAL_AND(item->events, EPOLL_EVENTS_PRIVATE);
+        } else if (TEST_FLAGS_FAIL(item->events, EPOLL_EVENTS_EDGE_TRIGGERED)) {
+            __epoll_markReady(item);    //Level triggered item stays in ready list until it is found not ready
+        }
+    }
+
+    interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    while (!linkedList_isEmpty(&list)) {    //Put unvisited items back to head, keep their order
+        LinkedListNode* node = linkedListNode_getPrev(&list);
+        linkedListNode_delete(node);
+        linkedListNode_insertBack(&epoll->readyList, node);
+    }
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    mutex_release(&epoll->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    while (!linkedList_isEmpty(&list)) {
+        LinkedListNode* node = linkedListNode_getPrev(&list);
+        linkedListNode_delete(node);
+        linkedListNode_insertBack(&epoll->readyList, node);
+    }
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    mutex_release(&epoll->lock);
+    return 0;
+}
+
+static Index64 __epoll_fsEntry_seek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __epoll_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static Size __epoll_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static PollEvents __epoll_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    Epoll* epoll = epoll_getFromFSentry(entry);
+    poll_wait(table, &epoll->pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    bool interruptEnabled = spinlock_lockIrqSave(&epoll->readyLock);
+    bool isReady = !linkedList_isEmpty(&epoll->readyList);
+    spinlock_unlockIrqRestore(&epoll->readyLock, interruptEnabled);
+
+    return isReady ? POLL_EVENTS_IN : EMPTY_FLAGS;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
\ No newline at end of file
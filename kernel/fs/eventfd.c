@@ -0,0 +1,230 @@
+#include<fs/eventfd.h>
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/locks/spinlock.h>
+#include<debug.h>
+#include<error.h>
+
+static ConstCstring _eventfd_fsEntry_name = "eventfd";
+
+static void __eventfd_release(Object object);
+
+static bool __eventfd_tryRead(Eventfd* eventfd, Uint64* valueRet);
+
+static bool __eventfd_tryWrite(Eventfd* eventfd, Uint64 value);
+
+static Index64 __eventfd_fsEntry_seek(fsEntry* entry, Index64 seekTo);
+
+static Size __eventfd_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __eventfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __eventfd_fsEntry_poll(fsEntry* entry, PollTable* table);
+
+static fsEntryOperations _eventfd_fsEntry_operations = {
+    .seek   = __eventfd_fsEntry_seek,
+    .read   = __eventfd_fsEntry_read,
+    .write  = __eventfd_fsEntry_write,
+    .poll   = __eventfd_fsEntry_poll
+};
+
+fsEntry* eventfd_create(Uint64 initValue, Flags8 flags, FCNTLopenFlags openFlags) {
+    if (initValue > EVENTFD_COUNTER_MAX) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Eventfd* eventfd = mm_allocate(sizeof(Eventfd));
+    if (eventfd == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    eventfd->lock = SPINLOCK_UNLOCKED;
+    eventfd->counter = initValue;
+    eventfd->flags = flags;
+    pollWaitQueue_initStruct(&eventfd->pollQueue);
+
+    fsEntry* ret = anonymousFile_create(_eventfd_fsEntry_name, &_eventfd_fsEntry_operations, __eventfd_release, (Object)eventfd, FCNTL_OPEN_READ_WRITE | openFlags);
+    ERROR_GOTO_IF_ERROR(1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_free(eventfd);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+Eventfd* eventfd_getFromFSentry(fsEntry* entry) {
+    return (Eventfd*)anonymousFile_getObject(entry, &_eventfd_fsEntry_operations);
+}
+
+void eventfd_signal(Eventfd* eventfd, Uint64 n) {
+    bool interruptEnabled = spinlock_lockIrqSave(&eventfd->lock);
+    bool wasZero = eventfd->counter == 0;
+    eventfd->counter = (EVENTFD_COUNTER_MAX - eventfd->counter < n) ? EVENTFD_COUNTER_MAX : eventfd->counter + n;
+    bool becameReadable = wasZero && eventfd->counter > 0;
+    spinlock_unlockIrqRestore(&eventfd->lock, interruptEnabled);
+
+    if (becameReadable) {
+        pollWaitQueue_wakeup(&eventfd->pollQueue, POLL_EVENTS_IN);
+    }
+}
+
+static void __eventfd_release(Object object) {
+    Eventfd* eventfd = (Eventfd*)object;
+    DEBUG_ASSERT_SILENT(linkedList_isEmpty(&eventfd->pollQueue.entries));
+    mm_free(eventfd);
+}
+
+static bool __eventfd_tryRead(Eventfd* eventfd, Uint64* valueRet) {
+    bool interruptEnabled = spinlock_lockIrqSave(&eventfd->lock);
+    Uint64 value = 0;
+    if (eventfd->counter > 0) {
+        value = TEST_FLAGS(eventfd->flags, EVENTFD_FLAGS_SEMAPHORE) ? 1 : eventfd->counter;
+        eventfd->counter -= value;
+    }
+    spinlock_unlockIrqRestore(&eventfd->lock, interruptEnabled);
+
+    if (value == 0) {
+        return false;
+    }
+
+    *valueRet = value;
+    pollWaitQueue_wakeup(&eventfd->pollQueue, POLL_EVENTS_OUT);
+
+    return true;
+}
+
+static bool __eventfd_tryWrite(Eventfd* eventfd, Uint64 value) {
+    bool interruptEnabled = spinlock_lockIrqSave(&eventfd->lock);
+    bool ret = EVENTFD_COUNTER_MAX - eventfd->counter >= value;
+    bool wasZero = eventfd->counter == 0;
+    if (ret) {
+        eventfd->counter += value;
+    }
+    spinlock_unlockIrqRestore(&eventfd->lock, interruptEnabled);
+
+    if (ret && wasZero && value > 0) {
+        pollWaitQueue_wakeup(&eventfd->pollQueue, POLL_EVENTS_IN);
+    }
+
+    return ret;
+}
+
+static Index64 __eventfd_fsEntry_seek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __eventfd_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    if (n < sizeof(Uint64)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Eventfd* eventfd = eventfd_getFromFSentry(entry);
+    PollWaiter waiter;
+    bool waiting = false;
+    Uint64 value;
+    while (!__eventfd_tryRead(eventfd, &value)) {
+        if (TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, writers may come in between
+            pollWaiter_initStruct(&waiter, -1);
+            waiting = true;
+            poll_wait(&waiter.table, &eventfd->pollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        pollWaiter_sleep(&waiter);
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    memory_memcpy(buffer, &value, sizeof(Uint64));
+
+    return sizeof(Uint64);
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static Size __eventfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    Uint64 value;
+    if (n < sizeof(Uint64)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    memory_memcpy(&value, buffer, sizeof(Uint64));
+    if (value > EVENTFD_COUNTER_MAX) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Eventfd* eventfd = eventfd_getFromFSentry(entry);
+    PollWaiter waiter;
+    bool waiting = false;
+    while (!__eventfd_tryWrite(eventfd, value)) {
+        if (TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, readers may come in between
+            pollWaiter_initStruct(&waiter, -1);
+            waiting = true;
+            poll_wait(&waiter.table, &eventfd->pollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        pollWaiter_sleep(&waiter);
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    return sizeof(Uint64);
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static PollEvents __eventfd_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    Eventfd* eventfd = eventfd_getFromFSentry(entry);
+    poll_wait(table, &eventfd->pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    bool interruptEnabled = spinlock_lockIrqSave(&eventfd->lock);
+    Uint64 counter = eventfd->counter;
+    spinlock_unlockIrqRestore(&eventfd->lock, interruptEnabled);
+
+    PollEvents ret = EMPTY_FLAGS;
+    if (counter > 0) {
+        SET_FLAG_BACK(ret, POLL_EVENTS_IN);
+    }
+
+    if (counter < EVENTFD_COUNTER_MAX) {
+        SET_FLAG_BACK(ret, POLL_EVENTS_OUT);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
\ No newline at end of file
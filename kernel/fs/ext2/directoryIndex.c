@@ -0,0 +1,479 @@
+#include<fs/ext2/directoryIndex.h>
+
+#include<fs/ext2/ext2.h>
+#include<fs/ext2/vnode.h>
+#include<fs/vnode.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<debug.h>
+#include<error.h>
+
+typedef struct __EXT2directoryIndexRootInfo {
+    Uint32  reserved;
+    Uint8   hashVersion;
+    Uint8   infoLength;
+    Uint8   indirectLevelNum;
+    Uint8   flags;
+} __attribute__((packed)) __EXT2directoryIndexRootInfo;
+
+typedef struct __EXT2directoryIndexEntry {
+    Uint32  hash;   //Lowest bit set if leaf continues a collision from previous leaf
+    Index32 block;
+} __attribute__((packed)) __EXT2directoryIndexEntry;
+
+typedef struct __EXT2directoryIndexCountLimit {
+    Uint16  limit;
+    Uint16  count;
+} __attribute__((packed)) __EXT2directoryIndexCountLimit;   //Takes place of hash of first entry
+
+typedef struct __EXT2directoryIndexNodeHeader {
+    Index32 inodeID;
+    Uint16  recordLength;
+    Uint8   nameLength;
+    Uint8   type;
+} __attribute__((packed)) __EXT2directoryIndexNodeHeader;   //Index block looks like an empty directory entry covering whole block to linear readers
+
+#define __EXT2_DIRECTORY_INDEX_ROOT_INFO_OFFSET 24  //After '.' and '..' entries
+#define __EXT2_DIRECTORY_INDEX_NODE_ENTRY_OFFSET 8  //After an empty entry covering whole block
+#define __EXT2_DIRECTORY_INDEX_BLOCK_MASK       0x0FFFFFFF
+
+#define __EXT2_DIRECTORY_INDEX_ROTATE_LEFT(__X, __N)    (((__X) << (__N)) | ((__X) >> (32 - (__N))))
+
+static Uint32 __ext2DirectoryIndex_legacyHash(ConstCstring name, Size nameLength, bool isUnsigned);
+
+static void __ext2DirectoryIndex_nameToBuffer(ConstCstring name, Size nameLength, Uint32* buffer, int num, bool isUnsigned);
+
+static void __ext2DirectoryIndex_halfMD4transform(Uint32* buffer, Uint32* in);
+
+static void __ext2DirectoryIndex_TEAtransform(Uint32* buffer, Uint32* in);
+
+static void __ext2DirectoryIndex_insertEntry(vNode* vnode, EXT2directoryIndexPath* path, Uint8 level, Uint32 hash, Index32 block);
+
+static inline Size __ext2DirectoryIndex_getBlockSize(vNode* vnode) {
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    return EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
+}
+
+static inline __EXT2directoryIndexEntry* __ext2DirectoryIndex_initNode(Uint8* block, Size blockSize) {
+    __EXT2directoryIndexNodeHeader* header = (__EXT2directoryIndexNodeHeader*)block;
+    memory_memset(header, 0, sizeof(__EXT2directoryIndexNodeHeader));
+    header->recordLength = blockSize;
+
+    __EXT2directoryIndexEntry* ret = (__EXT2directoryIndexEntry*)(block + __EXT2_DIRECTORY_INDEX_NODE_ENTRY_OFFSET);
+    __EXT2directoryIndexCountLimit* countLimit = (__EXT2directoryIndexCountLimit*)ret;
+    countLimit->limit = (blockSize - __EXT2_DIRECTORY_INDEX_NODE_ENTRY_OFFSET) / sizeof(__EXT2directoryIndexEntry);
+    countLimit->count = 0;
+
+    return ret;
+}
+
+Uint32 ext2DirectoryIndex_hash(ConstCstring name, Size nameLength, Uint8 hashVersion, Uint32* seed) {
+    Uint32 buffer[4] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476 }, in[8];
+    if (seed != NULL && (seed[0] | seed[1] | seed[2] | seed[3]) != 0) {
+        memory_memcpy(buffer, seed, sizeof(buffer));
+    }
+
+    bool isUnsigned = hashVersion >= EXT2_DIRECTORY_INDEX_HASH_LEGACY_UNSIGNED;
+    Uint32 ret = 0;
+    switch (hashVersion) {
+        case EXT2_DIRECTORY_INDEX_HASH_LEGACY:
+        case EXT2_DIRECTORY_INDEX_HASH_LEGACY_UNSIGNED: {
+            ret = __ext2DirectoryIndex_legacyHash(name, nameLength, isUnsigned);
+            break;
+        }
+        case EXT2_DIRECTORY_INDEX_HASH_HALF_MD4:
+        case EXT2_DIRECTORY_INDEX_HASH_HALF_MD4_UNSIGNED: {
+            for (Index64 i = 0; i < nameLength; i += 32) {
+                __ext2DirectoryIndex_nameToBuffer(name + i, nameLength - i, in, 8, isUnsigned);
+                __ext2DirectoryIndex_halfMD4transform(buffer, in);
+            }
+            ret = buffer[1];
+            break;
+        }
+        case EXT2_DIRECTORY_INDEX_HASH_TEA:
+        case EXT2_DIRECTORY_INDEX_HASH_TEA_UNSIGNED: {
+            for (Index64 i = 0; i < nameLength; i += 16) {
+                __ext2DirectoryIndex_nameToBuffer(name + i, nameLength - i, in, 4, isUnsigned);
+                __ext2DirectoryIndex_TEAtransform(buffer, in);
+            }
+            ret = buffer[0];
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    ret &= ~1;
+    if (ret == (0x7FFFFFFFu << 1)) { //Reserved for end of directory
+        ret = (0x7FFFFFFFu - 1) << 1;
+    }
+
+    return ret;
+}
+
+Index32 ext2DirectoryIndex_findLeaf(vNode* vnode, ConstCstring name, Size nameLength, EXT2directoryIndexPath* pathRet) {
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    EXT2SuperBlock* superblock = ext2fscore->superBlock;
+
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
+    Size blockNum = vnode->size / blockSize;
+
+    Uint8* buffer = mm_allocate(blockSize);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    vNode_rawReadData(vnode, 0, buffer, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    Index32 ret = INVALID_INDEX32;
+    __EXT2directoryIndexRootInfo* info = (__EXT2directoryIndexRootInfo*)(buffer + __EXT2_DIRECTORY_INDEX_ROOT_INFO_OFFSET);
+    if (info->reserved != 0 || info->indirectLevelNum > EXT2_DIRECTORY_INDEX_MAX_INDIRECT_LEVEL || __EXT2_DIRECTORY_INDEX_ROOT_INFO_OFFSET + info->infoLength + sizeof(__EXT2directoryIndexEntry) > blockSize) {
+        mm_free(buffer);
+        return INVALID_INDEX32;
+    }
+
+    Uint8 hashVersion = info->hashVersion, indirectLevelNum = info->indirectLevelNum;
+    if (hashVersion <= EXT2_DIRECTORY_INDEX_HASH_TEA && TEST_FLAGS(superblock->flags, EXT2_SUPERBLOCK_IN_STORAGE_FLAGS_UNSIGNED_HASH)) {
+        hashVersion += EXT2_DIRECTORY_INDEX_HASH_LEGACY_UNSIGNED;
+    }
+
+    if (hashVersion > EXT2_DIRECTORY_INDEX_HASH_TEA_UNSIGNED) {
+        mm_free(buffer);
+        return INVALID_INDEX32;
+    }
+
+    pathRet->hashVersion = hashVersion;
+    pathRet->frameNum = 0;
+    memory_memcpy(pathRet->seed, superblock->hashSeed, sizeof(pathRet->seed));  //Superblock is packed
+    pathRet->hash = ext2DirectoryIndex_hash(name, nameLength, hashVersion, pathRet->seed);
+
+    Index32 block = 0;
+    Size entriesBegin = __EXT2_DIRECTORY_INDEX_ROOT_INFO_OFFSET + info->infoLength;
+    for (Uint8 level = 0; ; ++level) {
+        __EXT2directoryIndexEntry* entries = (__EXT2directoryIndexEntry*)(buffer + entriesBegin);
+        __EXT2directoryIndexCountLimit* countLimit = (__EXT2directoryIndexCountLimit*)entries;
+        Size count = countLimit->count;
+        if (count == 0 || count > countLimit->limit || entriesBegin + count * sizeof(__EXT2directoryIndexEntry) > blockSize) {
+            break;
+        }
+
+        Index32 begin = 1, end = count;    //Last entry with hash not greater than hash, first entry covers hashes below second one
+        while (begin < end) {
+            Index32 mid = (begin + end) / 2;
+            if (entries[mid].hash > pathRet->hash) {
+                end = mid;
+            } else {
+                begin = mid + 1;
+            }
+        }
+
+        pathRet->frames[level] = (EXT2directoryIndexFrame) {
+            .block          = block,
+            .entriesBegin   = entriesBegin,
+            .position       = begin - 1
+        };
+        pathRet->frameNum = level + 1;
+
+        block = entries[begin - 1].block & __EXT2_DIRECTORY_INDEX_BLOCK_MASK;
+        if (block == 0 || block >= blockNum) {
+            break;
+        }
+
+        if (level == indirectLevelNum) {
+            ret = block;
+            break;
+        }
+
+        vNode_rawReadData(vnode, (Index64)block * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+        entriesBegin = __EXT2_DIRECTORY_INDEX_NODE_ENTRY_OFFSET;
+    }
+
+    pathRet->leaf = ret;
+
+    mm_free(buffer);
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+    return INVALID_INDEX32;
+}
+
+Index32 ext2DirectoryIndex_nextLeaf(vNode* vnode, EXT2directoryIndexPath* path) {   //As htree_next_block in Linux
+    Size blockSize = __ext2DirectoryIndex_getBlockSize(vnode);
+    Size blockNum = vnode->size / blockSize;
+
+    Uint8* buffer = mm_allocate(blockSize);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Index32 level = path->frameNum - 1;
+    EXT2directoryIndexFrame* frame = NULL;
+    __EXT2directoryIndexEntry* entries = NULL;
+    while (true) {  //Lowest index block not at its last entry yet, next leaf may be under another index block
+        frame = &path->frames[level];
+        vNode_rawReadData(vnode, (Index64)frame->block * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+
+        entries = (__EXT2directoryIndexEntry*)(buffer + frame->entriesBegin);
+        if (frame->position + 1 < ((__EXT2directoryIndexCountLimit*)entries)->count) {
+            break;
+        }
+
+        if (level == 0) {   //Last leaf of directory
+            mm_free(buffer);
+            return INVALID_INDEX32;
+        }
+        --level;
+    }
+
+    if ((entries[frame->position + 1].hash & ~1) != path->hash) {   //Next leaf begins with another hash, collision bit set or not
+        mm_free(buffer);
+        return INVALID_INDEX32;
+    }
+
+    ++frame->position;
+    Index32 block = entries[frame->position].block & __EXT2_DIRECTORY_INDEX_BLOCK_MASK;
+    for (++level; level < path->frameNum; ++level) {    //Down along first entries of following index blocks
+        if (block == 0 || block >= blockNum) {
+            ERROR_THROW(ERROR_ID_DATA_ERROR, 0);
+        }
+
+        vNode_rawReadData(vnode, (Index64)block * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+
+        path->frames[level].block = block;
+        path->frames[level].position = 0;
+        block = ((__EXT2directoryIndexEntry*)(buffer + path->frames[level].entriesBegin))[0].block & __EXT2_DIRECTORY_INDEX_BLOCK_MASK;
+    }
+
+    if (block == 0 || block >= blockNum) {
+        ERROR_THROW(ERROR_ID_DATA_ERROR, 0);
+    }
+    path->leaf = block;
+
+    mm_free(buffer);
+    return block;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+    return INVALID_INDEX32;
+}
+
+void ext2DirectoryIndex_addLeaf(vNode* vnode, EXT2directoryIndexPath* path, Uint32 hash, Index32 leaf) {
+    DEBUG_ASSERT_SILENT(path->frameNum > 0);
+    __ext2DirectoryIndex_insertEntry(vnode, path, path->frameNum - 1, hash, leaf);
+}
+
+static Uint32 __ext2DirectoryIndex_legacyHash(ConstCstring name, Size nameLength, bool isUnsigned) {
+    Uint32 hash0 = 0x12A3FE2D, hash1 = 0x37ABE8F9;
+    for (Index64 i = 0; i < nameLength; ++i) {
+        int c = isUnsigned ? (int)(Uint8)name[i] : (int)(Int8)name[i];
+        Uint32 hash = hash1 + (hash0 ^ (Uint32)(c * 7152373));
+        if (hash & 0x80000000) {
+            hash -= 0x7FFFFFFF;
+        }
+        hash1 = hash0;
+        hash0 = hash;
+    }
+
+    return hash0 << 1;
+}
+
+static void __ext2DirectoryIndex_nameToBuffer(ConstCstring name, Size nameLength, Uint32* buffer, int num, bool isUnsigned) {
+    Uint32 pad = (Uint32)nameLength | ((Uint32)nameLength << 8);
+    pad |= pad << 16;
+
+    Uint32 val = pad;
+    Size length = nameLength > num * 4 ? num * 4 : nameLength;
+    for (Index64 i = 0; i < length; ++i) {
+        int c = isUnsigned ? (int)(Uint8)name[i] : (int)(Int8)name[i];
+        val = (Uint32)c + (val << 8);
+        if (i % 4 == 3) {
+            *buffer++ = val;
+            val = pad;
+            --num;
+        }
+    }
+
+    if (--num >= 0) {
+        *buffer++ = val;
+    }
+
+    while (--num >= 0) {
+        *buffer++ = pad;
+    }
+}
+
+#define __EXT2_DIRECTORY_INDEX_F(__X, __Y, __Z) ((__Z) ^ ((__X) & ((__Y) ^ (__Z))))
+#define __EXT2_DIRECTORY_INDEX_G(__X, __Y, __Z) (((__X) & (__Y)) + (((__X) ^ (__Y)) & (__Z)))
+#define __EXT2_DIRECTORY_INDEX_H(__X, __Y, __Z) ((__X) ^ (__Y) ^ (__Z))
+#define __EXT2_DIRECTORY_INDEX_ROUND(__F, __A, __B, __C, __D, __X, __S) (__A += __F(__B, __C, __D) + (__X), __A = __EXT2_DIRECTORY_INDEX_ROTATE_LEFT(__A, __S))
+
+static void __ext2DirectoryIndex_halfMD4transform(Uint32* buffer, Uint32* in) {
+    static const Uint32 k2 = 013240474631, k3 = 015666365641;
+    Uint32 a = buffer[0], b = buffer[1], c = buffer[2], d = buffer[3];
+
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, a, b, c, d, in[0], 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, d, a, b, c, in[1], 7);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, c, d, a, b, in[2], 11);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, b, c, d, a, in[3], 19);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, a, b, c, d, in[4], 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, d, a, b, c, in[5], 7);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, c, d, a, b, in[6], 11);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_F, b, c, d, a, in[7], 19);
+
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, a, b, c, d, in[1] + k2, 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, d, a, b, c, in[3] + k2, 5);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, c, d, a, b, in[5] + k2, 9);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, b, c, d, a, in[7] + k2, 13);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, a, b, c, d, in[0] + k2, 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, d, a, b, c, in[2] + k2, 5);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, c, d, a, b, in[4] + k2, 9);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_G, b, c, d, a, in[6] + k2, 13);
+
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, a, b, c, d, in[3] + k3, 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, d, a, b, c, in[7] + k3, 9);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, c, d, a, b, in[2] + k3, 11);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, b, c, d, a, in[6] + k3, 15);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, a, b, c, d, in[1] + k3, 3);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, d, a, b, c, in[5] + k3, 9);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, c, d, a, b, in[0] + k3, 11);
+    __EXT2_DIRECTORY_INDEX_ROUND(__EXT2_DIRECTORY_INDEX_H, b, c, d, a, in[4] + k3, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+static void __ext2DirectoryIndex_TEAtransform(Uint32* buffer, Uint32* in) {
+    Uint32 sum = 0, b0 = buffer[0], b1 = buffer[1];
+    Uint32 a = in[0], b = in[1], c = in[2], d = in[3];
+
+    for (int i = 0; i < 16; ++i) {
+        sum += 0x9E3779B9;
+        b0 += ((b1 << 4) + a) ^ (b1 + sum) ^ ((b1 >> 5) + b);
+        b1 += ((b0 << 4) + c) ^ (b0 + sum) ^ ((b0 >> 5) + d);
+    }
+
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+static void __ext2DirectoryIndex_insertEntry(vNode* vnode, EXT2directoryIndexPath* path, Uint8 level, Uint32 hash, Index32 block) {
+    Size blockSize = __ext2DirectoryIndex_getBlockSize(vnode);
+
+    Uint8* buffer = mm_allocate(2 * blockSize); //Index block and its new sibling
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    EXT2directoryIndexFrame* frame = &path->frames[level];
+    vNode_rawReadData(vnode, (Index64)frame->block * blockSize, buffer, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    __EXT2directoryIndexEntry* entries = (__EXT2directoryIndexEntry*)(buffer + frame->entriesBegin);
+    __EXT2directoryIndexCountLimit* countLimit = (__EXT2directoryIndexCountLimit*)entries;
+    Size count = countLimit->count;
+
+    if (count < countLimit->limit) {
+        Index32 insertAt = frame->position + 1;
+        memory_memmove(&entries[insertAt + 1], &entries[insertAt], (count - insertAt) * sizeof(__EXT2directoryIndexEntry));
+        entries[insertAt] = (__EXT2directoryIndexEntry) { .hash = hash, .block = block };
+        ++countLimit->count;
+
+        vNode_rawWriteData(vnode, (Index64)frame->block * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+
+        mm_free(buffer);
+        return;
+    }
+
+    Uint8* sibling = buffer + blockSize;
+    Index32 siblingBlock = INVALID_INDEX32;
+    if (level == 0) {   //Root is full, move its entries to a new index block under it
+        if (path->frameNum > EXT2_DIRECTORY_INDEX_MAX_WRITE_LEVEL) {
+            ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 0);
+        }
+
+        siblingBlock = ext2_vNode_appendBlock(vnode);
+        ERROR_GOTO_IF_ERROR(0);
+
+        __EXT2directoryIndexEntry* siblingEntries = __ext2DirectoryIndex_initNode(sibling, blockSize);
+        __EXT2directoryIndexCountLimit siblingCountLimit = *(__EXT2directoryIndexCountLimit*)siblingEntries;
+        memory_memcpy(siblingEntries, entries, count * sizeof(__EXT2directoryIndexEntry));
+        siblingCountLimit.count = count;
+        *(__EXT2directoryIndexCountLimit*)siblingEntries = siblingCountLimit;
+
+        vNode_rawWriteData(vnode, (Index64)siblingBlock * blockSize, sibling, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+
+        countLimit->count = 1;
+        entries[0].block = siblingBlock;
+        ++((__EXT2directoryIndexRootInfo*)(buffer + __EXT2_DIRECTORY_INDEX_ROOT_INFO_OFFSET))->indirectLevelNum;
+        vNode_rawWriteData(vnode, 0, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+
+        memory_memmove(&path->frames[1], &path->frames[0], path->frameNum * sizeof(EXT2directoryIndexFrame));
+        ++path->frameNum;
+        path->frames[0].position = 0;
+        path->frames[1].block = siblingBlock;
+        path->frames[1].entriesBegin = __EXT2_DIRECTORY_INDEX_NODE_ENTRY_OFFSET;
+
+        mm_free(buffer);
+
+        __ext2DirectoryIndex_insertEntry(vnode, path, 1, hash, block);  //Index block holds more entries than root, never full here
+        return;
+    }
+
+    //Split full index block, upper half goes to a new block added to parent
+    siblingBlock = ext2_vNode_appendBlock(vnode);
+    ERROR_GOTO_IF_ERROR(0);
+
+    Size keptNum = count / 2, movedNum = count - keptNum;
+    Uint32 splitHash = entries[keptNum].hash;
+    __EXT2directoryIndexEntry* siblingEntries = __ext2DirectoryIndex_initNode(sibling, blockSize);
+    __EXT2directoryIndexCountLimit siblingCountLimit = *(__EXT2directoryIndexCountLimit*)siblingEntries;
+    memory_memcpy(siblingEntries, &entries[keptNum], movedNum * sizeof(__EXT2directoryIndexEntry));
+    siblingCountLimit.count = movedNum;
+    *(__EXT2directoryIndexCountLimit*)siblingEntries = siblingCountLimit;
+    countLimit->count = keptNum;
+
+    vNode_rawWriteData(vnode, (Index64)siblingBlock * blockSize, sibling, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    Uint8 frameNumBefore = path->frameNum;
+    __ext2DirectoryIndex_insertEntry(vnode, path, level - 1, splitHash, siblingBlock);  //Block split stays unchanged on failure, sibling is left as an empty entry
+    ERROR_GOTO_IF_ERROR(0);
+    frame = &path->frames[level + (path->frameNum - frameNumBefore)];   //Root may have moved down
+
+    vNode_rawWriteData(vnode, (Index64)frame->block * blockSize, buffer, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (frame->position >= keptNum) {   //Leaf split is under sibling now
+        frame->block = siblingBlock;
+        frame->position -= keptNum;
+        ++(frame - 1)->position;
+    }
+
+    mm_free(buffer);
+
+    __ext2DirectoryIndex_insertEntry(vnode, path, frame - path->frames, hash, block);   //Both halves have room now
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+}
\ No newline at end of file
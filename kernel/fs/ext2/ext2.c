@@ -92,6 +92,39 @@ void ext2fscore_freeInode(EXT2fscore* fscore, Index32 index) {
     ext2blockGroupDescriptor_freeInode(&fscore->blockGroupTables[blockGroupIndex], fscore, inBlockIndex);
 }
 
+void ext2fscore_writeInode(EXT2fscore* fscore, Index32 inodeID, EXT2inode* inode) {
+    EXT2SuperBlock* superBlock = fscore->superBlock;
+    Index32 blockGroupID = ext2SuperBlock_inodeID2BlockGroupIndex(superBlock, inodeID);
+
+    DEBUG_ASSERT_SILENT(blockGroupID < fscore->blockGroupNum);
+
+    EXT2blockGroupDescriptor* desc = &fscore->blockGroupTables[blockGroupID];
+    
+    Index32 inodeIndexInBlockGroup = (inodeID - 1) % superBlock->blockGroupInodeNum;
+    Index32 inodeBlockIndex = desc->inodeTableIndex + (inodeIndexInBlockGroup * sizeof(EXT2inode)) / EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superBlock->blockSizeShift);
+    Index32 inodeBlockOffset = (inodeIndexInBlockGroup * sizeof(EXT2inode)) % EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superBlock->blockSizeShift);
+
+    BlockDevice* blockDevice = fscore->fscore.blockDevice;
+    Size granularity = blockDevice->device.granularity;
+    Size deviceBlockSize = POWER_2(granularity);
+    Index32 inodeDeviceBlockIndex = ext2SuperBlock_blockIndexFS2device(superBlock, granularity, inodeBlockIndex, inodeBlockOffset);
+    Index32 inodeDeviceBlockOffset = ext2SuperBlock_blockOffsetFS2device(superBlock, granularity, inodeBlockIndex, inodeBlockOffset);
+
+    DEBUG_ASSERT_SILENT(inodeDeviceBlockOffset + sizeof(EXT2inode) <= deviceBlockSize);
+
+    Uint8 deviceBlockBuffer[deviceBlockSize];
+    blockDevice_readBlocks(blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
+    ERROR_GOTO_IF_ERROR(0);
+    
+    memory_memcpy(deviceBlockBuffer + inodeDeviceBlockOffset, inode, sizeof(EXT2inode));
+
+    blockDevice_writeBlocks(blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
 void ext2_init() {
     
 }
@@ -287,32 +320,11 @@ static void __ext2_fscore_closeVnode(FScore* fscore, vNode* vnode) {
     EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
     EXT2fscore* ext2fscore = HOST_POINTER(fscore, EXT2fscore, fscore);
 
-    Index32 inodeID = vnode->vnodeID;
-    EXT2SuperBlock* superBlock = ext2fscore->superBlock;
-    Index32 blockGroupID = ext2SuperBlock_inodeID2BlockGroupIndex(superBlock, inodeID);
-
-    DEBUG_ASSERT_SILENT(blockGroupID < ext2fscore->blockGroupNum);
-
-    EXT2blockGroupDescriptor* desc = &ext2fscore->blockGroupTables[blockGroupID];
-    
-    Index32 inodeIndexInBlockGroup = (inodeID - 1) % superBlock->blockGroupInodeNum;
-    Index32 inodeBlockIndex = desc->inodeTableIndex + (inodeIndexInBlockGroup * sizeof(EXT2inode)) / EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superBlock->blockSizeShift);
-    Index32 inodeBlockOffset = (inodeIndexInBlockGroup * sizeof(EXT2inode)) % EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superBlock->blockSizeShift);
-
-    Size granularity = fscore->blockDevice->device.granularity;
-    Size deviceBlockSize = POWER_2(granularity);
-    Index32 inodeDeviceBlockIndex = ext2SuperBlock_blockIndexFS2device(superBlock, granularity, inodeBlockIndex, inodeBlockOffset);
-    Index32 inodeDeviceBlockOffset = ext2SuperBlock_blockOffsetFS2device(superBlock, granularity, inodeBlockIndex, inodeBlockOffset);
-
-    DEBUG_ASSERT_SILENT(inodeDeviceBlockOffset + sizeof(EXT2inode) <= deviceBlockSize);
-
-    Uint8 deviceBlockBuffer[deviceBlockSize];
-    blockDevice_readBlocks(fscore->blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
-    ERROR_GOTO_IF_ERROR(0);
-    
-    memory_memcpy(deviceBlockBuffer + inodeDeviceBlockOffset, &ext2vnode->inode, sizeof(EXT2inode));
+    FSnodeAttribute* attribute = &vnode->fsNode->attribute;   //Inode is written here anyway, so dirty timestamps go with it
+    ext2vnode->inode.lastAccessTime = attribute->lastAccessTime;
+    ext2vnode->inode.modificationTime = attribute->lastModifyTime;
 
-    blockDevice_writeBlocks(fscore->blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
+    ext2fscore_writeInode(ext2fscore, vnode->vnodeID, &ext2vnode->inode);
     ERROR_GOTO_IF_ERROR(0);
 
     mm_free(ext2vnode);
@@ -1,14 +1,17 @@
 #include<fs/ext2/vnode.h>
 
 #include<devices/blockDevice.h>
+#include<fs/ext2/directoryIndex.h>
 #include<fs/ext2/ext2.h>
 #include<fs/ext2/inode.h>
 #include<fs/vnode.h>
+#include<kit/bit.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
 #include<system/pageTable.h>
+#include<algorithms.h>
 #include<error.h>
 
 typedef struct __EXT2vnodeIterateFuncIO __EXT2vnodeIterateFuncIO;
@@ -20,6 +23,8 @@ typedef struct __EXT2vnodeIterateFuncIO {
     void* currentBuffer;
 } __EXT2vnodeIterateFuncIO;
 
+#define __EXT2_VNODE_DIRECTORY_BATCH_SIZE   (4 * PAGE_SIZE) //Directory blocks read at once when iterating
+
 typedef struct __EXT2directoryEntry {
     Index32 inodeID;
     Uint16 recordLength;
@@ -97,6 +102,28 @@ static void __ext2_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode
 
 static void __ext2_vNode_readDirectoryEntries(vNode* vnode);
 
+static void __ext2_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory);
+
+static Index64 __ext2_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);
+
+static void __ext2_vNode_syncAttribute(vNode* vnode);
+
+static void __ext2_vNode_createChildNode(vNode* vnode, __EXT2directoryEntry* entry);
+
+static __EXT2directoryEntry* __ext2_vNode_findEntryInBlock(void* block, Size blockSize, ConstCstring name, Size nameLength, bool isDirectory);
+
+static Index32 __ext2_vNode_findEntry(vNode* vnode, Uint8* buffer, ConstCstring name, Size nameLength, bool isDirectory, __EXT2directoryEntry** entryRet);
+
+static bool __ext2_vNode_insertEntryInBlock(Uint8* block, Size blockSize, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type);
+
+static void __ext2_vNode_deleteEntryInBlock(Uint8* block, __EXT2directoryEntry* entry);
+
+static void __ext2_vNode_insertEntry(vNode* vnode, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type);
+
+static void __ext2_vNode_insertIndexedEntry(vNode* vnode, EXT2directoryIndexPath* path, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type);
+
+static void __ext2_vNode_dropDirectoryIndex(vNode* vnode);
+
 static vNodeOperations _ext2_vNodeOperations = {
     .readData                   = __ext2_vNode_readData,
     .writeData                  = __ext2_vNode_writeData,
@@ -104,7 +131,10 @@ static vNodeOperations _ext2_vNodeOperations = {
     .addDirectoryEntry          = __ext2_vNode_addDirectoryEntry,
     .removeDirectoryEntry       = __ext2_vNode_removeDirectoryEntry,
     .renameDirectoryEntry       = __ext2_vNode_renameDirectoryEntry,
-    .readDirectoryEntries       = __ext2_vNode_readDirectoryEntries
+    .readDirectoryEntries       = __ext2_vNode_readDirectoryEntries,
+    .lookupDirectoryEntry       = __ext2_vNode_lookupDirectoryEntry,
+    .iterateDirectoryEntries    = __ext2_vNode_iterateDirectoryEntries,
+    .syncAttribute              = __ext2_vNode_syncAttribute
 };
 
 vNodeOperations* ext2_vNode_getOperations() {
@@ -255,141 +285,138 @@ static void __ext2_vNode_resize(vNode* vnode, Size newSizeInByte) {
     } else if (newSizeInBlock > oldSizeInBlock) {
         ext2Inode_expandTable(inode, vnode->vnodeID, ext2fscore, oldSizeInBlock, newSizeInBlock);
     }
+    ERROR_GOTO_IF_ERROR(0);
+
     inode->sectorCnt = newSizeInBlock * deviceBlockNum;
-}
+    inode->l32Size = (Uint32)newSizeInByte;
+    if (vnode->fsNode->entry.type != FS_ENTRY_TYPE_DIRECTORY) { //Directory ACL for directories
+        inode->h32Size = (Uint32)(newSizeInByte >> 32);
+    }
 
-static Index64 __ext2_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr) { //TODO: NOT TESTED YET
-    EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
-    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore); 
-    
-    EXT2SuperBlock* superblock = ext2fscore->superBlock;
-    EXT2inode* inode = &ext2vnode->inode;
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(vnode->fsNode);
+    vnode->tokenSpaceSize = newSizeInBlock * blockSize;
+    vnode->fsNode->entry.size = vnode->size = newSizeInByte;
 
-    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
-    Uint8 granularity = ext2fscore->fscore.blockDevice->device.granularity;
-    Size deviceBlockNum = blockSize / POWER_2(granularity);
-    Size blockNum = inode->sectorCnt / deviceBlockNum;
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
 
-    Index32 indexInBuffer = blockSize;
+Index32 ext2_vNode_appendBlock(vNode* vnode) {
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
 
-    Uint8 deviceBlockBuffer[POWER_2(granularity)];
-    FSnodeAttribute fsnodeAttribute;
+    Index32 ret = DIVIDE_ROUND_UP(vnode->size, blockSize);
+    vNode_rawResize(vnode, (Size)(ret + 1) * blockSize);
+    ERROR_GOTO_IF_ERROR(0);
 
-    Size bufferSize = 2 * blockSize;
-    Uint8* buffer = NULL;
-    buffer = mm_allocatePages(DIVIDE_ROUND_UP(bufferSize, PAGE_SIZE));
-    if (buffer == NULL) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
-    }
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return INVALID_INDEX32;
+}
 
-    Size nameLength = cstring_strlen(entry->name);
-    Size requiredSpaceLength = ALIGN_UP(sizeof(__EXT2directoryEntry) + nameLength, 4);
+static Index64 __ext2_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr) { //TODO: NOT TESTED YET
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    EXT2SuperBlock* superblock = ext2fscore->superBlock;
 
     Index32 blockGroupIndex = ext2SuperBlock_inodeID2BlockGroupIndex(superblock, vnode->vnodeID);
     Index32 newInodeID = ext2fscore_allocateInode(ext2fscore, blockGroupIndex, entry->type == FS_ENTRY_TYPE_DIRECTORY);
-    Index32 currentIndex = 0;
-    Index32 lastIndex = 0;
-    __EXT2directoryEntry* lastEntry = NULL;
-    Size lastEntryActualSize = 0;
-    bool found = false;
+    if (newInodeID == INVALID_INDEX32) {
+        ERROR_THROW(ERROR_ID_OUT_OF_MEMORY, 0);
+    }
 
-    for (Index32 i = 0; i < blockNum; ++i) {
-        vNode_rawReadData(vnode, i * blockSize, &buffer[blockSize], blockSize);
-        ERROR_GOTO_IF_ERROR(0);
+    __ext2_vNode_insertEntry(vnode, entry->name, cstring_strlen(entry->name), newInodeID, __ext2_directoryEntry_convertTypeExt2(entry->type));
+    ERROR_GOTO_IF_ERROR(1);
 
-        while (!found) {    //TODO: Not covering the case of first entry deleted
-            __EXT2directoryEntry* currentEntry = (__EXT2directoryEntry*)(buffer + indexInBuffer);
-            
-            if (indexInBuffer + 4 >= bufferSize || indexInBuffer + currentEntry->recordLength > bufferSize) {   //It works for EXT2 directory tail mechanism
-                memory_memcpy(buffer, buffer + blockSize, blockSize);
-                indexInBuffer -= blockSize;
-                break;
-            }   //TODO: Not considering record length is large (Larger then two blocks)
+    return (Index64)newInodeID;
+    ERROR_FINAL_BEGIN(1);
+    ext2fscore_freeInode(ext2fscore, newInodeID);
+    ERROR_FINAL_BEGIN(0);
+    return INVALID_INDEX64;
+}
 
-            Size entryActualSize = ALIGN_UP(sizeof(__EXT2directoryEntry) + currentEntry->nameLength, 4);
-            Size holeSize = currentEntry->recordLength - entryActualSize;
+static void __ext2_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirectory) {  //TODO: NOT TESTED YET
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
 
-            if (holeSize >= requiredSpaceLength) {
-                __EXT2directoryEntry* newEntry = (__EXT2directoryEntry*)((void*)entry + entryActualSize);
+    Uint8* buffer = mm_allocate(blockSize);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
 
-                newEntry->inodeID = newInodeID;
-                newEntry->recordLength = holeSize;
-                newEntry->nameLength = nameLength;
-                newEntry->type = __ext2_directoryEntry_convertTypeExt2(entry->type);
-                memory_memcpy(newEntry->name, entry->name, nameLength);
-                
-                currentEntry->recordLength = entryActualSize;
+    __EXT2directoryEntry* found = NULL;
+    Index32 blockIndex = __ext2_vNode_findEntry(vnode, buffer, name, cstring_strlen(name), isDirectory, &found);
+    ERROR_GOTO_IF_ERROR(0);
 
-                vNode_rawWriteData(vnode, currentIndex, currentEntry, currentEntry->recordLength + requiredSpaceLength);
+    if (blockIndex != INVALID_INDEX32) {
+        __ext2_vNode_deleteEntryInBlock(buffer, found);
+        vNode_rawWriteData(vnode, (Index64)blockIndex * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
+    }
 
-                found = true;
-            }
+    mm_free(buffer);
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+}
 
-            indexInBuffer += currentEntry->recordLength;
-            lastIndex = currentIndex;
-            currentIndex += currentEntry->recordLength;
-            lastEntry = currentEntry;
-            lastEntryActualSize = entryActualSize;
-        }
+static void __ext2_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName) {   //TODO: NOT TESTED YET
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
 
-        if (found) {
-            break;
-        }
+    Uint8* buffer = mm_allocate(blockSize);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
     }
 
-    if (!found) {
-        Size newTailEntriesSize = lastEntryActualSize + requiredSpaceLength;
-        vNode_rawResize(vnode, lastIndex + newTailEntriesSize);
-        DEBUG_ASSERT_SILENT(lastEntry != NULL);
-        void* newTailEntries = mm_allocate(newTailEntriesSize);
-        memory_memcpy(newTailEntries, lastEntry, lastEntryActualSize);
+    __EXT2directoryEntry* found = NULL;
+    Index32 blockIndex = __ext2_vNode_findEntry(vnode, buffer, entry->entry.name, cstring_strlen(entry->entry.name), entry->entry.type == FS_ENTRY_TYPE_DIRECTORY, &found);
+    ERROR_GOTO_IF_ERROR(0);
 
-        __EXT2directoryEntry* lastEntry = (__EXT2directoryEntry*)newTailEntries;
-        __EXT2directoryEntry* newEntry = (__EXT2directoryEntry*)((void*)entry + lastEntryActualSize);
-
-        newEntry->inodeID = newInodeID;
-        newEntry->recordLength = blockSize - ((lastIndex + lastEntryActualSize) % (blockSize + 1));
-        newEntry->nameLength = nameLength;
-        newEntry->type = __ext2_directoryEntry_convertTypeExt2(entry->type);
+    if (blockIndex == INVALID_INDEX32) {
+        mm_free(buffer);
+        return;
+    }
 
-        lastEntry->recordLength = lastEntryActualSize;
+    Index32 inodeID = found->inodeID;
+    Uint8 type = found->type;
 
-        vNode_rawWriteData(vnode, lastIndex, newTailEntries, newTailEntriesSize);
+    __ext2_vNode_insertEntry(moveTo, newName, cstring_strlen(newName), inodeID, type);   //Inserted first, entry is never lost on failure
+    ERROR_GOTO_IF_ERROR(0);
 
-        mm_free(newTailEntries);
+    if (moveTo == vnode) {  //Inserting may change the block, or move entry to another leaf by splitting
+        blockIndex = __ext2_vNode_findEntry(vnode, buffer, entry->entry.name, cstring_strlen(entry->entry.name), entry->entry.type == FS_ENTRY_TYPE_DIRECTORY, &found);
+        ERROR_GOTO_IF_ERROR(0);
+        DEBUG_ASSERT_SILENT(blockIndex != INVALID_INDEX32);
     }
 
-    mm_freePages(buffer);
-    return (Index64)newInodeID;
+    __ext2_vNode_deleteEntryInBlock(buffer, found);
+    vNode_rawWriteData(vnode, (Index64)blockIndex * blockSize, buffer, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
 
+    mm_free(buffer);
+    return;
     ERROR_FINAL_BEGIN(0);
-
     if (buffer != NULL) {
-        mm_freePages(buffer);
+        mm_free(buffer);
     }
 }
 
-static void __ext2_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirectory) {  //TODO: NOT TESTED YET
+static void __ext2_vNode_readDirectoryEntries(vNode* vnode) {
     EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
     EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore); 
     
     EXT2SuperBlock* superblock = ext2fscore->superBlock;
     EXT2inode* inode = &ext2vnode->inode;
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(vnode->fsNode);
 
     Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
     Uint8 granularity = ext2fscore->fscore.blockDevice->device.granularity;
     Size deviceBlockNum = blockSize / POWER_2(granularity);
     Size blockNum = inode->sectorCnt / deviceBlockNum;
 
-    Index32 indexInBuffer = blockSize, lastIndexInBuffer = INVALID_INDEX32;
-    Index32 currentIndex = 0, lastCurrentIndex = INVALID_INDEX32;
-    Size lastEntryActualSize = 0, currentEntryActualSize = 0;
-
-    Uint8 deviceBlockBuffer[POWER_2(granularity)];
-    FSnodeAttribute fsnodeAttribute;
+    Index32 indexInBuffer = blockSize;
 
     Size bufferSize = 2 * blockSize;
     Uint8* buffer = NULL;
@@ -399,45 +426,24 @@ static void __ext2_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, b
         ERROR_GOTO(0);
     }
 
-    bool found = false;
     for (Index32 i = 0; i < blockNum; ++i) {
         vNode_rawReadData(vnode, i * blockSize, &buffer[blockSize], blockSize);
         ERROR_GOTO_IF_ERROR(0);
 
-        while (!found) {    //TODO: Not covering the case of first entry deleted
+        while (true) {
             __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(buffer + indexInBuffer);
             if (indexInBuffer + 4 >= bufferSize || indexInBuffer + entry->recordLength > bufferSize) {  //It works for EXT2 directory tail mechanism
                 memory_memcpy(buffer, buffer + blockSize, blockSize);
-                lastIndexInBuffer -= blockSize;
                 indexInBuffer -= blockSize;
                 break;
             }   //TODO: Not considering record length is large
 
-            lastEntryActualSize = currentEntryActualSize;
-            currentEntryActualSize = ALIGN_UP(sizeof(__EXT2directoryEntry) + entry->nameLength, 4);
-
-            if (cstring_strncmp(entry->name, name, entry->nameLength) == 0 && isDirectory == (entry->type == __EXT2_DIRECTORY_ENTRY_DIRECTORY)) {
-                entry->inodeID = 0;
-                if (lastIndexInBuffer == INVALID_INDEX32) {
-                    vNode_rawWriteData(vnode, 0, entry, currentEntryActualSize);
-                } else {
-                    DEBUG_ASSERT_SILENT(0 <= lastIndexInBuffer && lastIndexInBuffer < bufferSize);
-                    __EXT2directoryEntry* lastEntry = (__EXT2directoryEntry*)(buffer + lastIndexInBuffer);
-                    lastEntry->recordLength += entry->recordLength;
-                    vNode_rawWriteData(vnode, lastCurrentIndex, entry, currentIndex - lastCurrentIndex + sizeof(__EXT2directoryEntry));
-                }
-                found = true;
-                break;
+            if (entry->inodeID != 0) {  //Deleted entries and index nodes of hashed directory have no inode
+                __ext2_vNode_createChildNode(vnode, entry);
+                ERROR_GOTO_IF_ERROR(0);
             }
 
-            lastIndexInBuffer = indexInBuffer;
             indexInBuffer += entry->recordLength;
-            lastCurrentIndex = currentIndex;
-            currentIndex += entry->recordLength;
-        }
-
-        if (found) {
-            break;
         }
     }
 
@@ -451,258 +457,450 @@ static void __ext2_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, b
     }
 }
 
-static void __ext2_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName) {   //TODO: NOT TESTED YET
+static void __ext2_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory) {
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
+
+    Uint8* buffer = mm_allocate(blockSize);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    __EXT2directoryEntry* found = NULL;
+    __ext2_vNode_findEntry(vnode, buffer, name, nameLength, isDirectory, &found);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (found == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+
+    __ext2_vNode_createChildNode(vnode, found);
+    ERROR_GOTO_IF_ERROR(0);
+
+    mm_free(buffer);
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+}
+
+static Index64 __ext2_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) { //Cookie is offset of entry in directory
     EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
-    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore); 
-    
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+
     EXT2SuperBlock* superblock = ext2fscore->superBlock;
     EXT2inode* inode = &ext2vnode->inode;
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(vnode->fsNode);
 
     Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
-    Uint8 granularity = ext2fscore->fscore.blockDevice->device.granularity;
-    Size deviceBlockNum = blockSize / POWER_2(granularity);
-    Size blockNum = inode->sectorCnt / deviceBlockNum;
-
-    Index32 indexInBuffer = blockSize, lastIndexInBuffer = INVALID_INDEX32;
-    Index32 currentIndex = 0, lastCurrentIndex = INVALID_INDEX32;
-    Size lastEntryActualSize = 0, currentEntryActualSize = 0;
-
-    Uint8 deviceBlockBuffer[POWER_2(granularity)];
-    FSnodeAttribute fsnodeAttribute;
+    Size deviceBlockNum = blockSize / POWER_2(ext2fscore->fscore.blockDevice->device.granularity);
+    Size directorySize = inode->sectorCnt / deviceBlockNum * blockSize;
 
-    Size bufferSize = 2 * blockSize;
-    Uint8* buffer = NULL;
-    void* movedEntry = NULL;
-    buffer = mm_allocatePages(DIVIDE_ROUND_UP(bufferSize, PAGE_SIZE));
+    Size batchSize = ALIGN_UP(algorithms_umax64(__EXT2_VNODE_DIRECTORY_BATCH_SIZE, blockSize), blockSize);
+    Uint8* buffer = mm_allocatePages(DIVIDE_ROUND_UP(batchSize, PAGE_SIZE));
     if (buffer == NULL) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
     }
 
-    Size nameLength = cstring_strlen(newName);
-    Size requiredSpaceLength = ALIGN_UP(sizeof(__EXT2directoryEntry) + nameLength, 4);
-    movedEntry = mm_allocate(requiredSpaceLength);
-    memory_memcpy(((__EXT2directoryEntry*)movedEntry)->name, newName, nameLength);
-
-    bool found = false;
-    for (Index32 i = 0; i < blockNum; ++i) {
-        vNode_rawReadData(vnode, i * blockSize, &buffer[blockSize], blockSize);
+    Index64 ret = cookie;
+    bool stopped = false;
+    for (Index64 batchBegin = ALIGN_DOWN(cookie, blockSize); !stopped && batchBegin < directorySize; batchBegin += batchSize) {
+        Size batchN = algorithms_umin64(batchSize, directorySize - batchBegin);
+        vNode_rawReadData(vnode, batchBegin, buffer, batchN);  //Whole blocks in one read, entries never cross blocks
         ERROR_GOTO_IF_ERROR(0);
 
-        while (!found) {    //TODO: Not covering the case of first entry deleted
-            __EXT2directoryEntry* currentEntry = (__EXT2directoryEntry*)(buffer + indexInBuffer);
-            if (indexInBuffer + 4 >= bufferSize || indexInBuffer + currentEntry->recordLength > bufferSize) {  //It works for EXT2 directory tail mechanism
-                memory_memcpy(buffer, buffer + blockSize, blockSize);
-                lastIndexInBuffer -= blockSize;
-                indexInBuffer -= blockSize;
-                break;
-            }   //TODO: Not considering record length is large
-
-            lastEntryActualSize = currentEntryActualSize;
-            currentEntryActualSize = ALIGN_UP(sizeof(__EXT2directoryEntry) + currentEntry->nameLength, 4);
-
-            if (cstring_strncmp(currentEntry->name, entry->entry.name, currentEntry->nameLength) == 0 && entry->entry.type == __ext2_directoryEntry_convertTypeFS(currentEntry->type)) {
-                memory_memcpy(movedEntry, currentEntry, sizeof(__EXT2directoryEntry));
-                currentEntry->inodeID = 0;
-                if (lastIndexInBuffer == INVALID_INDEX32) {
-                    vNode_rawWriteData(vnode, 0, entry, currentEntryActualSize);
-                } else {
-                    DEBUG_ASSERT_SILENT(0 <= lastIndexInBuffer && lastIndexInBuffer < bufferSize);
-                    __EXT2directoryEntry* lastEntry = (__EXT2directoryEntry*)(buffer + lastIndexInBuffer);
-                    lastEntry->recordLength += currentEntry->recordLength;
-                    vNode_rawWriteData(vnode, lastCurrentIndex, entry, currentIndex - lastCurrentIndex + sizeof(__EXT2directoryEntry));
-                }
-                found = true;
-                break;
+        for (Index32 offset = 0; offset + sizeof(__EXT2directoryEntry) <= batchN;) {
+            __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(buffer + offset);
+            Size blockRemaining = blockSize - offset % blockSize;
+            if (entry->recordLength < sizeof(__EXT2directoryEntry) || entry->recordLength > blockRemaining) {   //Broken block, skip the rest of it
+                offset += blockRemaining;
+                continue;
             }
 
-            lastIndexInBuffer = indexInBuffer;
-            indexInBuffer += currentEntry->recordLength;
-            lastCurrentIndex = currentIndex;
-            currentIndex += currentEntry->recordLength;
-        }
+            Index64 entryBegin = batchBegin + offset, entryEnd = entryBegin + entry->recordLength;
+            offset += entry->recordLength;
+            if (entryBegin < cookie) {
+                continue;
+            }
 
-        if (found) {
-            break;
+            if (entry->inodeID != 0 && !func(arg, entry->name, entry->nameLength, __ext2_directoryEntry_convertTypeFS(entry->type), entry->inodeID, entryEnd)) {
+                stopped = true;
+                break;
+            }
+            ret = entryEnd;
         }
     }
 
-    if (!found) {
+    mm_freePages(buffer);
+
+    return stopped ? ret : algorithms_umax64(cookie, directorySize);
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
         mm_freePages(buffer);
-        mm_free(movedEntry);
-        return;
     }
+    return INVALID_INDEX64;
+}
 
-    indexInBuffer = blockSize, lastIndexInBuffer = INVALID_INDEX32;
-    currentIndex = 0, lastCurrentIndex = INVALID_INDEX32;
-    lastEntryActualSize = 0, currentEntryActualSize = 0;
+static void __ext2_vNode_syncAttribute(vNode* vnode) {
+    EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
 
-    __EXT2directoryEntry* lastEntry = NULL;
-    found = false;
+    FSnodeAttribute* attribute = &vnode->fsNode->attribute;
+    ext2vnode->inode.lastAccessTime = attribute->lastAccessTime;
+    ext2vnode->inode.modificationTime = attribute->lastModifyTime;
 
-    for (Index32 i = 0; i < blockNum; ++i) {
-        vNode_rawReadData(vnode, i * blockSize, &buffer[blockSize], blockSize);
-        ERROR_GOTO_IF_ERROR(0);
+    ext2fscore_writeInode(ext2fscore, vnode->vnodeID, &ext2vnode->inode);
+}
 
-        while (!found) {    //TODO: Not covering the case of first entry deleted
-            __EXT2directoryEntry* currentEntry = (__EXT2directoryEntry*)(buffer + indexInBuffer);
-            
-            if (indexInBuffer + 4 >= bufferSize || indexInBuffer + currentEntry->recordLength > bufferSize) {   //It works for EXT2 directory tail mechanism
-                memory_memcpy(buffer, buffer + blockSize, blockSize);
-                indexInBuffer -= blockSize;
-                break;
-            }   //TODO: Not considering record length is large (Larger then two blocks)
+static void __ext2_vNode_createChildNode(vNode* vnode, __EXT2directoryEntry* entry) {
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    EXT2SuperBlock* superblock = ext2fscore->superBlock;
+    Uint8 granularity = ext2fscore->fscore.blockDevice->device.granularity;
 
-            Size entryActualSize = ALIGN_UP(sizeof(__EXT2directoryEntry) + currentEntry->nameLength, 4);
-            Size holeSize = currentEntry->recordLength - entryActualSize;
+    Uint8 deviceBlockBuffer[POWER_2(granularity)];
+    FSnodeAttribute fsnodeAttribute;
 
-            if (holeSize >= requiredSpaceLength) {
-                __EXT2directoryEntry* newEntry = (__EXT2directoryEntry*)((void*)entry + entryActualSize);
-                memory_memcpy(newEntry, movedEntry, requiredSpaceLength);
-                newEntry->recordLength = holeSize;
-                
-                currentEntry->recordLength = entryActualSize;
+    fsEntryType type = __ext2_directoryEntry_convertTypeFS(entry->type);
+    DEBUG_ASSERT_SILENT(type != FS_ENTRY_TYPE_DUMMY);
 
-                vNode_rawWriteData(vnode, currentIndex, currentEntry, currentEntry->recordLength + requiredSpaceLength);
+    Index32 blockGroupID = ext2SuperBlock_inodeID2BlockGroupIndex(superblock, entry->inodeID);
+    DEBUG_ASSERT_SILENT(blockGroupID < ext2fscore->blockGroupNum);
+    EXT2blockGroupDescriptor* desc = &ext2fscore->blockGroupTables[blockGroupID];
 
-                found = true;
-            }
+    Index32 inodeIndexInBlockGroup = (entry->inodeID - 1) % superblock->blockGroupInodeNum;
+    Index32 inodeBlockIndex = desc->inodeTableIndex + (inodeIndexInBlockGroup * superblock->iNodeSizeInByte) / EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
+    Index32 inodeBlockOffset = (inodeIndexInBlockGroup * superblock->iNodeSizeInByte) % EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
 
-            indexInBuffer += currentEntry->recordLength;
-            lastCurrentIndex = currentIndex;
-            currentIndex += currentEntry->recordLength;
-            lastEntry = currentEntry;
-            lastEntryActualSize = entryActualSize;
-        }
+    Index32 inodeDeviceBlockIndex = ext2SuperBlock_blockIndexFS2device(superblock, granularity, inodeBlockIndex, inodeBlockOffset);
+    Index32 inodeDeviceBlockOffset = ext2SuperBlock_blockOffsetFS2device(superblock, granularity, inodeBlockIndex, inodeBlockOffset);
+
+    blockDevice_readBlocks(ext2fscore->fscore.blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
+    ERROR_GOTO_IF_ERROR(0);
+
+    EXT2inode* inode = (EXT2inode*)(deviceBlockBuffer + inodeDeviceBlockOffset);
+
+    Size size = 0;
+    if (type == FS_ENTRY_TYPE_FILE) {
+        size = ((Size)inode->h32Size << 32) | inode->l32Size;
+    }
 
-        if (found) {
+    fsnodeAttribute.createTime = inode->createTime;
+    fsnodeAttribute.lastAccessTime = inode->lastAccessTime;
+    fsnodeAttribute.lastModifyTime = inode->modificationTime;
+
+    DirectoryEntry newDirEntry = (DirectoryEntry) {
+        .name = entry->name,
+        .type = type,
+        .mode = 0,
+        .vnodeID = entry->inodeID,
+        .size = size,
+        .pointsTo = entry->inodeID
+    };
+
+    fsnode_create(&newDirEntry, entry->nameLength, &fsnodeAttribute, vnode->fsNode);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static __EXT2directoryEntry* __ext2_vNode_findEntryInBlock(void* block, Size blockSize, ConstCstring name, Size nameLength, bool isDirectory) {
+    for (Index32 offset = 0; offset + sizeof(__EXT2directoryEntry) <= blockSize;) { //Entries never cross blocks
+        __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(block + offset);
+        if (entry->recordLength < sizeof(__EXT2directoryEntry) || offset + entry->recordLength > blockSize) {
             break;
         }
+
+        if (entry->inodeID != 0 && entry->nameLength == nameLength && isDirectory == (entry->type == __EXT2_DIRECTORY_ENTRY_DIRECTORY) && memory_memcmp(entry->name, name, nameLength) == 0) {
+            return entry;
+        }
+
+        offset += entry->recordLength;
     }
 
-    if (!found) {
-        Size newTailEntriesSize = lastEntryActualSize + requiredSpaceLength;
-        vNode_rawResize(vnode, lastCurrentIndex + newTailEntriesSize);
-        DEBUG_ASSERT_SILENT(lastEntry != NULL);
-        void* newTailEntries = mm_allocate(newTailEntriesSize);
-        memory_memcpy(newTailEntries, lastEntry, lastEntryActualSize);
+    return NULL;
+}
 
-        __EXT2directoryEntry* lastEntry = (__EXT2directoryEntry*)newTailEntries;
-        __EXT2directoryEntry* newEntry = (__EXT2directoryEntry*)((void*)entry + lastEntryActualSize);
+static Index32 __ext2_vNode_findEntry(vNode* vnode, Uint8* buffer, ConstCstring name, Size nameLength, bool isDirectory, __EXT2directoryEntry** entryRet) {
+    EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
+    Size blockNum = vnode->size / blockSize;
+
+    *entryRet = NULL;
+    if (ext2DirectoryIndex_isIndexed(ext2fscore, &ext2vnode->inode)) {
+        EXT2directoryIndexPath path;
+        Index32 leaf = ext2DirectoryIndex_findLeaf(vnode, name, nameLength, &path);
+        ERROR_GOTO_IF_ERROR(0);
 
-        memory_memcpy(newEntry, movedEntry, requiredSpaceLength);
-        newEntry->recordLength = blockSize - ((lastCurrentIndex + lastEntryActualSize) % (blockSize + 1));
+        if (leaf != INVALID_INDEX32) {  //Otherwise index is not usable, scan all blocks
+            while (leaf != INVALID_INDEX32) {   //Name may be in following leaves when its hash collides across them
+                vNode_rawReadData(vnode, (Index64)leaf * blockSize, buffer, blockSize);
+                ERROR_GOTO_IF_ERROR(0);
 
-        lastEntry->recordLength = lastEntryActualSize;
+                if ((*entryRet = __ext2_vNode_findEntryInBlock(buffer, blockSize, name, nameLength, isDirectory)) != NULL) {
+                    return leaf;
+                }
 
-        vNode_rawWriteData(vnode, lastCurrentIndex, newTailEntries, newTailEntriesSize);
+                leaf = ext2DirectoryIndex_nextLeaf(vnode, &path);
+                ERROR_GOTO_IF_ERROR(0);
+            }
+
+            return INVALID_INDEX32;
+        }
     }
 
-    mm_free(movedEntry);
-    mm_freePages(buffer);
-    return;
+    for (Index32 i = 0; i < blockNum; ++i) {
+        vNode_rawReadData(vnode, (Index64)i * blockSize, buffer, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
 
+        if ((*entryRet = __ext2_vNode_findEntryInBlock(buffer, blockSize, name, nameLength, isDirectory)) != NULL) {
+            return i;
+        }
+    }
+
+    return INVALID_INDEX32;
     ERROR_FINAL_BEGIN(0);
+    return INVALID_INDEX32;
+}
+
+static bool __ext2_vNode_insertEntryInBlock(Uint8* block, Size blockSize, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type) {
+    Size requiredSize = ALIGN_UP(sizeof(__EXT2directoryEntry) + nameLength, 4);
+    for (Index32 offset = 0; offset + sizeof(__EXT2directoryEntry) <= blockSize;) {
+        __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(block + offset);
+        if (entry->recordLength < sizeof(__EXT2directoryEntry) || offset + entry->recordLength > blockSize) {
+            break;
+        }
+
+        Size usedSize = entry->inodeID == 0 ? 0 : ALIGN_UP(sizeof(__EXT2directoryEntry) + entry->nameLength, 4);   //Deleted entry is reused as a whole
+        if (entry->recordLength - usedSize >= requiredSize) {
+            __EXT2directoryEntry* newEntry = (__EXT2directoryEntry*)(block + offset + usedSize);
+            newEntry->recordLength = entry->recordLength - usedSize;
+            if (usedSize != 0) {
+                entry->recordLength = usedSize;
+            }
 
-    if (movedEntry != NULL) {
-        mm_free(movedEntry);
+            newEntry->inodeID = inodeID;
+            newEntry->nameLength = nameLength;
+            newEntry->type = type;
+            memory_memcpy(newEntry->name, name, nameLength);
+
+            return true;
+        }
+
+        offset += entry->recordLength;
     }
 
-    if (buffer != NULL) {
-        mm_freePages(buffer);
+    return false;
+}
+
+static void __ext2_vNode_deleteEntryInBlock(Uint8* block, __EXT2directoryEntry* entry) {
+    if ((Uint8*)entry == block) {   //No entry before to take its space
+        entry->inodeID = 0;
+        return;
     }
+
+    __EXT2directoryEntry* previous = (__EXT2directoryEntry*)block;
+    while ((Uint8*)previous + previous->recordLength != (Uint8*)entry) {
+        previous = (__EXT2directoryEntry*)((Uint8*)previous + previous->recordLength);
+    }
+    previous->recordLength += entry->recordLength;
 }
 
-static void __ext2_vNode_readDirectoryEntries(vNode* vnode) {
+static void __ext2_vNode_insertEntry(vNode* vnode, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type) {
     EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
-    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore); 
-    
-    EXT2SuperBlock* superblock = ext2fscore->superBlock;
-    EXT2inode* inode = &ext2vnode->inode;
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(vnode->fsNode);
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
+    Size blockNum = vnode->size / blockSize;
 
-    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
-    Uint8 granularity = ext2fscore->fscore.blockDevice->device.granularity;
-    Size deviceBlockNum = blockSize / POWER_2(granularity);
-    Size blockNum = inode->sectorCnt / deviceBlockNum;
+    Uint8* buffer = NULL;
+    if (ext2DirectoryIndex_isIndexed(ext2fscore, &ext2vnode->inode)) {
+        EXT2directoryIndexPath path;
+        Index32 leaf = ext2DirectoryIndex_findLeaf(vnode, name, nameLength, &path);
+        ERROR_GOTO_IF_ERROR(0);
 
-    Index32 indexInBuffer = blockSize;
+        if (leaf != INVALID_INDEX32) {
+            __ext2_vNode_insertIndexedEntry(vnode, &path, name, nameLength, inodeID, type);
+            ERROR_GOTO_IF_ERROR(0);
+            return;
+        }
 
-    Uint8 deviceBlockBuffer[POWER_2(granularity)];
-    FSnodeAttribute fsnodeAttribute;
+        __ext2_vNode_dropDirectoryIndex(vnode); //Index not usable (e.g. unknown hash), go on as ext2 without dir_index does, fsck rebuilds it
+        ERROR_GOTO_IF_ERROR(0);
+    }
 
-    Size bufferSize = 2 * blockSize;
-    Uint8* buffer = NULL;
-    buffer = mm_allocatePages(DIVIDE_ROUND_UP(bufferSize, PAGE_SIZE));
+    buffer = mm_allocate(blockSize);
     if (buffer == NULL) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
     }
 
-    DEBUG_ASSERT_SILENT(dirNode->dirPart.childrenNum == FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM);
-    dirNode->dirPart.childrenNum = 0;
     for (Index32 i = 0; i < blockNum; ++i) {
-        vNode_rawReadData(vnode, i * blockSize, &buffer[blockSize], blockSize);
+        vNode_rawReadData(vnode, (Index64)i * blockSize, buffer, blockSize);
         ERROR_GOTO_IF_ERROR(0);
 
-        while (true) {  //TODO: Not covering the case of first entry deleted
-            __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(buffer + indexInBuffer);
-            if (indexInBuffer + 4 >= bufferSize || indexInBuffer + entry->recordLength > bufferSize) {  //It works for EXT2 directory tail mechanism
-                memory_memcpy(buffer, buffer + blockSize, blockSize);
-                indexInBuffer -= blockSize;
-                break;
-            }   //TODO: Not considering record length is large
+        if (__ext2_vNode_insertEntryInBlock(buffer, blockSize, name, nameLength, inodeID, type)) {
+            vNode_rawWriteData(vnode, (Index64)i * blockSize, buffer, blockSize);
+            ERROR_GOTO_IF_ERROR(0);
+
+            mm_free(buffer);
+            return;
+        }
+    }
 
-            fsEntryType type = __ext2_directoryEntry_convertTypeFS(entry->type);
-            DEBUG_ASSERT_SILENT(type != FS_ENTRY_TYPE_DUMMY);
+    Index32 newBlock = ext2_vNode_appendBlock(vnode);   //No room in any block
+    ERROR_GOTO_IF_ERROR(0);
 
-            Index32 blockGroupID = ext2SuperBlock_inodeID2BlockGroupIndex(superblock, entry->inodeID);
-            DEBUG_ASSERT_SILENT(blockGroupID < ext2fscore->blockGroupNum);
-            EXT2blockGroupDescriptor* desc = &ext2fscore->blockGroupTables[blockGroupID];
+    memory_memset(buffer, 0, blockSize);
+    ((__EXT2directoryEntry*)buffer)->recordLength = blockSize;
+    __ext2_vNode_insertEntryInBlock(buffer, blockSize, name, nameLength, inodeID, type);
+    vNode_rawWriteData(vnode, (Index64)newBlock * blockSize, buffer, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
 
-            Index32 inodeIndexInBlockGroup = (entry->inodeID - 1) % superblock->blockGroupInodeNum;
-            Index32 inodeBlockIndex = desc->inodeTableIndex + (inodeIndexInBlockGroup * superblock->iNodeSizeInByte) / EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
-            Index32 inodeBlockOffset = (inodeIndexInBlockGroup * superblock->iNodeSizeInByte) % EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(superblock->blockSizeShift);
+    mm_free(buffer);
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (buffer != NULL) {
+        mm_free(buffer);
+    }
+}
 
-            Index32 inodeDeviceBlockIndex = ext2SuperBlock_blockIndexFS2device(superblock, granularity, inodeBlockIndex, inodeBlockOffset);
-            Index32 inodeDeviceBlockOffset = ext2SuperBlock_blockOffsetFS2device(superblock, granularity, inodeBlockIndex, inodeBlockOffset);
+typedef struct __EXT2directoryEntryHash {
+    Uint32  hash;
+    Uint16  offset;
+    Uint16  size;
+} __EXT2directoryEntryHash;
 
-            blockDevice_readBlocks(ext2fscore->fscore.blockDevice, inodeDeviceBlockIndex, deviceBlockBuffer, 1);
-            ERROR_GOTO_IF_ERROR(0);
+static void __ext2_vNode_insertIndexedEntry(vNode* vnode, EXT2directoryIndexPath* path, ConstCstring name, Size nameLength, Index32 inodeID, Uint8 type) {   //As do_split in Linux when leaf is full
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    Size blockSize = EXT2_SUPERBLOCK_IN_STORAGE_GET_BLOCK_SIZE(ext2fscore->superBlock->blockSizeShift);
+
+    __EXT2directoryEntryHash* map = NULL;
+    Uint8* buffer = mm_allocate(3 * blockSize); //Leaf, its lower half and its upper half
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
 
-            EXT2inode* inode = (EXT2inode*)(deviceBlockBuffer + inodeDeviceBlockOffset);
+    Uint8* leaf = buffer, * lower = buffer + blockSize, * upper = buffer + 2 * blockSize;
+    vNode_rawReadData(vnode, (Index64)path->leaf * blockSize, leaf, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
 
-            Size size = 0;
-            if (type == FS_ENTRY_TYPE_FILE) {
-                size = ((Size)inode->h32Size << 32) | inode->l32Size;
-            }
+    if (__ext2_vNode_insertEntryInBlock(leaf, blockSize, name, nameLength, inodeID, type)) {
+        vNode_rawWriteData(vnode, (Index64)path->leaf * blockSize, leaf, blockSize);
+        ERROR_GOTO_IF_ERROR(0);
 
-            fsnodeAttribute.createTime = inode->createTime;
-            fsnodeAttribute.lastAccessTime = inode->lastAccessTime;
-            fsnodeAttribute.lastModifyTime = inode->modificationTime;
-
-            DirectoryEntry newDirEntry = (DirectoryEntry) {
-                .name = entry->name,
-                .type = type,
-                .mode = 0,
-                .vnodeID = entry->inodeID,
-                .size = size,
-                .pointsTo = entry->inodeID
+        mm_free(buffer);
+        return;
+    }
+
+    //Leaf is full, move entries with higher hashes to a new leaf
+    map = mm_allocate(blockSize / ALIGN_UP(sizeof(__EXT2directoryEntry) + 1, 4) * sizeof(__EXT2directoryEntryHash));
+    if (map == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Size entryNum = 0;
+    for (Index32 offset = 0; offset + sizeof(__EXT2directoryEntry) <= blockSize;) {
+        __EXT2directoryEntry* entry = (__EXT2directoryEntry*)(leaf + offset);
+        if (entry->recordLength < sizeof(__EXT2directoryEntry) || offset + entry->recordLength > blockSize) {
+            break;
+        }
+
+        if (entry->inodeID != 0) {
+            __EXT2directoryEntryHash current = {
+                .hash   = ext2DirectoryIndex_hash(entry->name, entry->nameLength, path->hashVersion, path->seed),
+                .offset = offset,
+                .size   = ALIGN_UP(sizeof(__EXT2directoryEntry) + entry->nameLength, 4)
             };
 
-            fsnode_create(&newDirEntry, entry->nameLength, &fsnodeAttribute, &dirNode->node);
+            Index32 i = entryNum++;
+            for (; i > 0 && map[i - 1].hash > current.hash; --i) {  //Insertion sort by hash, stable for equal hashes
+                map[i] = map[i - 1];
+            }
+            map[i] = current;
+        }
 
-            indexInBuffer += entry->recordLength;
+        offset += entry->recordLength;
+    }
+
+    if (entryNum < 2) {
+        ERROR_THROW(ERROR_ID_DATA_ERROR, 0);
+    }
+
+    Index32 split = entryNum;
+    for (Size movedSize = 0; split > 1 && movedSize + map[split - 1].size / 2 <= blockSize / 2; --split) {  //Move about half of the bytes
+        movedSize += map[split - 1].size;
+    }
+    split = algorithms_umin32(split, entryNum - 1);
+
+    Uint32 splitHash = map[split].hash;
+    if (map[split - 1].hash == splitHash) { //Hash continues in new leaf
+        splitHash |= 1;
+    }
+
+    for (int i = 0; i < 2; ++i) {   //Compact both halves
+        Uint8* half = i == 0 ? lower : upper;
+        Index32 begin = i == 0 ? 0 : split, end = i == 0 ? split : entryNum;
+
+        Size offset = 0;
+        __EXT2directoryEntry* last = NULL;
+        for (Index32 j = begin; j < end; ++j) {
+            last = (__EXT2directoryEntry*)(half + offset);
+            memory_memcpy(last, leaf + map[j].offset, map[j].size);
+            last->recordLength = map[j].size;
+            offset += map[j].size;
         }
+        last->recordLength += blockSize - offset;
     }
 
-    mm_freePages(buffer);
-    return;
+    bool toUpper = path->hash >= (splitHash & ~1);
+    if (!__ext2_vNode_insertEntryInBlock(toUpper ? upper : lower, blockSize, name, nameLength, inodeID, type)) {
+        ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 0);
+    }
+
+    Index32 newLeaf = ext2_vNode_appendBlock(vnode);
+    ERROR_GOTO_IF_ERROR(0);
+
+    memory_memset(leaf, 0, blockSize);  //Empty until added to index, so a failed split leaves no entry twice for linear readers
+    ((__EXT2directoryEntry*)leaf)->recordLength = blockSize;
+    vNode_rawWriteData(vnode, (Index64)newLeaf * blockSize, leaf, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    ext2DirectoryIndex_addLeaf(vnode, path, splitHash, newLeaf);
+    ERROR_GOTO_IF_ERROR(0);
+
+    vNode_rawWriteData(vnode, (Index64)newLeaf * blockSize, upper, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
 
+    vNode_rawWriteData(vnode, (Index64)path->leaf * blockSize, lower, blockSize);
+    ERROR_GOTO_IF_ERROR(0);
+
+    mm_free(map);
+    mm_free(buffer);
+    return;
     ERROR_FINAL_BEGIN(0);
+    if (map != NULL) {
+        mm_free(map);
+    }
 
     if (buffer != NULL) {
-        mm_freePages(buffer);
+        mm_free(buffer);
     }
+}
+
+static void __ext2_vNode_dropDirectoryIndex(vNode* vnode) {    //Index blocks become empty entries to linear readers
+    EXT2vnode* ext2vnode = HOST_POINTER(vnode, EXT2vnode, vnode);
+    EXT2fscore* ext2fscore = HOST_POINTER(vnode->fscore, EXT2fscore, fscore);
+    EXT2inode* inode = &ext2vnode->inode;
+
+    if (TEST_FLAGS_NONE(inode->flags, EXT2_INODE_FALGS_HASH_INDEX_DIRECTORY)) {
+        return;
+    }
+
+    CLEAR_FLAG_BACK(inode->flags, EXT2_INODE_FALGS_HASH_INDEX_DIRECTORY);
+    ext2fscore_writeInode(ext2fscore, vnode->vnodeID, inode);
 }
\ No newline at end of file
@@ -3,9 +3,78 @@
 #include<fs/fat32/fat32.h>
 #include<kit/types.h>
 #include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<structs/bitmap.h>
+#include<structs/RBtree.h>
+#include<algorithms.h>
 #include<debug.h>
 #include<error.h>
 
+#define __FAT32_CLUSTER_MAP_INITIAL_CAPACITY   4
+
+//Run of free clusters, runs in index never touch each other
+typedef struct __FAT32freeExtent {
+    RBtreeNode  treeNode;
+    Index32     begin;
+    Size        length;
+} __FAT32freeExtent;
+
+static inline void __fat32_markFATdirty(FAT32fscore* fscore, Index32 cluster) {
+    bitmap_setBit(&fscore->dirtyFATsectors, cluster * sizeof(Index32) / fscore->BPB->bytePerSector);
+}
+
+static int __fat32_freeExtentCmpFunc(RBtreeNode* node1, RBtreeNode* node2);
+
+static int __fat32_freeExtentSearchFunc(RBtreeNode* node, Object key);
+
+static __FAT32freeExtent* __fat32_findFreeExtentFloor(FAT32fscore* fscore, Index32 cluster);
+
+static __FAT32freeExtent* __fat32_getNextFreeExtent(FAT32fscore* fscore, __FAT32freeExtent* extent);
+
+static void __fat32_addFreeRun(FAT32fscore* fscore, Index32 begin, Size length);
+
+static Index32 __fat32_takeFreeRun(FAT32fscore* fscore, __FAT32freeExtent* extent, Index32 begin, Size length, Index32 lastCluster);
+
+static void __fat32_clusterMap_append(FAT32clusterMap* map, Index32 physicalBegin, Size length);
+
+void fat32_buildFreeClusterIndex(FAT32fscore* fscore) {
+    RBtree_initStruct(&fscore->freeExtents, __fat32_freeExtentCmpFunc, __fat32_freeExtentSearchFunc);
+
+    Index32* FAT = fscore->FAT;
+    Index32 runBegin = INVALID_INDEX32;
+    for (Index32 i = 2; i <= fscore->clusterNum; ++i) {
+        bool isFree = i < fscore->clusterNum && fat32_getClusterType(fscore, PTR_TO_VALUE(32, FAT + i)) == FAT32_CLUSTER_TYPE_FREE;
+        if (isFree) {
+            bitmap_setBit(&fscore->freeClusters, i);
+            if (runBegin == INVALID_INDEX32) {
+                runBegin = i;
+            }
+            continue;
+        }
+
+        if (runBegin != INVALID_INDEX32) {
+            __fat32_addFreeRun(fscore, runBegin, i - runBegin);
+            ERROR_GOTO_IF_ERROR(0);
+            runBegin = INVALID_INDEX32;
+        }
+    }
+    fscore->nextFreeHint = 2;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    fat32_clearFreeClusterIndex(fscore);
+}
+
+void fat32_clearFreeClusterIndex(FAT32fscore* fscore) {
+    RBtree* tree = &fscore->freeExtents;
+    RBtreeNode* node;
+    while ((node = RBtree_getFirst(tree)) != NULL) {
+        RBtree_directDelete(tree, node);
+        mm_free(HOST_POINTER(node, __FAT32freeExtent, treeNode));
+    }
+}
+
 //TODO: These codes seems wrong
 FAT32ClusterType fat32_getClusterType(FAT32fscore* fscore, Index32 physicalClusterIndex) {
     if (physicalClusterIndex == 0x00000000) {
@@ -84,24 +153,58 @@ Size fat32_getClusterChainLength(FAT32fscore* fscore, Index32 firstCluster) {
     return ret;
 }
 
-Index32 fat32_allocateClusterChain(FAT32fscore* fscore, Size length) {
-    Index32* FAT = fscore->FAT;
-    Index32 currentCluster = fscore->firstFreeCluster, last = INVALID_INDEX32;
-    for (int i = 0; i < length; ++i) {
-        if (currentCluster == FAT32_CLSUTER_END_OF_CHAIN) {
+Index32 fat32_allocateClusterChain(FAT32fscore* fscore, Size length, Index32 nearCluster) {
+    Index32 ret = INVALID_INDEX32, last = INVALID_INDEX32;
+    if (length > fscore->freeClusters.bitSetNum) {
+        ERROR_THROW(ERROR_ID_OUT_OF_MEMORY, 0);
+    }
+
+    Index32 goal = nearCluster == INVALID_INDEX32 ? fscore->nextFreeHint : nearCluster + 1;
+    Size remaining = length;
+
+    __FAT32freeExtent* extent = __fat32_findFreeExtentFloor(fscore, goal);
+    if (extent != NULL && goal < extent->begin + extent->length) {  //Continue right after near cluster if possible
+        Size taken = algorithms_umin64(remaining, extent->begin + extent->length - goal);
+        last = __fat32_takeFreeRun(fscore, extent, goal, taken, last);
+        ERROR_GOTO_IF_ERROR(0);
+        ret = goal;
+        remaining -= taken;
+    }
+
+    while (remaining > 0) {
+        __FAT32freeExtent* first = __fat32_getNextFreeExtent(fscore, __fat32_findFreeExtentFloor(fscore, goal)), * current = first;
+        if (first == NULL) {
             ERROR_THROW(ERROR_ID_OUT_OF_MEMORY, 0);
         }
 
-        last = currentCluster;
-        currentCluster = PTR_TO_VALUE(32, FAT + currentCluster);
+        __FAT32freeExtent* fit = NULL;
+        do {    //First run after goal large enough for the rest, so it stays in one piece
+            if (current->length >= remaining) {
+                fit = current;
+                break;
+            }
+            current = __fat32_getNextFreeExtent(fscore, current);
+        } while (current != first);
+
+        extent = fit == NULL ? first : fit;
+        Index32 begin = extent->begin;
+        Size taken = algorithms_umin64(remaining, extent->length);
+        last = __fat32_takeFreeRun(fscore, extent, begin, taken, last);
+        ERROR_GOTO_IF_ERROR(0);
+        if (ret == INVALID_INDEX32) {
+            ret = begin;
+        }
+        remaining -= taken;
+        goal = begin + taken;
     }
 
-    Index32 ret = fscore->firstFreeCluster;
-    fscore->firstFreeCluster = currentCluster;
-    PTR_TO_VALUE(32, FAT + last) = FAT32_CLSUTER_END_OF_CHAIN;
+    fscore->nextFreeHint = last + 1;
 
     return ret;
     ERROR_FINAL_BEGIN(0);
+    if (ret != INVALID_INDEX32) {
+        fat32_freeClusterChain(fscore, ret);
+    }
     return INVALID_INDEX32;
 }
 
@@ -109,15 +212,30 @@ void fat32_freeClusterChain(FAT32fscore* fscore, Index32 clusterChainFirst) {
     DEBUG_ASSERT_SILENT(fat32_getClusterType(fscore, clusterChainFirst) == FAT32_CLUSTER_TYPE_ALLOCATERD);
 
     Index32* FAT = fscore->FAT;
-    Index32 currentCluster = fscore->firstFreeCluster, last = INVALID_INDEX32;
-    while (currentCluster != FAT32_CLSUTER_END_OF_CHAIN) {
-        last = currentCluster;
-        currentCluster = PTR_TO_VALUE(32, FAT + currentCluster);
+    Index32 currentCluster = clusterChainFirst;
+    while (fat32_getClusterType(fscore, currentCluster) == FAT32_CLUSTER_TYPE_ALLOCATERD) {
+        Index32 runBegin = currentCluster;
+        Size runLength = 0;
+        while (true) {  //Contiguous part of chain goes back to index as one run
+            Index32 next = PTR_TO_VALUE(32, FAT + currentCluster);
+            PTR_TO_VALUE(32, FAT + currentCluster) = 0;
+            bitmap_setBit(&fscore->freeClusters, currentCluster);
+            __fat32_markFATdirty(fscore, currentCluster);
+            ++runLength;
+
+            bool isContinous = next == currentCluster + 1;
+            currentCluster = next;
+            if (!isContinous) {
+                break;
+            }
+        }
+
+        __fat32_addFreeRun(fscore, runBegin, runLength);
+        ERROR_GOTO_IF_ERROR(0);
     }
-    DEBUG_ASSERT_SILENT(last != INVALID_INDEX32);
 
-    PTR_TO_VALUE(32, FAT + last) = fscore->firstFreeCluster;
-    fscore->firstFreeCluster = clusterChainFirst;
+    return;
+    ERROR_FINAL_BEGIN(0);   //Clusters not added are lost until remounted
 }
 
 Index32 fat32_cutClusterChain(FAT32fscore* fscore, Index32 cluster) {
@@ -126,6 +244,7 @@ Index32 fat32_cutClusterChain(FAT32fscore* fscore, Index32 cluster) {
     Index32* FAT = fscore->FAT;
     Index32 ret = PTR_TO_VALUE(32, FAT + cluster);
     PTR_TO_VALUE(32, FAT + cluster) = FAT32_CLSUTER_END_OF_CHAIN;
+    __fat32_markFATdirty(fscore, cluster);
 
     return ret;
 }
@@ -142,4 +261,240 @@ void fat32_insertClusterChain(FAT32fscore* fscore, Index32 cluster, Index32 clus
 
     PTR_TO_VALUE(32, FAT + currentCluster) = PTR_TO_VALUE(32, FAT + cluster);
     PTR_TO_VALUE(32, FAT + cluster) = clusterChainToInsert;
+    __fat32_markFATdirty(fscore, currentCluster);
+    __fat32_markFATdirty(fscore, cluster);
+}
+
+void fat32_buildClusterMap(FAT32fscore* fscore, FAT32clusterMap* map, Index32 firstCluster) {
+    map->extents = NULL;
+    map->extentNum = map->extentCapacity = map->clusterNum = 0;
+
+    if (fat32_getClusterType(fscore, firstCluster) != FAT32_CLUSTER_TYPE_ALLOCATERD) {
+        return;
+    }
+
+    fat32_extendClusterMap(fscore, map, firstCluster);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    fat32_clearClusterMap(map);
+}
+
+void fat32_extendClusterMap(FAT32fscore* fscore, FAT32clusterMap* map, Index32 firstCluster) {
+    Size oldClusterNum = map->clusterNum;
+    for (Index32 current = firstCluster; current != INVALID_INDEX32;) {
+        Size continousLength = 0;
+        Index32 next = fat32_stepCluster(fscore, current, INFINITE, &continousLength);
+
+        __fat32_clusterMap_append(map, current, continousLength);
+        ERROR_GOTO_IF_ERROR(0);
+
+        current = next;
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    fat32_truncateClusterMap(map, oldClusterNum);
+}
+
+void fat32_truncateClusterMap(FAT32clusterMap* map, Size clusterNum) {
+    while (map->extentNum > 0) {
+        FAT32clusterExtent* last = &map->extents[map->extentNum - 1];
+        if (last->logicalBegin < clusterNum) {
+            last->length = algorithms_umin64(last->length, clusterNum - last->logicalBegin);
+            break;
+        }
+        --map->extentNum;
+    }
+
+    map->clusterNum = algorithms_umin64(map->clusterNum, clusterNum);
+}
+
+void fat32_clearClusterMap(FAT32clusterMap* map) {
+    if (map->extents != NULL) {
+        mm_free(map->extents);
+    }
+
+    map->extents = NULL;
+    map->extentNum = map->extentCapacity = map->clusterNum = 0;
+}
+
+Index32 fat32_mapCluster(FAT32clusterMap* map, Index32 index, Size* continousRet) {
+    if (index >= map->clusterNum) {
+        ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 0);
+    }
+
+    Size low = 0, high = map->extentNum;    //Last run begins not after index
+    while (high - low > 1) {
+        Size mid = (low + high) >> 1;
+        if (map->extents[mid].logicalBegin <= index) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    FAT32clusterExtent* extent = &map->extents[low];
+    DEBUG_ASSERT_SILENT(extent->logicalBegin <= index && index < extent->logicalBegin + extent->length);
+
+    Size offset = index - extent->logicalBegin;
+    if (continousRet != NULL) {
+        *continousRet = extent->length - offset;
+    }
+
+    return extent->physicalBegin + offset;
+    ERROR_FINAL_BEGIN(0);
+    return INVALID_INDEX32;
+}
+
+static int __fat32_freeExtentCmpFunc(RBtreeNode* node1, RBtreeNode* node2) {
+    return (int)HOST_POINTER(node1, __FAT32freeExtent, treeNode)->begin - (int)HOST_POINTER(node2, __FAT32freeExtent, treeNode)->begin;
+}
+
+static int __fat32_freeExtentSearchFunc(RBtreeNode* node, Object key) {
+    return (int)HOST_POINTER(node, __FAT32freeExtent, treeNode)->begin - (int)key;
+}
+
+static __FAT32freeExtent* __fat32_findFreeExtentFloor(FAT32fscore* fscore, Index32 cluster) {
+    RBtree* tree = &fscore->freeExtents;
+    __FAT32freeExtent* ret = NULL;
+    for (RBtreeNode* node = tree->root; node != &tree->NIL;) {
+        __FAT32freeExtent* extent = HOST_POINTER(node, __FAT32freeExtent, treeNode);
+        if (extent->begin <= cluster) {
+            ret = extent;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+
+    return ret;
+}
+
+static __FAT32freeExtent* __fat32_getNextFreeExtent(FAT32fscore* fscore, __FAT32freeExtent* extent) {
+    RBtree* tree = &fscore->freeExtents;
+    RBtreeNode* next = extent == NULL ? NULL : RBtree_getSuccessor(tree, &extent->treeNode);
+    if (next == NULL) { //Wrap around
+        next = RBtree_getFirst(tree);
+    }
+
+    return next == NULL ? NULL : HOST_POINTER(next, __FAT32freeExtent, treeNode);
+}
+
+static void __fat32_addFreeRun(FAT32fscore* fscore, Index32 begin, Size length) {
+    RBtree* tree = &fscore->freeExtents;
+    __FAT32freeExtent* prev = __fat32_findFreeExtentFloor(fscore, begin), * next = NULL;
+    RBtreeNode* nextNode = prev == NULL ? RBtree_getFirst(tree) : RBtree_getSuccessor(tree, &prev->treeNode);
+    if (nextNode != NULL) {
+        next = HOST_POINTER(nextNode, __FAT32freeExtent, treeNode);
+    }
+    DEBUG_ASSERT_SILENT(prev == NULL || prev->begin + prev->length <= begin);
+    DEBUG_ASSERT_SILENT(next == NULL || begin + length <= next->begin);
+
+    bool mergePrev = prev != NULL && prev->begin + prev->length == begin, mergeNext = next != NULL && begin + length == next->begin;
+    if (mergePrev && mergeNext) {
+        prev->length += length + next->length;
+        RBtree_directDelete(tree, &next->treeNode);
+        mm_free(next);
+    } else if (mergePrev) {
+        prev->length += length;
+    } else if (mergeNext) {
+        next->begin = begin;    //Order of runs not changed
+        next->length += length;
+    } else {
+        __FAT32freeExtent* extent = mm_allocate(sizeof(__FAT32freeExtent));
+        if (extent == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        RBtreeNode_initStruct(tree, &extent->treeNode);
+        extent->begin = begin;
+        extent->length = length;
+        RBtree_insert(tree, &extent->treeNode);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static Index32 __fat32_takeFreeRun(FAT32fscore* fscore, __FAT32freeExtent* extent, Index32 begin, Size length, Index32 lastCluster) {
+    DEBUG_ASSERT_SILENT(extent->begin <= begin && begin + length <= extent->begin + extent->length);
+
+    RBtree* tree = &fscore->freeExtents;
+    Index32 extentEnd = extent->begin + extent->length, end = begin + length;
+    if (begin != extent->begin && end != extentEnd) {   //Split, right part needs a new run
+        __FAT32freeExtent* right = mm_allocate(sizeof(__FAT32freeExtent));
+        if (right == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        RBtreeNode_initStruct(tree, &right->treeNode);
+        right->begin = end;
+        right->length = extentEnd - end;
+        extent->length = begin - extent->begin;
+        RBtree_insert(tree, &right->treeNode);
+    } else if (begin != extent->begin) {
+        extent->length -= length;
+    } else if (end != extentEnd) {
+        extent->begin = end;    //Order of runs not changed
+        extent->length -= length;
+    } else {
+        RBtree_directDelete(tree, &extent->treeNode);
+        mm_free(extent);
+    }
+
+    Index32* FAT = fscore->FAT;
+    for (Index32 i = begin; i < end; ++i) {
+        PTR_TO_VALUE(32, FAT + i) = i + 1 == end ? FAT32_CLSUTER_END_OF_CHAIN : i + 1;
+        bitmap_clearBit(&fscore->freeClusters, i);
+        __fat32_markFATdirty(fscore, i);
+    }
+
+    if (lastCluster != INVALID_INDEX32) {
+        PTR_TO_VALUE(32, FAT + lastCluster) = begin;
+    }
+
+    return end - 1;
+    ERROR_FINAL_BEGIN(0);
+    return lastCluster;
+}
+
+static void __fat32_clusterMap_append(FAT32clusterMap* map, Index32 physicalBegin, Size length) {
+    if (map->extentNum > 0) {
+        FAT32clusterExtent* last = &map->extents[map->extentNum - 1];
+        if (last->physicalBegin + last->length == physicalBegin) {  //Appended right after last run
+            last->length += length;
+            map->clusterNum += length;
+            return;
+        }
+    }
+
+    if (map->extentNum == map->extentCapacity) {
+        Size newCapacity = map->extentCapacity == 0 ? __FAT32_CLUSTER_MAP_INITIAL_CAPACITY : map->extentCapacity * 2;
+        FAT32clusterExtent* newExtents = mm_allocate(newCapacity * sizeof(FAT32clusterExtent));
+        if (newExtents == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        if (map->extents != NULL) {
+            memory_memcpy(newExtents, map->extents, map->extentNum * sizeof(FAT32clusterExtent));
+            mm_free(map->extents);
+        }
+        map->extents = newExtents;
+        map->extentCapacity = newCapacity;
+    }
+
+    map->extents[map->extentNum++] = (FAT32clusterExtent) {
+        .logicalBegin   = map->clusterNum,
+        .physicalBegin  = physicalBegin,
+        .length         = length
+    };
+    map->clusterNum += length;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
 }
\ No newline at end of file
@@ -27,7 +27,7 @@ static Uint16 __fat32_directoryEntry_convertRealTimeToTimeField(RealTime* realTi
 
 void fat32_directoryEntry_parse(FAT32UnknownTypeEntry* entriesBegin, String* nameOut, Flags8* attributeOut, FSnodeAttribute* fsnodeAttributeOut, Index32* firstClusterOut, Size* sizeOut) {
     DEBUG_ASSERT_SILENT(string_isAvailable(nameOut));
-    DEBUG_ASSERT_SILENT(!fat32_directoryEntry_isEnd(entriesBegin));
+    DEBUG_ASSERT_SILENT(!fat32_directoryEntry_isEnd(entriesBegin) && !fat32_directoryEntry_isDeleted(entriesBegin));
     
     Size length = fat32_directoryEntry_getEntriesLength(entriesBegin);
     if (length > sizeof(FAT32DirectoryEntry)) {
@@ -16,6 +16,7 @@
 #include<memory/mm.h>
 #include<memory/paging.h>
 #include<multitask/locks/spinlock.h>
+#include<structs/bitmap.h>
 #include<structs/hashTable.h>
 #include<structs/string.h>
 #include<system/pageTable.h>
@@ -84,7 +85,7 @@ bool fat32_checkType(BlockDevice* blockDevice) {
 #define __FS_FAT32_BATCH_ALLOCATE_SIZE  BATCH_ALLOCATE_SIZE((FAT32fscore, 1), (FAT32BPB, 1))
 
 void fat32_open(FS* fs, BlockDevice* blockDevice) {
-    void* batchAllocated = NULL, * buffer = NULL;
+    void* batchAllocated = NULL, * buffer = NULL, * freeClustersBits = NULL, * dirtyFATsectorsBits = NULL;
     batchAllocated = mm_allocate(__FS_FAT32_BATCH_ALLOCATE_SIZE);
     if (batchAllocated == NULL) {
         ERROR_ASSERT_ANY();
@@ -140,23 +141,20 @@ void fat32_open(FS* fs, BlockDevice* blockDevice) {
 
     fat32fscore->FAT                    = FAT;
 
-    Index32 firstFreeCluster = INVALID_INDEX32, last = INVALID_INDEX32;
-    for (Index32 i = 0; i < clusterNum; ++i) {
-        Index32 nextCluster = PTR_TO_VALUE(32, FAT + i);
-        if (fat32_getClusterType(fat32fscore, nextCluster) != FAT32_CLUSTER_TYPE_FREE) {
-            continue;
-        }
-
-        if (firstFreeCluster == INVALID_INDEX32) {
-            firstFreeCluster = i;
-        } else {
-            PTR_TO_VALUE(32, FAT + last) = i;
-        }
-
-        last = i;
+    Size freeClustersBitsSize = DIVIDE_ROUND_UP(clusterNum, 64) * sizeof(Uint64), dirtyFATsectorsBitsSize = DIVIDE_ROUND_UP(BPB->sectorPerFAT, 64) * sizeof(Uint64);
+    freeClustersBits = mm_allocate(freeClustersBitsSize);
+    dirtyFATsectorsBits = mm_allocate(dirtyFATsectorsBitsSize);
+    if (freeClustersBits == NULL || dirtyFATsectorsBits == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
     }
-    PTR_TO_VALUE(32, FAT + last) = FAT32_CLSUTER_END_OF_CHAIN;
-    fat32fscore->firstFreeCluster   = firstFreeCluster;
+    memory_memset(freeClustersBits, 0, freeClustersBitsSize);
+    memory_memset(dirtyFATsectorsBits, 0, dirtyFATsectorsBitsSize);
+    bitmap_initStruct(&fat32fscore->freeClusters, clusterNum, freeClustersBits);
+    bitmap_initStruct(&fat32fscore->dirtyFATsectors, BPB->sectorPerFAT, dirtyFATsectorsBits);
+
+    fat32_buildFreeClusterIndex(fat32fscore);
+    ERROR_GOTO_IF_ERROR(0);
 
     hashTable_initStruct(&fat32fscore->metadataTableFirstCluster, FAT32_FSCORE_VNODE_TABLE_CHAIN_NUM, fat32fscore->metadataTableChainsFirstCluster, hashTable_defaultHashFunc);
     
@@ -181,6 +179,14 @@ void fat32_open(FS* fs, BlockDevice* blockDevice) {
         mm_free(FAT);
     }
 
+    if (freeClustersBits != NULL) {
+        mm_free(freeClustersBits);
+    }
+
+    if (dirtyFATsectorsBits != NULL) {
+        mm_free(dirtyFATsectorsBits);
+    }
+
     if (buffer != NULL) {
         mm_free(buffer);
     }
@@ -202,6 +208,9 @@ void fat32_close(FS* fs) {
     Size FATsizeInByte = fat32fscore->FATrange.length * POWER_2(fscoreDevice->granularity);
     memory_memset(fat32fscore->FAT, 0, FATsizeInByte);
     mm_free(fat32fscore->FAT);
+    fat32_clearFreeClusterIndex(fat32fscore);
+    mm_free(fat32fscore->freeClusters.bitPtr);
+    mm_free(fat32fscore->dirtyFATsectors.bitPtr);
 
     void* batchAllocated = fat32fscore; //TODO: Ugly code
     memory_memset(batchAllocated, 0, __FS_FAT32_BATCH_ALLOCATE_SIZE);
@@ -213,7 +222,7 @@ void fat32_close(FS* fs) {
 
 Index32 fat32FScore_createFirstCluster(FAT32fscore* fscore) {
     void* clusterBuffer = NULL;
-    Index32 firstCluster = fat32_allocateClusterChain(fscore, 1);   //First cluster of new file/directory must be all 0
+    Index32 firstCluster = fat32_allocateClusterChain(fscore, 1, INVALID_INDEX32);   //First cluster of new file/directory must be all 0
     if (firstCluster == INVALID_INDEX32) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
@@ -256,13 +265,16 @@ static vNode* __fat32_fscore_openVnode(FScore* fscore, fsNode* node) {
     Device* fscoreDevice        = &fscore->blockDevice->device;
     fat32vnode->firstCluster    = nodeEntry->pointsTo;
 
+    fat32_buildClusterMap(fat32fscore, &fat32vnode->clusterMap, fat32vnode->firstCluster);   //Walks chain once, length of chain comes with it
+    ERROR_GOTO_IF_ERROR(0);
+
     vNode* vnode = &fat32vnode->vnode;
 
     BlockDevice* fscoreBlockDevice = fscore->blockDevice;
 
     vNodeInitArgs args = {
         .vnodeID        = node->entry.vnodeID,
-        .tokenSpaceSize = fat32_getClusterChainLength(fat32fscore, fat32vnode->firstCluster) * BPB->sectorPerCluster * POWER_2(fscoreBlockDevice->device.granularity),
+        .tokenSpaceSize = fat32vnode->clusterMap.clusterNum * BPB->sectorPerCluster * POWER_2(fscoreBlockDevice->device.granularity),
         .size           = nodeEntry->size,
         .fscore         = fscore,
         .operations     = fat32_vNode_getOperations(),
@@ -291,47 +303,68 @@ static void __fat32_fscore_closeVnode(FScore* fscore, vNode* vnode) {
     FAT32vnode* fat32vnode = HOST_POINTER(vnode, FAT32vnode, vnode);
     //TODO: Update own entry if resized
 
+    fat32_clearClusterMap(&fat32vnode->clusterMap);
     mm_free(fat32vnode);
 }
 
 static void __fat32_fscore_sync(FScore* fscore) {
-    Index32* FATcopy = NULL;
+    void* buffer = NULL;
 
     FAT32fscore* fat32fscore = HOST_POINTER(fscore, FAT32fscore, fscore);
     
     FAT32BPB* BPB = fat32fscore->BPB;
     BlockDevice* fscoreBlockDevice = fscore->blockDevice;
     Device* fscoreDevice = &fscoreBlockDevice->device;
+    Size sectorSize = POWER_2(fscoreDevice->granularity);
 
     RangeN* fatRange = &fat32fscore->FATrange;
-    Size FATsizeInByte = fatRange->length * POWER_2(fscoreDevice->granularity);
-    FATcopy = mm_allocate(FATsizeInByte);
-    if (FATcopy == NULL) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
-    }
-    memory_memcpy(FATcopy, fat32fscore->FAT, FATsizeInByte);
+    Bitmap* dirtyFATsectors = &fat32fscore->dirtyFATsectors;
+    Index64 sectorIndex = 0;
+    while ((sectorIndex = bitmap_findFirstSet(dirtyFATsectors, sectorIndex)) != INVALID_INDEX64) {
+        Size runLength = 1; //Consecutive dirty sectors are written together
+        while (sectorIndex + runLength < dirtyFATsectors->bitNum && bitmap_testBit(dirtyFATsectors, sectorIndex + runLength)) {
+            ++runLength;
+        }
 
-    for (int i = fat32fscore->firstFreeCluster, next; i != FAT32_CLSUTER_END_OF_CHAIN; i = next) {
-        next = PTR_TO_VALUE(32, FATcopy + i);
-        PTR_TO_VALUE(32, FATcopy + i) = 0;
+        void* sectors = (void*)fat32fscore->FAT + sectorIndex * sectorSize;
+        for (int i = 0; i < fatRange->n; ++i) {
+            blockDevice_writeBlocks(fscoreBlockDevice, fatRange->begin + i * fatRange->length + sectorIndex, sectors, runLength);
+            ERROR_GOTO_IF_ERROR(0);
+        }
+
+        bitmap_clearBits(dirtyFATsectors, sectorIndex, runLength);
+        sectorIndex += runLength;
     }
 
-    for (int i = 0; i < fatRange->n; ++i) { //TODO: FAT is only saved here, maybe we can make it save at anytime
-        blockDevice_writeBlocks(fscoreBlockDevice, fatRange->begin + i * fatRange->length, FATcopy, fatRange->length);
+    if (BPB->FSinfoSectorNum != 0 && BPB->FSinfoSectorNum != 0xFFFF) {
+        buffer = mm_allocate(sectorSize);
+        if (buffer == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        blockDevice_readBlocks(fscoreBlockDevice, BPB->FSinfoSectorNum, buffer, 1);
         ERROR_GOTO_IF_ERROR(0);
-    }
 
-    mm_free(FATcopy);
-    FATcopy = NULL;
+        FAT32FSinfo* FSinfo = (FAT32FSinfo*)buffer;
+        if (FSinfo->leadSignature == FAT32_FSINFO_LEAD_SIGNATURE && FSinfo->structSignature == FAT32_FSINFO_STRUCT_SIGNATURE) {
+            FSinfo->freeClusterNum = fat32fscore->freeClusters.bitSetNum;
+            FSinfo->nextFreeCluster = fat32fscore->nextFreeHint;
+            blockDevice_writeBlocks(fscoreBlockDevice, BPB->FSinfoSectorNum, buffer, 1);
+            ERROR_GOTO_IF_ERROR(0);
+        }
+
+        mm_free(buffer);
+        buffer = NULL;
+    }
 
     blockDevice_flush(fscoreBlockDevice);
     ERROR_GOTO_IF_ERROR(0);
 
     return;
     ERROR_FINAL_BEGIN(0);
-    if (FATcopy != NULL) {
-        mm_free(FATcopy);
+    if (buffer != NULL) {
+        mm_free(buffer);
     }
     return;
 }
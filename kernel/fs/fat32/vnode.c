@@ -37,6 +37,17 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
 
 static void __fat32_vNode_readDirectoryEntries(vNode* vnode);
 
+static void __fat32_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory);
+
+static Index64 __fat32_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);
+
+static bool __fat32_vNode_doReadDirectoryEntries(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __fat32_vNode_markEntriesDeleted(vNode* vnode, Index64 begin, FAT32UnknownTypeEntry* entries, Size entriesLength, void* clusterBuffer);
+
+#define __FAT32_VNODE_DIRECTORY_BATCH_SIZE  (4 * PAGE_SIZE) //Directory data read at once when iterating
+DEBUG_ASSERT_COMPILE(__FAT32_VNODE_DIRECTORY_BATCH_SIZE >= FAT32_DIRECTORY_ENTRY_MAX_ENTRIES_SIZE);
+
 static vNodeOperations _fat32_vNodeOperations = {
     .readData                   = __fat32_vNode_readData,
     .writeData                  = __fat32_vNode_writeData,
@@ -44,7 +55,9 @@ static vNodeOperations _fat32_vNodeOperations = {
     .addDirectoryEntry          = __fat32_vNode_addDirectoryEntry,
     .removeDirectoryEntry       = __fat32_vNode_removeDirectoryEntry,
     .renameDirectoryEntry       = __fat32_vNode_renameDirectoryEntry,
-    .readDirectoryEntries       = __fat32_vNode_readDirectoryEntries
+    .readDirectoryEntries       = __fat32_vNode_readDirectoryEntries,
+    .lookupDirectoryEntry       = __fat32_vNode_lookupDirectoryEntry,
+    .iterateDirectoryEntries    = __fat32_vNode_iterateDirectoryEntries
 };
 
 static FAT32DirectoryEntry _fat32_vNode_directoryTail;
@@ -185,14 +198,18 @@ static void __fat32_vNode_doReadData(vNode* vnode, Index64 begin, void* buffer,
     FAT32BPB* BPB = fat32fscore->BPB;
     Size clusterSize = POWER_2(targetDevice->granularity) * BPB->sectorPerCluster;
 
-    Index32 currentClusterIndex = fat32_getCluster(fat32fscore, fat32vnode->firstCluster, begin / clusterSize);
-    if (currentClusterIndex == INVALID_INDEX32) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
-    }
+    FAT32clusterMap* clusterMap = &fat32vnode->clusterMap;
+    Index32 logicalClusterIndex = begin / clusterSize, currentClusterIndex = INVALID_INDEX32;
+    Size continousClusterLength = 0;
 
     Size remainByteNum = byteN;
     if (begin % clusterSize != 0) {
+        currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, NULL);
+        if (currentClusterIndex == INVALID_INDEX32) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
         Index64 offsetInCluster = begin % clusterSize;
         blockDevice_readBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, clusterBuffer, BPB->sectorPerCluster);
         ERROR_GOTO_IF_ERROR(0);
@@ -200,8 +217,7 @@ static void __fat32_vNode_doReadData(vNode* vnode, Index64 begin, void* buffer,
         Size byteReadN = algorithms_umin64(remainByteNum, clusterSize - offsetInCluster);
         memory_memcpy(buffer, clusterBuffer + offsetInCluster, byteReadN);
         
-        currentClusterIndex = fat32_getCluster(fat32fscore, currentClusterIndex, 1);
-
+        ++logicalClusterIndex;
         buffer += byteReadN;
         remainByteNum -= byteReadN;
     }
@@ -209,18 +225,18 @@ static void __fat32_vNode_doReadData(vNode* vnode, Index64 begin, void* buffer,
     if (remainByteNum >= clusterSize) {
         Size remainingFullClusterNum = remainByteNum / clusterSize;
         while (remainingFullClusterNum > 0) {
-            DEBUG_ASSERT_SILENT(currentClusterIndex != INVALID_INDEX32);
-
-            Size continousClusterLength = 0;
-            Index32 nextClusterIndex = fat32_stepCluster(fat32fscore, currentClusterIndex, remainingFullClusterNum, &continousClusterLength);
-            DEBUG_ASSERT_SILENT(VALUE_WITHIN(0, remainingFullClusterNum, continousClusterLength, <, <=));
+            currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, &continousClusterLength);   //Whole run at once
+            if (currentClusterIndex == INVALID_INDEX32) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+            continousClusterLength = algorithms_umin64(continousClusterLength, remainingFullClusterNum);
 
             Size continousBlockLength = continousClusterLength * BPB->sectorPerCluster;
             blockDevice_readBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, buffer, continousBlockLength);
             ERROR_GOTO_IF_ERROR(0);
 
-            currentClusterIndex = nextClusterIndex;
-
+            logicalClusterIndex += continousClusterLength;
             buffer += continousClusterLength * clusterSize;
             remainingFullClusterNum -= continousClusterLength;
         }
@@ -229,7 +245,12 @@ static void __fat32_vNode_doReadData(vNode* vnode, Index64 begin, void* buffer,
     }
 
     if (remainByteNum > 0) {
-        DEBUG_ASSERT_SILENT(currentClusterIndex != INVALID_INDEX32);
+        currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, NULL);
+        if (currentClusterIndex == INVALID_INDEX32) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
         blockDevice_readBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, clusterBuffer, BPB->sectorPerCluster);
         ERROR_GOTO_IF_ERROR(0);
 
@@ -259,14 +280,18 @@ static void __fat32_vNode_doWriteData(vNode* vnode, Index64 begin, const void* b
     FAT32BPB* BPB = fat32fscore->BPB;
     Size clusterSize = POWER_2(targetDevice->granularity) * BPB->sectorPerCluster;
 
-    Index32 currentClusterIndex = fat32_getCluster(fat32fscore, fat32vnode->firstCluster, begin / clusterSize);
-    if (currentClusterIndex == INVALID_INDEX32) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
-    }
+    FAT32clusterMap* clusterMap = &fat32vnode->clusterMap;
+    Index32 logicalClusterIndex = begin / clusterSize, currentClusterIndex = INVALID_INDEX32;
+    Size continousClusterLength = 0;
 
     Size remainByteNum = byteN;
     if (begin % clusterSize != 0) {
+        currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, NULL);
+        if (currentClusterIndex == INVALID_INDEX32) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
         Index64 offsetInCluster = begin % clusterSize;
         blockDevice_readBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, clusterBuffer, BPB->sectorPerCluster);
         ERROR_GOTO_IF_ERROR(0);
@@ -277,8 +302,7 @@ static void __fat32_vNode_doWriteData(vNode* vnode, Index64 begin, const void* b
         blockDevice_writeBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, clusterBuffer, BPB->sectorPerCluster);
         ERROR_GOTO_IF_ERROR(0);
 
-        currentClusterIndex = fat32_getCluster(fat32fscore, currentClusterIndex, 1);
-
+        ++logicalClusterIndex;
         buffer += byteReadN;
         remainByteNum -= byteReadN;
     }
@@ -286,18 +310,18 @@ static void __fat32_vNode_doWriteData(vNode* vnode, Index64 begin, const void* b
     if (remainByteNum >= clusterSize) {
         Size remainingFullClusterNum = remainByteNum / clusterSize;
         while (remainingFullClusterNum > 0) {
-            DEBUG_ASSERT_SILENT(currentClusterIndex != INVALID_INDEX32);
-
-            Size continousClusterLength = 0;
-            Index32 nextClusterIndex = fat32_stepCluster(fat32fscore, currentClusterIndex, remainingFullClusterNum, &continousClusterLength);
-            DEBUG_ASSERT_SILENT(VALUE_WITHIN(0, remainingFullClusterNum, continousClusterLength, <, <=));
+            currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, &continousClusterLength);   //Whole run at once
+            if (currentClusterIndex == INVALID_INDEX32) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+            continousClusterLength = algorithms_umin64(continousClusterLength, remainingFullClusterNum);
 
             Size continousBlockLength = continousClusterLength * BPB->sectorPerCluster;
             blockDevice_writeBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, buffer, continousBlockLength);
             ERROR_GOTO_IF_ERROR(0);
 
-            currentClusterIndex = nextClusterIndex;
-
+            logicalClusterIndex += continousClusterLength;
             buffer += continousClusterLength * clusterSize;
             remainingFullClusterNum -= continousClusterLength;
         }
@@ -306,7 +330,12 @@ static void __fat32_vNode_doWriteData(vNode* vnode, Index64 begin, const void* b
     }
 
     if (remainByteNum > 0) {
-        DEBUG_ASSERT_SILENT(currentClusterIndex != INVALID_INDEX32);
+        currentClusterIndex = fat32_mapCluster(clusterMap, logicalClusterIndex, NULL);
+        if (currentClusterIndex == INVALID_INDEX32) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
         blockDevice_readBlocks(targetBlockDevice, (Index64)currentClusterIndex * BPB->sectorPerCluster + fat32fscore->dataBlockRange.begin, clusterBuffer, BPB->sectorPerCluster);
         ERROR_GOTO_IF_ERROR(0);
         
@@ -339,28 +368,33 @@ static void __fat32_vNode_resize(vNode* vnode, Size newSizeInByte) {
         newSizeInCluster = 1;
     }
     
+    FAT32clusterMap* clusterMap = &fat32vnode->clusterMap;
     if (newSizeInCluster < oldSizeInCluster) {
-        Index32 tail = fat32_getCluster(fat32fscore, fat32vnode->firstCluster, newSizeInCluster - 1);
+        Index32 tail = fat32_mapCluster(clusterMap, newSizeInCluster - 1, NULL);
         if (tail == INVALID_INDEX32) {
             ERROR_ASSERT_ANY();
             ERROR_GOTO(0);
         }
 
         Index32 cut = fat32_cutClusterChain(fat32fscore, tail);
+        fat32_truncateClusterMap(clusterMap, newSizeInCluster);
         fat32_freeClusterChain(fat32fscore, cut);
     } else if (newSizeInCluster > oldSizeInCluster) {
-        freeClusterChain = fat32_allocateClusterChain(fat32fscore, newSizeInCluster - oldSizeInCluster);
-        if (freeClusterChain == INVALID_INDEX32) {
+        Index32 tail = fat32_mapCluster(clusterMap, oldSizeInCluster - 1, NULL);
+        if (tail == INVALID_INDEX32) {
             ERROR_ASSERT_ANY();
             ERROR_GOTO(0);
         }
 
-        Index32 tail = fat32_getCluster(fat32fscore, fat32vnode->firstCluster, oldSizeInCluster - 1);
+        freeClusterChain = fat32_allocateClusterChain(fat32fscore, newSizeInCluster - oldSizeInCluster, tail);  //Right after tail if possible, so file stays contiguous
         if (freeClusterChain == INVALID_INDEX32) {
             ERROR_ASSERT_ANY();
             ERROR_GOTO(0);
         }
 
+        fat32_extendClusterMap(fat32fscore, clusterMap, freeClusterChain);
+        ERROR_GOTO_IF_ERROR(0);
+
         fat32_insertClusterChain(fat32fscore, tail, freeClusterChain);
     }
 
@@ -400,39 +434,8 @@ static Index64 __fat32_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* ent
         ERROR_GOTO(0);
     }
 
-    bool found = false;
-    String entryName;
-    string_initStruct(&entryName);
-    ERROR_GOTO_IF_ERROR(0);
-    Flags8 attribute = EMPTY_FLAGS;
-    FSnodeAttribute fsnodeAttribute;
-    Index32 firstCluster = 0;
-    Size size = 0;
-    Index64 currentPointer = 0;
+    Index64 currentPointer = vnode->size - sizeof(FAT32DirectoryEntry);  //Removed slots stay marked so offsets never shift, new entries always go to end of directory, duplication is checked by caller
     Size entriesLength = 0;
-    while (!found) {
-        __fat32_vNode_doReadData(vnode, currentPointer, entriesBuffer, sizeof(FAT32UnknownTypeEntry), clusterBuffer);
-        ERROR_GOTO_IF_ERROR(0);
-        if (fat32_directoryEntry_isEnd(entriesBuffer)) {
-            break;
-        }
-
-        entriesLength = fat32_directoryEntry_getEntriesLength(entriesBuffer);
-        __fat32_vNode_doReadData(vnode, currentPointer, entriesBuffer, entriesLength, clusterBuffer);
-        ERROR_GOTO_IF_ERROR(0);
-
-        fat32_directoryEntry_parse(entriesBuffer, &entryName, &attribute, &fsnodeAttribute, &firstCluster, &size);
-        if (cstring_strcmp(entry->name, entryName.data) == 0 && (entry->type == FS_ENTRY_TYPE_DIRECTORY) == TEST_FLAGS(attribute, FAT32_DIRECTORY_ENTRY_ATTRIBUTE_DIRECTORY)) {            
-            found = true;
-            break;
-        }
-        
-        currentPointer += entriesLength;
-    }
-
-    if (found) {
-        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
-    }
 
     Index32 newFirstCluster = fat32FScore_createFirstCluster(fat32fscore);
     if (newFirstCluster == INVALID_INDEX32) {
@@ -475,7 +478,7 @@ static Index64 __fat32_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* ent
 }
 
 static void __fat32_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirectory) {
-    void* clusterBuffer = NULL, * entriesBuffer = NULL, * remainingData = NULL;
+    void* clusterBuffer = NULL, * entriesBuffer = NULL;
     
     FScore* fscore = vnode->fscore;
     FAT32fscore* fat32fscore = HOST_POINTER(fscore, FAT32fscore, fscore);
@@ -514,6 +517,11 @@ static void __fat32_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name,
         }
 
         entriesLength = fat32_directoryEntry_getEntriesLength(entriesBuffer);
+        if (fat32_directoryEntry_isDeleted(entriesBuffer)) {
+            currentPointer += entriesLength;
+            continue;
+        }
+
         __fat32_vNode_doReadData(vnode, currentPointer, entriesBuffer, entriesLength, clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
 
@@ -532,16 +540,7 @@ static void __fat32_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name,
 
     DEBUG_ASSERT_SILENT(entriesLength > 0);
     DEBUG_ASSERT_SILENT(currentPointer + entriesLength < vnode->size);
-    Size remainingDataSize = vnode->size - currentPointer - entriesLength;
-    remainingData = mm_allocate(remainingDataSize);
-    __fat32_vNode_doReadData(vnode, currentPointer + entriesLength, remainingData, remainingDataSize, clusterBuffer);
-    ERROR_GOTO_IF_ERROR(0);
-    __fat32_vNode_doWriteData(vnode, currentPointer, remainingData, remainingDataSize, clusterBuffer);
-    ERROR_GOTO_IF_ERROR(0);
-    mm_free(remainingData);
-    remainingData = NULL;
-    
-    vNode_rawResize(vnode, vnode->size - entriesLength);
+    __fat32_vNode_markEntriesDeleted(vnode, currentPointer, entriesBuffer, entriesLength, clusterBuffer);   //Following entries are not shifted, so their offsets stay valid as readdir cookies
     ERROR_GOTO_IF_ERROR(0);
     
     mm_free(clusterBuffer);
@@ -556,14 +555,10 @@ static void __fat32_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name,
     if (entriesBuffer != NULL) {
         mm_free(entriesBuffer);
     }
-
-    if (remainingData != NULL) {
-        mm_free(remainingData);
-    }
 }
 
 static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName) {
-    void* clusterBuffer = NULL, *entriesBuffer = NULL, * transplantEntriesBuffer = NULL, * remainingData = NULL;
+    void* clusterBuffer = NULL, *entriesBuffer = NULL, * transplantEntriesBuffer = NULL;
     
     FScore* fscore = vnode->fscore;
     FAT32fscore* fat32fscore = HOST_POINTER(fscore, FAT32fscore, fscore);
@@ -605,11 +600,16 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
     while (!found) {
         __fat32_vNode_doReadData(vnode, currentPointer, transplantEntriesBuffer, sizeof(FAT32UnknownTypeEntry), clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
-        if (fat32_directoryEntry_isEnd(entriesBuffer)) {
+        if (fat32_directoryEntry_isEnd(transplantEntriesBuffer)) {
             break;
         }
 
         entriesLength = fat32_directoryEntry_getEntriesLength(transplantEntriesBuffer);
+        if (fat32_directoryEntry_isDeleted(transplantEntriesBuffer)) {
+            currentPointer += entriesLength;
+            continue;
+        }
+
         __fat32_vNode_doReadData(vnode, currentPointer, transplantEntriesBuffer, entriesLength, clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
 
@@ -628,16 +628,8 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
 
     DEBUG_ASSERT_SILENT(entriesLength > 0);
     DEBUG_ASSERT_SILENT(currentPointer + entriesLength < vnode->size);
-    Size remainingDataSize = vnode->size - currentPointer - entriesLength;
-    remainingData = mm_allocate(remainingDataSize);
-    __fat32_vNode_doReadData(vnode, currentPointer + entriesLength, remainingData, remainingDataSize, clusterBuffer);
-    ERROR_GOTO_IF_ERROR(0);
-    __fat32_vNode_doWriteData(vnode, currentPointer, remainingData, remainingDataSize, clusterBuffer);
-    ERROR_GOTO_IF_ERROR(0);
-    mm_free(remainingData);
-    remainingData = NULL;
-    
-    vNode_rawResize(vnode, vnode->size - entriesLength);
+    memory_memcpy(entriesBuffer, transplantEntriesBuffer, entriesLength);  //Transplanted entries are kept unmarked
+    __fat32_vNode_markEntriesDeleted(vnode, currentPointer, entriesBuffer, entriesLength, clusterBuffer);
     ERROR_GOTO_IF_ERROR(0);
 
     //Write to moveTo directory
@@ -654,6 +646,11 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
         }
 
         entriesLength = fat32_directoryEntry_getEntriesLength(entriesBuffer);
+        if (fat32_directoryEntry_isDeleted(entriesBuffer)) {
+            currentPointer += entriesLength;
+            continue;
+        }
+
         __fat32_vNode_doReadData(moveTo, currentPointer, entriesBuffer, entriesLength, clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
 
@@ -670,15 +667,14 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
         ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
     }
 
-    DEBUG_ASSERT_SILENT(entriesLength > 0);
-    vNode_rawResize(moveTo, moveTo->size + entriesLength);
+    vNode_rawResize(moveTo, moveTo->size + transplantEntriesLength);
     ERROR_GOTO_IF_ERROR(0);
 
-    __fat32_vNode_doWriteData(moveTo, currentPointer, transplantEntriesBuffer, entriesLength, clusterBuffer);
+    __fat32_vNode_doWriteData(moveTo, currentPointer, transplantEntriesBuffer, transplantEntriesLength, clusterBuffer);
     ERROR_GOTO_IF_ERROR(0);
-    currentPointer += entriesLength;
+    currentPointer += transplantEntriesLength;
 
-    __fat32_vNode_doWriteData(vnode, currentPointer, &_fat32_vNode_directoryTail, sizeof(FAT32DirectoryEntry), clusterBuffer);
+    __fat32_vNode_doWriteData(moveTo, currentPointer, &_fat32_vNode_directoryTail, sizeof(FAT32DirectoryEntry), clusterBuffer);  //Source keeps its tail, removed entries are only marked
     ERROR_GOTO_IF_ERROR(0);
 
     mm_free(clusterBuffer);
@@ -698,13 +694,121 @@ static void __fat32_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNod
     if (transplantEntriesBuffer != NULL) {
         mm_free(transplantEntriesBuffer);
     }
+}
+
+static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
+    __fat32_vNode_doReadDirectoryEntries(vnode, NULL, 0, false);
+}
 
-    if (remainingData != NULL) {
-        mm_free(remainingData);
+static void __fat32_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory) {
+    bool found = __fat32_vNode_doReadDirectoryEntries(vnode, name, nameLength, isDirectory);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (!found) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
     }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
 }
 
-static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
+static Index64 __fat32_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) {   //Cookie is offset of entries in directory, removed entries are only marked so offsets never shift
+    void* clusterBuffer = NULL, * batchBuffer = NULL;
+
+    FScore* fscore = vnode->fscore;
+    FAT32fscore* fat32fscore = HOST_POINTER(fscore, FAT32fscore, fscore);
+    FAT32BPB* BPB = fat32fscore->BPB;
+    DEBUG_ASSERT_SILENT(vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+
+    Size clusterSize = POWER_2(fscore->blockDevice->device.granularity) * BPB->sectorPerCluster;
+    clusterBuffer = mm_allocate(clusterSize);
+    if (clusterBuffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    batchBuffer = mm_allocatePages(DIVIDE_ROUND_UP(__FAT32_VNODE_DIRECTORY_BATCH_SIZE, PAGE_SIZE));
+    if (batchBuffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    String entryName;
+    string_initStruct(&entryName);
+    ERROR_GOTO_IF_ERROR(0);
+    Flags8 attribute = EMPTY_FLAGS;
+    FSnodeAttribute fsnodeAttribute;
+    Index32 firstCluster = 0;
+    Size size = 0;
+
+    FAT32vnode* fat32vnode = HOST_POINTER(vnode, FAT32vnode, vnode);
+    Index64 currentPointer = cookie, batchBegin = cookie;
+    Size batchN = 0;
+    Index32 currentClusterIndex = INVALID_INDEX32, mappedClusterIndex = INVALID_INDEX32;   //Physical and logical cluster of entries, mapped through cluster map instead of walking FAT
+
+    while (currentPointer + sizeof(FAT32UnknownTypeEntry) <= vnode->size) {
+        FAT32UnknownTypeEntry* entries = batchBuffer + (currentPointer - batchBegin);
+        if (currentPointer + sizeof(FAT32UnknownTypeEntry) > batchBegin + batchN || currentPointer + fat32_directoryEntry_getEntriesLength(entries) > batchBegin + batchN) {   //Entries cross end of batch, read next batch from them
+            batchBegin = currentPointer;
+            batchN = algorithms_umin64(__FAT32_VNODE_DIRECTORY_BATCH_SIZE, vnode->size - currentPointer);
+            __fat32_vNode_doReadData(vnode, batchBegin, batchBuffer, batchN, clusterBuffer);
+            ERROR_GOTO_IF_ERROR(1);
+            entries = batchBuffer;
+        }
+
+        if (fat32_directoryEntry_isEnd(entries)) {
+            break;
+        }
+
+        Size entriesLength = fat32_directoryEntry_getEntriesLength(entries);
+        if (currentPointer + entriesLength > batchBegin + batchN) { //Broken entries run out of directory
+            break;
+        }
+
+        if (fat32_directoryEntry_isDeleted(entries)) {
+            currentPointer += entriesLength;
+            continue;
+        }
+
+        if (DIVIDE_ROUND_DOWN(currentPointer, clusterSize) != mappedClusterIndex) {
+            mappedClusterIndex = DIVIDE_ROUND_DOWN(currentPointer, clusterSize);
+            currentClusterIndex = fat32_mapCluster(&fat32vnode->clusterMap, mappedClusterIndex, NULL);
+            if (currentClusterIndex == INVALID_INDEX32) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(1);
+            }
+        }
+
+        fat32_directoryEntry_parse(entries, &entryName, &attribute, &fsnodeAttribute, &firstCluster, &size);
+        ERROR_GOTO_IF_ERROR(1);
+        fsEntryType type = TEST_FLAGS(attribute, FAT32_DIRECTORY_ENTRY_ATTRIBUTE_DIRECTORY) ? FS_ENTRY_TYPE_DIRECTORY : FS_ENTRY_TYPE_FILE;
+        ID vnodeID = currentClusterIndex * clusterSize | (currentPointer % clusterSize);    //Same as vnode ID of fsNode read by readDirectoryEntries
+        if (!func(arg, entryName.data, entryName.length, type, vnodeID, currentPointer + entriesLength)) {
+            break;
+        }
+
+        currentPointer += entriesLength;
+    }
+
+    string_clearStruct(&entryName);
+    mm_free(clusterBuffer);
+    mm_freePages(batchBuffer);
+
+    return currentPointer;
+    ERROR_FINAL_BEGIN(1);
+    string_clearStruct(&entryName);
+    ERROR_FINAL_BEGIN(0);
+    if (clusterBuffer != NULL) {
+        mm_free(clusterBuffer);
+    }
+
+    if (batchBuffer != NULL) {
+        mm_freePages(batchBuffer);
+    }
+    return INVALID_INDEX64;
+}
+
+static bool __fat32_vNode_doReadDirectoryEntries(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory) {
     void* clusterBuffer = NULL, * entriesBuffer = NULL;
     
     FScore* fscore = vnode->fscore;
@@ -739,12 +843,11 @@ static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
     Size size = 0;
     Index64 currentPointer = 0;
     Size entriesLength = 0;
+    bool found = false;
 
     FAT32vnode* fat32vnode = HOST_POINTER(vnode, FAT32vnode, vnode);
-    Index32 currentClusterIndex = fat32_getCluster(fat32fscore, fat32vnode->firstCluster, 0);
+    Index32 currentClusterIndex = INVALID_INDEX32, mappedClusterIndex = INVALID_INDEX32;   //Physical and logical cluster of entries
 
-    DEBUG_ASSERT_SILENT(dirNode->dirPart.childrenNum == FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM);
-    dirNode->dirPart.childrenNum = 0;
     while (true) {
         __fat32_vNode_doReadData(vnode, currentPointer, entriesBuffer, sizeof(FAT32UnknownTypeEntry), clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
@@ -753,6 +856,11 @@ static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
         }
         
         entriesLength = fat32_directoryEntry_getEntriesLength(entriesBuffer);
+        if (fat32_directoryEntry_isDeleted(entriesBuffer)) {
+            currentPointer += entriesLength;
+            continue;
+        }
+
         __fat32_vNode_doReadData(vnode, currentPointer, entriesBuffer, entriesLength, clusterBuffer);
         ERROR_GOTO_IF_ERROR(0);
         
@@ -761,6 +869,17 @@ static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
 
         DEBUG_ASSERT_SILENT(type != FS_ENTRY_TYPE_DIRECTORY || size == 0);
 
+        found = name == NULL || (entryName.length == nameLength && (type == FS_ENTRY_TYPE_DIRECTORY) == isDirectory && memory_memcmp(entryName.data, name, nameLength) == 0);
+
+        if (DIVIDE_ROUND_DOWN(currentPointer, clusterSize) != mappedClusterIndex) {
+            mappedClusterIndex = DIVIDE_ROUND_DOWN(currentPointer, clusterSize);
+            currentClusterIndex = fat32_mapCluster(&fat32vnode->clusterMap, mappedClusterIndex, NULL);
+            if (currentClusterIndex == INVALID_INDEX32) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+        }
+
         DirectoryEntry newDirEntry = (DirectoryEntry) {
             .name = entryName.data,
             .type = type,
@@ -770,19 +889,22 @@ static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
             .pointsTo = (Index64)firstCluster
         };
 
-        fsnode_create(&newDirEntry, INFINITE, &fsnodeAttribute, &dirNode->node);
+        if (found) {
+            fsnode_create(&newDirEntry, INFINITE, &fsnodeAttribute, &dirNode->node);
+            ERROR_GOTO_IF_ERROR(0);
 
-        Size stepClusterNum = DIVIDE_ROUND_DOWN(currentPointer + entriesLength, clusterSize) - DIVIDE_ROUND_DOWN(currentPointer, clusterSize);
-        currentPointer += entriesLength;
-        if (stepClusterNum != 0) {
-            currentClusterIndex = fat32_getCluster(fat32fscore, currentClusterIndex, stepClusterNum);
+            if (name != NULL) { //Only child named is needed
+                break;
+            }
         }
+
+        currentPointer += entriesLength;
     }
 
     mm_free(clusterBuffer);
     mm_free(entriesBuffer);
 
-    return;
+    return found;
     ERROR_FINAL_BEGIN(0);
     if (clusterBuffer != NULL) {
         mm_free(clusterBuffer);
@@ -791,5 +913,13 @@ static void __fat32_vNode_readDirectoryEntries(vNode* vnode) {
     if (entriesBuffer != NULL) {
         mm_free(entriesBuffer);
     }
-    return;
+    return false;
+}
+
+static void __fat32_vNode_markEntriesDeleted(vNode* vnode, Index64 begin, FAT32UnknownTypeEntry* entries, Size entriesLength, void* clusterBuffer) {
+    for (int i = 0; i < entriesLength / sizeof(FAT32UnknownTypeEntry); ++i) {
+        *((Uint8*)&entries[i]) = FAT32_DIRECTORY_ENTRY_DELETED_MARK;
+    }
+
+    __fat32_vNode_doWriteData(vnode, begin, entries, entriesLength, clusterBuffer); //Error passthrough
 }
\ No newline at end of file
@@ -3,20 +3,32 @@
 #include<devices/blockDevice.h>
 #include<devices/memoryBlockDevice.h>
 #include<fs/devfs/devfs.h>
+#include<fs/epoll.h>
 #include<fs/ext2/ext2.h>
 #include<fs/fat32/fat32.h>
 #include<fs/fsEntry.h>
 #include<fs/fsIdentifier.h>
 #include<fs/path.h>
+#include<fs/poll.h>
+#include<fs/tmpfs/pageTree.h>
+#include<fs/tmpfs/tmpfs.h>
+#include<fs/tmpfs/vnode.h>
+#include<interrupt/IDT.h>
 #include<kit/util.h>
 #include<memory/paging.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
+#include<multitask/pipe.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
 #include<structs/hashTable.h>
+#include<system/pageTable.h>
+#include<time/timer.h>
+#include<algorithms.h>
 #include<cstring.h>
 #include<error.h>
 
-FS* fs_rootFS = NULL, * fs_devFS = NULL, * fs_ext2;
+FS* fs_rootFS = NULL, * fs_devFS = NULL, * fs_tmpFS = NULL, * fs_ext2;
 
 typedef struct {
     void  (*init)();
@@ -25,6 +37,18 @@ typedef struct {
     void  (*close)(FS* fs);
 } __FileSystemSupport;
 
+static fsNode* __fs_createAndLookup(vNode* dirVnode, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __fs_updateAccessTime(File* file);
+
+static void __fs_updateModifyTime(File* file);
+
+static Size __fs_fileTransferFromTmpfs(File* to, File* from, TmpfsVnode* tmpfsVnode, Size n);
+
+static Size __fs_fileTransferByBuffer(File* to, File* from, Size n);
+
+static Uint8 _fs_zeroPage[PAGE_SIZE];   //Written out for holes of tmpfs file
+
 static __FileSystemSupport _supports[FS_TYPE_NUM] = {
     [FS_TYPE_FAT32] = {
         .init       = fat32_init,
@@ -43,10 +67,21 @@ static __FileSystemSupport _supports[FS_TYPE_NUM] = {
         .checkType  = devfs_checkType,
         .open       = devfs_open,
         .close      = devfs_close
+    },
+    [FS_TYPE_TMPFS] = {
+        .init       = tmpfs_init,
+        .checkType  = tmpfs_checkType,
+        .open       = tmpfs_open,
+        .close      = tmpfs_close
     }
 };
 
 void fs_init() {
+    fsnode_init();
+    fscore_init();
+    vNode_init();
+    epoll_init();
+
     if (blockDevice_bootFromDevice == NULL) {
         ERROR_THROW(ERROR_ID_STATE_ERROR, 0);
     }
@@ -109,8 +144,21 @@ void fs_init() {
     fs_open(fs_devFS, NULL);
     ERROR_GOTO_IF_ERROR(0);
 
+    _supports[FS_TYPE_TMPFS].init();
+    ERROR_GOTO_IF_ERROR(0);
+
+    fs_tmpFS = mm_allocate(sizeof(FS));
+    if (fs_tmpFS == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    _supports[FS_TYPE_TMPFS].open(fs_tmpFS, NULL);  //Never found by fs_checkType, there is no device to check
+    ERROR_GOTO_IF_ERROR(0);
+
     fsIdentifier devfsMountPoint;
     fsIdentifier ext2MountPoint;
+    fsIdentifier tmpfsMountPoint;
 
     FScore* rootFScore = fs_rootFS->fscore;
     vNode* rootFSrootVnode = fscore_getVnode(rootFScore, rootFScore->rootFSnode, false);  //Refer rootFScore->rootFSnode
@@ -118,20 +166,28 @@ void fs_init() {
     ERROR_GOTO_IF_ERROR(0);
     fsIdentifier_initStruct(&ext2MountPoint, rootFSrootVnode, "/mnt", true);    //TODO: fails if mnt not exist
     ERROR_GOTO_IF_ERROR(0);
+    fsIdentifier_initStruct(&tmpfsMountPoint, rootFSrootVnode, "/tmp", true);   //TODO: fails if tmp not exist
+    ERROR_GOTO_IF_ERROR(0);
 
     FScore* devFScore = fs_devFS->fscore;
     vNode* devFSrootVnode = fscore_getVnode(devFScore, devFScore->rootFSnode, false);
-    fscore_rawMount(rootFScore, &devfsMountPoint, devFSrootVnode, EMPTY_FLAGS);
+    fscore_rawMount(rootFScore, &devfsMountPoint, devFSrootVnode, FSCORE_FLAGS_DEFAULT);
     ERROR_GOTO_IF_ERROR(0);
     
     FScore* ext2FScore = fs_ext2->fscore;
     vNode* ext2rootVnode = fscore_getVnode(ext2FScore, ext2FScore->rootFSnode, false);
-    fscore_rawMount(rootFScore, &ext2MountPoint, ext2rootVnode, EMPTY_FLAGS);
+    fscore_rawMount(rootFScore, &ext2MountPoint, ext2rootVnode, FSCORE_FLAGS_DEFAULT);
+    ERROR_GOTO_IF_ERROR(0);
+
+    FScore* tmpFScore = fs_tmpFS->fscore;
+    vNode* tmpFSrootVnode = fscore_getVnode(tmpFScore, tmpFScore->rootFSnode, false);
+    fscore_rawMount(rootFScore, &tmpfsMountPoint, tmpFSrootVnode, FSCORE_FLAGS_DEFAULT);
     ERROR_GOTO_IF_ERROR(0);
 
     fscore_releaseVnode(rootFSrootVnode);
     fscore_releaseVnode(devFSrootVnode);
     fscore_releaseVnode(ext2rootVnode);
+    fscore_releaseVnode(tmpFSrootVnode);
 
     return;
     ERROR_FINAL_BEGIN(0);
@@ -146,6 +202,10 @@ void fs_init() {
     if (fs_devFS != NULL) {
         mm_free(fs_devFS);
     }
+
+    if (fs_tmpFS != NULL) {
+        mm_free(fs_tmpFS);
+    }
 }
 
 FStype fs_checkType(BlockDevice* device) {
@@ -167,8 +227,6 @@ void fs_close(FS* fs) {
 }
 
 File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags) {
-    String absolutePathStr, dirAbsolurePath, basename;
-    fsIdentifier dirIdentifier;
     fsNode* dirFSnode = NULL, * targetNode = NULL;
     FScore* finalFScore = NULL;
     vNode* dirVnode = NULL, * targetVnode = NULL;
@@ -176,88 +234,73 @@ File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags) {
 
     bool isDirectory = TEST_FLAGS(flags, FCNTL_OPEN_DIRECTORY);
 
-    string_initStructStr(&absolutePathStr, absolutePath);
-    ERROR_GOTO_IF_ERROR(0);
-
-    string_initStruct(&dirAbsolurePath);
-    ERROR_GOTO_IF_ERROR(0);
-    path_dirname(&absolutePathStr, &dirAbsolurePath);
-    ERROR_GOTO_IF_ERROR(0);
-
-    string_initStruct(&basename);
-    ERROR_GOTO_IF_ERROR(0);
-    path_basename(&absolutePathStr, &basename);
-    ERROR_GOTO_IF_ERROR(0);
-
-    FScore* rootFScore = fs_rootFS->fscore;
-    vNode* rootFSrootVnode = fscore_getVnode(rootFScore, rootFScore->rootFSnode, false);    //Refer rootFSrootVnode->fsNode once
-    DEBUG_ASSERT_SILENT(rootFSrootVnode != NULL);
-    
-    fsIdentifier_initStruct(&dirIdentifier, rootFSrootVnode, dirAbsolurePath.data, true);
-    
-    dirFSnode = fscore_getFSnode(rootFScore, &dirIdentifier, &finalFScore, true);   //Refer dirFSnode once
-
-    dirVnode = fscore_getVnode(finalFScore, dirFSnode, true);
-    if (dirVnode == NULL) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
+    Size pathLength = cstring_strlen(absolutePath);
+    while (pathLength > 1 && absolutePath[pathLength - 1] == PATH_SEPERATOR) {  //Trailing separators name nothing
+        --pathLength;
     }
 
-    if (dirFSnode != dirVnode->fsNode) {    //The fsNode we found is mounted, transfer pointer and refer count to actual one
-        fsnode_derefer(dirFSnode);
-        dirFSnode = dirVnode->fsNode;
-        fsnode_refer(dirFSnode);
+    Index64 basenameBegin = pathLength;
+    while (basenameBegin > 0 && absolutePath[basenameBegin - 1] != PATH_SEPERATOR) {
+        --basenameBegin;
     }
+    ConstCstring basename = absolutePath + basenameBegin;
+    Size basenameLength = pathLength - basenameBegin;
 
-    finalFScore = dirVnode->fscore;
-    
-    bool needCreate = false;
-    targetNode = fsnode_lookup(dirFSnode, basename.data, isDirectory, true);    //Refer targetNode once (if found)
-    if (targetNode == NULL) {
-        ERROR_ASSERT_ANY();
-        ERROR_CHECKPOINT({
-                ERROR_GOTO(0);
-            }, 
-            (ERROR_ID_NOT_FOUND, {
-                needCreate = true;
-                ERROR_CLEAR();
-                break;
-            })
-        );
-    }
-
-    if (needCreate) {
-        Timestamp timestamp;
-        time_getTimestamp(&timestamp);
-        FSnodeAttribute attr;
-        attr.createTime = timestamp.second;
-        attr.lastAccessTime = timestamp.second;
-        attr.lastModifyTime = timestamp.second;
-
-        DirectoryEntry newEntry = (DirectoryEntry) {
-            .name = basename.data,
-            .type = isDirectory ? FS_ENTRY_TYPE_DIRECTORY : FS_ENTRY_TYPE_FILE,
-            .mode = 0,  //TODO: mode not used yet
-            .vnodeID = DIRECTORY_ENTRY_VNDOE_ID_ANY,
-            .size = DIRECTORY_ENTRY_SIZE_ANY,
-            .pointsTo = DIRECTORY_ENTRY_POINTS_TO_ANY
-        };
-
-        vNode_addDirectoryEntry(dirVnode, &newEntry, &attr);
-        ERROR_GOTO_IF_ERROR(0);
+    FScore* rootFScore = fs_rootFS->fscore;
+    if (basenameLength == 0 || (basenameLength == 1 && basename[0] == '.') || (basenameLength == 2 && basename[0] == '.' && basename[1] == '.')) {
+        targetNode = fscore_walk(rootFScore, rootFScore->rootFSnode, absolutePath, pathLength, isDirectory, true, &finalFScore);    //Refer targetNode once, nothing to create
+        if (targetNode == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+    } else {
+        dirFSnode = fscore_walk(rootFScore, rootFScore->rootFSnode, absolutePath, basenameBegin, true, true, &finalFScore);    //Refer dirFSnode once
+        if (dirFSnode == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
 
-        dirVnode->fsNode->attribute.lastModifyTime = timestamp.second;  //TODO: Write this back to directory data
+        dirVnode = fscore_getVnode(finalFScore, dirFSnode, false);
+        if (dirVnode == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
 
-        targetNode = fsnode_lookup(dirFSnode, basename.data, isDirectory, true);    //Refer targetNode once (if found)
+        bool needCreate = false;
+        targetNode = fsnode_lookupN(dirFSnode, basename, basenameLength, isDirectory, true);    //Refer targetNode once (if found)
         if (targetNode == NULL) {
             ERROR_ASSERT_ANY();
-            ERROR_GOTO(0);
+            ERROR_CHECKPOINT({
+                    ERROR_GOTO(0);
+                }, 
+                (ERROR_ID_NOT_FOUND, {
+                    needCreate = true;
+                    ERROR_CLEAR();
+                    break;
+                })
+            );
+        }
+
+        if (needCreate) {
+            targetNode = __fs_createAndLookup(dirVnode, basename, basenameLength, isDirectory); //Refer targetNode once
+            if (targetNode == NULL) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
         }
     }
 
     DEBUG_ASSERT_SILENT(targetNode != NULL);
 
-    targetVnode = fscore_getVnode(finalFScore, targetNode, false);
+    targetVnode = fscore_getVnode(finalFScore, targetNode, true);
+    if (targetVnode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+    finalFScore = targetVnode->fscore;
+
+    fscore_releaseFSnode(targetNode);   //Opened vnode keeps its node
+    targetNode = NULL;
     
     ret = fscore_rawOpenFSentry(finalFScore, targetVnode, flags);
     if (ret == NULL) {
@@ -265,13 +308,13 @@ File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags) {
         ERROR_GOTO(0);
     }
 
-    fscore_releaseVnode(dirVnode);
-    fscore_releaseFSnode(dirFSnode);
-    fsIdentifier_clearStruct(&dirIdentifier);
-    fscore_releaseVnode(rootFSrootVnode);
-    string_clearStruct(&basename);
-    string_clearStruct(&dirAbsolurePath);
-    string_clearStruct(&absolutePathStr);
+    if (dirVnode != NULL) {
+        fscore_releaseVnode(dirVnode);
+    }
+
+    if (dirFSnode != NULL) {
+        fscore_releaseFSnode(dirFSnode);
+    }
     
     return ret;
     ERROR_FINAL_BEGIN(0);
@@ -283,6 +326,10 @@ File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags) {
         fscore_releaseVnode(targetVnode);
     }
 
+    if (targetNode != NULL) {
+        fscore_releaseFSnode(targetNode);
+    }
+
     if (dirVnode != NULL) {
         fscore_releaseVnode(dirVnode);
     }
@@ -291,22 +338,6 @@ File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags) {
         fscore_releaseFSnode(dirFSnode);
     }
 
-    if (fsIdentifier_isActive(&dirIdentifier)) {
-        fsIdentifier_clearStruct(&dirIdentifier);
-    }
-
-    if (string_isAvailable(&basename)) {
-        string_clearStruct(&basename);
-    }
-
-    if (string_isAvailable(&dirAbsolurePath)) {
-        string_clearStruct(&dirAbsolurePath);
-    }
-
-    if (string_isAvailable(&absolutePathStr)) {
-        string_clearStruct(&absolutePathStr);
-    }
-
     return NULL;
 }
 
@@ -314,6 +345,8 @@ void fs_fileClose(File* file) {
     vNode* vnode = file->vnode;
     FScore* fscore = vnode->fscore;
 
+    epoll_closeFSentry(file);
+
     fscore_rawCloseFSentry(fscore, file);
     ERROR_GOTO_IF_ERROR(0);
 
@@ -324,7 +357,7 @@ void fs_fileClose(File* file) {
     ERROR_FINAL_BEGIN(0);
 }
 
-void fs_fileRead(File* file, void* buffer, Size n) {
+Size fs_fileRead(File* file, void* buffer, Size n) {
     if (FCNTL_OPEN_EXTRACL_ACCESS_MODE(file->flags) == FCNTL_OPEN_WRITE_ONLY) {
         ERROR_THROW(ERROR_ID_PERMISSION_ERROR, 0);
     }
@@ -333,21 +366,18 @@ void fs_fileRead(File* file, void* buffer, Size n) {
         ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 0);
     }
 
-    fsEntry_rawRead(file, buffer, n);
+    Size ret = fsEntry_rawRead(file, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
-    fsEntry_rawSeek(file, file->pointer + n);
+    fsEntry_rawSeek(file, file->pointer + ret);
 
-    if (TEST_FLAGS_FAIL(file->flags, FCNTL_OPEN_NOATIME)) {
-        Timestamp timestamp;
-        time_getTimestamp(&timestamp);
-        file->vnode->fsNode->attribute.lastAccessTime = timestamp.second;   //TODO: Write this back to directory data
-    }
+    __fs_updateAccessTime(file);
 
-    return;
+    return ret;
     ERROR_FINAL_BEGIN(0);
+    return 0;
 }
 
-void fs_fileWrite(File* file, const void* buffer, Size n) {
+Size fs_fileWrite(File* file, const void* buffer, Size n) {
     if (FCNTL_OPEN_EXTRACL_ACCESS_MODE(file->flags) == FCNTL_OPEN_READ_ONLY) {
         ERROR_THROW(ERROR_ID_PERMISSION_ERROR, 0);
     }
@@ -356,18 +386,69 @@ void fs_fileWrite(File* file, const void* buffer, Size n) {
         fs_fileSeek(file, 0, FS_FILE_SEEK_END);
     }
 
-    fsEntry_rawWrite(file, buffer, n);
+    Size ret = fsEntry_rawWrite(file, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
-    fsEntry_rawSeek(file, file->pointer + n);
+    fsEntry_rawSeek(file, file->pointer + ret);
 
-    if (TEST_FLAGS_FAIL(file->flags, FCNTL_OPEN_NOATIME)) {
-        Timestamp timestamp;
-        time_getTimestamp(&timestamp);
-        file->vnode->fsNode->attribute.lastAccessTime = timestamp.second;   //TODO: Write this back to directory data
+    __fs_updateModifyTime(file);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+Size fs_fileTransfer(File* to, File* from, Size n) {
+    if (FCNTL_OPEN_EXTRACL_ACCESS_MODE(from->flags) == FCNTL_OPEN_WRITE_ONLY || FCNTL_OPEN_EXTRACL_ACCESS_MODE(to->flags) == FCNTL_OPEN_READ_ONLY) {
+        ERROR_THROW(ERROR_ID_PERMISSION_ERROR, 0);
     }
 
-    return;
+    if (from->vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY || to->vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Size fromSize = from->vnode->size;
+    if (fromSize != INFINITE) { //Pipes and devices have no end
+        n = algorithms_umin64(n, from->pointer >= fromSize ? 0 : fromSize - from->pointer);
+    }
+
+    Pipe* fromPipe = pipe_getFromFSentry(from), * toPipe = pipe_getFromFSentry(to);
+    if (fromPipe != NULL && fromPipe == toPipe) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    if (from->vnode == to->vnode && from->vnode->fsNode->entry.type == FS_ENTRY_TYPE_FILE && n > 0) {  //Same file through different entries, overlapping ranges would read data just written
+        Index64 toBegin = TEST_FLAGS(to->flags, FCNTL_OPEN_APPEND) ? to->vnode->size : to->pointer;
+        if (from->pointer < toBegin + n && toBegin < from->pointer + n) {
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+        }
+    }
+
+    Size ret = 0;
+    TmpfsVnode* tmpfsVnode = NULL;
+    if (fromPipe != NULL && toPipe != NULL) {
+        ret = pipe_transferPipe(fromPipe, from, toPipe, to, n);
+    } else if (fromPipe != NULL) {
+        ret = pipe_transferTo(fromPipe, from, to, n);
+    } else if (toPipe != NULL) {
+        ret = pipe_transferFrom(toPipe, to, from, n);
+    } else if ((tmpfsVnode = tmpfs_vNode_getFromFSentry(from)) != NULL) {
+        ret = __fs_fileTransferFromTmpfs(to, from, tmpfsVnode, n);
+    } else {
+        ret = __fs_fileTransferByBuffer(to, from, n);
+    }
+    ERROR_GOTO_IF_ERROR(0);
+
+    return ret;
     ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+PollEvents fs_filePoll(File* file, PollTable* table) {
+    if (file->operations->poll == NULL) {
+        return POLL_EVENTS_DEFAULT;
+    }
+
+    return fsEntry_rawPoll(file, table);
 }
 
 Index64 fs_fileSeek(File* file, Int64 offset, Uint8 begin) {
@@ -430,9 +511,177 @@ void fs_fileStat(File* file, FS_fileStat* stat) {
         stat->rDevice = vnode->deviceID;
     }
     stat->size = vnode->size;
-    stat->blockSize = POWER_2(fscore->blockDevice->device.granularity);
+    stat->blockSize = fscore->blockDevice == NULL ? PAGE_SIZE : POWER_2(fscore->blockDevice->device.granularity);   //Memory backed fs has no device
     stat->blocks = vnode->tokenSpaceSize / stat->blockSize;
     stat->accessTime.second = attribute->lastAccessTime;
     stat->modifyTime.second = attribute->lastModifyTime;
     stat->createTime.second = attribute->createTime;
+}
+
+void fs_syncDaemon() {
+    idt_enableInterrupt();
+    while (true) {
+        timer_sleep(FS_SYNC_INTERVAL, TIME_UNIT_SECOND);
+        vNode_syncDirtyAttributes();
+    }
+}
+
+void fs_startSyncDaemon() {
+    process_createThread(schedule_getRootProcess(), fs_syncDaemon);
+}
+
+static void __fs_updateAccessTime(File* file) {
+    if (TEST_FLAGS(file->flags, FCNTL_OPEN_NOATIME)) {
+        return;
+    }
+
+    vNode* vnode = file->vnode;
+    FSnodeAttribute* attribute = &vnode->fsNode->attribute;
+    Timestamp timestamp;
+    time_getCoarseTimestamp(&timestamp);    //Second precision is all attribute keeps
+
+    if (TEST_FLAGS(vnode->fscore->flags, FSCORE_FLAGS_RELATIME) && attribute->lastAccessTime > attribute->lastModifyTime && timestamp.second < attribute->lastAccessTime + FSCORE_RELATIME_INTERVAL) {
+        return;
+    }
+
+    if (attribute->lastAccessTime == timestamp.second) {
+        return;
+    }
+
+    attribute->lastAccessTime = timestamp.second;
+    vNode_markAttributeDirty(vnode);
+}
+
+static void __fs_updateModifyTime(File* file) {
+    vNode* vnode = file->vnode;
+    FSnodeAttribute* attribute = &vnode->fsNode->attribute;
+    Timestamp timestamp;
+    time_getCoarseTimestamp(&timestamp);
+
+    if (attribute->lastModifyTime == timestamp.second) {
+        return;
+    }
+
+    attribute->lastModifyTime = timestamp.second;
+    vNode_markAttributeDirty(vnode);
+}
+
+static fsNode* __fs_createAndLookup(vNode* dirVnode, ConstCstring name, Size nameLength, bool isDirectory) {
+    String nameStr;
+    string_initStructStrN(&nameStr, name, nameLength); //Only creation needs a NULL-terminated name
+    ERROR_GOTO_IF_ERROR(0);
+
+    Timestamp timestamp;
+    time_getTimestamp(&timestamp);
+    FSnodeAttribute attr;
+    attr.createTime = timestamp.second;
+    attr.lastAccessTime = timestamp.second;
+    attr.lastModifyTime = timestamp.second;
+
+    DirectoryEntry newEntry = (DirectoryEntry) {
+        .name = nameStr.data,
+        .type = isDirectory ? FS_ENTRY_TYPE_DIRECTORY : FS_ENTRY_TYPE_FILE,
+        .mode = 0,  //TODO: mode not used yet
+        .vnodeID = DIRECTORY_ENTRY_VNDOE_ID_ANY,
+        .size = DIRECTORY_ENTRY_SIZE_ANY,
+        .pointsTo = DIRECTORY_ENTRY_POINTS_TO_ANY
+    };
+
+    vNode_addDirectoryEntry(dirVnode, &newEntry, &attr);
+    ERROR_GOTO_IF_ERROR(0);
+
+    dirVnode->fsNode->attribute.lastModifyTime = timestamp.second;
+    vNode_markAttributeDirty(dirVnode);
+
+    fsNode* ret = fsnode_lookupN(dirVnode->fsNode, name, nameLength, isDirectory, true);   //Refer ret once (if found)
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    string_clearStruct(&nameStr);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    if (string_isAvailable(&nameStr)) {
+        string_clearStruct(&nameStr);
+    }
+
+    return NULL;
+}
+
+static Size __fs_fileTransferFromTmpfs(File* to, File* from, TmpfsVnode* tmpfsVnode, Size n) {
+    Size ret = 0;
+    while (ret < n) {
+        Index64 begin = from->pointer;
+        Size pageOffset = begin % PAGE_SIZE, chunkByteN = algorithms_umin64(n - ret, PAGE_SIZE - pageOffset);
+
+        void* frame = tmpfs_vNode_referFrame(tmpfsVnode, begin / PAGE_SIZE);   //Referred, stays valid even if file truncated meanwhile
+        const void* data = frame == NULL ? _fs_zeroPage : PAGING_CONVERT_KERNEL_MEMORY_P2V(frame) + pageOffset;
+        Size writeByteN = fs_fileWrite(to, data, chunkByteN);
+        if (frame != NULL) {
+            tmpfsPageTree_releaseFrame(frame);
+        }
+        ERROR_GOTO_IF_ERROR(0);
+
+        fsEntry_rawSeek(from, begin + writeByteN);
+        ret += writeByteN;
+
+        if (writeByteN < chunkByteN) {
+            break;
+        }
+    }
+
+    if (ret > 0) {
+        __fs_updateAccessTime(from);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    if (ret > 0) {  //Report bytes already written, error shows up again in next transfer
+        __fs_updateAccessTime(from);
+        ERROR_CLEAR();
+    }
+    return ret;
+}
+
+static Size __fs_fileTransferByBuffer(File* to, File* from, Size n) {
+    Size ret = 0, readByteN = 0, writeByteN = 0;
+    void* buffer = mm_allocatePages(FS_FILE_TRANSFER_BUFFER_SIZE / PAGE_SIZE);
+    if (buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    while (ret < n) {
+        Size chunkByteN = algorithms_umin64(n - ret, FS_FILE_TRANSFER_BUFFER_SIZE);
+        readByteN = fs_fileRead(from, buffer, chunkByteN);
+        ERROR_GOTO_IF_ERROR(1);
+
+        if (readByteN == 0) {
+            break;
+        }
+
+        writeByteN = fs_fileWrite(to, buffer, readByteN);
+        if (writeByteN < readByteN) {   //Data not written goes back, source is never a pipe here
+            fs_fileSeek(from, -(Int64)(readByteN - writeByteN), FS_FILE_SEEK_CURRENT);
+        }
+        ERROR_GOTO_IF_ERROR(1);
+        ret += writeByteN;
+
+        if (writeByteN < readByteN || readByteN < chunkByteN) {
+            break;
+        }
+    }
+
+    mm_freePages(buffer);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_freePages(buffer);
+    ERROR_FINAL_BEGIN(0);
+    if (ret > 0) {  //Report bytes already written, error shows up again in next transfer
+        ERROR_CLEAR();
+    }
+    return ret;
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ void fsEntry_initStruct(fsEntry* entry, vNode* vnode, fsEntryOperations* operati
     entry->pointer = 0;
     entry->vnode = vnode;
     entry->operations = operations;
+    linkedList_initStruct(&entry->epollItems);
 }
 
 void fsEntry_clearStruct(fsEntry* entry) {
@@ -36,7 +37,7 @@ Index64 fsEntry_genericSeek(fsEntry* entry, Index64 seekTo) {
     return entry->pointer = seekTo;
 }
 
-void fsEntry_genericRead(fsEntry* entry, void* buffer, Size n) {
+Size fsEntry_genericRead(fsEntry* entry, void* buffer, Size n) {
     vNode* vnode = entry->vnode;
 
     if (entry->pointer + n > vnode->size) {
@@ -46,11 +47,12 @@ void fsEntry_genericRead(fsEntry* entry, void* buffer, Size n) {
     vNode_rawReadData(vnode, entry->pointer, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
 
-    return;
+    return n;
     ERROR_FINAL_BEGIN(0);
+    return 0;
 }
 
-void fsEntry_genericWrite(fsEntry* entry, const void* buffer, Size n) {
+Size fsEntry_genericWrite(fsEntry* entry, const void* buffer, Size n) {
     vNode* vnode = entry->vnode;
 
     if (entry->pointer + n > vnode->size) {
@@ -61,19 +63,22 @@ void fsEntry_genericWrite(fsEntry* entry, const void* buffer, Size n) {
     vNode_rawWriteData(vnode, entry->pointer, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
 
-    return;
+    return n;
     ERROR_FINAL_BEGIN(0);
+    return 0;
 }
 
 fsEntry* fsEntry_copy(fsEntry* entry) {
-    fsEntry* ret = mm_allocate(sizeof(fsEntry));
+    vNode* vnode = entry->vnode;
+    fsEntry* ret = fscore_rawOpenFSentry(vnode->fscore, vnode, entry->flags);  //Open through fscore, it may track opened entries (e.g. pipe ends)
     if (ret == NULL) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
     }
 
-    memory_memcpy(ret, entry, sizeof(fsEntry));
-    REF_COUNTER_REFER(ret->vnode->refCounter);
+    ret->mode = entry->mode;
+    ret->pointer = entry->pointer;
+    REF_COUNTER_REFER(vnode->refCounter);
 
     return ret;
     ERROR_FINAL_BEGIN(0);
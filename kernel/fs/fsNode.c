@@ -1,5 +1,6 @@
 #include<fs/fsNode.h>
 
+#include<algorithms.h>
 #include<fs/directoryEntry.h>
 #include<fs/path.h>
 #include<fs/vnode.h>
@@ -22,10 +23,39 @@ static inline bool __fsnode_isReadyToRelease(fsNode* node) {
     return REF_COUNTER_CHECK(node->refCounter, 0);
 }
 
-static inline Object __fsnode_nameHash(ConstCstring name, bool isDirectory) {
-    return cstring_strhash(name) ^ VAL_LEFT_SHIFT((Uint64)isDirectory, 63);
+static HashTable _fsnode_dcache;    //Children of all directories, keyed by parent, name and type
+static SinglyLinkedList _fsnode_dcacheChains[FSNODE_DCACHE_HASH_CHAIN_SIZE];
+static LinkedList _fsnode_lruList;  //Directories with known children, least recently used first
+static Size _fsnode_cachedNodeNum = 0;
+static Spinlock _fsnode_dcacheLock = SPINLOCK_UNLOCKED;
+
+static inline Object __fsnode_dcacheKey(fsNode* parent, ConstCstring name, Size nameLength, bool isDirectory) {
+    Object hash = 0xCBF29CE484222325ull ^ ((Object)parent * 0x9E3779B97F4A7C15ull);  //Same name in different directories goes to different chains
+    for (int i = 0; i < nameLength; ++i) {
+        hash ^= (Object)name[i];
+        hash *= 0x00000100000001B3ull;
+    }
+    return hash ^ VAL_LEFT_SHIFT((Uint64)isDirectory, 63);
 }
 
+static fsNode* __fsnode_dcacheFind(fsNode* parent, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __fsnode_dcacheRemove(fsNode* node);
+
+static void __fsnode_dcacheUnhash(fsNode* node);
+
+static void __fsnode_dcacheDetachChildren(fsNode* node);
+
+static void __fsnode_forgetDetachedChildren(fsNode* node);
+
+static void __fsnode_shrinkDcache(fsNode* keep);
+
+static fsNode* __fsnode_lookupCached(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __fsnode_lookupDirectoryEntry(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __fsnode_pinChildren(fsNode* node);
+
 static void __fsnode_doGetAbsolutePath(fsNode* node, String* pathOut);
 
 static void __fsnodeDirPart_initStruct(fsNodeDirPart* part);
@@ -38,6 +68,11 @@ static void __dirfsNode_addChildNode(DirFSnode* dirNode, fsNode* child);
 
 static fsNode* __dirfsNode_removeChildNode(DirFSnode* dirNode, ConstCstring name, bool isDirectory);
 
+void fsnode_init() {
+    hashTable_initStruct(&_fsnode_dcache, FSNODE_DCACHE_HASH_CHAIN_SIZE, _fsnode_dcacheChains, hashTable_defaultHashFunc);
+    linkedList_initStruct(&_fsnode_lruList);
+}
+
 void fsnodeAttribute_initDefault(FSnodeAttribute* attribute) {
     attribute->uid = 0;
     attribute->gid = 0;
@@ -51,6 +86,16 @@ fsNode* fsnode_create(DirectoryEntry* entry, Size nameN, FSnodeAttribute* attrib
     DEBUG_ASSERT_SILENT(entry->type != FS_ENTRY_TYPE_DUMMY);
     
     fsNode* ret = NULL;
+    if (parent != NULL && FSNODE_GET_DIRFSNODE(parent)->dirPart.partial) { //Children looked up by name are met again when all children are read
+        Size nameLength = algorithms_umin64(nameN, cstring_strlen(entry->name));
+        spinlock_lock(&_fsnode_dcacheLock);
+        ret = __fsnode_dcacheFind(parent, entry->name, nameLength, entry->type == FS_ENTRY_TYPE_DIRECTORY);
+        spinlock_unlock(&_fsnode_dcacheLock);
+        if (ret != NULL) {
+            return ret;
+        }
+    }
+
     if (entry->type == FS_ENTRY_TYPE_DIRECTORY) {
         DirFSnode* dirNode = mm_allocate(sizeof(DirFSnode));
         if (dirNode == NULL) {
@@ -99,29 +144,35 @@ bool fsnode_derefer(fsNode* node) {
 }
 
 fsNode* fsnode_lookup(fsNode* node, ConstCstring name, bool isDirectory, bool autoRead) {
+    return fsnode_lookupN(node, name, cstring_strlen(name), isDirectory, autoRead);
+}
+
+fsNode* fsnode_lookupN(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory, bool autoRead) {
     DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
 
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(node);
-    if (dirNode->dirPart.childrenNum == FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM) { //Children not read yet
-        if (autoRead) {
-            fsnode_readDirectoryEntries(node);
+    fsNode* ret = __fsnode_lookupCached(node, name, nameLength, isDirectory);   //Referred if found
+    if (ret == NULL && !fsnode_isChildrenKnown(node)) { //Child not read yet
+        if (!autoRead) {
+            ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+        }
+
+        if (node->vnode->operations->lookupDirectoryEntry != NULL) {
+            __fsnode_lookupDirectoryEntry(node, name, nameLength, isDirectory);
         } else {
-            return NULL;
+            fsnode_readDirectoryEntries(node);
         }
+        ERROR_GOTO_IF_ERROR(0);
+
+        ret = __fsnode_lookupCached(node, name, nameLength, isDirectory);
     }
 
-    fsNode* ret = NULL;
-    spinlock_lock(&node->lock);
-    Object hash = __fsnode_nameHash(name, isDirectory);
-    HashChainNode* hashNode = hashTable_find(&dirNode->dirPart.childrenHash, hash);
-    if (hashNode == NULL) {
-        return NULL;
+    if (ret == NULL) {  //All children are known, so a miss is a negative entry
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
     }
-    
-    ret = HOST_POINTER(hashNode, fsNode, childHashNode);
-    spinlock_unlock(&node->lock);
-    fsnode_refer(ret);  //Refer returned node
+
     return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
 }
 
 void fsnode_setVnode(fsNode* node, vNode* vnode) {
@@ -155,12 +206,15 @@ void fsnode_setMount(fsNode* node, vNode* mountVnode) {
         return;
     }
 
+    vNode* oldMountVnode = node->mount;
     node->mount = mountVnode;
     if (mountVnode == NULL) {
+        oldMountVnode->fsNode->mounted = false;
         fsnode_derefer(node);
-        fsnode_releaseVnode(mountVnode->fscore, mountVnode->fsNode);
+        fsnode_releaseVnode(oldMountVnode->fscore, oldMountVnode->fsNode);
     } else {
         fsnode_requestVnode(mountVnode->fscore, mountVnode->fsNode);
+        mountVnode->fsNode->mounted = true;
         fsnode_refer(node);
     }
 
@@ -191,6 +245,7 @@ bool fsnode_releaseVnode(FScore* fscore, fsNode* node) {
     if (REF_COUNTER_DEREFER(node->vNodeRefCounter) > 0) {
         fsnode_derefer(node);
     } else {
+        vNode_clearAttributeDirty(node->vnode);
         fscore_rawCloseVnode(fscore, node->vnode);
         fsnode_setVnode(node, NULL); //Derefer node here
     }
@@ -199,10 +254,25 @@ bool fsnode_releaseVnode(FScore* fscore, fsNode* node) {
 void fsnode_readDirectoryEntries(fsNode* node) {
     DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
     DEBUG_ASSERT_SILENT(node->vnode != NULL);
-    DEBUG_ASSERT_SILENT(FSNODE_GET_DIRFSNODE(node)->dirPart.childrenNum == FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM);
+
+    fsNodeDirPart* part = &FSNODE_GET_DIRFSNODE(node)->dirPart;
+    if (fsnode_isChildrenKnown(node)) {
+        return;
+    }
+
+    bool pinned = part->childrenNum != FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM;   //Children looked up by name pinned vnode already
+    if (!pinned) {
+        part->childrenNum = 0;
+    }
 
     vNode_rawReadDirectoryEntries(node->vnode);   //Use fsnode_create to append children to node, refer node by number of child
     ERROR_GOTO_IF_ERROR(0);
+    part->partial = false;
+
+    if (!pinned) {
+        __fsnode_pinChildren(node);
+        ERROR_GOTO_IF_ERROR(0);
+    }
 
     return;
     ERROR_FINAL_BEGIN(0);
@@ -219,27 +289,21 @@ void fsnode_forgetAllDirectoryEntries(fsNode* node) {
         return;
     }
 
-    for (LinkedListNode* listNode = linkedListNode_getNext(&part->children); listNode != &part->children;) {
-        LinkedListNode* next = linkedListNode_getNext(listNode);
-        linkedListNode_delete(listNode);
-        fsNode* childNode = HOST_POINTER(listNode, fsNode, childNode);
-        DEBUG_ASSERT_SILENT(fsnode_derefer(childNode)); //Derefer node here
-        listNode = next;
-    }
+    spinlock_lock(&_fsnode_dcacheLock);
+    __fsnode_dcacheDetachChildren(node);
+    spinlock_unlock(&_fsnode_dcacheLock);
 
-    part->childrenNum = FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM;
-
-    __fsnodeDirPart_initStruct(part);
+    __fsnode_forgetDetachedChildren(node);
 }
 
 void fsnode_forgetDirectoryEntry(fsNode* node, ConstCstring name, bool isDirectory) {
     DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
     DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(node);
-    fsNodeDirPart* part = &dirNode->dirPart;
 
     fsNode* removed = __dirfsNode_removeChildNode(dirNode, name, isDirectory);
     if (removed != NULL) {
         DEBUG_ASSERT_SILENT(fsnode_derefer(removed));   //Derefer node here
+        fsnode_derefer(node);   //Derefer parent referred in creation
     }
 }
 
@@ -273,13 +337,19 @@ void fsnode_move(fsNode* node, fsNode* moveTo, ConstCstring newName) {
         string_clearStruct(&node->name);
         string_initStructStr(&node->name, newName);
         ERROR_GOTO_IF_ERROR(0);
+        node->entry.name = node->name.data;
     }
     __dirfsNode_addChildNode(newParentNode, node);
+    ERROR_GOTO_IF_ERROR(0);
+    node->parent = moveTo;
     
     spinlock_unlock(&moveTo->lock);
-    spinlock_unlock(&node->parent->lock);
+    spinlock_unlock(&originParentNode->node.lock);
     spinlock_unlock(&node->lock);
 
+    fsnode_refer(moveTo);   //Keep parent referred by children
+    fsnode_derefer(&originParentNode->node);
+
     return;
     ERROR_FINAL_BEGIN(0);
 
@@ -310,6 +380,7 @@ static void __fsnode_initStruct(fsNode* node, Size nameN, DirectoryEntry* entry,
     node->parent = parent;
 
     node->vnode = node->mount = NULL;
+    node->mounted = false;
     REF_COUNTER_INIT(node->vNodeRefCounter, 0);
     
     node->lock = SPINLOCK_UNLOCKED;
@@ -329,6 +400,7 @@ static void __fsnode_initStruct(fsNode* node, Size nameN, DirectoryEntry* entry,
 static void __fsnode_release(fsNode* node) {
     DEBUG_ASSERT_SILENT(__fsnode_isReadyToRelease(node));
 
+    string_clearStruct(&node->name);
     mm_free(node);
 }
 
@@ -349,12 +421,10 @@ static void __fsnode_doGetAbsolutePath(fsNode* node, String* pathOut) {
 
 static void __fsnodeDirPart_initStruct(fsNodeDirPart* part) {
     linkedList_initStruct(&part->children);
-    hashTable_initStruct(&part->childrenHash, FSNODE_DIR_PART_CHILDREN_HASH_CHAIN_SIZE, part->childrenHashChains, hashTable_defaultHashFunc);
     part->childrenNum = FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM;
     REF_COUNTER_INIT(part->livingChildNum, 0);
-    for (int i = 0; i < FSNODE_DIR_PART_CHILDREN_HASH_CHAIN_SIZE; ++i) {
-        singlyLinkedList_initStruct(&part->childrenHashChains[i]);
-    }
+    linkedListNode_initStruct(&part->lruNode);
+    part->partial = false;
 }
 
 static void __dirFSnode_addLivingChild(DirFSnode* dirNode) {
@@ -388,32 +458,186 @@ static void __dirFSnode_removeLivingChild(DirFSnode* dirNode) {
 
 static void __dirfsNode_addChildNode(DirFSnode* dirNode, fsNode* child) {
     hashChainNode_initStruct(&child->childHashNode);
-    Object hash = __fsnode_nameHash(child->name.data, child->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+    Object key = __fsnode_dcacheKey(&dirNode->node, child->name.data, child->name.length, child->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+
+    spinlock_lock(&_fsnode_dcacheLock);
+    hashTable_insert(&_fsnode_dcache, key, &child->childHashNode);
+    ERROR_GOTO_IF_ERROR(0);
+    ++_fsnode_cachedNodeNum;
+    spinlock_unlock(&_fsnode_dcacheLock);
 
     fsNodeDirPart* part = &dirNode->dirPart;
-    hashTable_insert(&part->childrenHash, hash, &child->childHashNode);
-    
-    linkedList_initStruct(&child->childNode);
+    linkedListNode_initStruct(&child->childNode);
     linkedListNode_insertBack(&part->children, &child->childNode);
     ++part->childrenNum;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (spinlock_isLocked(&_fsnode_dcacheLock)) {
+        spinlock_unlock(&_fsnode_dcacheLock);
+    }
 }
 
 static fsNode* __dirfsNode_removeChildNode(DirFSnode* dirNode, ConstCstring name, bool isDirectory) {
-    Object hash = __fsnode_nameHash(name, isDirectory);
-
-    fsNodeDirPart* part = &dirNode->dirPart;
-    HashChainNode* deleted = hashTable_delete(&part->childrenHash, hash);
-    if (deleted == NULL) {
+    spinlock_lock(&_fsnode_dcacheLock);
+    fsNode* deletedNode = __fsnode_dcacheFind(&dirNode->node, name, cstring_strlen(name), isDirectory);
+    spinlock_unlock(&_fsnode_dcacheLock);
+    if (deletedNode == NULL) {
         return NULL;
     }
 
-    fsNode* deletedNode = HOST_POINTER(deleted, fsNode, childHashNode);
-
-    DEBUG_ASSERT_SILENT(deletedNode->parent == &dirNode->node);
     DEBUG_ASSERT_SILENT(__fsnode_isReadyToRelease(deletedNode));
+
+    __fsnode_dcacheRemove(deletedNode);
     
+    fsNodeDirPart* part = &dirNode->dirPart;
     linkedListNode_delete(&deletedNode->childNode);
     --part->childrenNum;
 
     return deletedNode;
 }
+
+static fsNode* __fsnode_dcacheFind(fsNode* parent, ConstCstring name, Size nameLength, bool isDirectory) {
+    Object key = __fsnode_dcacheKey(parent, name, nameLength, isDirectory);
+    SinglyLinkedList* chain = _fsnode_dcache.chains + _fsnode_dcache.hashFunc(&_fsnode_dcache, key);
+    for (SinglyLinkedListNode* chainNode = chain->next; chainNode != chain; chainNode = chainNode->next) {
+        fsNode* node = HOST_POINTER(chainNode, fsNode, childHashNode.node);
+        if (node->childHashNode.key != key || node->parent != parent || node->name.length != nameLength) {
+            continue;
+        }
+
+        if ((node->entry.type == FS_ENTRY_TYPE_DIRECTORY) == isDirectory && memory_memcmp(node->name.data, name, nameLength) == 0) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+static void __fsnode_dcacheRemove(fsNode* node) {
+    spinlock_lock(&_fsnode_dcacheLock);
+    __fsnode_dcacheUnhash(node);
+    spinlock_unlock(&_fsnode_dcacheLock);
+}
+
+static void __fsnode_dcacheUnhash(fsNode* node) {
+    Object key = node->childHashNode.key;
+    SinglyLinkedList* chain = _fsnode_dcache.chains + _fsnode_dcache.hashFunc(&_fsnode_dcache, key);
+    for (SinglyLinkedListNode* chainNode = chain->next, * last = chain; chainNode != chain; last = chainNode, chainNode = chainNode->next) {
+        if (chainNode != &node->childHashNode.node) {
+            continue;
+        }
+
+        singlyLinkedList_deleteNext(last);
+        singlyLinkedListNode_initStruct(chainNode);
+        --_fsnode_dcache.size;
+        --_fsnode_cachedNodeNum;
+        break;
+    }
+}
+
+static void __fsnode_dcacheDetachChildren(fsNode* node) {
+    fsNodeDirPart* part = &FSNODE_GET_DIRFSNODE(node)->dirPart;
+
+    linkedListNode_delete(&part->lruNode);
+    for (LinkedListNode* listNode = linkedListNode_getNext(&part->children); listNode != &part->children; listNode = linkedListNode_getNext(listNode)) {
+        __fsnode_dcacheUnhash(HOST_POINTER(listNode, fsNode, childNode));   //Lookups cannot find and refer children anymore
+    }
+}
+
+static void __fsnode_forgetDetachedChildren(fsNode* node) {
+    fsNodeDirPart* part = &FSNODE_GET_DIRFSNODE(node)->dirPart;
+
+    for (LinkedListNode* listNode = linkedListNode_getNext(&part->children); listNode != &part->children;) {
+        LinkedListNode* next = linkedListNode_getNext(listNode);
+        linkedListNode_delete(listNode);
+        fsNode* childNode = HOST_POINTER(listNode, fsNode, childNode);
+        DEBUG_ASSERT_SILENT(fsnode_derefer(childNode)); //Derefer node here
+        fsnode_derefer(node);   //Derefer parent referred in creation
+        listNode = next;
+    }
+
+    __fsnodeDirPart_initStruct(part);
+
+    fsnode_releaseVnode(node->vnode->fscore, node); //Release pin of known children
+}
+
+static fsNode* __fsnode_lookupCached(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory) {
+    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(node);
+
+    spinlock_lock(&_fsnode_dcacheLock);
+    fsNode* ret = __fsnode_dcacheFind(node, name, nameLength, isDirectory);
+    if (ret != NULL) {
+        fsnode_refer(ret);  //Refer before unlocking, or shrinking may forget it meanwhile
+        linkedListNode_delete(&dirNode->dirPart.lruNode);   //Move to most recently used
+        linkedListNode_insertFront(&_fsnode_lruList, &dirNode->dirPart.lruNode);
+    }
+    spinlock_unlock(&_fsnode_dcacheLock);
+
+    return ret;
+}
+
+static void __fsnode_lookupDirectoryEntry(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory) {
+    DEBUG_ASSERT_SILENT(node->vnode != NULL);
+
+    fsNodeDirPart* part = &FSNODE_GET_DIRFSNODE(node)->dirPart;
+    bool pinned = part->childrenNum != FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM;
+    if (!pinned) {
+        part->childrenNum = 0;
+        part->partial = true;
+    }
+
+    vNode_rawLookupDirectoryEntry(node->vnode, name, nameLength, isDirectory);  //Use fsnode_create to append the child to node
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (!pinned) {
+        __fsnode_pinChildren(node);
+        ERROR_GOTO_IF_ERROR(0);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    if (!pinned && part->childrenNum == 0) {    //Nothing appended, back to unknown
+        __fsnodeDirPart_initStruct(part);
+    }
+}
+
+static void __fsnode_pinChildren(fsNode* node) {
+    fsnode_requestVnode(node->vnode->fscore, node); //Known children pin vnode, released when forgotten
+    ERROR_GOTO_IF_ERROR(0);
+
+    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(node);
+    spinlock_lock(&_fsnode_dcacheLock);
+    linkedListNode_insertFront(&_fsnode_lruList, &dirNode->dirPart.lruNode);
+    spinlock_unlock(&_fsnode_dcacheLock);
+
+    __fsnode_shrinkDcache(node);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __fsnode_shrinkDcache(fsNode* keep) {
+    while (true) {
+        fsNode* victim = NULL;
+
+        spinlock_lock(&_fsnode_dcacheLock);
+        if (_fsnode_cachedNodeNum > FSNODE_DCACHE_MAX_NODE_NUM) {
+            for (LinkedListNode* lruNode = linkedListNode_getNext(&_fsnode_lruList); lruNode != &_fsnode_lruList; lruNode = linkedListNode_getNext(lruNode)) {
+                DirFSnode* dirNode = HOST_POINTER(lruNode, DirFSnode, dirPart.lruNode);
+                if (&dirNode->node != keep && REF_COUNTER_CHECK(dirNode->dirPart.livingChildNum, 0)) {  //Directories with known children are living, so leaves go first
+                    victim = &dirNode->node;
+                    __fsnode_dcacheDetachChildren(victim);  //Children are referred only under this lock, so none of them comes alive after the check
+                    break;
+                }
+            }
+        }
+        spinlock_unlock(&_fsnode_dcacheLock);
+
+        if (victim == NULL) {
+            break;
+        }
+
+        __fsnode_forgetDetachedChildren(victim);
+    }
+}
\ No newline at end of file
@@ -11,17 +11,31 @@
 #include<kit/util.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
+#include<multitask/locks/spinlock.h>
 #include<structs/hashTable.h>
 #include<structs/linkedList.h>
 #include<structs/refCounter.h>
 #include<structs/string.h>
 #include<error.h>
 
-static fsNode* __fscore_getLocalFSnode(FScore* fscore, fsNode* baseNode, String* pathFromBase, bool isDirectory);
+static HashTable _fscore_mountHash;
+static SinglyLinkedList _fscore_mountHashChains[FSCORE_MOUNT_HASH_CHAIN_SIZE];
+static Spinlock _fscore_mountLock = SPINLOCK_UNLOCKED;
+
+static inline Object __fscore_mountKey(FScore* fscore, fsNode* mountedRoot) {
+    return ((Object)fscore * 0x9E3779B97F4A7C15ull) ^ (Object)mountedRoot;
+}
+
+static fsNode* __fscore_lookupChild(FScore* fscore, fsNode* node, ConstCstring name, Size nameLength, bool isDirectory);
+
+void fscore_init() {
+    hashTable_initStruct(&_fscore_mountHash, FSCORE_MOUNT_HASH_CHAIN_SIZE, _fscore_mountHashChains, hashTable_defaultHashFunc);
+}
 
 void fscore_initStruct(FScore* fscore, FScoreInitArgs* args) {
     fscore->blockDevice     = args->blockDevice;
     fscore->operations      = args->operations;
+    fscore->flags           = FSCORE_FLAGS_DEFAULT;
 
     DirectoryEntry rootDirEntry = (DirectoryEntry) {
         .name = "",
@@ -47,90 +61,86 @@ void fscore_initStruct(FScore* fscore, FScoreInitArgs* args) {
 fsNode* fscore_getFSnode(FScore* fscore, fsIdentifier* identifier, FScore** finalFScoreOut, bool followMount) {
     DEBUG_ASSERT_SILENT(finalFScoreOut != NULL);
 
-    String localAbsoluteDirPath, dirPathFromBase, basename;
-    fsNode* ret = NULL;
-    vNode* parentDirVnode = NULL;
+    String* path = &identifier->path;
+    return fscore_walk(fscore, identifier->baseVnode->fsNode, path->data, path->length, identifier->isDirectory, followMount, finalFScoreOut);
+}
 
-    string_initStruct(&localAbsoluteDirPath);
-    ERROR_GOTO_IF_ERROR(0);
-    string_initStruct(&dirPathFromBase);
-    ERROR_GOTO_IF_ERROR(0);
-    string_initStruct(&basename);
-    ERROR_GOTO_IF_ERROR(0);
+fsNode* fscore_walk(FScore* fscore, fsNode* baseNode, ConstCstring path, Size pathLength, bool isDirectory, bool followMount, FScore** finalFScoreOut) {
+    DEBUG_ASSERT_SILENT(finalFScoreOut != NULL);
 
-    fsIdentifier_getAbsolutePath(identifier, &localAbsoluteDirPath);
-    ERROR_GOTO_IF_ERROR(0);
-    path_basename(&localAbsoluteDirPath, &basename);
-    ERROR_GOTO_IF_ERROR(0);
-    path_dirname(&localAbsoluteDirPath, &localAbsoluteDirPath);
-    ERROR_GOTO_IF_ERROR(0);
+    fsNode* currentNode = baseNode;
+    FScore* currentFScore = fscore;
 
-    if (basename.length == 0) { //Identifier points to root
-        DEBUG_ASSERT_SILENT(localAbsoluteDirPath.length == 0 || (localAbsoluteDirPath.length == 1 && localAbsoluteDirPath.data[0] == PATH_SEPERATOR));
-        ret = identifier->baseVnode->fsNode;
-        fsnode_refer(ret);  //Refer 'ret' once
-
-        *finalFScoreOut = fscore;
-    } else {
-        vNode* currentBaseVnode = identifier->baseVnode;
-        FScore* currentFScore = fscore;
-        
-        if (followMount) {
-            while (true) {
-                Mount* relayMount = fscore_lookupMount(currentFScore, localAbsoluteDirPath.data);
-                if (relayMount == NULL) {
-                    break;
-                }
-        
-                currentBaseVnode = relayMount->mountedVnode;
-                string_slice(&dirPathFromBase, &localAbsoluteDirPath, relayMount->path.length, localAbsoluteDirPath.length);
-                ERROR_GOTO_IF_ERROR(0);
-                fsnode_getAbsolutePath(currentBaseVnode->fsNode, &localAbsoluteDirPath);
-                ERROR_GOTO_IF_ERROR(0);
-                path_join(&localAbsoluteDirPath, &localAbsoluteDirPath, &dirPathFromBase);
-                ERROR_GOTO_IF_ERROR(0);
-                currentFScore = currentBaseVnode->fscore;
-            }
+    fsnode_refer(currentNode);  //Refer 'currentNode' once
+
+    Index64 index = 0;
+    while (true) {
+        while (index < pathLength && path[index] == PATH_SEPERATOR) {
+            ++index;
         }
 
-        fsNode* parentNode = __fscore_getLocalFSnode(currentFScore, currentBaseVnode->fsNode, &localAbsoluteDirPath, identifier->isDirectory);   //Refer 'ret' once
-        ERROR_GOTO_IF_ERROR(0);
+        if (index == pathLength) {
+            break;
+        }
 
-        fsnode_requestVnode(currentFScore, parentNode);
-        
-        ret = fsnode_lookup(parentNode, basename.data, identifier->isDirectory, true);
+        ConstCstring name = path + index;
+        while (index < pathLength && path[index] != PATH_SEPERATOR) {
+            ++index;
+        }
+        Size nameLength = (path + index) - name;
 
-        fsnode_releaseVnode(currentFScore, parentNode);
+        while (index < pathLength && path[index] == PATH_SEPERATOR) {
+            ++index;
+        }
+        bool isLast = (index == pathLength);
 
-        *finalFScoreOut = currentFScore;
-    }
+        if (currentNode->entry.type != FS_ENTRY_TYPE_DIRECTORY) {
+            ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+        }
 
-    string_clearStruct(&basename);
-    string_clearStruct(&dirPathFromBase);
-    string_clearStruct(&localAbsoluteDirPath);
+        if (nameLength == 1 && name[0] == '.') {
+            continue;
+        }
 
-    return ret;
-    ERROR_FINAL_BEGIN(0);
-    if (string_isAvailable(&dirPathFromBase)) {
-        string_clearStruct(&dirPathFromBase);
-    }
+        fsNode* nextNode = NULL;
+        if (nameLength == 2 && name[0] == '.' && name[1] == '.') {
+            nextNode = currentNode->parent;
+            if (nextNode == NULL && currentNode->mounted) { //Root of mounted fs, go to parent of mount point
+                Mount* mount = fscore_lookupMount(currentFScore, currentNode);
+                DEBUG_ASSERT_SILENT(mount != NULL);
+                currentFScore = mount->mountPointFScore;
+                nextNode = mount->mountPoint->parent == NULL ? mount->mountPoint : mount->mountPoint->parent;
+            }
 
-    if (string_isAvailable(&basename)) {
-        string_clearStruct(&basename);
-    }
+            if (nextNode == NULL) { //".." of root is root itself
+                continue;
+            }
 
-    if (string_isAvailable(&localAbsoluteDirPath)) {
-        string_clearStruct(&localAbsoluteDirPath);
-    }
+            fsnode_refer(nextNode);
+        } else {
+            nextNode = __fscore_lookupChild(currentFScore, currentNode, name, nameLength, isLast ? isDirectory : true);    //Refer 'nextNode' once
+            if (nextNode == NULL) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+        }
 
-    if (parentDirVnode != NULL) {
-        fscore_releaseVnode(parentDirVnode);    //Release 'parentDirVnode->fsNode' (parentDirNode) once (if vNode opened)
-    }
+        fsnode_derefer(currentNode);    //Release 'currentNode' from last round
+        currentNode = nextNode;
 
-    if (ret != NULL) {
-        fsnode_derefer(ret);    //Release 'ret' once (from root or __fscore_getLocalFSnode)
+        while (followMount && currentNode->mount != NULL) { //Mount point is kept referred by mount, no need to hold it here
+            vNode* mountedVnode = currentNode->mount;
+            fsnode_refer(mountedVnode->fsNode);
+            fsnode_derefer(currentNode);
+            currentNode = mountedVnode->fsNode;
+            currentFScore = mountedVnode->fscore;
+        }
     }
 
+    *finalFScoreOut = currentFScore;
+    return currentNode;
+    ERROR_FINAL_BEGIN(0);
+    fsnode_derefer(currentNode);
     return NULL;
 }
 
@@ -193,22 +203,8 @@ void fscore_genericCloseFSentry(FScore* fscore, fsEntry* entry) {
 }
 
 void fscore_genericMount(FScore* fscore, fsIdentifier* mountPoint, vNode* mountVnode, Flags8 flags) {
-    //TODO: flags not used yet
-    //TODO: Lock
     fsNode* mountPointNode = NULL;
-    Mount* mount = mm_allocate(sizeof(Mount));
-    if (mount == NULL) {
-        ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
-    }
-
-    string_initStruct(&mount->path);
-    fsIdentifier_getAbsolutePath(mountPoint, &mount->path);
-    ERROR_GOTO_IF_ERROR(0);
-    linkedListNode_initStruct(&mount->node);
-    mount->mountedVnode = mountVnode;
-
-    linkedListNode_insertBack(&fscore->mounted, &mount->node);
+    Mount* mount = NULL;
 
     FScore* finalFScore = NULL;
     mountPointNode = fscore_getFSnode(fscore, mountPoint, &finalFScore, false); //Refer 'mountPointNode' once (if found)
@@ -219,34 +215,36 @@ void fscore_genericMount(FScore* fscore, fsIdentifier* mountPoint, vNode* mountV
     DEBUG_ASSERT_SILENT(fscore == finalFScore);
     DEBUG_ASSERT_SILENT(mountPointNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
 
-    fsnode_setMount(mountPointNode, mountVnode);
+    if (fscore_lookupMount(mountVnode->fscore, mountVnode->fsNode) != NULL) {  //TODO: Same fs mounted at multiple places
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
+    }
+
+    mount = mm_allocate(sizeof(Mount));
+    if (mount == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    linkedListNode_initStruct(&mount->node);
+    hashChainNode_initStruct(&mount->hashNode);
+    mount->mountPoint = mountPointNode;
+    mount->mountPointFScore = fscore;
+    mount->mountedVnode = mountVnode;
+
+    fsnode_setMount(mountPointNode, mountVnode);    //Mount point is referred by mount
     ERROR_GOTO_IF_ERROR(0);
+    mountVnode->fscore->flags = flags;
+
+    spinlock_lock(&_fscore_mountLock);
+    linkedListNode_insertBack(&fscore->mounted, &mount->node);
+    hashTable_insert(&_fscore_mountHash, __fscore_mountKey(mountVnode->fscore, mountVnode->fsNode), &mount->hashNode);
+    spinlock_unlock(&_fscore_mountLock);
 
     fscore_releaseFSnode(mountPointNode);   //Release 'mountPointNode' once (from fscore_getFSnode)
 
     return;
     ERROR_FINAL_BEGIN(0);
     if (mount != NULL) {
-        if (string_isAvailable(&mount->path)) {
-            string_clearStruct(&mount->path);
-        }
-
-        bool inserted = false;
-        for (LinkedListNode* node = fscore->mounted.next; node != &fscore->mounted; node = node->next) {
-            if (&mount->node == node) {
-                inserted = true;
-                break;
-            }
-        }
-
-        if (inserted) {
-            linkedListNode_delete(&mount->node);
-        }
-
-        if (mountPointNode != NULL && mountPointNode->mount == mountVnode) {
-            fsnode_setMount(mountPointNode, NULL);  //TODO: Is this correct?
-        }
-
         mm_free(mount);
     }
 
@@ -256,29 +254,29 @@ void fscore_genericMount(FScore* fscore, fsIdentifier* mountPoint, vNode* mountV
 }
 
 void fscore_genericUnmount(FScore* fscore, fsIdentifier* mountPoint) {
-    //TODO: Lock
-    fsNode* mountPointNode = NULL;
-    String mountPointPath;
-    string_initStruct(&mountPointPath);
-    fsIdentifier_getAbsolutePath(mountPoint, &mountPointPath);
-    ERROR_GOTO_IF_ERROR(0);
-
-    Mount* mount = fscore_lookupMount(fscore, mountPointPath.data);
-    DEBUG_ASSERT_SILENT(mount != NULL);
-
-    string_clearStruct(&mount->path);
-    linkedListNode_delete(&mount->node);
-
-    mm_free(mount);
-
     FScore* finalFScore = NULL;
-    mountPointNode = fscore_getFSnode(fscore, mountPoint, &finalFScore, false);   //Refer 'mountPointNode' once (if found)
+    fsNode* mountPointNode = fscore_getFSnode(fscore, mountPoint, &finalFScore, false);   //Refer 'mountPointNode' once (if found)
     if (mountPointNode == NULL) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
     }
     DEBUG_ASSERT_SILENT(mountPointNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
 
+    vNode* mountedVnode = mountPointNode->mount;
+    if (mountedVnode == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+
+    Mount* mount = fscore_lookupMount(mountedVnode->fscore, mountedVnode->fsNode);
+    DEBUG_ASSERT_SILENT(mount != NULL && mount->mountPoint == mountPointNode);
+
+    spinlock_lock(&_fscore_mountLock);
+    linkedListNode_delete(&mount->node);
+    hashTable_delete(&_fscore_mountHash, mount->hashNode.key);
+    spinlock_unlock(&_fscore_mountLock);
+
+    mm_free(mount);
+
     fsnode_setMount(mountPointNode, NULL);
     ERROR_GOTO_IF_ERROR(0);
 
@@ -286,72 +284,32 @@ void fscore_genericUnmount(FScore* fscore, fsIdentifier* mountPoint) {
 
     return;
     ERROR_FINAL_BEGIN(0);
-
-    if (string_isAvailable(&mountPointPath)) {
-        string_clearStruct(&mountPointPath);
-    }
-
     if (mountPointNode != NULL) {
-        fsnode_setMount(mountPointNode, NULL);
+        fscore_releaseFSnode(mountPointNode);
     }
 }
 
-Mount* fscore_lookupMount(FScore* fscore, ConstCstring path) {
-    //TODO: Lock
-    for (LinkedListNode* node = fscore->mounted.next; node != &fscore->mounted; node = node->next) {
-        Mount* mount = HOST_POINTER(node, Mount, node);
-        String* mountPath = &mount->path;
+Mount* fscore_lookupMount(FScore* fscore, fsNode* mountedRoot) {
+    spinlock_lock(&_fscore_mountLock);
+    HashChainNode* found = hashTable_find(&_fscore_mountHash, __fscore_mountKey(fscore, mountedRoot));
+    spinlock_unlock(&_fscore_mountLock);
 
-        Size prefixLen = cstring_prefixLen(path, mountPath->data);
-        if (prefixLen == mountPath->length) {
-            return mount;
-        }
-    }
-
-    return NULL;
+    return found == NULL ? NULL : HOST_POINTER(found, Mount, hashNode);
 }
 
-static fsNode* __fscore_getLocalFSnode(FScore* fscore, fsNode* baseNode, String* pathFromBase, bool isDirectory) {
-    Index64 currentIndex = 0;
-    String walked;
-    fsNode* currentNode = baseNode;
-
-    fsnode_refer(baseNode);
-    if (pathFromBase->length == 0 || cstring_strcmp(pathFromBase->data, PATH_SEPERATOR_STR) == 0) {
-        return baseNode;
+static fsNode* __fscore_lookupChild(FScore* fscore, fsNode* node, ConstCstring name, Size nameLength, bool isDirectory) {
+    if (fsnode_isChildrenKnown(node)) {
+        return fsnode_lookupN(node, name, nameLength, isDirectory, false);  //Cached, a few hash lookups only
     }
 
-    string_initStruct(&walked);
+    fsnode_requestVnode(fscore, node);  //Reading child needs vnode, known children keep it pinned afterwards
     ERROR_GOTO_IF_ERROR(0);
 
-    while (currentIndex != INVALID_INDEX64) {
-        currentIndex = path_walk(pathFromBase, currentIndex, &walked);
-        ERROR_GOTO_IF_ERROR(0);
-
-        fsnode_requestVnode(fscore, currentNode);
+    fsNode* ret = fsnode_lookupN(node, name, nameLength, isDirectory, true);    //Refer 'ret' once (if found)
 
-        fsNode* lastNode = currentNode;
-        currentNode = fsnode_lookup(currentNode, walked.data, (currentIndex == INVALID_INDEX64) ? isDirectory : true, true);    //Refer 'currentNode' once
-        //TODO: Check need release here
-        if (currentNode == NULL) {
-            return NULL;
-        }
-        ERROR_GOTO_IF_ERROR(0);
-
-        fsnode_derefer(lastNode);   //Refer the 'currentNode' from last round
-
-        DEBUG_ASSERT_SILENT(currentNode->mount == NULL);
-    }
+    fsnode_releaseVnode(fscore, node);
 
-    return currentNode;
+    return ret;
     ERROR_FINAL_BEGIN(0);
-    if (string_isAvailable(&walked)) {
-        string_clearStruct(&walked);
-    }
-
-    if (currentNode != NULL) {
-        fsnode_derefer(currentNode);
-    }
-    
     return NULL;
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include<fs/poll.h>
+
+#include<fs/fs.h>
+#include<fs/fsEntry.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/mm.h>
+#include<multitask/locks/spinlock.h>
+#include<multitask/schedule.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+#include<structs/linkedList.h>
+#include<structs/singlyLinkedList.h>
+#include<time/timer.h>
+#include<debug.h>
+#include<error.h>
+
+static bool __pollWaiter_waitOperations_tryTake(Wait* wait, Thread* thread);
+
+static bool __pollWaiter_waitOperations_shouldWait(Wait* wait, Thread* thread);
+
+static void __pollWaiter_waitOperations_wait(Wait* wait, Thread* thread);
+
+static void __pollWaiter_waitOperations_quitWaitting(Wait* wait, Thread* thread);
+
+static WaitOperations _pollWaiter_waitOperations = {
+    .tryTake        = __pollWaiter_waitOperations_tryTake,
+    .shouldWait     = __pollWaiter_waitOperations_shouldWait,
+    .wait           = __pollWaiter_waitOperations_wait,
+    .quitWaitting   = __pollWaiter_waitOperations_quitWaitting
+};
+
+static void __pollWaiter_wakeup(PollTableEntry* entry, PollEvents events);
+
+static void __pollWaiter_timeoutHandler(Timer* timer);
+
+void pollWaitQueue_initStruct(PollWaitQueue* queue) {
+    queue->lock = SPINLOCK_UNLOCKED;
+    linkedList_initStruct(&queue->entries);
+}
+
+void pollWaitQueue_wakeup(PollWaitQueue* queue, PollEvents events) {
+    bool interruptEnabled = spinlock_lockIrqSave(&queue->lock);
+    for (LinkedListNode* node = linkedListNode_getNext(&queue->entries); node != &queue->entries;) {
+        PollTableEntry* entry = HOST_POINTER(node, PollTableEntry, node);
+        node = linkedListNode_getNext(node);    //Callback never removes entry, but keep it safe
+        entry->table->wakeup(entry, events);
+    }
+    spinlock_unlockIrqRestore(&queue->lock, interruptEnabled);
+}
+
+void pollTable_initStruct(PollTable* table, PollWakeupFunc wakeup) {
+    table->wakeup = wakeup;
+    singlyLinkedList_initStruct(&table->entries);
+}
+
+void pollTable_clearStruct(PollTable* table) {
+    while (!singlyLinkedList_isEmpty(&table->entries)) {
+        PollTableEntry* entry = HOST_POINTER(singlyLinkedList_getNext(&table->entries), PollTableEntry, tableNode);
+        singlyLinkedList_deleteNext(&table->entries);
+
+        PollWaitQueue* queue = entry->queue;
+        bool interruptEnabled = spinlock_lockIrqSave(&queue->lock);
+        linkedListNode_delete(&entry->node);
+        spinlock_unlockIrqRestore(&queue->lock, interruptEnabled);
+
+        mm_free(entry);
+    }
+}
+
+void poll_wait(PollTable* table, PollWaitQueue* queue) {
+    if (table == NULL) {
+        return;
+    }
+
+    PollTableEntry* entry = mm_allocate(sizeof(PollTableEntry));
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    linkedListNode_initStruct(&entry->node);
+    singlyLinkedListNode_initStruct(&entry->tableNode);
+    entry->queue = queue;
+    entry->table = table;
+
+    bool interruptEnabled = spinlock_lockIrqSave(&queue->lock);
+    linkedListNode_insertFront(&queue->entries, &entry->node);
+    spinlock_unlockIrqRestore(&queue->lock, interruptEnabled);
+
+    singlyLinkedList_insertNext(&table->entries, &entry->tableNode);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+void pollWaiter_initStruct(PollWaiter* waiter, Int64 timeout) {
+    pollTable_initStruct(&waiter->table, __pollWaiter_wakeup);
+    waiter->thread          = schedule_getCurrentThread();
+    waiter->triggered       = false;
+    waiter->sleeping        = false;
+    waiter->timedOut        = timeout == 0;
+    waiter->timeout         = timeout;
+    waiter->timerStarted    = false;
+    wait_initStruct(&waiter->wait, &_pollWaiter_waitOperations);
+}
+
+void pollWaiter_clearStruct(PollWaiter* waiter) {
+    if (waiter->timerStarted) {
+        schedule_enterCritical();
+        if (TEST_FLAGS(waiter->timer.flags, TIMER_FLAGS_PRESENT)) {
+            timer_stop(&waiter->timer);
+        }
+        schedule_leaveCritical();
+    }
+
+    pollTable_clearStruct(&waiter->table);
+}
+
+bool pollWaiter_sleep(PollWaiter* waiter) {
+    if (waiter->timeout > 0 && !waiter->timerStarted) {
+        timer_initStruct(&waiter->timer, waiter->timeout, TIME_UNIT_NANOSECOND);
+        waiter->timer.handler = __pollWaiter_timeoutHandler;
+        waiter->timer.data = (Object)waiter;
+        timer_start(&waiter->timer);
+        waiter->timerStarted = true;
+    }
+
+    schedule_enterCritical();   //Wakers must not slip in between checking and sleeping, TODO: Not enough for SMP
+    if (waiter->triggered || waiter->timedOut) {
+        schedule_leaveCritical();
+    } else {
+        waiter->sleeping = true;
+        thread_sleep(waiter->thread, &waiter->wait);
+    }
+
+    waiter->triggered = false;  //Caller scans again, events after this point wake it up next time
+
+    return !waiter->timedOut;
+}
+
+Size poll_poll(PollRequest* requests, Size n, Int64 timeout) {
+    PollWaiter waiter;
+    pollWaiter_initStruct(&waiter, timeout);
+    PollTable* table = timeout == 0 ? NULL : &waiter.table;
+
+    Size ret = 0;
+    while (true) {
+        ret = 0;
+        for (int i = 0; i < n; ++i) {
+            PollRequest* request = &requests[i];
+            PollEvents events = fs_filePoll(request->entry, table);
+            ERROR_GOTO_IF_ERROR(0);
+
+            request->revents = events & (request->events | POLL_EVENTS_ALWAYS);
+            if (request->revents != EMPTY_FLAGS) {
+                ++ret;
+            }
+        }
+        table = NULL;   //Registered at first scan, later scans only collect events
+
+        if (ret > 0 || !pollWaiter_sleep(&waiter)) {
+            break;
+        }
+    }
+
+    pollWaiter_clearStruct(&waiter);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    pollWaiter_clearStruct(&waiter);
+    return 0;
+}
+
+static bool __pollWaiter_waitOperations_tryTake(Wait* wait, Thread* thread) {
+    return false;
+}
+
+static bool __pollWaiter_waitOperations_shouldWait(Wait* wait, Thread* thread) {
+    PollWaiter* waiter = HOST_POINTER(wait, PollWaiter, wait);
+    return waiter->sleeping;    //Not woken up by queue or timer, spurious
+}
+
+static void __pollWaiter_waitOperations_wait(Wait* wait, Thread* thread) {
+    DEBUG_ASSERT_SILENT(thread == schedule_getCurrentThread());
+    DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+
+    if (schedule_isInCritical()) {
+        schedule_leaveCritical();
+        DEBUG_ASSERT_SILENT(!schedule_isInCritical());
+    }
+
+    schedule_yield();
+}
+
+static void __pollWaiter_waitOperations_quitWaitting(Wait* wait, Thread* thread) {
+    PollWaiter* waiter = HOST_POINTER(wait, PollWaiter, wait);
+    waiter->sleeping = false;
+}
+
+static void __pollWaiter_wakeup(PollTableEntry* entry, PollEvents events) {
+    PollWaiter* waiter = HOST_POINTER(entry->table, PollWaiter, table);
+    waiter->triggered = true;   //Events are rescanned, no need to filter here
+    if (waiter->sleeping) {
+        waiter->sleeping = false;
+        thread_wakeup(waiter->thread);
+    }
+}
+
+static void __pollWaiter_timeoutHandler(Timer* timer) {
+    PollWaiter* waiter = (PollWaiter*)timer->data;
+    waiter->timedOut = true;
+    if (waiter->sleeping) {
+        waiter->sleeping = false;
+        thread_wakeup(waiter->thread);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include<fs/signalfd.h>
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<multitask/signal.h>
+#include<multitask/thread.h>
+#include<structs/linkedList.h>
+#include<error.h>
+
+static ConstCstring _signalfd_fsEntry_name = "signalfd";
+
+static void __signalfd_release(Object object);
+
+static Thread* __signalfd_takePending(Signalfd* signalfd, int* signalRet);
+
+static bool __signalfd_hasPending(Signalfd* signalfd);
+
+static Index64 __signalfd_fsEntry_seek(fsEntry* entry, Index64 seekTo);
+
+static Size __signalfd_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __signalfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __signalfd_fsEntry_poll(fsEntry* entry, PollTable* table);
+
+static fsEntryOperations _signalfd_fsEntry_operations = {
+    .seek   = __signalfd_fsEntry_seek,
+    .read   = __signalfd_fsEntry_read,
+    .write  = __signalfd_fsEntry_write,
+    .poll   = __signalfd_fsEntry_poll
+};
+
+fsEntry* signalfd_create(Flags32 mask, FCNTLopenFlags openFlags) {
+    Signalfd* signalfd = mm_allocate(sizeof(Signalfd));
+    if (signalfd == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    signalfd_setMask(signalfd, mask);
+
+    fsEntry* ret = anonymousFile_create(_signalfd_fsEntry_name, &_signalfd_fsEntry_operations, __signalfd_release, (Object)signalfd, FCNTL_OPEN_READ_ONLY | openFlags);
+    ERROR_GOTO_IF_ERROR(1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_free(signalfd);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+Signalfd* signalfd_getFromFSentry(fsEntry* entry) {
+    return (Signalfd*)anonymousFile_getObject(entry, &_signalfd_fsEntry_operations);
+}
+
+void signalfd_setMask(Signalfd* signalfd, Flags32 mask) {
+    signalfd->mask = CLEAR_FLAG(mask, SIGNAL_MASK_UNBLOCKABLE | FLAG32(0));
+    pollWaitQueue_wakeup(&schedule_getCurrentProcess()->signalPollQueue, POLL_EVENTS_IN);   //Signals pending already may be readable now
+}
+
+static void __signalfd_release(Object object) {
+    mm_free((Signalfd*)object);
+}
+
+static Thread* __signalfd_takePending(Signalfd* signalfd, int* signalRet) {   //Signals of current thread first, then signals pended to process
+    Thread* currentThread = schedule_getCurrentThread();
+    int signal = signalQueue_takePending(&currentThread->signalQueue, signalfd->mask);
+    if (signal != 0) {
+        *signalRet = signal;
+        return currentThread;
+    }
+
+    Process* process = currentThread->process;
+    for (LinkedListNode* node = linkedListNode_getNext(&process->threads); node != &process->threads; node = linkedListNode_getNext(node)) {
+        Thread* thread = HOST_POINTER(node, Thread, processNode);
+        if (thread == currentThread) {
+            continue;
+        }
+
+        signal = signalQueue_takePending(&thread->signalQueue, signalfd->mask);
+        if (signal != 0) {
+            *signalRet = signal;
+            return thread;
+        }
+    }
+
+    return NULL;
+}
+
+static bool __signalfd_hasPending(Signalfd* signalfd) {
+    Process* process = schedule_getCurrentProcess();
+    for (LinkedListNode* node = linkedListNode_getNext(&process->threads); node != &process->threads; node = linkedListNode_getNext(node)) {
+        if (signalQueue_hasPending(&HOST_POINTER(node, Thread, processNode)->signalQueue, signalfd->mask)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static Index64 __signalfd_fsEntry_seek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __signalfd_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    Size infoN = n / sizeof(SignalfdSiginfo);
+    if (infoN == 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Signalfd* signalfd = signalfd_getFromFSentry(entry);
+    SignalfdSiginfo* infos = (SignalfdSiginfo*)buffer;
+    PollWaiter waiter;
+    bool waiting = false;
+    Size ret = 0;
+    while (true) {
+        int signal;
+        Thread* thread;
+        while (ret < infoN && (thread = __signalfd_takePending(signalfd, &signal)) != NULL) {
+            SignalfdSiginfo* info = &infos[ret++];
+            memory_memset(info, 0, sizeof(SignalfdSiginfo));
+            info->signo = signal;
+            info->tid = thread->tid;
+        }
+
+        if (ret > 0) {
+            break;
+        }
+
+        if (TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, signals may come in between
+            pollWaiter_initStruct(&waiter, -1);
+            waiting = true;
+            poll_wait(&waiter.table, &schedule_getCurrentProcess()->signalPollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        pollWaiter_sleep(&waiter);
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    return ret * sizeof(SignalfdSiginfo);
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static Size __signalfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static PollEvents __signalfd_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    Signalfd* signalfd = signalfd_getFromFSentry(entry);
+    poll_wait(table, &schedule_getCurrentProcess()->signalPollQueue);  //Signals of poller process are reported
+    ERROR_GOTO_IF_ERROR(0);
+
+    return __signalfd_hasPending(signalfd) ? POLL_EVENTS_IN : EMPTY_FLAGS;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include<fs/timerfd.h>
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/locks/spinlock.h>
+#include<time/time.h>
+#include<time/timer.h>
+#include<debug.h>
+#include<error.h>
+
+static ConstCstring _timerfd_fsEntry_name = "timerfd";
+
+static void __timerfd_release(Object object);
+
+static Int64 __timerfd_getRemaining(Timerfd* timerfd);
+
+static void __timerfd_timerHandler(Timer* timer);
+
+static Uint64 __timerfd_takeExpirations(Timerfd* timerfd);
+
+static Index64 __timerfd_fsEntry_seek(fsEntry* entry, Index64 seekTo);
+
+static Size __timerfd_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __timerfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __timerfd_fsEntry_poll(fsEntry* entry, PollTable* table);
+
+static fsEntryOperations _timerfd_fsEntry_operations = {
+    .seek   = __timerfd_fsEntry_seek,
+    .read   = __timerfd_fsEntry_read,
+    .write  = __timerfd_fsEntry_write,
+    .poll   = __timerfd_fsEntry_poll
+};
+
+static inline Int64 __timerfd_now() {
+    Timestamp now;
+    time_getMonotonicTimestamp(&now);
+    return now.second * TIME_UNIT_SECOND + now.nanosecond;
+}
+
+fsEntry* timerfd_create(bool realtime, FCNTLopenFlags openFlags) {
+    Timerfd* timerfd = mm_allocate(sizeof(Timerfd));
+    if (timerfd == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    timerfd->lock = SPINLOCK_UNLOCKED;
+    timer_initStruct(&timerfd->timer, 0, TIME_UNIT_NANOSECOND);
+    timerfd->interval = 0;
+    timerfd->intervalTick = 0;
+    timerfd->deadline = -1;
+    timerfd->expirationN = 0;
+    timerfd->realtime = realtime;
+    pollWaitQueue_initStruct(&timerfd->pollQueue);
+
+    fsEntry* ret = anonymousFile_create(_timerfd_fsEntry_name, &_timerfd_fsEntry_operations, __timerfd_release, (Object)timerfd, FCNTL_OPEN_READ_ONLY | openFlags);
+    ERROR_GOTO_IF_ERROR(1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_free(timerfd);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+Timerfd* timerfd_getFromFSentry(fsEntry* entry) {
+    return (Timerfd*)anonymousFile_getObject(entry, &_timerfd_fsEntry_operations);
+}
+
+void timerfd_setTime(Timerfd* timerfd, Int64 value, Int64 interval, Int64* oldValueRet, Int64* oldIntervalRet) {
+    if (value < 0 || interval < 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);   //Handler never runs while holding this, TODO: Not enough for SMP
+    if (oldValueRet != NULL) {
+        *oldValueRet = __timerfd_getRemaining(timerfd);
+    }
+
+    if (oldIntervalRet != NULL) {
+        *oldIntervalRet = timerfd->interval;
+    }
+
+    if (TEST_FLAGS(timerfd->timer.flags, TIMER_FLAGS_PRESENT)) {
+        timer_stop(&timerfd->timer);
+    }
+
+    timerfd->interval = interval;
+    timerfd->deadline = -1;
+    timerfd->expirationN = 0;
+
+    if (value > 0) {
+        if (interval > 0) { //Timer converts time to tick, interval is converted first and kept for later expirations
+            timer_initStruct(&timerfd->timer, interval, TIME_UNIT_NANOSECOND);
+            timerfd->intervalTick = timerfd->timer.tick;
+        }
+
+        timer_initStruct(&timerfd->timer, value, TIME_UNIT_NANOSECOND);
+        timerfd->timer.handler = __timerfd_timerHandler;
+        timerfd->timer.data = (Object)timerfd;
+        if (interval > 0) {
+            SET_FLAG_BACK(timerfd->timer.flags, TIMER_FLAGS_REPEAT);
+        }
+
+        timerfd->deadline = __timerfd_now() + value;
+        timer_start(&timerfd->timer);
+    }
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+void timerfd_getTime(Timerfd* timerfd, Int64* valueRet, Int64* intervalRet) {
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);
+    *valueRet = __timerfd_getRemaining(timerfd);
+    *intervalRet = timerfd->interval;
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+}
+
+static void __timerfd_release(Object object) {
+    Timerfd* timerfd = (Timerfd*)object;
+    DEBUG_ASSERT_SILENT(linkedList_isEmpty(&timerfd->pollQueue.entries));
+
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);
+    if (TEST_FLAGS(timerfd->timer.flags, TIMER_FLAGS_PRESENT)) {
+        timer_stop(&timerfd->timer);
+    }
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+
+    mm_free(timerfd);
+}
+
+static Int64 __timerfd_getRemaining(Timerfd* timerfd) {
+    if (timerfd->deadline < 0) {
+        return 0;
+    }
+
+    Int64 remaining = timerfd->deadline - __timerfd_now();
+    return remaining > 0 ? remaining : 1;   //Expired but not handled yet, still armed
+}
+
+static void __timerfd_timerHandler(Timer* timer) {
+    Timerfd* timerfd = (Timerfd*)timer->data;
+
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);
+    ++timerfd->expirationN;
+    if (timerfd->interval > 0) {
+        timerfd->deadline += timerfd->interval;
+        timer->tick = timerfd->intervalTick;    //Timer is added again with this tick after handler returns
+    } else {
+        timerfd->deadline = -1;
+    }
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+
+    pollWaitQueue_wakeup(&timerfd->pollQueue, POLL_EVENTS_IN);
+}
+
+static Uint64 __timerfd_takeExpirations(Timerfd* timerfd) {
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);
+    Uint64 ret = timerfd->expirationN;
+    timerfd->expirationN = 0;
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+
+    return ret;
+}
+
+static Index64 __timerfd_fsEntry_seek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __timerfd_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    if (n < sizeof(Uint64)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Timerfd* timerfd = timerfd_getFromFSentry(entry);
+    PollWaiter waiter;
+    bool waiting = false;
+    Uint64 expirationN;
+    while ((expirationN = __timerfd_takeExpirations(timerfd)) == 0) {
+        if (TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, timer may expire in between
+            pollWaiter_initStruct(&waiter, -1);
+            waiting = true;
+            poll_wait(&waiter.table, &timerfd->pollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        pollWaiter_sleep(&waiter);
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    memory_memcpy(buffer, &expirationN, sizeof(Uint64));
+
+    return sizeof(Uint64);
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static Size __timerfd_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static PollEvents __timerfd_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    Timerfd* timerfd = timerfd_getFromFSentry(entry);
+    poll_wait(table, &timerfd->pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    bool interruptEnabled = spinlock_lockIrqSave(&timerfd->lock);
+    bool expired = timerfd->expirationN > 0;
+    spinlock_unlockIrqRestore(&timerfd->lock, interruptEnabled);
+
+    return expired ? POLL_EVENTS_IN : EMPTY_FLAGS;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include<fs/tmpfs/pageTree.h>
+
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/frameMetadata.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<structs/refCounter.h>
+#include<system/pageTable.h>
+#include<algorithms.h>
+#include<debug.h>
+#include<error.h>
+
+static inline Size __tmpfsPageTree_capacity(Uint8 height) {
+    return POWER_2(height * TMPFS_PAGE_TREE_FANOUT_SHIFT);
+}
+
+static inline Index16 __tmpfsPageTree_slotIndex(Index64 pageIndex, Uint8 level) {
+    return VAL_RIGHT_SHIFT(pageIndex, (level - 1) * TMPFS_PAGE_TREE_FANOUT_SHIFT) & (TMPFS_PAGE_TREE_FANOUT - 1);
+}
+
+static void** __tmpfsPageTree_allocateNode();
+
+static void __tmpfsPageTree_grow(TmpfsPageTree* tree, Uint8 height);
+
+static Size __tmpfsPageTree_truncateNode(void** node, Uint8 level, Index64 beginPageIndex, Size pageN);
+
+void tmpfsPageTree_initStruct(TmpfsPageTree* tree) {
+    tree->root = NULL;
+    tree->height = 0;
+}
+
+void* tmpfsPageTree_get(TmpfsPageTree* tree, Index64 pageIndex) {
+    if (tree->root == NULL || pageIndex >= __tmpfsPageTree_capacity(tree->height)) {
+        return NULL;
+    }
+
+    void* current = tree->root;
+    for (Uint8 level = tree->height; level > 0 && current != NULL; --level) {
+        current = ((void**)current)[__tmpfsPageTree_slotIndex(pageIndex, level)];
+    }
+
+    return current;
+}
+
+void tmpfsPageTree_set(TmpfsPageTree* tree, Index64 pageIndex, void* frame) {
+    DEBUG_ASSERT_SILENT(frame != NULL && tmpfsPageTree_get(tree, pageIndex) == NULL);
+
+    if (tree->root == NULL && pageIndex == 0) { //Small file takes no node
+        tree->root = frame;
+        tree->height = 0;
+        return;
+    }
+
+    Uint8 height = algorithms_umax8(tree->height, 1);
+    while (pageIndex >= __tmpfsPageTree_capacity(height)) {
+        ++height;
+    }
+    DEBUG_ASSERT_SILENT(height <= TMPFS_PAGE_TREE_MAX_HEIGHT);
+
+    __tmpfsPageTree_grow(tree, height);
+    ERROR_GOTO_IF_ERROR(0);
+
+    void** node = tree->root;
+    for (Uint8 level = tree->height; level > 1; --level) {
+        Index16 slot = __tmpfsPageTree_slotIndex(pageIndex, level);
+        if (node[slot] == NULL) {
+            node[slot] = __tmpfsPageTree_allocateNode();
+            if (node[slot] == NULL) {   //Nodes allocated on the way stay empty, freed by truncate
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+        }
+        node = node[slot];
+    }
+    node[__tmpfsPageTree_slotIndex(pageIndex, 1)] = frame;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+Size tmpfsPageTree_truncate(TmpfsPageTree* tree, Size pageN) {
+    if (tree->root == NULL) {
+        return 0;
+    }
+
+    if (tree->height == 0) {
+        if (pageN > 0) {
+            return 0;
+        }
+
+        tmpfsPageTree_releaseFrame(tree->root);
+        tree->root = NULL;
+        return 1;
+    }
+
+    Size ret = __tmpfsPageTree_truncateNode(tree->root, tree->height, 0, pageN);
+    while (tree->height > 0 && pageN <= __tmpfsPageTree_capacity(tree->height - 1)) {  //Only first slot may be used, let it be the root
+        void** node = tree->root;
+        tree->root = node[0];
+        mm_freePages(node);
+        --tree->height;
+
+        if (tree->root == NULL) {
+            tree->height = 0;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+void tmpfsPageTree_releaseFrame(void* frame) {
+    FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(frame));
+    DEBUG_ASSERT_SILENT(unit != NULL);
+    if (REF_COUNTER_DEREFER(unit->refCounter) == 0) {   //Not mapped or referred anywhere
+        mm_freeFrames(frame, 1);
+    }
+}
+
+static void** __tmpfsPageTree_allocateNode() {
+    void** ret = mm_allocatePages(1);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+    memory_memset(ret, 0, PAGE_SIZE);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void __tmpfsPageTree_grow(TmpfsPageTree* tree, Uint8 height) {
+    if (tree->root == NULL) {
+        tree->root = __tmpfsPageTree_allocateNode();
+        if (tree->root == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        tree->height = height;
+        return;
+    }
+
+    if (tree->height == 0) {    //Frame of page 0 goes to first slot of a node
+        void** node = __tmpfsPageTree_allocateNode();
+        if (node == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        node[0] = tree->root;
+        tree->root = node;
+        tree->height = 1;
+    }
+
+    while (tree->height < height) { //Old tree becomes first subtree of new root
+        void** node = __tmpfsPageTree_allocateNode();
+        if (node == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        node[0] = tree->root;
+        tree->root = node;
+        ++tree->height;
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static Size __tmpfsPageTree_truncateNode(void** node, Uint8 level, Index64 beginPageIndex, Size pageN) {
+    Size ret = 0, span = __tmpfsPageTree_capacity(level - 1);
+    for (Index16 i = 0; i < TMPFS_PAGE_TREE_FANOUT; ++i) {
+        Index64 slotBegin = beginPageIndex + i * span;
+        if (slotBegin + span <= pageN || node[i] == NULL) {
+            continue;
+        }
+
+        if (level == 1) {
+            tmpfsPageTree_releaseFrame(node[i]);
+            node[i] = NULL;
+            ++ret;
+            continue;
+        }
+
+        ret += __tmpfsPageTree_truncateNode(node[i], level - 1, slotBegin, pageN);
+        if (slotBegin >= pageN) {
+            mm_freePages(node[i]);
+            node[i] = NULL;
+        }
+    }
+
+    return ret;
+}
\ No newline at end of file
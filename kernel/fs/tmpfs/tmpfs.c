@@ -0,0 +1,235 @@
+#include<fs/tmpfs/tmpfs.h>
+
+#include<devices/blockDevice.h>
+#include<fs/fs.h>
+#include<fs/fsEntry.h>
+#include<fs/fsNode.h>
+#include<fs/fscore.h>
+#include<fs/tmpfs/pageTree.h>
+#include<fs/tmpfs/vnode.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/frameMetadata.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<structs/string.h>
+#include<system/pageTable.h>
+#include<debug.h>
+#include<error.h>
+
+static vNode* __tmpfs_fscore_openVnode(FScore* fscore, fsNode* node);
+
+static void __tmpfs_fscore_closeVnode(FScore* fscore, vNode* vnode);
+
+static void __tmpfs_fscore_sync(FScore* fscore);
+
+static fsEntry* __tmpfs_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags);
+
+static ConstCstring __tmpfs_name = "TMPFS";
+static FScoreOperations __tmpfs_fscoreOperations = {
+    .openVnode      = __tmpfs_fscore_openVnode,
+    .closeVnode     = __tmpfs_fscore_closeVnode,
+    .sync           = __tmpfs_fscore_sync,
+    .openFSentry    = __tmpfs_fscore_openFSentry,
+    .closeFSentry   = fscore_genericCloseFSentry,
+    .mount          = fscore_genericMount,
+    .unmount        = fscore_genericUnmount
+};
+
+static fsEntryOperations _tmpfs_fsEntryOperations = {
+    .seek           = fsEntry_genericSeek,
+    .read           = fsEntry_genericRead,
+    .write          = tmpfs_vNode_write,
+    .poll           = NULL
+};
+
+void tmpfs_init() {
+}
+
+bool tmpfs_checkType(BlockDevice* blockDevice) {
+    return false;   //Never found on device, opened explicitly
+}
+
+void tmpfs_open(FS* fs, BlockDevice* blockDevice) {
+    DEBUG_ASSERT_SILENT(blockDevice == NULL);
+
+    Tmpfscore* tmpfscore = mm_allocate(sizeof(Tmpfscore));
+    if (tmpfscore == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    tmpfscore->nextInodeID  = 1;
+    tmpfscore->pageLimit    = TMPFS_DEFAULT_PAGE_LIMIT;
+    tmpfscore->pageNum      = 0;
+
+    FSnodeAttribute attribute;
+    fsnodeAttribute_initDefault(&attribute);
+    tmpfscore->rootInode = tmpfscore_createInode(tmpfscore, FS_ENTRY_TYPE_DIRECTORY, &attribute);  //Held by tmpfscore
+    if (tmpfscore->rootInode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+
+    FScore* fscore = &tmpfscore->fscore;
+    FScoreInitArgs args = {
+        .blockDevice        = blockDevice,
+        .operations         = &__tmpfs_fscoreOperations,
+        .rootVnodeID        = tmpfscore->rootInode->inodeID,
+        .rootFSnodePointsTo = (Index64)tmpfscore->rootInode
+    };
+
+    fscore_initStruct(fscore, &args);
+    ERROR_GOTO_IF_ERROR(2);
+
+    fs->fscore = fscore;
+    fs->name = __tmpfs_name;
+    fs->type = FS_TYPE_TMPFS;
+
+    return;
+    ERROR_FINAL_BEGIN(2);
+    tmpfscore_releaseInode(tmpfscore, tmpfscore->rootInode);
+    ERROR_FINAL_BEGIN(1);
+    mm_free(tmpfscore);
+    ERROR_FINAL_BEGIN(0);
+}
+
+void tmpfs_close(FS* fs) {
+    Tmpfscore* tmpfscore = HOST_POINTER(fs->fscore, Tmpfscore, fscore);
+    tmpfscore_releaseInode(tmpfscore, tmpfscore->rootInode);    //All files go with root
+    DEBUG_ASSERT_SILENT(tmpfscore->pageNum == 0);
+    mm_free(tmpfscore);
+}
+
+void tmpfscore_setPageLimit(Tmpfscore* tmpfscore, Size pageLimit) {
+    if (pageLimit < tmpfscore->pageNum) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    tmpfscore->pageLimit = pageLimit;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+TmpfsInode* tmpfscore_createInode(Tmpfscore* tmpfscore, fsEntryType type, FSnodeAttribute* attribute) {
+    TmpfsInode* ret = mm_allocate(sizeof(TmpfsInode));
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    ret->inodeID = tmpfscore->nextInodeID++;
+    ret->type = type;
+    REF_COUNTER_INIT(ret->refCounter, 1);
+    ret->size = 0;
+    memory_memcpy(&ret->attribute, attribute, sizeof(FSnodeAttribute));
+    mutex_initStruct(&ret->lock, EMPTY_FLAGS);
+    tmpfsPageTree_initStruct(&ret->pages);
+    linkedList_initStruct(&ret->children);
+    ret->nextCookie = 1;    //Cookie 0 is start of directory
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+void tmpfscore_releaseInode(Tmpfscore* tmpfscore, TmpfsInode* inode) {
+    if (REF_COUNTER_DEREFER(inode->refCounter) != 0) {
+        return;
+    }
+
+    while (!linkedList_isEmpty(&inode->children)) { //Only when whole fs closed, removing non-empty directory is refused
+        LinkedListNode* node = linkedListNode_getNext(&inode->children);
+        linkedListNode_delete(node);
+
+        TmpfsDirectoryEntry* entry = HOST_POINTER(node, TmpfsDirectoryEntry, node);
+        tmpfscore_releaseInode(tmpfscore, entry->inode);
+        string_clearStruct(&entry->name);
+        mm_free(entry);
+    }
+
+    tmpfscore->pageNum -= tmpfsPageTree_truncate(&inode->pages, 0); //Frames still mapped are freed when unmapped
+    mm_free(inode);
+}
+
+void* tmpfscore_allocateFrame(Tmpfscore* tmpfscore) {
+    if (tmpfscore->pageNum >= tmpfscore->pageLimit) {
+        ERROR_THROW(ERROR_ID_OUT_OF_MEMORY, 0);
+    }
+
+    void* ret = mm_allocateFrames(1);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    memory_memset(PAGING_CONVERT_KERNEL_MEMORY_P2V(ret), 0, PAGE_SIZE);
+    FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(ret));
+    DEBUG_ASSERT_SILENT(unit != NULL);
+    REF_COUNTER_INIT(unit->refCounter, 1);
+    ++tmpfscore->pageNum;
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static vNode* __tmpfs_fscore_openVnode(FScore* fscore, fsNode* node) {
+    TmpfsVnode* tmpfsVnode = mm_allocate(sizeof(TmpfsVnode));
+    if (tmpfsVnode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    TmpfsInode* inode = (TmpfsInode*)node->entry.pointsTo;
+    DEBUG_ASSERT_SILENT(inode->inodeID == node->entry.vnodeID && inode->type == node->entry.type);
+
+    vNode* vnode = &tmpfsVnode->vnode;
+    vNodeInitArgs args = {
+        .vnodeID        = inode->inodeID,
+        .tokenSpaceSize = ALIGN_UP(inode->size, PAGE_SIZE),
+        .size           = inode->size,
+        .fscore         = fscore,
+        .operations     = tmpfs_vNode_getOperations(),
+        .fsNode         = node,
+        .deviceID       = INVALID_ID
+    };
+    vNode_initStruct(vnode, &args);
+
+    REF_COUNTER_REFER(inode->refCounter);   //File stays readable after removed until closed
+    tmpfsVnode->inode = inode;
+
+    return vnode;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void __tmpfs_fscore_closeVnode(FScore* fscore, vNode* vnode) {
+    DEBUG_ASSERT_SILENT(REF_COUNTER_GET(vnode->refCounter) == 0);
+
+    TmpfsVnode* tmpfsVnode = HOST_POINTER(vnode, TmpfsVnode, vnode);
+    TmpfsInode* inode = tmpfsVnode->inode;
+    memory_memcpy(&inode->attribute, &vnode->fsNode->attribute, sizeof(FSnodeAttribute));  //Node may be forgotten after vnode closed
+    tmpfscore_releaseInode(HOST_POINTER(fscore, Tmpfscore, fscore), inode);
+
+    mm_free(tmpfsVnode);
+}
+
+static void __tmpfs_fscore_sync(FScore* fscore) {
+
+}
+
+static fsEntry* __tmpfs_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags) {
+    fsEntry* ret = fscore_genericOpenFSentry(fscore, vnode, flags);
+    ERROR_GOTO_IF_ERROR(0);
+
+    ret->operations = &_tmpfs_fsEntryOperations;
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
\ No newline at end of file
@@ -0,0 +1,437 @@
+#include<fs/tmpfs/vnode.h>
+
+#include<fs/directoryEntry.h>
+#include<fs/fsEntry.h>
+#include<fs/fsNode.h>
+#include<fs/fscore.h>
+#include<fs/tmpfs/pageTree.h>
+#include<fs/tmpfs/tmpfs.h>
+#include<fs/vnode.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/extendedPageTable.h>
+#include<memory/frameMetadata.h>
+#include<memory/memory.h>
+#include<memory/memoryOperations.h>
+#include<memory/mm.h>
+#include<memory/vms.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<structs/string.h>
+#include<system/pageTable.h>
+#include<algorithms.h>
+#include<cstring.h>
+#include<debug.h>
+#include<error.h>
+
+static void __tmpfs_vNode_readData(vNode* vnode, Index64 begin, void* buffer, Size byteN);
+
+static void __tmpfs_vNode_writeData(vNode* vnode, Index64 begin, const void* buffer, Size byteN);
+
+static void __tmpfs_vNode_resize(vNode* vnode, Size newSizeInByte);
+
+static Index64 __tmpfs_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr);
+
+static void __tmpfs_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirectory);
+
+static void __tmpfs_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName);
+
+static void __tmpfs_vNode_readDirectoryEntries(vNode* vnode);
+
+static void __tmpfs_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory);
+
+static Index64 __tmpfs_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);
+
+static void __tmpfs_vNode_syncAttribute(vNode* vnode);
+
+static TmpfsDirectoryEntry* __tmpfs_vNode_findEntry(TmpfsInode* directory, ConstCstring name, Size nameLength, bool isDirectory);
+
+static void __tmpfs_vNode_createChildNode(vNode* vnode, TmpfsDirectoryEntry* entry);
+
+static void* __tmpfs_vNode_getFrame(TmpfsVnode* tmpfsVnode, Index64 pageIndex);
+
+static void* __tmpfs_vNode_drawGetFrame(Object object, Index64 pageIndex);
+
+static vNodeOperations _tmpfs_vNodeOperations = {
+    .readData                   = __tmpfs_vNode_readData,
+    .writeData                  = __tmpfs_vNode_writeData,
+    .resize                     = __tmpfs_vNode_resize,
+    .addDirectoryEntry          = __tmpfs_vNode_addDirectoryEntry,
+    .removeDirectoryEntry       = __tmpfs_vNode_removeDirectoryEntry,
+    .renameDirectoryEntry       = __tmpfs_vNode_renameDirectoryEntry,
+    .readDirectoryEntries       = __tmpfs_vNode_readDirectoryEntries,
+    .lookupDirectoryEntry       = __tmpfs_vNode_lookupDirectoryEntry,
+    .iterateDirectoryEntries    = __tmpfs_vNode_iterateDirectoryEntries,
+    .syncAttribute              = __tmpfs_vNode_syncAttribute
+};
+
+vNodeOperations* tmpfs_vNode_getOperations() {
+    return &_tmpfs_vNodeOperations;
+}
+
+TmpfsVnode* tmpfs_vNode_getFromFSentry(fsEntry* entry) {
+    vNode* vnode = entry->vnode;
+    if (vnode == NULL || vnode->operations != &_tmpfs_vNodeOperations || vnode->fsNode->entry.type != FS_ENTRY_TYPE_FILE) {
+        return NULL;
+    }
+
+    return HOST_POINTER(vnode, TmpfsVnode, vnode);
+}
+
+void tmpfs_vNode_draw(TmpfsVnode* tmpfsVnode, VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable) {
+    TmpfsInode* inode = tmpfsVnode->inode;
+    virtualMemoryRegionInfo_drawFrames(info, pageTable, &inode->lock, &inode->size, __tmpfs_vNode_drawGetFrame, (Object)tmpfsVnode);
+}
+
+void* tmpfs_vNode_referFrame(TmpfsVnode* tmpfsVnode, Index64 pageIndex) {
+    TmpfsInode* inode = tmpfsVnode->inode;
+    mutex_acquire(&inode->lock);
+
+    void* ret = tmpfsPageTree_get(&inode->pages, pageIndex);
+    if (ret != NULL) {
+        FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(ret));
+        DEBUG_ASSERT_SILENT(unit != NULL);
+        REF_COUNTER_REFER(unit->refCounter);
+    }
+
+    mutex_release(&inode->lock);
+
+    return ret;
+}
+
+Size tmpfs_vNode_write(fsEntry* entry, const void* buffer, Size n) {
+    TmpfsVnode* tmpfsVnode = HOST_POINTER(entry->vnode, TmpfsVnode, vnode);
+    TmpfsInode* inode = tmpfsVnode->inode;
+    Tmpfscore* tmpfscore = HOST_POINTER(entry->vnode->fscore, Tmpfscore, fscore);
+    if (inode->type != FS_ENTRY_TYPE_FILE || n == 0) {
+        return fsEntry_genericWrite(entry, buffer, n);
+    }
+
+    mutex_acquire(&inode->lock);    //Held across resize and write, no truncate in between
+
+    Index64 endPageIndex = DIVIDE_ROUND_UP(entry->pointer + n, PAGE_SIZE);
+    for (Index64 i = entry->pointer / PAGE_SIZE; i < endPageIndex; ++i) {   //Take all frames before size changes, write hitting page limit leaves file as it was
+        if (__tmpfs_vNode_getFrame(tmpfsVnode, i) == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+    }
+
+    Size ret = fsEntry_genericWrite(entry, buffer, n);
+    ERROR_GOTO_IF_ERROR(1);
+
+    mutex_release(&inode->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    tmpfscore->pageNum -= tmpfsPageTree_truncate(&inode->pages, DIVIDE_ROUND_UP(inode->size, PAGE_SIZE));    //Give back frames taken beyond file
+    mutex_release(&inode->lock);
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static void __tmpfs_vNode_readData(vNode* vnode, Index64 begin, void* buffer, Size byteN) {
+    TmpfsInode* inode = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+    if (inode->type != FS_ENTRY_TYPE_FILE) {
+        ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+    }
+
+    mutex_acquire(&inode->lock);
+
+    if (begin + byteN > inode->size) {
+        ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 1);
+    }
+
+    for (Size remaining = byteN; remaining > 0;) {
+        Index64 offset = begin % PAGE_SIZE;
+        Size copyN = algorithms_umin64(remaining, PAGE_SIZE - offset);
+        void* frame = tmpfsPageTree_get(&inode->pages, begin / PAGE_SIZE);
+        if (frame == NULL) {    //Hole, reads as 0 without allocating
+            memory_memset(buffer, 0, copyN);
+        } else {
+            memory_memcpy(buffer, PAGING_CONVERT_KERNEL_MEMORY_P2V(frame) + offset, copyN);
+        }
+
+        buffer += copyN;
+        begin += copyN;
+        remaining -= copyN;
+    }
+
+    mutex_release(&inode->lock);
+
+    return;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&inode->lock);
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __tmpfs_vNode_writeData(vNode* vnode, Index64 begin, const void* buffer, Size byteN) {
+    TmpfsVnode* tmpfsVnode = HOST_POINTER(vnode, TmpfsVnode, vnode);
+    TmpfsInode* inode = tmpfsVnode->inode;
+    if (inode->type != FS_ENTRY_TYPE_FILE) {
+        ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+    }
+
+    mutex_acquire(&inode->lock);
+
+    if (begin + byteN > inode->size) {
+        ERROR_THROW(ERROR_ID_OUT_OF_BOUND, 1);
+    }
+
+    for (Size remaining = byteN; remaining > 0;) {
+        Index64 offset = begin % PAGE_SIZE;
+        Size copyN = algorithms_umin64(remaining, PAGE_SIZE - offset);
+        void* frame = __tmpfs_vNode_getFrame(tmpfsVnode, begin / PAGE_SIZE);
+        if (frame == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+        memory_memcpy(PAGING_CONVERT_KERNEL_MEMORY_P2V(frame) + offset, buffer, copyN);
+
+        buffer += copyN;
+        begin += copyN;
+        remaining -= copyN;
+    }
+
+    mutex_release(&inode->lock);
+
+    return;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&inode->lock);
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __tmpfs_vNode_resize(vNode* vnode, Size newSizeInByte) {
+    TmpfsInode* inode = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+    if (inode->type != FS_ENTRY_TYPE_FILE) {
+        return;
+    }
+
+    Tmpfscore* tmpfscore = HOST_POINTER(vnode->fscore, Tmpfscore, fscore);
+
+    mutex_acquire(&inode->lock);
+
+    Size newPageN = DIVIDE_ROUND_UP(newSizeInByte, PAGE_SIZE);
+    if (newSizeInByte < inode->size) {  //Growing takes no frame, pages are allocated when written
+        tmpfscore->pageNum -= tmpfsPageTree_truncate(&inode->pages, newPageN);
+
+        Index64 tailBegin = newSizeInByte % PAGE_SIZE;
+        void* tailFrame = tailBegin == 0 ? NULL : tmpfsPageTree_get(&inode->pages, newPageN - 1);
+        if (tailFrame != NULL) {    //Data cut off reads as 0 if file grows again
+            memory_memset(PAGING_CONVERT_KERNEL_MEMORY_P2V(tailFrame) + tailBegin, 0, PAGE_SIZE - tailBegin);
+        }
+    }
+
+    inode->size = vnode->fsNode->entry.size = vnode->size = newSizeInByte;
+    vnode->tokenSpaceSize = newPageN * PAGE_SIZE;
+
+    mutex_release(&inode->lock);
+}
+
+static Index64 __tmpfs_vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr) {
+    DEBUG_ASSERT_SILENT(directoryEntry_checkAdding(entry));
+
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode, * inode = NULL;
+    Tmpfscore* tmpfscore = HOST_POINTER(vnode->fscore, Tmpfscore, fscore);
+    TmpfsDirectoryEntry* tmpfsDirectoryEntry = NULL;
+
+    if (!(entry->type == FS_ENTRY_TYPE_FILE || entry->type == FS_ENTRY_TYPE_DIRECTORY)) {
+        ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+    }
+
+    if (__tmpfs_vNode_findEntry(directory, entry->name, cstring_strlen(entry->name), entry->type == FS_ENTRY_TYPE_DIRECTORY) != NULL) {
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
+    }
+
+    tmpfsDirectoryEntry = mm_allocate(sizeof(TmpfsDirectoryEntry));
+    if (tmpfsDirectoryEntry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    string_initStructStr(&tmpfsDirectoryEntry->name, entry->name);
+    ERROR_GOTO_IF_ERROR(1);
+
+    inode = tmpfscore_createInode(tmpfscore, entry->type, attr);   //Directory entry holds it
+    if (inode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(2);
+    }
+
+    tmpfsDirectoryEntry->inode = inode;
+    tmpfsDirectoryEntry->cookie = directory->nextCookie++;
+    linkedListNode_insertFront(&directory->children, &tmpfsDirectoryEntry->node);   //Appended, children are listed in creation order
+
+    entry->vnodeID = inode->inodeID;
+    entry->size = 0;
+    entry->pointsTo = (Index64)inode;
+
+    return entry->pointsTo;
+    ERROR_FINAL_BEGIN(2);
+    string_clearStruct(&tmpfsDirectoryEntry->name);
+    ERROR_FINAL_BEGIN(1);
+    mm_free(tmpfsDirectoryEntry);
+    ERROR_FINAL_BEGIN(0);
+    return INVALID_INDEX64;
+}
+
+static void __tmpfs_vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirectory) {
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+
+    TmpfsDirectoryEntry* tmpfsDirectoryEntry = __tmpfs_vNode_findEntry(directory, name, cstring_strlen(name), isDirectory);
+    if (tmpfsDirectoryEntry == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+
+    if (!linkedList_isEmpty(&tmpfsDirectoryEntry->inode->children)) {
+        ERROR_THROW(ERROR_ID_STATE_ERROR, 0);
+    }
+
+    linkedListNode_delete(&tmpfsDirectoryEntry->node);
+    tmpfscore_releaseInode(HOST_POINTER(vnode->fscore, Tmpfscore, fscore), tmpfsDirectoryEntry->inode);   //Data kept until opened vnode closed
+    string_clearStruct(&tmpfsDirectoryEntry->name);
+    mm_free(tmpfsDirectoryEntry);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __tmpfs_vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName) {
+    DEBUG_ASSERT_SILENT(moveTo->fscore == vnode->fscore);
+
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode, * moveToDirectory = HOST_POINTER(moveTo, TmpfsVnode, vnode)->inode;
+    bool isDirectory = entry->entry.type == FS_ENTRY_TYPE_DIRECTORY;
+
+    TmpfsDirectoryEntry* tmpfsDirectoryEntry = __tmpfs_vNode_findEntry(directory, entry->name.data, entry->name.length, isDirectory);
+    if (tmpfsDirectoryEntry == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+
+    if (__tmpfs_vNode_findEntry(moveToDirectory, newName, cstring_strlen(newName), isDirectory) != NULL) {
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
+    }
+
+    String name;
+    string_initStructStr(&name, newName);
+    ERROR_GOTO_IF_ERROR(0);
+
+    string_clearStruct(&tmpfsDirectoryEntry->name);
+    memory_memcpy(&tmpfsDirectoryEntry->name, &name, sizeof(String));
+
+    linkedListNode_delete(&tmpfsDirectoryEntry->node);
+    tmpfsDirectoryEntry->cookie = moveToDirectory->nextCookie++;    //Moved to tail, cookies keep increasing along children
+    linkedListNode_insertFront(&moveToDirectory->children, &tmpfsDirectoryEntry->node);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __tmpfs_vNode_readDirectoryEntries(vNode* vnode) {
+    DEBUG_ASSERT_SILENT(vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+
+    for (LinkedListNode* node = linkedListNode_getNext(&directory->children); node != &directory->children; node = linkedListNode_getNext(node)) {
+        __tmpfs_vNode_createChildNode(vnode, HOST_POINTER(node, TmpfsDirectoryEntry, node));
+        ERROR_GOTO_IF_ERROR(0);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __tmpfs_vNode_lookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory) {
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+
+    TmpfsDirectoryEntry* tmpfsDirectoryEntry = __tmpfs_vNode_findEntry(directory, name, nameLength, isDirectory);
+    if (tmpfsDirectoryEntry == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+
+    __tmpfs_vNode_createChildNode(vnode, tmpfsDirectoryEntry);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static Index64 __tmpfs_vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) {
+    DEBUG_ASSERT_SILENT(vnode->fsNode->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+    TmpfsInode* directory = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+
+    Index64 ret = algorithms_umax64(cookie, directory->nextCookie);
+    for (LinkedListNode* node = linkedListNode_getNext(&directory->children); node != &directory->children; node = linkedListNode_getNext(node)) {
+        TmpfsDirectoryEntry* entry = HOST_POINTER(node, TmpfsDirectoryEntry, node);
+        if (entry->cookie < cookie) {   //Entries removed before cookie do not shift the rest
+            continue;
+        }
+
+        if (!func(arg, entry->name.data, entry->name.length, entry->inode->type, entry->inode->inodeID, entry->cookie + 1)) {
+            ret = entry->cookie;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+static void __tmpfs_vNode_syncAttribute(vNode* vnode) {
+    TmpfsInode* inode = HOST_POINTER(vnode, TmpfsVnode, vnode)->inode;
+    memory_memcpy(&inode->attribute, &vnode->fsNode->attribute, sizeof(FSnodeAttribute));
+}
+
+static TmpfsDirectoryEntry* __tmpfs_vNode_findEntry(TmpfsInode* directory, ConstCstring name, Size nameLength, bool isDirectory) {
+    DEBUG_ASSERT_SILENT(directory->type == FS_ENTRY_TYPE_DIRECTORY);
+
+    for (LinkedListNode* node = linkedListNode_getNext(&directory->children); node != &directory->children; node = linkedListNode_getNext(node)) {
+        TmpfsDirectoryEntry* entry = HOST_POINTER(node, TmpfsDirectoryEntry, node);
+        if (entry->name.length == nameLength && memory_memcmp(entry->name.data, name, nameLength) == 0 && (entry->inode->type == FS_ENTRY_TYPE_DIRECTORY) == isDirectory) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void __tmpfs_vNode_createChildNode(vNode* vnode, TmpfsDirectoryEntry* entry) {
+    TmpfsInode* inode = entry->inode;
+    DirectoryEntry directoryEntry = (DirectoryEntry) {
+        .name       = entry->name.data,
+        .type       = inode->type,
+        .mode       = 0,    //TODO: Support for mode
+        .vnodeID    = inode->inodeID,
+        .size       = inode->size,
+        .pointsTo   = (Index64)inode
+    };
+
+    fsnode_create(&directoryEntry, INFINITE, &inode->attribute, vnode->fsNode);
+}
+
+static void* __tmpfs_vNode_getFrame(TmpfsVnode* tmpfsVnode, Index64 pageIndex) {
+    TmpfsInode* inode = tmpfsVnode->inode;
+    void* ret = tmpfsPageTree_get(&inode->pages, pageIndex);
+    if (ret != NULL) {
+        return ret;
+    }
+
+    Tmpfscore* tmpfscore = HOST_POINTER(tmpfsVnode->vnode.fscore, Tmpfscore, fscore);
+    ret = tmpfscore_allocateFrame(tmpfscore);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    tmpfsPageTree_set(&inode->pages, pageIndex, ret);
+    ERROR_GOTO_IF_ERROR(1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_freeFrames(ret, 1);
+    --tmpfscore->pageNum;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void* __tmpfs_vNode_drawGetFrame(Object object, Index64 pageIndex) {
+    return __tmpfs_vNode_getFrame((TmpfsVnode*)object, pageIndex);
+}
\ No newline at end of file
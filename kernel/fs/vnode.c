@@ -11,9 +11,18 @@
 #include<structs/hashTable.h>
 #include<structs/refCounter.h>
 #include<structs/singlyLinkedList.h>
+#include<algorithms.h>
 #include<debug.h>
 #include<error.h>
 
+static LinkedList _vNode_dirtyList;
+static Spinlock _vNode_dirtyLock;
+
+void vNode_init() {
+    linkedList_initStruct(&_vNode_dirtyList);
+    _vNode_dirtyLock = SPINLOCK_UNLOCKED;
+}
+
 void vNode_initStruct(vNode* vnode, vNodeInitArgs* args) {
     vnode->signature        = VNODE_SIGNATURE;
     vnode->vnodeID          = args->vnodeID;
@@ -31,6 +40,7 @@ void vNode_initStruct(vNode* vnode, vNodeInitArgs* args) {
     
     vnode->fsNode           = args->fsNode;
     vnode->lock             = SPINLOCK_UNLOCKED;
+    linkedListNode_initStruct(&vnode->dirtyNode);
 }
 
 void vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr) {
@@ -39,11 +49,25 @@ void vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribut
     DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
 
     spinlock_lock(&vnode->lock);
+
+    found = fsnode_lookup(node, entry->name, entry->type == FS_ENTRY_TYPE_DIRECTORY, vnode->operations->lookupDirectoryEntry != NULL);  //Cheap with known children or lookup by name, fs checks itself otherwise
+    if (found != NULL) {
+        fsnode_derefer(found);
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
+    }
+    ERROR_CHECKPOINT({
+            ERROR_GOTO(0);
+        },
+        (ERROR_ID_NOT_FOUND, {
+            ERROR_CLEAR();
+            break;
+        })
+    );
     
     Index64 pointsTo = vNode_rawAddDirectoryEntry(vnode, entry, attr);  //TODO: Seem fs are not setting vnodeID correctly
     ERROR_GOTO_IF_ERROR(0);
 
-    if (FSNODE_GET_DIRFSNODE(node)->dirPart.childrenNum != FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM) {
+    if (fsnode_isChildrenKnown(node)) { //New child is looked up by name if only some children are known
         fsnode_forgetAllDirectoryEntries(node);
     }
     
@@ -104,3 +128,97 @@ void vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, Cons
         spinlock_unlock(&vnode->lock);
     }
 }
+
+Index64 vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) {
+    fsNode* node = vnode->fsNode;
+    DEBUG_ASSERT_SILENT(node->vnode == vnode);
+    DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
+
+    if (vnode->operations->iterateDirectoryEntries != NULL) {
+        spinlock_lock(&vnode->lock);
+        Index64 ret = vNode_rawIterateDirectoryEntries(vnode, cookie, func, arg);
+        spinlock_unlock(&vnode->lock);
+        return ret;
+    }
+
+    spinlock_lock(&node->lock);
+    fsnode_readDirectoryEntries(node);  //Fallback, cookie is index of child
+    ERROR_GOTO_IF_ERROR(0);
+
+    LinkedList* children = &FSNODE_GET_DIRFSNODE(node)->dirPart.children;
+    Index64 index = 0;
+    for (LinkedListNode* childNode = linkedListNode_getNext(children); childNode != children; childNode = linkedListNode_getNext(childNode), ++index) {
+        if (index < cookie) {
+            continue;
+        }
+
+        fsNode* child = HOST_POINTER(childNode, fsNode, childNode);
+        if (!func(arg, child->name.data, child->name.length, child->entry.type, child->entry.vnodeID, index + 1)) {
+            break;
+        }
+    }
+    spinlock_unlock(&node->lock);
+
+    return algorithms_umax64(index, cookie);
+    ERROR_FINAL_BEGIN(0);
+    spinlock_unlock(&node->lock);
+    return INVALID_INDEX64;
+}
+
+void vNode_markAttributeDirty(vNode* vnode) {
+    if (vnode->operations->syncAttribute == NULL) {
+        return;
+    }
+
+    if (TEST_FLAGS_FAIL(vnode->fscore->flags, FSCORE_FLAGS_LAZYTIME)) {
+        vNode_rawSyncAttribute(vnode);
+        return;
+    }
+
+    spinlock_lock(&_vNode_dirtyLock);
+    if (vnode->dirtyNode.next == NULL) {
+        linkedListNode_insertFront(&_vNode_dirtyList, &vnode->dirtyNode);
+    }
+    spinlock_unlock(&_vNode_dirtyLock);
+}
+
+void vNode_clearAttributeDirty(vNode* vnode) {
+    spinlock_lock(&_vNode_dirtyLock);
+    if (vnode->dirtyNode.next != NULL) {
+        linkedListNode_delete(&vnode->dirtyNode);
+        linkedListNode_initStruct(&vnode->dirtyNode);
+    }
+    spinlock_unlock(&_vNode_dirtyLock);
+}
+
+void vNode_syncDirtyAttributes() {
+    while (true) {
+        vNode* vnode = NULL;
+
+        spinlock_lock(&_vNode_dirtyLock);
+        while (!linkedList_isEmpty(&_vNode_dirtyList)) {
+            LinkedListNode* node = linkedListNode_getNext(&_vNode_dirtyList);
+            linkedListNode_delete(node);
+            linkedListNode_initStruct(node);
+
+            vNode* dirty = HOST_POINTER(node, vNode, dirtyNode);
+            if (REF_COUNTER_GET(dirty->fsNode->vNodeRefCounter) == 0) {  //Being closed, closing writes attribute back
+                continue;
+            }
+
+            fsnode_requestVnode(dirty->fscore, dirty->fsNode);  //Keep vnode open while writing
+            vnode = dirty;
+            break;
+        }
+        spinlock_unlock(&_vNode_dirtyLock);
+
+        if (vnode == NULL) {
+            break;
+        }
+
+        vNode_rawSyncAttribute(vnode);
+        ERROR_CLEAR();  //Attribute is written back again when vnode closed
+
+        fsnode_releaseVnode(vnode->fscore, vnode->fsNode);  //Pair with fsnode_requestVnode above
+    }
+}
\ No newline at end of file
@@ -11,6 +11,7 @@ typedef Uint32 DeviceID;
 typedef Uint32 MajorDeviceID;
 typedef Uint32 MinorDeviceID;
 
+#include<fs/poll.h>
 #include<kit/bit.h>
 #include<kit/oop.h>
 #include<structs/RBtree.h>
@@ -87,6 +88,8 @@ typedef struct DeviceOperations {
     void (*writeUnits)(Device* device, Index64 unitIndex, const void* buffer, Size unitN);
 
     void (*flush)(Device* device);
+
+    PollEvents (*poll)(Device* device, PollTable* table);   //NULL if device never blocks
 } DeviceOperations;
 
 static inline void device_rawReadUnits(Device* device, Index64 unitIndex, void* buffer, Size unitN) {
@@ -101,4 +104,12 @@ static inline void device_rawFlush(Device* device) {
     device->operations->flush(device);
 }
 
+static inline PollEvents device_poll(Device* device, PollTable* table) {
+    if (device->operations->poll == NULL) {
+        return POLL_EVENTS_DEFAULT;
+    }
+
+    return device->operations->poll(device, table);
+}
+
 #endif // __DEVICES_DEVICE_H
@@ -3,12 +3,14 @@
 
 typedef struct InputFIFO InputFIFO;
 
+#include<fs/poll.h>
 #include<multitask/locks/semaphore.h>
 #include<structs/fifo.h>
 
 typedef struct InputFIFO {
     FIFO fifo;
     Semaphore lineNumSema;
+    PollWaitQueue pollQueue;    //Woken up when a line is ready
 } InputFIFO;
 
 void inputFIFO_initStruct(InputFIFO* fifo);
@@ -19,4 +21,8 @@ char inputFIFO_getChar(InputFIFO* fifo);
 
 Size inputFIFO_getLine(InputFIFO* fifo, Cstring buffer, Size n);
 
+static inline bool inputFIFO_hasLine(InputFIFO* fifo) {
+    return fifo->lineNumSema.counter > 0;
+}
+
 #endif // __DEVICES_TERMINAL_INPUTFIFO_H
@@ -7,6 +7,7 @@ typedef struct TeletypeDevice TeletypeDevice;
 
 #include<devices/display/display.h>
 #include<devices/charDevice.h>
+#include<fs/poll.h>
 #include<kit/types.h>
 #include<print.h>
 
@@ -18,6 +19,7 @@ typedef struct TeletypeOperations {
     Size (*read)(Teletype* tty, void* buffer, Size n);
     Size (*write)(Teletype* tty, const void* buffer, Size n);
     void (*flush)(Teletype* tty);
+    PollEvents (*poll)(Teletype* tty, PollTable* table);    //NULL if tty has no input
 } TeletypeOperations;
 
 typedef struct TeletypeDevice {
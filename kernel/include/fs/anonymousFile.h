@@ -0,0 +1,31 @@
+#if !defined(__FS_ANONYMOUSFILE_H)
+#define __FS_ANONYMOUSFILE_H
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<kit/types.h>
+
+typedef void (*AnonymousFileReleaseFunc)(Object object);
+
+/**
+ * @brief Create an fs entry not backed by any file system, for kernel objects exposed as file descriptors (e.g. eventfd)
+ *
+ * @param name Name of entry
+ * @param operations Operations of entry, also identifies type of object behind it
+ * @param release Called when last entry of object is closed, NULL if nothing to release
+ * @param object Object behind entry
+ * @param flags Open flags of entry
+ * @return fsEntry* Entry of object, NULL if error happens, object is not released in that case
+ */
+fsEntry* anonymousFile_create(ConstCstring name, fsEntryOperations* operations, AnonymousFileReleaseFunc release, Object object, FCNTLopenFlags flags);
+
+/**
+ * @brief Get object behind anonymous fs entry
+ *
+ * @param entry fs entry
+ * @param operations Operations given when creating, used to check type of object
+ * @return Object Object behind entry, OBJECT_NULL if entry is not an anonymous file with given operations
+ */
+Object anonymousFile_getObject(fsEntry* entry, fsEntryOperations* operations);
+
+#endif // __FS_ANONYMOUSFILE_H
@@ -0,0 +1,88 @@
+#if !defined(__FS_EPOLL_H)
+#define __FS_EPOLL_H
+
+typedef struct Epoll Epoll;
+typedef struct EpollEvent EpollEvent;
+
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<multitask/locks/mutex.h>
+#include<multitask/locks/spinlock.h>
+#include<structs/linkedList.h>
+
+//Low 16 bits are PollEvents
+#define EPOLL_EVENTS_ONESHOT        FLAG32(30)  //Disabled after reported once, until modified again
+#define EPOLL_EVENTS_EDGE_TRIGGERED FLAG32(31)  //Reported only when readiness changes, level triggered by default
+#define EPOLL_EVENTS_PRIVATE        (EPOLL_EVENTS_ONESHOT | EPOLL_EVENTS_EDGE_TRIGGERED)
+
+#define EPOLL_CONTROL_ADD           1
+#define EPOLL_CONTROL_DELETE        2
+#define EPOLL_CONTROL_MODIFY        3
+
+#define EPOLL_MAX_NEST_DEPTH        5   //Max epolls in a chain watching each other, wakeup recurses once per epoll
+
+typedef struct EpollEvent {
+    Uint32  events;
+    Uint64  data;   //Returned as is
+} __attribute__((packed)) EpollEvent;   //Same layout as struct epoll_event in user space
+
+/**
+ * @brief Interest list of fs entries, wakers put entries with events to ready list, so collecting events is O(ready) instead of O(watched)
+ */
+typedef struct Epoll {
+    Mutex           lock;       //Lock for interest list
+    LinkedList      items;
+    Spinlock        readyLock;  //Wakers may be in interrupt, always lock with interrupt disabled
+    LinkedList      readyList;  //Items may have events
+    PollWaitQueue   pollQueue;  //Threads in epoll_wait and pollers of epoll itself, woken up when item gets ready
+} Epoll;
+
+void epoll_init();
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @return fsEntry* Entry of epoll, the only way to release it is to close all entries
+ */
+fsEntry* epoll_create();
+
+/**
+ * @brief Get epoll behind fs entry
+ *
+ * @param entry fs entry
+ * @return Epoll* Epoll of entry, NULL if entry is not an epoll
+ */
+Epoll* epoll_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Remove items watching entry from all epolls, called before entry is closed
+ *
+ * @param entry Entry being closed
+ */
+void epoll_closeFSentry(fsEntry* entry);
+
+/**
+ * @brief Add, modify or delete watched entry
+ *
+ * @param epoll Epoll
+ * @param op EPOLL_CONTROL_XXX
+ * @param fd File descriptor of target, used as key with target
+ * @param target Entry to watch, epoll keeps its vnode until deleted or target closed, adding an epoll fails with ERROR_ID_LOOP if it watches this epoll or the chain gets deeper than EPOLL_MAX_NEST_DEPTH
+ * @param event Events interested and data returned, not used for deleting
+ */
+void epoll_control(Epoll* epoll, int op, int fd, fsEntry* target, EpollEvent* event);
+
+/**
+ * @brief Wait for events on watched entries
+ *
+ * @param epoll Epoll
+ * @param events Buffer for events
+ * @param maxEventN Max number of events to return
+ * @param timeout Timeout in nanosecond, 0 for not waiting, negative for infinite
+ * @return Size Number of events, 0 if timed out
+ */
+Size epoll_wait(Epoll* epoll, EpollEvent* events, Size maxEventN, Int64 timeout);
+
+#endif // __FS_EPOLL_H
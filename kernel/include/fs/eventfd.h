@@ -0,0 +1,53 @@
+#if !defined(__FS_EVENTFD_H)
+#define __FS_EVENTFD_H
+
+typedef struct Eventfd Eventfd;
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<multitask/locks/spinlock.h>
+
+#define EVENTFD_FLAGS_SEMAPHORE FLAG8(0)    //Read decreases counter by 1 instead of taking whole counter
+
+#define EVENTFD_COUNTER_MAX     0xFFFFFFFFFFFFFFFEull
+
+/**
+ * @brief 64-bit counter as file, read takes value out and write adds value in, for wakeups across threads and from interrupts
+ */
+typedef struct Eventfd {
+    Spinlock        lock;   //Counter may be signaled in interrupt, always lock with interrupt disabled
+    Uint64          counter;
+    Flags8          flags;
+    PollWaitQueue   pollQueue;
+} Eventfd;
+
+/**
+ * @brief Create an eventfd
+ *
+ * @param initValue Initial value of counter
+ * @param flags EVENTFD_FLAGS_XXX
+ * @param openFlags Open flags of entry, FCNTL_OPEN_NONBLOCK is respected
+ * @return fsEntry* Entry of eventfd, the only way to release it is to close all entries
+ */
+fsEntry* eventfd_create(Uint64 initValue, Flags8 flags, FCNTLopenFlags openFlags);
+
+/**
+ * @brief Get eventfd behind fs entry
+ *
+ * @param entry fs entry
+ * @return Eventfd* Eventfd of entry, NULL if entry is not an eventfd
+ */
+Eventfd* eventfd_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Add value to counter from kernel, never blocks, counter saturates at EVENTFD_COUNTER_MAX, can be called in interrupt
+ *
+ * @param eventfd Eventfd
+ * @param n Value to add
+ */
+void eventfd_signal(Eventfd* eventfd, Uint64 n);
+
+#endif // __FS_EVENTFD_H
@@ -0,0 +1,83 @@
+#if !defined(__FS_EXT2_DIRECTORYINDEX_H)
+#define __FS_EXT2_DIRECTORYINDEX_H
+
+#include<fs/ext2/ext2.h>
+#include<fs/ext2/inode.h>
+#include<fs/vnode.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+
+#define EXT2_DIRECTORY_INDEX_HASH_LEGACY            0
+#define EXT2_DIRECTORY_INDEX_HASH_HALF_MD4          1
+#define EXT2_DIRECTORY_INDEX_HASH_TEA               2
+#define EXT2_DIRECTORY_INDEX_HASH_LEGACY_UNSIGNED   3
+#define EXT2_DIRECTORY_INDEX_HASH_HALF_MD4_UNSIGNED 4
+#define EXT2_DIRECTORY_INDEX_HASH_TEA_UNSIGNED      5
+
+#define EXT2_DIRECTORY_INDEX_MAX_INDIRECT_LEVEL     2   //Index levels below root readable
+#define EXT2_DIRECTORY_INDEX_MAX_WRITE_LEVEL        1   //Index levels below root created by splitting, deeper index needs large_dir of ext4
+
+typedef struct EXT2directoryIndexFrame {
+    Index32 block;          //Index block in directory, 0 for root
+    Uint16  entriesBegin;   //Offset of index entries in block
+    Uint16  position;       //Index entry followed down to next level
+} EXT2directoryIndexFrame;
+
+/**
+ * @brief Walked path from root of index down to a leaf, kept for following collisions and adding split leaves
+ */
+typedef struct EXT2directoryIndexPath {
+    Uint8                   hashVersion;    //Unsigned variants already resolved
+    Uint8                   frameNum;       //Index blocks walked through, leaf is below the last one
+    Uint32                  seed[4];
+    Uint32                  hash;           //Hash of name walked for
+    Index32                 leaf;
+    EXT2directoryIndexFrame frames[EXT2_DIRECTORY_INDEX_MAX_INDIRECT_LEVEL + 1];
+} EXT2directoryIndexPath;
+
+static inline bool ext2DirectoryIndex_isIndexed(EXT2fscore* fscore, EXT2inode* inode) {
+    return TEST_FLAGS(fscore->superBlock->optimalFeatures, EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_DIRECTORY_HASH_INDEX) && TEST_FLAGS(inode->flags, EXT2_INODE_FALGS_HASH_INDEX_DIRECTORY);
+}
+
+/**
+ * @brief Hash name as hashed directory (htree) does
+ *
+ * @param name Name, not necessarily NULL-terminated
+ * @param nameLength Length of name
+ * @param hashVersion EXT2_DIRECTORY_INDEX_HASH_XXX
+ * @param seed Hash seed in superblock
+ * @return Uint32 Major hash of name, lowest bit is always 0
+ */
+Uint32 ext2DirectoryIndex_hash(ConstCstring name, Size nameLength, Uint8 hashVersion, Uint32* seed);
+
+/**
+ * @brief Walk index of hashed directory down to the leaf block may hold name
+ *
+ * @param vnode vNode of hashed directory
+ * @param name Name, not necessarily NULL-terminated
+ * @param nameLength Length of name
+ * @param pathRet Path walked, valid only if leaf found
+ * @return Index32 Leaf block in directory, INVALID_INDEX32 if index is not usable, directory should be scanned linearly then
+ */
+Index32 ext2DirectoryIndex_findLeaf(vNode* vnode, ConstCstring name, Size nameLength, EXT2directoryIndexPath* pathRet);
+
+/**
+ * @brief Move path to next leaf if it continues hash of path, name may be in following leaves when hash collides across them
+ *
+ * @param vnode vNode of hashed directory
+ * @param path Path returned by ext2DirectoryIndex_findLeaf
+ * @return Index32 Next leaf block, INVALID_INDEX32 if next leaf begins with another hash
+ */
+Index32 ext2DirectoryIndex_nextLeaf(vNode* vnode, EXT2directoryIndexPath* path);
+
+/**
+ * @brief Add a leaf split from leaf of path to index, full index blocks are split, full root moves its entries one level down
+ *
+ * @param vnode vNode of hashed directory
+ * @param path Path to leaf split
+ * @param hash Lowest hash in new leaf, lowest bit set if it continues a hash of leaf split
+ * @param leaf New leaf block, follows leaf split
+ */
+void ext2DirectoryIndex_addLeaf(vNode* vnode, EXT2directoryIndexPath* path, Uint32 hash, Index32 leaf);
+
+#endif // __FS_EXT2_DIRECTORYINDEX_H
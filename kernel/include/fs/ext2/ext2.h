@@ -6,6 +6,7 @@ typedef struct EXT2fscore EXT2fscore;
 
 #include<devices/blockDevice.h>
 #include<fs/ext2/blockGroup.h>
+#include<fs/ext2/inode.h>
 #include<fs/fs.h>
 #include<fs/fscore.h>
 #include<kit/bit.h>
@@ -62,7 +63,7 @@ typedef struct EXT2SuperBlock {
 #define EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_HAS_JOURNAL                 FLAG32(2)
 #define EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_INODE_EXTENDED_ATTRIBUTE    FLAG32(3)
 #define EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_RESIZE                      FLAG32(4)
-#define EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_DIRECTORY_HASH_INDEX        FLAG32(4)
+#define EXT2_SUPERBLOCK_IN_STORAGE_OPTIMAL_FEATURES_DIRECTORY_HASH_INDEX        FLAG32(5)
     Flags32 optimalFeatures;
 #define EXT2_SUPERBLOCK_IN_STORAGE_REUQUIRED_FEATURES_COMPRESSION           FLAG32(0)
 #define EXT2_SUPERBLOCK_IN_STORAGE_REUQUIRED_FEATURES_DIRECTORY_ENTRY_TYPE  FLAG32(1)
@@ -84,7 +85,13 @@ typedef struct EXT2SuperBlock {
     Uint32 journalInode;
     Uint32 journalDevice;
     Uint32 orphanInodeListHead;
-    Uint8 unused2[276];
+    Uint32 hashSeed[4];             //Seed of directory index hash, all 0 for default seed
+    Uint8 defaultHashVersion;
+    Uint8 unused2[99];
+#define EXT2_SUPERBLOCK_IN_STORAGE_FLAGS_SIGNED_HASH    FLAG32(0)
+#define EXT2_SUPERBLOCK_IN_STORAGE_FLAGS_UNSIGNED_HASH  FLAG32(1)   //Directory index hashes chars as unsigned
+    Flags32 flags;
+    Uint8 unused3[156];
 } __attribute__((packed)) EXT2SuperBlock;
 
 DEBUG_ASSERT_COMPILE(sizeof(EXT2SuperBlock) == 512);
@@ -124,6 +131,8 @@ Index32 ext2fscore_allocateInode(EXT2fscore* fscore, Index32 preferredBlockGroup
 
 void ext2fscore_freeInode(EXT2fscore* fscore, Index32 index);
 
+void ext2fscore_writeInode(EXT2fscore* fscore, Index32 inodeID, EXT2inode* inode);
+
 void ext2_init();
 
 bool ext2_checkType(BlockDevice* blockDevice);
@@ -46,7 +46,7 @@ typedef struct EXT2inode {
 #define EXT2_INODE_FALGS_APPEND_ONLY            FLAG32(5)
 #define EXT2_INODE_FALGS_NOT_FOR_DUMP           FLAG32(6)
 #define EXT2_INODE_FALGS_NO_LAST_ACCESS         FLAG32(7)
-#define EXT2_INODE_FALGS_HASH_INDEX_DIRECTORY   FLAG32(16)
+#define EXT2_INODE_FALGS_HASH_INDEX_DIRECTORY   FLAG32(12)
 #define EXT2_INODE_FALGS_AFS_DIRECTORY          FLAG32(17)
 #define EXT2_INODE_FALGS_JOURNAL_FILE_DATA      FLAG32(18)
     Flags32 flags;
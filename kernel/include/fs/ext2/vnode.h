@@ -14,4 +14,12 @@ typedef struct EXT2vnode {
 
 vNodeOperations* ext2_vNode_getOperations();
 
+/**
+ * @brief Grow file by one block
+ *
+ * @param vnode vNode of file
+ * @return Index32 Index of new block in file, INVALID_INDEX32 if failed
+ */
+Index32 ext2_vNode_appendBlock(vNode* vnode);
+
 #endif // __FS_EXT2_VNODE_H
@@ -10,11 +10,42 @@ typedef enum {
     FAT32_CLUSTER_TYPE_NOT_CLUSTER
 } FAT32ClusterType;
 
+typedef struct FAT32clusterExtent FAT32clusterExtent;
+typedef struct FAT32clusterMap FAT32clusterMap;
+
 #include<fs/fat32/fat32.h>
 #include<kit/types.h>
 
 #define FAT32_CLSUTER_END_OF_CHAIN 0x0FFFFFFF
 
+typedef struct FAT32clusterExtent {
+    Index32 logicalBegin;   //Index of first cluster of run in chain
+    Index32 physicalBegin;
+    Size    length;
+} FAT32clusterExtent;
+
+//Cluster chain of a file as runs of contiguous clusters, so cluster at any position is found in O(log runs)
+typedef struct FAT32clusterMap {
+    FAT32clusterExtent* extents;    //Sorted by logical begin
+    Size                extentNum;
+    Size                extentCapacity;
+    Size                clusterNum;
+} FAT32clusterMap;
+
+/**
+ * @brief Scan FAT for free clusters, fill free cluster bitmap and index of free runs, called when fs opened
+ *
+ * @param fscore FAT32 fscore, FAT and free cluster bitmap should be ready
+ */
+void fat32_buildFreeClusterIndex(FAT32fscore* fscore);
+
+/**
+ * @brief Release index of free runs, called when fs closed
+ *
+ * @param fscore FAT32 fscore
+ */
+void fat32_clearFreeClusterIndex(FAT32fscore* fscore);
+
 FAT32ClusterType fat32_getClusterType(FAT32fscore* fscore, Index32 cluster);
 
 Index32 fat32_getCluster(FAT32fscore* fscore, Index32 firstCluster, Index32 index);
@@ -23,7 +54,15 @@ Index32 fat32_stepCluster(FAT32fscore* fscore, Index32 firstCluster, Size n, Siz
 
 Size fat32_getClusterChainLength(FAT32fscore* fscore, Index32 firstCluster);
 
-Index32 fat32_allocateClusterChain(FAT32fscore* fscore, Size length);
+/**
+ * @brief Allocate a cluster chain, taken in as few runs as possible, continues right after near cluster if it can
+ *
+ * @param fscore FAT32 fscore
+ * @param length Number of clusters
+ * @param nearCluster Cluster chain should follow, like last cluster of file, INVALID_INDEX32 if no preference
+ * @return Index32 First cluster of chain, INVALID_INDEX32 if error happens
+ */
+Index32 fat32_allocateClusterChain(FAT32fscore* fscore, Size length, Index32 nearCluster);
 
 void fat32_freeClusterChain(FAT32fscore* fscore, Index32 clusterChainFirst);
 
@@ -31,4 +70,42 @@ Index32 fat32_cutClusterChain(FAT32fscore* fscore, Index32 cluster);
 
 void fat32_insertClusterChain(FAT32fscore* fscore, Index32 cluster, Index32 clusterChainFirst);
 
+/**
+ * @brief Build map of cluster chain, run by run with fat32_stepCluster
+ *
+ * @param fscore FAT32 fscore
+ * @param map Map to build
+ * @param firstCluster First cluster of chain, empty map if not allocated
+ */
+void fat32_buildClusterMap(FAT32fscore* fscore, FAT32clusterMap* map, Index32 firstCluster);
+
+/**
+ * @brief Append a chain to end of map, called before chain linked to tail of mapped chain
+ *
+ * @param fscore FAT32 fscore
+ * @param map Map to extend
+ * @param firstCluster First cluster of chain appended
+ */
+void fat32_extendClusterMap(FAT32fscore* fscore, FAT32clusterMap* map, Index32 firstCluster);
+
+/**
+ * @brief Forget clusters from given position, called when chain cut
+ *
+ * @param map Map to truncate
+ * @param clusterNum Number of clusters kept
+ */
+void fat32_truncateClusterMap(FAT32clusterMap* map, Size clusterNum);
+
+void fat32_clearClusterMap(FAT32clusterMap* map);
+
+/**
+ * @brief Get physical cluster at position of chain
+ *
+ * @param map Map of chain
+ * @param index Position in chain
+ * @param continousRet Number of contiguous clusters from returned cluster to end of its run
+ * @return Index32 Physical cluster, INVALID_INDEX32 if error happens
+ */
+Index32 fat32_mapCluster(FAT32clusterMap* map, Index32 index, Size* continousRet);
+
 #endif // __FS_FAT32_CLUSTER_H
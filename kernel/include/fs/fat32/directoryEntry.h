@@ -15,6 +15,8 @@ typedef struct FAT32UnknownTypeEntry FAT32UnknownTypeEntry;
 #include<debug.h>
 
 typedef struct FAT32DirectoryEntry {
+#define FAT32_DIRECTORY_ENTRY_END_MARK              0x00    //First byte of name, no entry follows
+#define FAT32_DIRECTORY_ENTRY_DELETED_MARK          0xE5    //First byte of name, entry removed but its slot kept
 #define FAT32_DIRECTORY_ENTRY_NAME_MAIN_LENGTH      8
 #define FAT32_DIRECTORY_ENTRY_NAME_EXT_LENGTH       3
 #define FAT32_DIRECTORY_ENTRY_NAME_LENGTH           (FAT32_DIRECTORY_ENTRY_NAME_MAIN_LENGTH + FAT32_DIRECTORY_ENTRY_NAME_EXT_LENGTH)
@@ -73,7 +75,15 @@ static inline bool fat32_directoryEntry_isUsingLongNameEntry(FAT32UnknownTypeEnt
     return entry->attribute == FAT32_DIRECTORY_ENTRY_LONG_NAME_ATTRIBUTE;
 }
 
+static inline bool fat32_directoryEntry_isDeleted(FAT32UnknownTypeEntry* entry) {
+    return *((Uint8*)entry) == FAT32_DIRECTORY_ENTRY_DELETED_MARK;
+}
+
 static inline Size fat32_directoryEntry_getEntriesLength(FAT32UnknownTypeEntry* entry) {
+    if (fat32_directoryEntry_isDeleted(entry)) {    //Every entry of removed entries is marked, skip them one by one
+        return sizeof(FAT32UnknownTypeEntry);
+    }
+
     if (fat32_directoryEntry_isUsingLongNameEntry(entry)) {
         FAT32LongNameEntry* longName = (FAT32LongNameEntry*)entry;
         DEBUG_ASSERT_SILENT(TEST_FLAGS(longName->order, FAT32_DIRECTORY_ENTRY_LONG_NAME_FLAG));
@@ -84,8 +94,7 @@ static inline Size fat32_directoryEntry_getEntriesLength(FAT32UnknownTypeEntry*
 }
 
 static inline bool fat32_directoryEntry_isEnd(FAT32UnknownTypeEntry* entry) {
-    Uint8 firstByte = *((Uint8*)entry);
-    return firstByte == 0x00 || firstByte == 0xE5;
+    return *((Uint8*)entry) == FAT32_DIRECTORY_ENTRY_END_MARK;
 }
 
 void fat32_directoryEntry_parse(FAT32UnknownTypeEntry* entriesBegin, String* nameOut, Flags8* attributeOut, FSnodeAttribute* fsnodeAttributeOut, Index32* firstClusterOut, Size* sizeOut);
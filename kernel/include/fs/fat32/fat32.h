@@ -3,6 +3,7 @@
 
 typedef struct FAT32fscore FAT32fscore;
 typedef struct FAT32BPB FAT32BPB;
+typedef struct FAT32FSinfo FAT32FSinfo;
 
 #include<devices/blockDevice.h>
 #include<fs/directoryEntry.h>
@@ -10,6 +11,8 @@ typedef struct FAT32BPB FAT32BPB;
 #include<fs/fsNode.h>
 #include<fs/fscore.h>
 #include<kit/types.h>
+#include<structs/bitmap.h>
+#include<structs/RBtree.h>
 
 typedef struct FAT32fscore {
     FScore              fscore;
@@ -22,7 +25,10 @@ typedef struct FAT32fscore {
     FAT32BPB*           BPB;
     Index32*            FAT;
 
-    Index32             firstFreeCluster;
+    Bitmap              freeClusters;       //Bit set if cluster is free
+    RBtree              freeExtents;        //Runs of free clusters keyed by first cluster
+    Index32             nextFreeHint;       //Where allocation without preference begins
+    Bitmap              dirtyFATsectors;    //Bit set if FAT sector changed since last sync
 
     #define FAT32_FSCORE_VNODE_TABLE_CHAIN_NUM  31
     HashTable           metadataTableFirstCluster;
@@ -61,6 +67,19 @@ typedef struct FAT32BPB {
     char    systemIdentifier[8];
 } __attribute__((packed)) FAT32BPB;
 
+typedef struct FAT32FSinfo {
+    Uint32  leadSignature;
+#define FAT32_FSINFO_LEAD_SIGNATURE     0x41615252
+    Uint8   reserved1[480];
+    Uint32  structSignature;
+#define FAT32_FSINFO_STRUCT_SIGNATURE   0x61417272
+    Uint32  freeClusterNum;
+    Uint32  nextFreeCluster;
+    Uint8   reserved2[12];
+    Uint32  trailSignature;
+#define FAT32_FSINFO_TRAIL_SIGNATURE    0xAA550000
+} __attribute__((packed)) FAT32FSinfo;
+
 void fat32_init();
 
 bool fat32_checkType(BlockDevice* blockDevice);
@@ -4,6 +4,7 @@
 typedef struct FAT32vnode FAT32vnode;
 
 #include<kit/types.h>
+#include<fs/fat32/cluster.h>
 #include<fs/fsEntry.h>
 #include<fs/vnode.h>
 #include<fs/fscore.h>
@@ -11,6 +12,7 @@ typedef struct FAT32vnode FAT32vnode;
 typedef struct FAT32vnode {
     vNode vnode;
     Index32 firstCluster;
+    FAT32clusterMap clusterMap; //Built when opened, kept up to date by resize
 } FAT32vnode;
 
 void fat32_vNode_init();
@@ -21,9 +21,7 @@ typedef Flags32 FCNTLopenFlags;
 #define FCNTL_OPEN_NOCTTY                       FLAG32(10)  //If file is terminal device, process haver no control on it
 #define FCNTL_OPEN_TRUNC                        FLAG32(12)  //Truncate to length 0 if is file and allow writing
 #define FCNTL_OPEN_APPEND                       FLAG32(13)  //Data only apeend to end, ignoring seek
-//TODO: Not implemented
-#define FCNTL_OPEN_NONBLOCK                     FLAG32(14)  //Open file in nonblocking mode if possible
-//TODO: Not implemented
+#define FCNTL_OPEN_NONBLOCK                     FLAG32(14)  //Open file in nonblocking mode if possible, only pipes, eventfd, signalfd and timerfd honor it for now
 #define FCNTL_OPEN_NDELAY                       FCNTL_OPEN_NONBLOCK
 //TODO: Not implemented
 #define FCNTL_OPEN_DSYNC                        FLAG32(16)  //Same as SYNC, for now
@@ -51,4 +49,11 @@ typedef Flags32 FCNTLopenFlags;
 #define FCNTL_OPEN_FILE_DEFAULT_FLAGS           FCNTL_OPEN_READ_WRITE
 #define FCNTL_OPEN_DIRECTORY_DEFAULT_FLAGS      FCNTL_OPEN_READ_WRITE | FCNTL_OPEN_DIRECTORY
 
+#define FCNTL_OPEN_STATUS_FLAGS_MASK            (FCNTL_OPEN_APPEND | FCNTL_OPEN_NONBLOCK | FCNTL_OPEN_NOATIME)  //Flags can be changed by F_SETFL
+
+#define FCNTL_COMMAND_GETFL                     3       //Get file status flags
+#define FCNTL_COMMAND_SETFL                     4       //Set file status flags
+#define FCNTL_COMMAND_SETPIPE_SZ                1031    //Set capacity of pipe
+#define FCNTL_COMMAND_GETPIPE_SZ                1032    //Get capacity of pipe
+
 #endif // __FS_FCNTL_H
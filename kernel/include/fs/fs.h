@@ -5,6 +5,7 @@ typedef enum {
     FS_TYPE_FAT32,
     FS_TYPE_EXT2,
     FS_TYPE_DEVFS,
+    FS_TYPE_TMPFS,
     FS_TYPE_NUM,
     FS_TYPE_UNKNOWN
 } FStype;
@@ -15,6 +16,7 @@ typedef struct FS_fileStat FS_fileStat;
 #include<devices/blockDevice.h>
 #include<fs/vnode.h>
 #include<fs/fscore.h>
+#include<fs/poll.h>
 #include<kit/oop.h>
 #include<kit/types.h>
 #include<time/time.h>
@@ -47,8 +49,17 @@ typedef struct FS {
     FStype          type;
 } FS;
 
+#define FS_SYNC_INTERVAL    5   //In second, dirty attributes of lazytime mounts are written back at this interval
+
 void fs_init();
 
+void fs_syncDaemon();
+
+/**
+ * @brief Start daemon writing dirty attributes back periodically, timer should be initialized
+ */
+void fs_startSyncDaemon();
+
 /**
  * @brief Check type of file system on device
  * 
@@ -78,9 +89,30 @@ File* fs_fileOpen(ConstCstring absolutePath, FCNTLopenFlags flags);
 
 void fs_fileClose(File* file);
 
-void fs_fileRead(File* file, void* buffer, Size n);
+Size fs_fileRead(File* file, void* buffer, Size n);   //Returns number of bytes read, may be less than n for pipes and devices
+
+Size fs_fileWrite(File* file, const void* buffer, Size n);
+
+#define FS_FILE_TRANSFER_BUFFER_SIZE    (16 * PAGE_SIZE)    //Bounce buffer for transfers no end can take directly
 
-void fs_fileWrite(File* file, const void* buffer, Size n);
+/**
+ * @brief Move data between files without going through user space, pipe ends read or write their ring buffer directly, pages of tmpfs file are written out without copying
+ *
+ * @param to File to write, from its pointer
+ * @param from File to read, from its pointer, if it is same file as to, ranges read and written should not overlap
+ * @param n Max number of bytes to move
+ * @return Size Number of bytes moved, may be less than n like fs_fileRead, 0 means EOF, error after some bytes moved is not reported until next call
+ */
+Size fs_fileTransfer(File* to, File* from, Size n);
+
+/**
+ * @brief Get current events of file and register table to its wait queues
+ * 
+ * @param file File
+ * @param table Poll table, NULL if only current events wanted
+ * @return PollEvents Current events, entries without poll operation are always readable and writable
+ */
+PollEvents fs_filePoll(File* file, PollTable* table);
 
 #define FS_FILE_SEEK_BEGIN      0
 #define FS_FILE_SEEK_CURRENT    1
@@ -119,5 +151,6 @@ void fs_fileStat(File* file, FS_fileStat* stat);
 
 extern FS* fs_rootFS;
 extern FS* fs_devFS;
+extern FS* fs_tmpFS;
 
 #endif // __FS_FS_H
@@ -7,6 +7,7 @@ typedef enum {
     FS_ENTRY_TYPE_DIRECTORY,
     FS_ENTRY_TYPE_DEVICE,
     FS_ENTRY_TYPE_PIPE,
+    FS_ENTRY_TYPE_ANONYMOUS,    //Kernel object exposed as file (e.g. epoll), not in any file system
 } fsEntryType;
 
 typedef struct fsEntry fsEntry;
@@ -20,11 +21,13 @@ typedef fsEntry File;
 #include<fs/fcntl.h>
 #include<fs/vnode.h>
 #include<fs/fscore.h>
+#include<fs/poll.h>
 #include<kit/bit.h>
 #include<kit/oop.h>
 #include<kit/types.h>
 #include<structs/string.h>
 #include<structs/hashTable.h>
+#include<structs/linkedList.h>
 
 //Real fs entry for process
 typedef struct fsEntry {    //TODO: Add RW lock
@@ -33,14 +36,17 @@ typedef struct fsEntry {    //TODO: Add RW lock
     Index64                 pointer;
     vNode*                  vnode;
     fsEntryOperations*      operations;
+    LinkedList              epollItems; //Epoll items watching this entry, removed when entry closed
 } fsEntry;
 
 typedef struct fsEntryOperations {
     Index64 (*seek)(fsEntry* entry, Index64 seekTo);
 
-    void (*read)(fsEntry* entry, void* buffer, Size n);
+    Size (*read)(fsEntry* entry, void* buffer, Size n);  //Returns number of bytes read, 0 means EOF
 
-    void (*write)(fsEntry* entry, const void* buffer, Size n);
+    Size (*write)(fsEntry* entry, const void* buffer, Size n);   //Returns number of bytes written
+
+    PollEvents (*poll)(fsEntry* entry, PollTable* table);   //Returns current events and register table to wait queues through poll_wait, NULL if entry never blocks
 } fsEntryOperations;
 
 static inline bool fsEntryType_isDevice(fsEntryType type) {
@@ -51,12 +57,16 @@ static inline Index64 fsEntry_rawSeek(fsEntry* entry, Size seekTo) {
     return entry->operations->seek(entry, seekTo);
 } 
 
-static inline void fsEntry_rawRead(fsEntry* entry, void* buffer, Size n) {
-    entry->operations->read(entry, buffer, n);
+static inline Size fsEntry_rawRead(fsEntry* entry, void* buffer, Size n) {
+    return entry->operations->read(entry, buffer, n);
 } 
 
-static inline void fsEntry_rawWrite(fsEntry* entry, const void* buffer, Size n) {
-    entry->operations->write(entry, buffer, n);
+static inline Size fsEntry_rawWrite(fsEntry* entry, const void* buffer, Size n) {
+    return entry->operations->write(entry, buffer, n);
+}
+
+static inline PollEvents fsEntry_rawPoll(fsEntry* entry, PollTable* table) {
+    return entry->operations->poll(entry, table);
 }
 
 void fsEntry_initStruct(fsEntry* entry, vNode* vnode, fsEntryOperations* operations, FCNTLopenFlags flags);
@@ -65,9 +75,9 @@ void fsEntry_clearStruct(fsEntry* entry);
 
 Index64 fsEntry_genericSeek(fsEntry* entry, Index64 seekTo);
 
-void fsEntry_genericRead(fsEntry* entry, void* buffer, Size n);
+Size fsEntry_genericRead(fsEntry* entry, void* buffer, Size n);
 
-void fsEntry_genericWrite(fsEntry* entry, const void* buffer, Size n);
+Size fsEntry_genericWrite(fsEntry* entry, const void* buffer, Size n);
 
 fsEntry* fsEntry_copy(fsEntry* entry);
 
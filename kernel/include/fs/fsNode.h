@@ -36,25 +36,25 @@ typedef struct fsNode {
     RefCounter32        refCounter; //How many instances requires this node to work
 
     LinkedListNode      childNode;
-    HashChainNode       childHashNode;
+    HashChainNode       childHashNode;  //Node in global dentry cache, keyed by parent, name and type
     fsNode*             parent;
 
     vNode*              vnode;
-    vNode*              mount;
+    vNode*              mount;      //Root vnode of fs mounted here, NULL if not a mount point
 
     RefCounter32        vNodeRefCounter;    //How many time is vnode referred
     
     Spinlock            lock;
+    bool                mounted;    //Is root of a mounted fs, mount point is found by fscore_lookupMount
 } fsNode;
 
 typedef struct fsNodeDirPart {
     LinkedList          children;
-    HashTable           childrenHash;
 #define FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM    (Uint32)-1
     Uint32              childrenNum;
     RefCounter32        livingChildNum; //Contained by refCounter
-#define FSNODE_DIR_PART_CHILDREN_HASH_CHAIN_SIZE    3
-    SinglyLinkedList    childrenHashChains[FSNODE_DIR_PART_CHILDREN_HASH_CHAIN_SIZE];
+    LinkedListNode      lruNode;        //Node in dentry cache LRU list, valid while children are known
+    bool                partial;        //Only children looked up by name are known, so a miss is not negative
 } fsNodeDirPart;
 
 typedef struct DirFSnode {
@@ -64,7 +64,17 @@ typedef struct DirFSnode {
 
 #define FSNODE_GET_DIRFSNODE(__NODE)    HOST_POINTER(__NODE, DirFSnode, node)
 
-DEBUG_ASSERT_COMPILE(IS_POWER_2(sizeof(DirFSnode)));
+static inline bool fsnode_isChildrenKnown(fsNode* node) {   //All children known, a miss in dentry cache is a negative entry
+    fsNodeDirPart* part = &FSNODE_GET_DIRFSNODE(node)->dirPart;
+    return part->childrenNum != FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM && !part->partial;
+}
+
+DEBUG_ASSERT_COMPILE(sizeof(DirFSnode) <= 256);  //Fits in one 256 bytes heap block
+
+#define FSNODE_DCACHE_HASH_CHAIN_SIZE   1024
+#define FSNODE_DCACHE_MAX_NODE_NUM      4096    //Children of least recently used directories are forgotten beyond this
+
+void fsnode_init();
 
 fsNode* fsnode_create(DirectoryEntry* entry, Size nameN, FSnodeAttribute* attribute, fsNode* parent);
 
@@ -74,6 +84,18 @@ bool fsnode_derefer(fsNode* node);
 
 fsNode* fsnode_lookup(fsNode* node, ConstCstring name, bool isDirectory, bool autoRead);
 
+/**
+ * @brief Look up child by name in dentry cache, no memory allocated
+ *
+ * @param node Directory node
+ * @param name Name of child, not necessarily NULL-terminated
+ * @param nameLength Length of name
+ * @param isDirectory Is child a directory
+ * @param autoRead Look child up in storage if not known yet, vnode of node must be opened, only child named is read if fs supports it
+ * @return fsNode* Child referred once, NULL with ERROR_ID_NOT_FOUND thrown if not exist
+ */
+fsNode* fsnode_lookupN(fsNode* node, ConstCstring name, Size nameLength, bool isDirectory, bool autoRead);
+
 void fsnode_setVnode(fsNode* node, vNode* vnode);
 
 void fsnode_setMount(fsNode* node, vNode* mountVnode);
@@ -82,6 +104,11 @@ void fsnode_requestVnode(FScore* fscore, fsNode* node);
 
 bool fsnode_releaseVnode(FScore* fscore, fsNode* node);
 
+/**
+ * @brief Read all children of directory, children already looked up by name are kept, nothing done if all children are known
+ *
+ * @param node Directory node, vnode must be opened
+ */
 void fsnode_readDirectoryEntries(fsNode* node);
 
 void fsnode_forgetAllDirectoryEntries(fsNode* node);
@@ -13,16 +13,26 @@ typedef struct Mount Mount;
 #include<fs/fsNode.h>
 #include<fs/vnode.h>
 #include<kit/atomic.h>
+#include<kit/bit.h>
 #include<kit/types.h>
+#include<structs/hashTable.h>
+#include<structs/linkedList.h>
 #include<structs/RBtree.h>
 #include<structs/string.h>
 
+#define FSCORE_FLAGS_RELATIME   FLAG8(0)    //Update access time only if it is not newer than modify time or older than FSCORE_RELATIME_INTERVAL
+#define FSCORE_FLAGS_LAZYTIME   FLAG8(1)    //Keep timestamp changes in memory until periodic sync or vnode closed
+#define FSCORE_FLAGS_DEFAULT    (FSCORE_FLAGS_RELATIME | FSCORE_FLAGS_LAZYTIME)
+
+#define FSCORE_RELATIME_INTERVAL    86400   //In second
+
 typedef struct FScore {
     BlockDevice*        blockDevice;
     FScoreOperations*   operations;
 
     fsNode*             rootFSnode;
     LinkedList          mounted;
+    Flags8              flags;      //FSCORE_FLAGS_XXX, set by mount
 } FScore;
 
 typedef struct FScoreOperations {
@@ -47,11 +57,15 @@ typedef struct FScoreInitArgs {
 
 //Stands for a mount instance in directory
 typedef struct Mount {
-    String          path;
-    LinkedListNode  node;
+    LinkedListNode  node;               //Node in mounted list of mount point's fscore
+    HashChainNode   hashNode;           //Node in mount hash, keyed by fscore and root node of mounted fs
+    fsNode*         mountPoint;
+    FScore*         mountPointFScore;
     vNode*          mountedVnode;
 } Mount;
 
+#define FSCORE_MOUNT_HASH_CHAIN_SIZE    31
+
 static inline vNode* fscore_rawOpenVnode(FScore* fscore, fsNode* node) {
     return fscore->operations->openVnode(fscore, node);
 }
@@ -80,10 +94,26 @@ static inline void fscore_rawUnmount(FScore* fscore, fsIdentifier* mountPoint) {
     fscore->operations->unmount(fscore, mountPoint);
 }
 
+void fscore_init();
+
 void fscore_initStruct(FScore* fscore, FScoreInitArgs* args);
 
 fsNode* fscore_getFSnode(FScore* fscore, fsIdentifier* identifier, FScore** finalFScoreOut, bool followMount);
 
+/**
+ * @brief Resolve path component by component on fsNodes, no memory allocated if all nodes on path are cached
+ * 
+ * @param fscore FScore of base node
+ * @param baseNode Node to begin with, leading separators are skipped, so absolute paths should begin with a root node
+ * @param path Path to resolve, not necessarily NULL-terminated, "." and ".." are handled
+ * @param pathLength Length of path
+ * @param isDirectory Is last component a directory, others must be
+ * @param followMount Cross mount points, including the last component
+ * @param finalFScoreOut FScore of returned node
+ * @return fsNode* Node referred once, NULL if error happens
+ */
+fsNode* fscore_walk(FScore* fscore, fsNode* baseNode, ConstCstring path, Size pathLength, bool isDirectory, bool followMount, FScore** finalFScoreOut);
+
 void fscore_releaseFSnode(fsNode* node);
 
 vNode* fscore_getVnode(FScore* fscore, fsNode* node, bool followMount);
@@ -98,6 +128,13 @@ void fscore_genericMount(FScore* fscore, fsIdentifier* mountPoint, vNode* mountV
 
 void fscore_genericUnmount(FScore* fscore, fsIdentifier* mountPoint);
 
-Mount* fscore_lookupMount(FScore* fscore, ConstCstring path);
+/**
+ * @brief Find where a fs is mounted, in O(1), mount points themselves are found by fsNode::mount
+ * 
+ * @param fscore FScore of mounted fs
+ * @param mountedRoot Root node of mounted fs
+ * @return Mount* Mount instance, NULL if not mounted
+ */
+Mount* fscore_lookupMount(FScore* fscore, fsNode* mountedRoot);
 
 #endif // __FS_FSCORE_H
@@ -0,0 +1,96 @@
+#if !defined(__FS_POLL_H)
+#define __FS_POLL_H
+
+#include<kit/types.h>
+
+typedef struct PollWaitQueue PollWaitQueue;
+typedef struct PollTableEntry PollTableEntry;
+typedef struct PollTable PollTable;
+typedef struct PollRequest PollRequest;
+
+typedef Flags16 PollEvents;
+
+#include<kit/bit.h>
+#include<multitask/locks/spinlock.h>
+#include<structs/linkedList.h>
+#include<structs/singlyLinkedList.h>
+
+//Same values as POLLXXX in user space
+#define POLL_EVENTS_IN          FLAG16(0)   //Data to read
+#define POLL_EVENTS_PRI         FLAG16(1)   //Urgent data to read
+#define POLL_EVENTS_OUT         FLAG16(2)   //Writing will not block
+#define POLL_EVENTS_ERR         FLAG16(3)   //Error condition, e.g. write end of pipe without reader
+#define POLL_EVENTS_HUP         FLAG16(4)   //Hang up, e.g. read end of pipe without writer
+#define POLL_EVENTS_NVAL        FLAG16(5)   //Invalid file descriptor
+#define POLL_EVENTS_ALWAYS      (POLL_EVENTS_ERR | POLL_EVENTS_HUP | POLL_EVENTS_NVAL)  //Reported even not requested
+#define POLL_EVENTS_DEFAULT     (POLL_EVENTS_IN | POLL_EVENTS_OUT)                      //For entries never block (e.g. regular files)
+
+/**
+ * @brief Queue of poll tables interested in an I/O source, source wakes it up when its readiness changes
+ */
+typedef struct PollWaitQueue {
+    Spinlock    lock;   //Source may wake it up in interrupt, always lock with interrupt disabled
+    LinkedList  entries;
+} PollWaitQueue;
+
+typedef void (*PollWakeupFunc)(PollTableEntry* entry, PollEvents events);
+
+typedef struct PollTableEntry {
+    LinkedListNode          node;       //Node in wait queue
+    SinglyLinkedListNode    tableNode;  //Node in poll table
+    PollWaitQueue*          queue;
+    PollTable*              table;
+} PollTableEntry;
+
+/**
+ * @brief Registrations of one poller, entries are added by poll operations through poll_wait
+ */
+typedef struct PollTable {
+    PollWakeupFunc      wakeup; //Called with queue locked and interrupt disabled, may be in interrupt
+    SinglyLinkedList    entries;
+} PollTable;
+
+typedef struct PollRequest {
+    struct fsEntry* entry;      //fs/fsEntry.h includes this header, use struct tag here
+    PollEvents      events;     //Events interested
+    PollEvents      revents;    //Events happened
+} PollRequest;
+
+void pollWaitQueue_initStruct(PollWaitQueue* queue);
+
+/**
+ * @brief Notify all pollers on queue, can be called in interrupt
+ *
+ * @param queue Wait queue
+ * @param events Events happened, pollers not interested may ignore it, EMPTY_FLAGS means unknown
+ */
+void pollWaitQueue_wakeup(PollWaitQueue* queue, PollEvents events);
+
+void pollTable_initStruct(PollTable* table, PollWakeupFunc wakeup);
+
+/**
+ * @brief Remove all registrations of poll table
+ *
+ * @param table Poll table
+ */
+void pollTable_clearStruct(PollTable* table);
+
+/**
+ * @brief Register poll table to wait queue, called by poll operations of I/O sources
+ *
+ * @param table Poll table, NULL means caller only wants current events
+ * @param queue Wait queue of source
+ */
+void poll_wait(PollTable* table, PollWaitQueue* queue);
+
+/**
+ * @brief Wait for events on fs entries, O(n) for each scan
+ *
+ * @param requests Entries and events interested, revents is set on return
+ * @param n Number of requests
+ * @param timeout Timeout in nanosecond, 0 for not waiting, negative for infinite
+ * @return Size Number of requests with revents set, 0 if timed out
+ */
+Size poll_poll(PollRequest* requests, Size n, Int64 timeout);
+
+#endif // __FS_POLL_H
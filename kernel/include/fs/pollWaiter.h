@@ -0,0 +1,45 @@
+#if !defined(__FS_POLLWAITER_H)
+#define __FS_POLLWAITER_H
+
+typedef struct PollWaiter PollWaiter;
+
+#include<fs/poll.h>
+#include<kit/types.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+#include<time/timer.h>
+
+/**
+ * @brief Poll table sleeping current thread until any registered queue is woken up or timed out
+ */
+typedef struct PollWaiter {
+    PollTable   table;
+    Thread*     thread;
+    bool        triggered;  //Any queue woken up since last sleep
+    bool        sleeping;
+    bool        timedOut;
+    Int64       timeout;    //In nanosecond, negative for infinite
+    bool        timerStarted;
+    Timer       timer;
+    Wait        wait;
+} PollWaiter;
+
+/**
+ * @brief Initialize a waiter for current thread
+ *
+ * @param waiter Waiter
+ * @param timeout Timeout in nanosecond, negative for infinite
+ */
+void pollWaiter_initStruct(PollWaiter* waiter, Int64 timeout);
+
+void pollWaiter_clearStruct(PollWaiter* waiter);
+
+/**
+ * @brief Sleep until any registered queue is woken up, returns at once if woken up since last sleep, timer starts at first sleep
+ *
+ * @param waiter Waiter
+ * @return bool False if timed out
+ */
+bool pollWaiter_sleep(PollWaiter* waiter);
+
+#endif // __FS_POLLWAITER_H
@@ -0,0 +1,57 @@
+#if !defined(__FS_SIGNALFD_H)
+#define __FS_SIGNALFD_H
+
+typedef struct Signalfd Signalfd;
+typedef struct SignalfdSiginfo SignalfdSiginfo;
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<kit/types.h>
+
+/**
+ * @brief Pending signals in mask read as records, signals should be blocked by thread or they are handled before read
+ */
+typedef struct Signalfd {
+    Flags32 mask;
+} Signalfd;
+
+typedef struct SignalfdSiginfo {
+    Uint32  signo;
+    Int32   errno;
+    Int32   code;
+    Uint32  pid;
+    Uint32  uid;
+    Int32   fd;
+    Uint32  tid;
+    Uint32  band;
+    Uint32  overrun;
+    Uint32  trapno;
+    Int32   status;
+    Int32   value;
+    Uint64  ptr;
+    Uint64  utime;
+    Uint64  stime;
+    Uint64  addr;
+    Uint8   reserved[40];
+} SignalfdSiginfo;  //Same layout as struct signalfd_siginfo in user space
+
+/**
+ * @brief Create a signalfd
+ *
+ * @param mask Signals to read, SIGNAL_MASK_UNBLOCKABLE is ignored
+ * @param openFlags Open flags of entry, FCNTL_OPEN_NONBLOCK is respected
+ * @return fsEntry* Entry of signalfd, the only way to release it is to close all entries
+ */
+fsEntry* signalfd_create(Flags32 mask, FCNTLopenFlags openFlags);
+
+/**
+ * @brief Get signalfd behind fs entry
+ *
+ * @param entry fs entry
+ * @return Signalfd* Signalfd of entry, NULL if entry is not a signalfd
+ */
+Signalfd* signalfd_getFromFSentry(fsEntry* entry);
+
+void signalfd_setMask(Signalfd* signalfd, Flags32 mask);
+
+#endif // __FS_SIGNALFD_H
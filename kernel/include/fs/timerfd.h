@@ -0,0 +1,64 @@
+#if !defined(__FS_TIMERFD_H)
+#define __FS_TIMERFD_H
+
+typedef struct Timerfd Timerfd;
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<kit/types.h>
+#include<multitask/locks/spinlock.h>
+#include<time/timer.h>
+
+/**
+ * @brief Kernel timer as file, read returns number of expirations since last read
+ */
+typedef struct Timerfd {
+    Spinlock        lock;           //Timer handler runs in interrupt, always lock with interrupt disabled
+    Timer           timer;
+    Int64           interval;       //In nanosecond, 0 for one-shot
+    Int64           intervalTick;   //Interval in timer tick, set to timer after first expiration
+    Int64           deadline;       //Monotonic time of next expiration in nanosecond, -1 if disarmed
+    Uint64          expirationN;    //Expirations not read yet
+    bool            realtime;       //Absolute time is on realtime clock instead of monotonic clock
+    PollWaitQueue   pollQueue;
+} Timerfd;
+
+/**
+ * @brief Create a disarmed timerfd
+ *
+ * @param realtime Use realtime clock for absolute time
+ * @param openFlags Open flags of entry, FCNTL_OPEN_NONBLOCK is respected
+ * @return fsEntry* Entry of timerfd, the only way to release it is to close all entries
+ */
+fsEntry* timerfd_create(bool realtime, FCNTLopenFlags openFlags);
+
+/**
+ * @brief Get timerfd behind fs entry
+ *
+ * @param entry fs entry
+ * @return Timerfd* Timerfd of entry, NULL if entry is not a timerfd
+ */
+Timerfd* timerfd_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Arm or disarm timer, expirations not read are dropped
+ *
+ * @param timerfd Timerfd
+ * @param value Time to first expiration in nanosecond, 0 to disarm
+ * @param interval Time between later expirations in nanosecond, 0 for one-shot
+ * @param oldValueRet Remaining time before setting, 0 if disarmed, NULL if not needed
+ * @param oldIntervalRet Interval before setting, NULL if not needed
+ */
+void timerfd_setTime(Timerfd* timerfd, Int64 value, Int64 interval, Int64* oldValueRet, Int64* oldIntervalRet);
+
+/**
+ * @brief Get remaining time and interval of timer
+ *
+ * @param timerfd Timerfd
+ * @param valueRet Remaining time in nanosecond, 0 if disarmed
+ * @param intervalRet Interval in nanosecond
+ */
+void timerfd_getTime(Timerfd* timerfd, Int64* valueRet, Int64* intervalRet);
+
+#endif // __FS_TIMERFD_H
@@ -0,0 +1,58 @@
+#if !defined(__FS_TMPFS_PAGETREE_H)
+#define __FS_TMPFS_PAGETREE_H
+
+typedef struct TmpfsPageTree TmpfsPageTree;
+
+#include<kit/types.h>
+#include<kit/util.h>
+#include<system/pageTable.h>
+
+#define TMPFS_PAGE_TREE_FANOUT_SHIFT    9   //One node is a page of frame pointers
+#define TMPFS_PAGE_TREE_FANOUT          POWER_2(TMPFS_PAGE_TREE_FANOUT_SHIFT)
+#define TMPFS_PAGE_TREE_MAX_HEIGHT      6   //Covers whole 64-bit file offset
+
+/**
+ * @brief Radix tree of frames keyed by page index, holes and pages never written are NULL, each frame in tree is referred once by tree
+ */
+typedef struct TmpfsPageTree {
+    void*   root;   //Frame of page 0 if height is 0, node with TMPFS_PAGE_TREE_FANOUT^height pages below otherwise, NULL if empty
+    Uint8   height;
+} TmpfsPageTree;
+
+void tmpfsPageTree_initStruct(TmpfsPageTree* tree);
+
+/**
+ * @brief Get frame of page
+ *
+ * @param tree Page tree
+ * @param pageIndex Index of page in file
+ * @return void* Physical frame, NULL if page is not in tree
+ */
+void* tmpfsPageTree_get(TmpfsPageTree* tree, Index64 pageIndex);
+
+/**
+ * @brief Put frame of page into tree, tree grows if page is beyond it, page should not be in tree yet
+ *
+ * @param tree Page tree
+ * @param pageIndex Index of page in file
+ * @param frame Physical frame, referred by tree since then
+ */
+void tmpfsPageTree_set(TmpfsPageTree* tree, Index64 pageIndex, void* frame);
+
+/**
+ * @brief Drop frames of pages from pageN, frames still mapped are freed when unmapped, nodes left empty are freed
+ *
+ * @param tree Page tree
+ * @param pageN Number of pages kept
+ * @return Size Number of frames dropped
+ */
+Size tmpfsPageTree_truncate(TmpfsPageTree* tree, Size pageN);
+
+/**
+ * @brief Drop one reference of data frame, frame is freed with last one
+ *
+ * @param frame Physical frame
+ */
+void tmpfsPageTree_releaseFrame(void* frame);
+
+#endif // __FS_TMPFS_PAGETREE_H
@@ -0,0 +1,63 @@
+#if !defined(__FS_TMPFS_TMPFS_H)
+#define __FS_TMPFS_TMPFS_H
+
+typedef struct Tmpfscore Tmpfscore;
+
+#include<devices/blockDevice.h>
+#include<fs/fs.h>
+#include<fs/fsNode.h>
+#include<fs/fscore.h>
+#include<fs/tmpfs/vnode.h>
+#include<kit/types.h>
+
+#define TMPFS_DEFAULT_PAGE_LIMIT    4096    //16MB of file data
+
+typedef struct Tmpfscore {
+    FScore      fscore;
+    TmpfsInode* rootInode;
+    ID          nextInodeID;
+    Size        pageLimit;  //Max number of data pages, writes beyond this fail with ERROR_ID_OUT_OF_MEMORY
+    Size        pageNum;    //Data pages held by files
+} Tmpfscore;
+
+void tmpfs_init();
+
+bool tmpfs_checkType(BlockDevice* blockDevice);
+
+/**
+ * @brief Open an empty tmpfs, each call opens a new instance
+ *
+ * @param fs File system to open
+ * @param blockDevice Should be NULL, tmpfs is not on device
+ */
+void tmpfs_open(FS* fs, BlockDevice* blockDevice);
+
+void tmpfs_close(FS* fs);
+
+/**
+ * @brief Change max number of data pages
+ *
+ * @param tmpfscore Tmpfs
+ * @param pageLimit New limit, should not be less than pages held already
+ */
+void tmpfscore_setPageLimit(Tmpfscore* tmpfscore, Size pageLimit);
+
+TmpfsInode* tmpfscore_createInode(Tmpfscore* tmpfscore, fsEntryType type, FSnodeAttribute* attribute);
+
+/**
+ * @brief Drop one reference of inode, data and children are released with last one
+ *
+ * @param tmpfscore Tmpfs
+ * @param inode Inode to release
+ */
+void tmpfscore_releaseInode(Tmpfscore* tmpfscore, TmpfsInode* inode);
+
+/**
+ * @brief Allocate a zeroed frame for file data, counted in page limit
+ *
+ * @param tmpfscore Tmpfs
+ * @return void* Physical frame referred once, NULL if limit reached or error happens
+ */
+void* tmpfscore_allocateFrame(Tmpfscore* tmpfscore);
+
+#endif // __FS_TMPFS_TMPFS_H
@@ -0,0 +1,83 @@
+#if !defined(__FS_TMPFS_VNODE_H)
+#define __FS_TMPFS_VNODE_H
+
+typedef struct TmpfsInode TmpfsInode;
+typedef struct TmpfsDirectoryEntry TmpfsDirectoryEntry;
+typedef struct TmpfsVnode TmpfsVnode;
+
+#include<fs/fsEntry.h>
+#include<fs/fsNode.h>
+#include<fs/vnode.h>
+#include<fs/tmpfs/pageTree.h>
+#include<kit/types.h>
+#include<memory/extendedPageTable.h>
+#include<memory/vms.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<structs/string.h>
+
+//File or directory living only in memory, kept after its vnode closed until it is removed
+typedef struct TmpfsInode {
+    ID              inodeID;
+    fsEntryType     type;
+    RefCounter32    refCounter; //Directory entry holds 1, opened vnode holds 1
+    Size            size;
+    FSnodeAttribute attribute;
+    Mutex           lock;       //Lock for size and pages
+    TmpfsPageTree   pages;      //Data of file
+    LinkedList      children;   //TmpfsDirectoryEntry of directory
+    Index64         nextCookie; //Cookie of next entry added to directory
+} TmpfsInode;
+
+typedef struct TmpfsDirectoryEntry {
+    LinkedListNode  node;
+    String          name;
+    TmpfsInode*     inode;
+    Index64         cookie;     //Position of entry for directory iteration, increasing along children
+} TmpfsDirectoryEntry;
+
+typedef struct TmpfsVnode {
+    vNode       vnode;
+    TmpfsInode* inode;
+} TmpfsVnode;
+
+vNodeOperations* tmpfs_vNode_getOperations();
+
+/**
+ * @brief Get tmpfs vnode behind fs entry, its frames can be mapped directly
+ *
+ * @param entry fs entry
+ * @return TmpfsVnode* Vnode of entry, NULL if entry is not a regular file on tmpfs
+ */
+TmpfsVnode* tmpfs_vNode_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Map frames of tmpfs file to region, pages not written yet are allocated, called by mapping_mmap after region drawn
+ *
+ * @param tmpfsVnode Vnode of file
+ * @param info Info of region, offset should be page aligned
+ * @param pageTable Page table to draw
+ */
+void tmpfs_vNode_draw(TmpfsVnode* tmpfsVnode, VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable);
+
+/**
+ * @brief Get frame of page and refer it, frame stays valid even if file truncated, released by tmpfsPageTree_releaseFrame
+ *
+ * @param tmpfsVnode Vnode of file
+ * @param pageIndex Index of page in file
+ * @return void* Physical frame referred once, NULL if page not written yet
+ */
+void* tmpfs_vNode_referFrame(TmpfsVnode* tmpfsVnode, Index64 pageIndex);
+
+/**
+ * @brief Write to tmpfs file at entry pointer, frames of written pages are allocated before file grows, so write failing on page limit keeps file size
+ *
+ * @param entry fs entry of file
+ * @param buffer Data to write
+ * @param n Number of bytes to write
+ * @return Size Number of bytes written, 0 on error
+ */
+Size tmpfs_vNode_write(fsEntry* entry, const void* buffer, Size n);
+
+#endif // __FS_TMPFS_VNODE_H
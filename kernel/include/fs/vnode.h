@@ -12,6 +12,7 @@ typedef struct vNodeInitArgs vNodeInitArgs;
 #include<kit/types.h>
 #include<multitask/locks/spinlock.h>
 #include<structs/hashTable.h>
+#include<structs/linkedList.h>
 #include<structs/refCounter.h>
 #include<structs/singlyLinkedList.h>
 
@@ -31,6 +32,7 @@ typedef struct vNode {
     ID                      deviceID;
 
     Spinlock                lock;   //TODO: Use mutex?
+    LinkedListNode          dirtyNode;  //Node in dirty attribute list, NULL next if attribute is clean
 } vNode;
 
 typedef struct vNodeInitArgs {
@@ -43,6 +45,8 @@ typedef struct vNodeInitArgs {
     ID deviceID;
 } vNodeInitArgs;
 
+typedef bool (*vNodeFillDirectoryFunc)(Object arg, ConstCstring name, Size nameLength, fsEntryType type, ID vnodeID, Index64 nextCookie);   //Returns false to stop before this entry, name is not NULL-terminated
+
 typedef struct vNodeOperations {
     void (*readData)(vNode* vnode, Index64 begin, void* buffer, Size byteN);
 
@@ -57,6 +61,12 @@ typedef struct vNodeOperations {
     void (*renameDirectoryEntry)(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName);
 
     void (*readDirectoryEntries)(vNode* vnode);
+
+    void (*lookupDirectoryEntry)(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory);   //Append only child named with fsnode_create, ERROR_ID_NOT_FOUND if not exist, NULL if fs can only read all children
+
+    Index64 (*iterateDirectoryEntries)(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);    //Pass entries from cookie to func without creating fsNode, returns cookie to resume from, NULL if fs can only read all children
+    //=========== Attribute Functions ===========
+    void (*syncAttribute)(vNode* vnode);    //Write attribute of fsNode back to storage, NULL if fs does not keep attributes
 } vNodeOperations;
 
 static inline void vNode_rawReadData(vNode* vnode, Index64 begin, void* buffer, Size byteN) {
@@ -87,6 +97,20 @@ static inline void vNode_rawReadDirectoryEntries(vNode* vnode) {
     vnode->operations->readDirectoryEntries(vnode);
 }
 
+static inline void vNode_rawLookupDirectoryEntry(vNode* vnode, ConstCstring name, Size nameLength, bool isDirectory) {
+    vnode->operations->lookupDirectoryEntry(vnode, name, nameLength, isDirectory);
+}
+
+static inline Index64 vNode_rawIterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg) {
+    return vnode->operations->iterateDirectoryEntries(vnode, cookie, func, arg);
+}
+
+static inline void vNode_rawSyncAttribute(vNode* vnode) {
+    vnode->operations->syncAttribute(vnode);
+}
+
+void vNode_init();
+
 void vNode_initStruct(vNode* vnode, vNodeInitArgs* args);
 
 void vNode_addDirectoryEntry(vNode* vnode, DirectoryEntry* entry, FSnodeAttribute* attr);
@@ -95,6 +119,36 @@ void vNode_removeDirectoryEntry(vNode* vnode, ConstCstring name, bool isDirector
 
 void vNode_renameDirectoryEntry(vNode* vnode, fsNode* entry, vNode* moveTo, ConstCstring newName);
 
+/**
+ * @brief Pass entries of directory to func in order, until func refuses one or no entry left
+ *
+ * @param vnode Directory vnode
+ * @param cookie Where to start, 0 for first entry, or cookie returned/passed before
+ * @param func Called with each entry, returns false to stop before the entry
+ * @param arg Argument passed to func
+ * @return Index64 Cookie of first entry not taken, INVALID_INDEX64 if error happens
+ */
+Index64 vNode_iterateDirectoryEntries(vNode* vnode, Index64 cookie, vNodeFillDirectoryFunc func, Object arg);
+
+/**
+ * @brief Mark attribute of vnode changed, written back at once, or by vNode_syncDirtyAttributes if fs is mounted with lazytime
+ *
+ * @param vnode vNode changed
+ */
+void vNode_markAttributeDirty(vNode* vnode);
+
+/**
+ * @brief Forget dirty mark of vnode, called before vnode closed, closing vnode should write attribute back itself
+ *
+ * @param vnode vNode to close
+ */
+void vNode_clearAttributeDirty(vNode* vnode);
+
+/**
+ * @brief Write attributes of all dirty vnodes back, called by periodic sync
+ */
+void vNode_syncDirtyAttributes();
+
 static inline Uint32 vNode_getReferenceCount(vNode* vnode) {
     return REF_COUNTER_GET(vnode->refCounter);
 }
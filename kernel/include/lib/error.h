@@ -22,6 +22,10 @@ typedef struct ErrorRecord ErrorRecord;
 #define ERROR_ID_PERMISSION_ERROR           10
 #define ERROR_ID_IO_FAILED                  11
 #define ERROR_ID_VERIFICATION_FAILED        12
+#define ERROR_ID_TIMEOUT                    13
+#define ERROR_ID_WOULD_BLOCK                14
+#define ERROR_ID_BROKEN_PIPE                15
+#define ERROR_ID_LOOP                       16
 
 typedef struct Error {
     ConstCstring desc;
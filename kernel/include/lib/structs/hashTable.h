@@ -67,4 +67,31 @@ HashChainNode* hashTable_delete(HashTable* table, Object key);
  */
 HashChainNode* hashTable_find(HashTable* table, Object key);
 
+/**
+ * @brief Insert value to hash table, may run concurrently with hashTable_rcuFind, updaters must still be serialized
+ * 
+ * @param table Hash table
+ * @param key Key of value
+ * @param node Value's hash chain node to insert
+ */
+void hashTable_rcuInsert(HashTable* table, Object key, HashChainNode* node);
+
+/**
+ * @brief Delete a value corresponded to key, may run concurrently with hashTable_rcuFind, deleted node must not be reused before a grace period
+ * 
+ * @param table Hash table
+ * @param key Key of value to delete
+ * @return HashChainNode* Deleted value's hash chain node, NULL if key not exist
+ */
+HashChainNode* hashTable_rcuDelete(HashTable* table, Object key);
+
+/**
+ * @brief Find value correspond to key inside a RCU read section, no lock required
+ * 
+ * @param table Hash table
+ * @param key Key of value to find
+ * @return HashChainNode* Value's hash chain node, NULL if key not exist
+ */
+HashChainNode* hashTable_rcuFind(HashTable* table, Object key);
+
 #endif // __LIB_STRUCTS_HASHTABLE_H
@@ -0,0 +1,88 @@
+#if !defined(__LIB_STRUCTS_RCULIST_H)
+#define __LIB_STRUCTS_RCULIST_H
+
+#include<kit/atomic.h>
+#include<kit/types.h>
+#include<structs/linkedList.h>
+#include<structs/singlyLinkedList.h>
+
+//RCU variants of list operations: updaters still serialize with their own lock, readers only need a RCU read section.
+//Removed nodes keep their next pointer so readers standing on them can move on, and must not be reused or freed before a grace period
+
+/**
+ * @brief Get the next node of a double linked list node, safe against concurrent RCU updaters
+ * 
+ * @param node The double linked list node, could be list header
+ * @return LinkedListNode* Next node
+ */
+static inline LinkedListNode* linkedListNode_rcuGetNext(LinkedListNode* node) {
+    return ATOMIC_LOAD(&node->next);
+}
+
+/**
+ * @brief Insert a node to the next position of a double linked list node, new node is published after initialized
+ * 
+ * @param node New node will be inserted to the next position of this double linked list node
+ * @param newNode New double linked list to insert
+ */
+static inline void linkedListNode_rcuInsertBack(LinkedListNode* node, LinkedListNode* newNode) {
+    LinkedListNode* next = node->next;
+    newNode->prev = node, newNode->next = next;
+    ATOMIC_STORE(&node->next, newNode);
+    next->prev = newNode;
+}
+
+/**
+ * @brief Insert a node to the previous position of a double linked list node, new node is published after initialized
+ * 
+ * @param node New node will be inserted to the previous position of this double linked list node
+ * @param newNode New double linked list to insert
+ */
+static inline void linkedListNode_rcuInsertFront(LinkedListNode* node, LinkedListNode* newNode) {
+    LinkedListNode* prev = node->prev;
+    newNode->prev = prev, newNode->next = node;
+    ATOMIC_STORE(&prev->next, newNode);
+    node->prev = newNode;
+}
+
+/**
+ * @brief Remove this node from the double linked list, node's next pointer is kept for readers still on it
+ * 
+ * @param node Node to remove
+ */
+static inline void linkedListNode_rcuDelete(LinkedListNode* node) {
+    ATOMIC_STORE(&node->prev->next, node->next);
+    node->next->prev = node->prev;
+}
+
+/**
+ * @brief Get the next node of a singly linked list node, safe against concurrent RCU updaters
+ * 
+ * @param node The singly linked list node, could be list header
+ * @return SinglyLinkedListNode* Next node
+ */
+static inline SinglyLinkedListNode* singlyLinkedList_rcuGetNext(SinglyLinkedListNode* node) {
+    return ATOMIC_LOAD(&node->next);
+}
+
+/**
+ * @brief Insert a node to the next position of a singly linked list node, new node is published after initialized
+ * 
+ * @param node New node will be inserted to the next position of this singly linked list node
+ * @param newNode New singly linked list to insert
+ */
+static inline void singlyLinkedList_rcuInsertNext(SinglyLinkedList* node, SinglyLinkedListNode* newNode) {
+    newNode->next = node->next;
+    ATOMIC_STORE(&node->next, newNode);
+}
+
+/**
+ * @brief Remove the next singly linked list node, removed node's next pointer is kept for readers still on it
+ * 
+ * @param node The node before the node to remove
+ */
+static inline void singlyLinkedList_rcuDeleteNext(SinglyLinkedList* node) {
+    ATOMIC_STORE(&node->next, node->next->next);
+}
+
+#endif // __LIB_STRUCTS_RCULIST_H
@@ -0,0 +1,8 @@
+#if !defined(__MEMORY_DEFAULTOPERATIONS_SHAREDMEMORY_H)
+#define __MEMORY_DEFAULTOPERATIONS_SHAREDMEMORY_H
+
+#include<memory/memoryOperations.h>
+
+extern MemoryOperations defaultMemoryOperations_sharedMemory;
+
+#endif // __MEMORY_DEFAULTOPERATIONS_SHAREDMEMORY_H
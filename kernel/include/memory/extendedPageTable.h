@@ -79,6 +79,9 @@ typedef struct ExtendedPageTableRoot {
     ExtraPageTableContext* context;
     void* pPageTable;
     FrameReaper reaper;
+    Uint16 pcid;
+    Uint64 tlbGeneration;   //Translations tagged by PCID are valid only if this matches mm->tlbGeneration
+    Uint64 activeCPUs;      //Bitmask of CPUs having this page table loaded
 } ExtendedPageTableRoot;
 
 ExtendedPageTableRoot* extendedPageTableRoot_copyTable(ExtendedPageTableRoot* source);
@@ -10,6 +10,7 @@ typedef enum DefaultMemoryOperationsType {
     DEFAULT_MEMORY_OPERATIONS_TYPE_ANON_SHARED,
     DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE,
     DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED,
+    DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY,
     DEFAULT_MEMORY_OPERATIONS_TYPE_NUM
 } __attribute__ ((packed)) DefaultMemoryOperationsType;
 
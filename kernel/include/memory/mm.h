@@ -9,6 +9,8 @@ typedef struct MemoryManager MemoryManager;
 #include<memory/extendedPageTable.h>
 #include<memory/frameMetadata.h>
 #include<memory/memoryOperations.h>
+#include<memory/paging.h>
+#include<memory/tlbShootdown.h>
 #include<system/memoryMap.h>
 #include<system/pageTable.h>
 #include<test.h>
@@ -21,6 +23,7 @@ typedef struct MemoryManager {
     FrameAllocator* frameAllocator;
     HeapAllocator* defaultAllocator;
     ExtendedPageTableRoot* extendedTable;
+    Uint64 tlbGeneration;   //Increased when mappings shared by all address spaces change
     Uintptr accessibleBegin, accessibleEnd;
 } MemoryManager;
 
@@ -29,7 +32,21 @@ void mm_init();
 extern MemoryManager* mm;
 
 static inline __attribute__((always_inline)) void mm_switchPageTable(ExtendedPageTableRoot* extendedTable) {
-    writeRegister_CR3_64((Uint64)extendedTable->pPageTable);
+    if (extendedTable == mm->extendedTable) {   //Lazy TLB, address space not changed, keep TLB untouched
+        return;
+    }
+
+    Uint64 cr3 = (Uint64)extendedTable->pPageTable | extendedTable->pcid;
+    if (extendedTable->pcid != PAGING_PCID_NONE && extendedTable->tlbGeneration == mm->tlbGeneration) {
+        SET_FLAG_BACK(cr3, PAGING_CR3_PCID_NOFLUSH);
+    }
+    extendedTable->tlbGeneration = mm->tlbGeneration;
+
+    writeRegister_CR3_64(cr3);
+    if (mm->extendedTable != NULL) {
+        tlbShootdown_markActive(mm->extendedTable, false);
+    }
+    tlbShootdown_markActive(extendedTable, true);
     mm->extendedTable = extendedTable;
 }
 
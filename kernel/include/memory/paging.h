@@ -35,6 +35,42 @@ void* paging_fastTranslate(ExtendedPageTableRoot* pageTable, void* v);
 //Flush the TLB, If page table update not working, try this
 #define PAGING_FLUSH_TLB()   writeRegister_CR3_64(readRegister_CR3_64());
 
+#define PAGING_PCID_NUM                 4096
+#define PAGING_PCID_NONE                0           //Untagged, address space using it is flushed on every switch
+#define PAGING_CR3_PCID_NOFLUSH         FLAG64(63)  //Keep translations tagged by new PCID when writing CR3
+
+/**
+ * @brief Assign a PCID to page table, so its translations survive switching to other address spaces, falls back to PAGING_PCID_NONE if PCID not supported or exhausted
+ * 
+ * @param root Page table
+ */
+void paging_assignPCID(ExtendedPageTableRoot* root);
+
+/**
+ * @brief Return PCID of page table
+ * 
+ * @param root Page table
+ */
+void paging_releasePCID(ExtendedPageTableRoot* root);
+
+bool paging_isInvpcidSupported();
+
+/**
+ * @brief Invalidate translations of pages changed in page table, shortcut for single range shootdown
+ * 
+ * @param root Page table changed
+ * @param v Begin of changed range
+ * @param n Num of pages changed
+ */
+void paging_flushTLB(ExtendedPageTableRoot* root, void* v, Size n);
+
+/**
+ * @brief Invalidate all translations private to page table, translations of shared kernel half are not affected
+ * 
+ * @param root Page table
+ */
+void paging_flushAddressSpace(ExtendedPageTableRoot* root);
+
 static inline __attribute__((always_inline)) void* paging_convertAddressV2P(void* v, Uintptr base) {
     return (void*)CLEAR_VAL((Uintptr)v, base);
 }
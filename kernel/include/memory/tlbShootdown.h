@@ -0,0 +1,73 @@
+#if !defined(__MEMORY_TLBSHOOTDOWN_H)
+#define __MEMORY_TLBSHOOTDOWN_H
+
+typedef struct TLBshootdownRange TLBshootdownRange;
+typedef struct TLBshootdown TLBshootdown;
+
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/extendedPageTable.h>
+
+#define TLB_SHOOTDOWN_LOCAL_CPU         0   //TODO: Read CPU ID when SMP is supported
+#define TLB_SHOOTDOWN_RANGE_NUM         8
+#define TLB_SHOOTDOWN_FULL_FLUSH_LIMIT  32  //Flush whole address space when more pages than this changed
+
+typedef struct TLBshootdownRange {
+    Uintptr begin;
+    Size    n;
+} TLBshootdownRange;
+
+/**
+ * @brief Batch of TLB invalidations for one page table, pages are merged into ranges and invalidated together on every CPU having the page table active
+ */
+typedef struct TLBshootdown {
+    ExtendedPageTableRoot*  root;
+    Size                    rangeNum;
+    Size                    pageNum;
+    Flags8                  flags;
+#define TLB_SHOOTDOWN_FLAGS_FULL_FLUSH  FLAG8(0)
+#define TLB_SHOOTDOWN_FLAGS_SHARED      FLAG8(1)    //Range in kernel memory or text, cached by all address spaces
+    volatile Uint32         pendingCPUnum;  //CPUs not finished invalidation yet
+    TLBshootdownRange       ranges[TLB_SHOOTDOWN_RANGE_NUM];
+} TLBshootdown;
+
+void tlbShootdown_initStruct(TLBshootdown* shootdown, ExtendedPageTableRoot* root);
+
+/**
+ * @brief Add pages to invalidate, merged with last range if adjacent, falls back to full flush when too many
+ * 
+ * @param shootdown Shootdown batch
+ * @param v Begin of pages
+ * @param n Num of pages
+ */
+void tlbShootdown_addPages(TLBshootdown* shootdown, void* v, Size n);
+
+/**
+ * @brief Invalidate all pages added on every CPU having page table active, returns when all of them finished, batch is reset after that
+ * 
+ * @param shootdown Shootdown batch
+ */
+void tlbShootdown_flush(TLBshootdown* shootdown);
+
+/**
+ * @brief Handle invalidation request on current CPU, called by shootdown sender or IPI handler
+ * 
+ * @param shootdown Shootdown batch
+ */
+void tlbShootdown_handleRequest(TLBshootdown* shootdown);
+
+/**
+ * @brief Mark page table active or inactive on current CPU, called when switching page table
+ * 
+ * @param root Page table
+ * @param active Is page table active
+ */
+static inline void tlbShootdown_markActive(ExtendedPageTableRoot* root, bool active) {
+    if (active) {
+        SET_FLAG_BACK(root->activeCPUs, FLAG64(TLB_SHOOTDOWN_LOCAL_CPU));
+    } else {
+        CLEAR_FLAG_BACK(root->activeCPUs, FLAG64(TLB_SHOOTDOWN_LOCAL_CPU));
+    }
+}
+
+#endif // __MEMORY_TLBSHOOTDOWN_H
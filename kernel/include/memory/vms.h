@@ -5,6 +5,7 @@ typedef struct VirtualMemoryRegionSharedFrames VirtualMemoryRegionSharedFrames;
 typedef struct VirtualMemoryRegionInfo VirtualMemoryRegionInfo;
 typedef struct VirtualMemoryRegion VirtualMemoryRegion;
 typedef struct VirtualMemorySpace VirtualMemorySpace;
+typedef struct Mutex Mutex;
 
 #include<fs/fsEntry.h>
 #include<kit/types.h>
@@ -66,6 +67,20 @@ static inline void virtualMemoryRegionInfo_drawToExtendedTable(VirtualMemoryRegi
     extendedPageTableRoot_draw(extendedTable, (void*)range->begin, p, range->length / PAGE_SIZE, info->memoryOperationsID, prot, flags);
 }
 
+typedef void* (*VirtualMemoryRegionInfoGetFrameFunc)(Object object, Index64 pageIndex);   //Returns frame of page, allocated if not present, NULL on error
+
+/**
+ * @brief Map frames of a paged object (shared memory, tmpfs file) to region, physically continuous frames are drawn together, each mapped frame is referred once
+ *
+ * @param info Info of region, offset should be page aligned
+ * @param pageTable Page table to draw
+ * @param lock Lock of object, held while drawing
+ * @param objectSize Size of object in byte, read with lock held, pages beyond it are left unmapped
+ * @param getFrame Get frame of page in object, called with lock held
+ * @param object Object passed to getFrame
+ */
+void virtualMemoryRegionInfo_drawFrames(VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable, Mutex* lock, const Size* objectSize, VirtualMemoryRegionInfoGetFrameFunc getFrame, Object object);
+
 typedef struct VirtualMemoryRegion {
     RBtreeNode treeNode;
     VirtualMemoryRegionInfo info;
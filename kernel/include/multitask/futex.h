@@ -0,0 +1,48 @@
+#if !defined(__MULTITASK_FUTEX_H)
+#define __MULTITASK_FUTEX_H
+
+#include<kit/bit.h>
+#include<kit/types.h>
+
+#define FUTEX_BITSET_MATCH_ANY  0xFFFFFFFF
+
+#define FUTEX_FLAGS_PRIVATE     FLAG8(0)    //Word is not shared with other address spaces, keyed by virtual address instead of physical address
+
+void futex_init();
+
+/**
+ * @brief Sleep on a user word if it still holds expected value, until woken up or timeout
+ * 
+ * @param uaddr User word, 4 bytes aligned
+ * @param val Expected value, ERROR_ID_WOULD_BLOCK thrown if word changed
+ * @param timeout Timeout in nanoseconds, negative for no timeout, ERROR_ID_TIMEOUT thrown if reached
+ * @param bitset Only woken up by wakers with overlapped bitset
+ * @param flags Futex flags
+ */
+void futex_wait(Uint32* uaddr, Uint32 val, Int64 timeout, Uint32 bitset, Flags8 flags);
+
+/**
+ * @brief Wake up threads sleeping on a user word
+ * 
+ * @param uaddr User word
+ * @param n Maximum number of threads to wake up
+ * @param bitset Only wake up waiters with overlapped bitset
+ * @param flags Futex flags
+ * @return Size Number of threads woken up
+ */
+Size futex_wake(Uint32* uaddr, Size n, Uint32 bitset, Flags8 flags);
+
+/**
+ * @brief Wake up threads sleeping on a user word, and move rest of them to sleep on another word without waking them up
+ * 
+ * @param uaddr User word
+ * @param nWake Maximum number of threads to wake up
+ * @param uaddr2 User word to move waiters to
+ * @param nRequeue Maximum number of threads to move
+ * @param cmpVal If not NULL, ERROR_ID_WOULD_BLOCK thrown if uaddr does not hold this value
+ * @param flags Futex flags
+ * @return Size Number of threads woken up and moved
+ */
+Size futex_requeue(Uint32* uaddr, Size nWake, Uint32* uaddr2, Size nRequeue, Uint32* cmpVal, Flags8 flags);
+
+#endif // __MULTITASK_FUTEX_H
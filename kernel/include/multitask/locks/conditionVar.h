@@ -3,11 +3,16 @@
 
 typedef struct ConditionVar ConditionVar;
 
+#include<kit/config.h>
 #include<multitask/wait.h>
+#include<multitask/locks/lockProfile.h>
 #include<multitask/locks/mutex.h>
 
 typedef struct ConditionVar {
     Wait wait;
+#if defined(CONFIG_LOCK_PROFILE)
+    LockClass* lockClass;   //Class of init site, every wait counts as contended, no hold time
+#endif
 } ConditionVar;
 
 typedef bool (*ConditionVariableFunc)(void* arg);
@@ -0,0 +1,137 @@
+#if !defined(__MULTITASK_LOCKS_LOCKPROFILE_H)
+#define __MULTITASK_LOCKS_LOCKPROFILE_H
+
+typedef struct LockClass LockClass;
+
+#include<kit/config.h>
+#include<kit/types.h>
+#include<real/simpleAsmLines.h>
+
+typedef Uint16 LockClassIndex;
+
+typedef enum LockClassType {
+    LOCK_CLASS_TYPE_SPINLOCK,
+    LOCK_CLASS_TYPE_MUTEX,
+    LOCK_CLASS_TYPE_SEMAPHORE,
+    LOCK_CLASS_TYPE_CONDITION_VAR,
+    LOCK_CLASS_TYPE_NUM
+} LockClassType;
+
+#define LOCK_PROFILE_CLASS_MAX      256 //Classes beyond this are counted in one overflow class
+#define LOCK_PROFILE_REPORT_SIZE    (LOCK_PROFILE_CLASS_MAX * 160)
+#define LOCK_PROFILE_HELD_MAX       32  //Max nested small locks tracked for hold time
+
+#define LOCK_CLASS_INDEX_NONE       0   //Small locks (spinlocks) refer to class by index, 0 means no class yet
+
+/**
+ * @brief Statistics shared by all locks created at same place, like lockdep classes, times are in TSC ticks
+ */
+typedef struct LockClass {
+    void*           key;            //Return address of init function (first lock site for spinlocks, they have no init function), NULL for overflow class
+    ConstCstring    name;           //NULL if not named, key is reported instead
+    LockClassType   type;
+    Uint64          acquireNum;
+    Uint64          contendedNum;   //Acquisitions had to spin or sleep
+    Uint64          waitTick;
+    Uint64          maxWaitTick;
+    Uint64          holdTick;
+    Uint64          maxHoldTick;
+} LockClass;
+
+#if defined(CONFIG_LOCK_PROFILE)
+
+static inline Uint64 lockProfile_now() {
+    return rdtsc();
+}
+
+/**
+ * @brief Get class of key, register it if not seen before, can be called in interrupt and before memory initialized
+ *
+ * @param key Call site identifying the class
+ * @param type Type of lock
+ * @return LockClass* Class of key, never NULL
+ */
+LockClass* lockProfile_getClass(void* key, LockClassType type);
+
+/**
+ * @brief Get index of class, for locks too small to hold a pointer
+ *
+ * @param lockClass Class returned by lockProfile_getClass
+ * @return LockClassIndex Index of class, never LOCK_CLASS_INDEX_NONE
+ */
+LockClassIndex lockProfile_getClassIndex(LockClass* lockClass);
+
+/**
+ * @brief Get class from index
+ *
+ * @param index Index returned by lockProfile_getClassIndex
+ * @return LockClass* Class of index
+ */
+LockClass* lockProfile_getClassFromIndex(LockClassIndex index);
+
+/**
+ * @brief Give class a readable name in report
+ *
+ * @param lockClass Class to name
+ * @param name Name, should be a static string
+ */
+void lockProfile_nameClass(LockClass* lockClass, ConstCstring name);
+
+/**
+ * @brief Record an acquisition
+ *
+ * @param lockClass Class of lock
+ * @param beginTick Tick when acquisition started
+ * @param contended Is acquisition spun or slept
+ * @return Uint64 Current tick, hold time begins here
+ */
+Uint64 lockProfile_recordAcquire(LockClass* lockClass, Uint64 beginTick, bool contended);
+
+/**
+ * @brief Record a release
+ *
+ * @param lockClass Class of lock
+ * @param holdTick Ticks since tick returned by lockProfile_recordAcquire
+ */
+void lockProfile_recordRelease(LockClass* lockClass, Uint64 holdTick);
+
+/**
+ * @brief Remember acquired tick of a lock too small to hold it, like held locks of lockdep
+ *
+ * @param lock Lock acquired
+ * @param acquiredTick Tick returned by lockProfile_recordAcquire
+ */
+void lockProfile_pushHeld(void* lock, Uint64 acquiredTick);
+
+/**
+ * @brief Forget a lock remembered by lockProfile_pushHeld, locks may be released in any order
+ *
+ * @param lock Lock to release
+ * @param acquiredTickRet Tick passed to lockProfile_pushHeld
+ * @return bool False if lock is not remembered (e.g. too deep nested)
+ */
+bool lockProfile_popHeld(void* lock, Uint64* acquiredTickRet);
+
+/**
+ * @brief Clear statistics of all classes, classes stay registered
+ */
+void lockProfile_reset();
+
+/**
+ * @brief Print statistics of all classes, sorted by contended acquisitions then total wait time
+ *
+ * @param buffer Buffer for report
+ * @param n Size of buffer, report is cut if buffer is not large enough
+ * @return Size Length of report
+ */
+Size lockProfile_report(Cstring buffer, Size n);
+
+#else
+
+static inline Uint64 lockProfile_now() {
+    return 0;
+}
+
+#endif
+
+#endif // __MULTITASK_LOCKS_LOCKPROFILE_H
@@ -0,0 +1,101 @@
+#if !defined(__MULTITASK_LOCKS_MCS_SPINLOCK_H)
+#define __MULTITASK_LOCKS_MCS_SPINLOCK_H
+
+typedef struct MCSspinlockNode MCSspinlockNode;
+typedef struct MCSspinlock MCSspinlock;
+
+#include<kit/types.h>
+#include<kit/atomic.h>
+#include<multitask/locks/spinlock.h>
+
+/**
+ * @brief Queue node of a MCS lock, provided by locker (usually on stack) and must stay valid until unlocked
+ */
+typedef struct MCSspinlockNode {
+    MCSspinlockNode* volatile   next;
+    volatile Uint8              locked; //Each waiter spins on its own node only
+} MCSspinlockNode;
+
+/**
+ * @brief Queued spinlock, lockers are granted in FIFO order and spin on their own node instead of the shared lock word
+ */
+typedef struct MCSspinlock {
+    MCSspinlockNode* volatile tail;
+} MCSspinlock;
+
+#define MCS_SPINLOCK_UNLOCKED   (MCSspinlock) { .tail = NULL }
+
+static inline bool mcsSpinlock_isLocked(MCSspinlock* lock) {
+    return ATOMIC_LOAD(&lock->tail) != NULL;
+}
+
+/**
+ * @brief Lock a MCS spinlock
+ * 
+ * @param lock MCS spinlock to lock
+ * @param node Queue node of this locker, pass the same node to mcsSpinlock_unlock
+ */
+static inline void mcsSpinlock_lock(MCSspinlock* lock, MCSspinlockNode* node) {
+    node->next = NULL;
+    node->locked = 1;
+
+    MCSspinlockNode* prev = ATOMIC_EXCHANGE_N(&lock->tail, node);
+    if (prev == NULL) {
+        return;
+    }
+
+    ATOMIC_STORE(&prev->next, node);
+    while (ATOMIC_LOAD(&node->locked) != 0) {
+        asm volatile("pause;" ::: "memory");
+    }
+}
+
+/**
+ * @brief Try to lock a MCS spinlock, only succeeds when queue is empty
+ * 
+ * @param lock MCS spinlock to lock
+ * @param node Queue node of this locker
+ * @return bool True if lock succeeded
+ */
+static inline bool mcsSpinlock_tryLock(MCSspinlock* lock, MCSspinlockNode* node) {
+    node->next = NULL;
+    node->locked = 1;
+
+    MCSspinlockNode* expected = NULL;
+    return ATOMIC_COMPARE_EXCHANGE_N(&lock->tail, &expected, node);
+}
+
+/**
+ * @brief Unlock a MCS spinlock, hands lock to next node in queue
+ * 
+ * @param lock MCS spinlock to unlock
+ * @param node Queue node used to lock
+ */
+static inline void mcsSpinlock_unlock(MCSspinlock* lock, MCSspinlockNode* node) {
+    MCSspinlockNode* next = ATOMIC_LOAD(&node->next);
+    if (next == NULL) {
+        MCSspinlockNode* expected = node;
+        if (ATOMIC_COMPARE_EXCHANGE_N(&lock->tail, &expected, NULL)) {
+            return;
+        }
+
+        while ((next = ATOMIC_LOAD(&node->next)) == NULL) { //Successor is between exchanging tail and linking itself
+            asm volatile("pause;" ::: "memory");
+        }
+    }
+
+    ATOMIC_STORE(&next->locked, 0);
+}
+
+static inline bool mcsSpinlock_lockIrqSave(MCSspinlock* lock, MCSspinlockNode* node) {
+    bool interruptEnabled = idt_disableInterrupt();
+    mcsSpinlock_lock(lock, node);
+    return interruptEnabled;
+}
+
+static inline void mcsSpinlock_unlockIrqRestore(MCSspinlock* lock, MCSspinlockNode* node, bool interruptEnabled) {
+    mcsSpinlock_unlock(lock, node);
+    idt_setInterrupt(interruptEnabled);
+}
+
+#endif // __MULTITASK_LOCKS_MCS_SPINLOCK_H
@@ -4,7 +4,9 @@
 typedef struct Mutex Mutex;
 
 #include<kit/bit.h>
+#include<kit/config.h>
 #include<kit/types.h>
+#include<multitask/locks/lockProfile.h>
 #include<multitask/thread.h>
 #include<multitask/wait.h>
 
@@ -13,18 +15,38 @@ typedef struct Mutex {
     Thread* acquiredBy;
 #define MUTEX_FLAG_TRY      FLAG8(0)
 #define MUTEX_FLAG_CRITICAL FLAG8(1)
+#define MUTEX_FLAG_HANDOFF  FLAG8(2)    //Pass mutex directly to oldest waiter on release, no other thread can take it in between
     Flags8 flags;
-    Wait wait;
+    Wait wait;      //Waiters are woken in FIFO order
+    Uint64 contendedNum;    //Times a thread had to sleep for this mutex
+    Uint64 waitTime;        //Total time threads slept for this mutex, in nanoseconds
+#if defined(CONFIG_LOCK_PROFILE)
+    LockClass* lockClass;   //Class of init site
+    Uint64 acquiredTick;
+#endif
 } Mutex;
 
+#define MUTEX_SPIN_LIMIT    128 //Maximum rounds to spin for a running owner before sleeping
+
 void mutex_initStruct(Mutex* mutex, Flags8 flags);
 
 bool mutex_isLocked(Mutex* mutex);
 
+/**
+ * @brief Acquire a mutex, spin shortly if owner is running on another CPU, then sleep until mutex is released to current thread
+ * 
+ * @param mutex Mutex to acquire
+ * @return bool True if mutex acquired, false only if MUTEX_FLAG_TRY set and mutex is held by others
+ */
 bool mutex_acquire(Mutex* mutex);
 
 bool mutex_release(Mutex* mutex);
 
+/**
+ * @brief Release a mutex regardless of depth, wakes up the oldest waiter
+ * 
+ * @param mutex Mutex to release
+ */
 void mutex_forceRelease(Mutex* mutex);
 
 #endif // __MULTITASK_LOCKS_MUTEX_H
@@ -0,0 +1,80 @@
+#if !defined(__MULTITASK_LOCKS_RW_SEMAPHORE_H)
+#define __MULTITASK_LOCKS_RW_SEMAPHORE_H
+
+typedef struct RWsemaphore RWsemaphore;
+
+#include<kit/types.h>
+#include<multitask/locks/spinlock.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+
+/**
+ * @brief Sleeping reader-writer lock, readers share it unless a writer holds or waits for it
+ */
+typedef struct RWsemaphore {
+    Spinlock    queueLock;  //Protects fields below and both wait lists
+    int         readerNum;  //Readers holding semaphore
+    Thread*     writer;     //Writer holding semaphore
+    Wait        readWait;
+    Wait        writeWait;
+} RWsemaphore;
+
+/**
+ * @brief Initialize a reader-writer semaphore
+ * 
+ * @param sem Reader-writer semaphore struct
+ */
+void rwSemaphore_initStruct(RWsemaphore* sem);
+
+/**
+ * @brief Acquire semaphore for read, may block current thread if a writer holds or is waiting for it
+ * 
+ * @param sem Reader-writer semaphore
+ */
+void rwSemaphore_downRead(RWsemaphore* sem);
+
+/**
+ * @brief Try to acquire semaphore for read without blocking
+ * 
+ * @param sem Reader-writer semaphore
+ * @return bool True if acquired
+ */
+bool rwSemaphore_tryDownRead(RWsemaphore* sem);
+
+/**
+ * @brief Release semaphore acquired for read, last reader passes it to the oldest waiting writer
+ * 
+ * @param sem Reader-writer semaphore
+ */
+void rwSemaphore_upRead(RWsemaphore* sem);
+
+/**
+ * @brief Acquire semaphore for write, may block current thread until all readers and writer released it
+ * 
+ * @param sem Reader-writer semaphore
+ */
+void rwSemaphore_downWrite(RWsemaphore* sem);
+
+/**
+ * @brief Try to acquire semaphore for write without blocking
+ * 
+ * @param sem Reader-writer semaphore
+ * @return bool True if acquired
+ */
+bool rwSemaphore_tryDownWrite(RWsemaphore* sem);
+
+/**
+ * @brief Release semaphore acquired for write, waiting readers are preferred over waiting writers so neither side starves
+ * 
+ * @param sem Reader-writer semaphore
+ */
+void rwSemaphore_upWrite(RWsemaphore* sem);
+
+/**
+ * @brief Turn write hold into read hold atomically, waiting readers are let in together
+ * 
+ * @param sem Reader-writer semaphore held for write by current thread
+ */
+void rwSemaphore_downgrade(RWsemaphore* sem);
+
+#endif // __MULTITASK_LOCKS_RW_SEMAPHORE_H
@@ -0,0 +1,114 @@
+#if !defined(__MULTITASK_LOCKS_RW_SPINLOCK_H)
+#define __MULTITASK_LOCKS_RW_SPINLOCK_H
+
+typedef struct RWspinlock RWspinlock;
+
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/atomic.h>
+#include<multitask/locks/spinlock.h>
+
+/**
+ * @brief Reader-writer spinlock, waiting writer blocks new readers so writers are not starved
+ */
+typedef struct RWspinlock {
+    volatile Uint32 state;
+#define RW_SPINLOCK_STATE_WRITER                FLAG32(31)
+#define RW_SPINLOCK_STATE_WAITING_WRITER_UNIT   FLAG32(16)
+#define RW_SPINLOCK_STATE_WAITING_WRITER_MASK   (RW_SPINLOCK_STATE_WRITER - RW_SPINLOCK_STATE_WAITING_WRITER_UNIT)  //Number of writers waiting, readers are blocked while any
+#define RW_SPINLOCK_STATE_READER_MASK           (RW_SPINLOCK_STATE_WAITING_WRITER_UNIT - 1)
+} RWspinlock;
+
+#define RW_SPINLOCK_UNLOCKED    (RWspinlock) { .state = 0 }
+
+static inline bool rwSpinlock_isWriteLocked(RWspinlock* lock) {
+    return TEST_FLAGS(ATOMIC_LOAD(&lock->state), RW_SPINLOCK_STATE_WRITER);
+}
+
+static inline Uint32 rwSpinlock_getReaderNum(RWspinlock* lock) {
+    return ATOMIC_LOAD(&lock->state) & RW_SPINLOCK_STATE_READER_MASK;
+}
+
+/**
+ * @brief Lock a reader-writer spinlock for read, shared with other readers
+ * 
+ * @param lock Reader-writer spinlock to lock
+ */
+static inline void rwSpinlock_readLock(RWspinlock* lock) {
+    while (true) {
+        Uint32 state = ATOMIC_LOAD(&lock->state);
+        if (TEST_FLAGS_NONE(state, RW_SPINLOCK_STATE_WRITER | RW_SPINLOCK_STATE_WAITING_WRITER_MASK) && ATOMIC_COMPARE_EXCHANGE_N(&lock->state, &state, state + 1)) {
+            break;
+        }
+
+        asm volatile("pause;" ::: "memory");
+    }
+}
+
+/**
+ * @brief Unlock a reader-writer spinlock locked for read
+ * 
+ * @param lock Reader-writer spinlock to unlock
+ */
+static inline void rwSpinlock_readUnlock(RWspinlock* lock) {
+    ATOMIC_FETCH_DEC(&lock->state);
+}
+
+/**
+ * @brief Lock a reader-writer spinlock for write, exclusive to all readers and writers
+ * 
+ * @param lock Reader-writer spinlock to lock
+ */
+static inline void rwSpinlock_writeLock(RWspinlock* lock) {
+    bool waiting = false;
+    while (true) {
+        Uint32 state = ATOMIC_LOAD(&lock->state);
+        if (TEST_FLAGS_NONE(state, RW_SPINLOCK_STATE_WRITER | RW_SPINLOCK_STATE_READER_MASK)) {
+            Uint32 desired = (state | RW_SPINLOCK_STATE_WRITER) - (waiting ? RW_SPINLOCK_STATE_WAITING_WRITER_UNIT : 0);   //Other waiting writers still block readers
+            if (ATOMIC_COMPARE_EXCHANGE_N(&lock->state, &state, desired)) {
+                break;
+            }
+            continue;
+        }
+
+        if (!waiting) {
+            ATOMIC_FETCH_ADD(&lock->state, RW_SPINLOCK_STATE_WAITING_WRITER_UNIT);
+            waiting = true;
+        }
+
+        asm volatile("pause;" ::: "memory");
+    }
+}
+
+/**
+ * @brief Unlock a reader-writer spinlock locked for write
+ * 
+ * @param lock Reader-writer spinlock to unlock
+ */
+static inline void rwSpinlock_writeUnlock(RWspinlock* lock) {
+    ATOMIC_FETCH_AND(&lock->state, ~RW_SPINLOCK_STATE_WRITER);
+}
+
+static inline bool rwSpinlock_readLockIrqSave(RWspinlock* lock) {
+    bool interruptEnabled = idt_disableInterrupt();
+    rwSpinlock_readLock(lock);
+    return interruptEnabled;
+}
+
+static inline void rwSpinlock_readUnlockIrqRestore(RWspinlock* lock, bool interruptEnabled) {
+    rwSpinlock_readUnlock(lock);
+    idt_setInterrupt(interruptEnabled);
+}
+
+static inline bool rwSpinlock_writeLockIrqSave(RWspinlock* lock) {
+    bool interruptEnabled = idt_disableInterrupt();
+    rwSpinlock_writeLock(lock);
+    return interruptEnabled;
+}
+
+static inline void rwSpinlock_writeUnlockIrqRestore(RWspinlock* lock, bool interruptEnabled) {
+    rwSpinlock_writeUnlock(lock);
+    idt_setInterrupt(interruptEnabled);
+}
+
+#endif // __MULTITASK_LOCKS_RW_SPINLOCK_H
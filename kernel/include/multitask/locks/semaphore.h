@@ -3,6 +3,8 @@
 
 typedef struct Semaphore Semaphore;
 
+#include<kit/config.h>
+#include<multitask/locks/lockProfile.h>
 #include<multitask/locks/spinlock.h>
 #include<multitask/thread.h>
 #include<multitask/wait.h>
@@ -12,6 +14,10 @@ typedef struct Semaphore {
     Spinlock queueLock;
     Wait wait;
     Thread* holdBy;
+#if defined(CONFIG_LOCK_PROFILE)
+    LockClass* lockClass;   //Class of init site, hold time only makes sense for semaphores used as locks
+    Uint64 acquiredTick;
+#endif
 } Semaphore;
 
 /**
@@ -0,0 +1,83 @@
+#if !defined(__MULTITASK_LOCKS_SEQLOCK_H)
+#define __MULTITASK_LOCKS_SEQLOCK_H
+
+typedef struct Seqlock Seqlock;
+
+#include<kit/types.h>
+#include<kit/atomic.h>
+#include<multitask/locks/spinlock.h>
+
+/**
+ * @brief Sequence lock for small read-mostly data, readers never block writers or each other, they retry if a write happened during read
+ */
+typedef struct Seqlock {
+    volatile Uint32 sequence;   //Odd when a writer is in progress
+    Spinlock        writerLock; //Serialize writers
+} Seqlock;
+
+#define SEQLOCK_UNLOCKED    (Seqlock) { .sequence = 0, .writerLock = SPINLOCK_UNLOCKED }
+
+/**
+ * @brief Begin a read section, waits if a writer is in progress
+ * 
+ * @param lock Seqlock to read
+ * @return Uint32 Sequence to pass to seqlock_readRetry
+ */
+static inline Uint32 seqlock_readBegin(Seqlock* lock) {
+    Uint32 ret;
+    while (((ret = ATOMIC_LOAD(&lock->sequence)) & 1) != 0) {
+        asm volatile("pause;" ::: "memory");
+    }
+
+    return ret;
+}
+
+/**
+ * @brief End a read section, data read in section is consistent only if this returns false
+ * 
+ * @param lock Seqlock read
+ * @param sequence Value returned by seqlock_readBegin
+ * @return bool True if a write happened during read section, and read should be retried
+ */
+static inline bool seqlock_readRetry(Seqlock* lock, Uint32 sequence) {
+    return ATOMIC_LOAD(&lock->sequence) != sequence;
+}
+
+/**
+ * @brief Begin a write section, never sleep or wait for readers inside it
+ * 
+ * @param lock Seqlock to write
+ */
+static inline void seqlock_writeBegin(Seqlock* lock) {
+    spinlock_lock(&lock->writerLock);
+    ATOMIC_INC_FETCH(&lock->sequence);
+}
+
+/**
+ * @brief End a write section
+ * 
+ * @param lock Seqlock written
+ */
+static inline void seqlock_writeEnd(Seqlock* lock) {
+    ATOMIC_INC_FETCH(&lock->sequence);
+    spinlock_unlock(&lock->writerLock);
+}
+
+/**
+ * @brief Begin a write section with interrupt disabled, required if the same seqlock is read in interrupt handlers
+ * 
+ * @param lock Seqlock to write
+ * @return bool Is interrupt enabled before, pass to seqlock_writeEndIrqRestore
+ */
+static inline bool seqlock_writeBeginIrqSave(Seqlock* lock) {
+    bool interruptEnabled = idt_disableInterrupt();
+    seqlock_writeBegin(lock);
+    return interruptEnabled;
+}
+
+static inline void seqlock_writeEndIrqRestore(Seqlock* lock, bool interruptEnabled) {
+    seqlock_writeEnd(lock);
+    idt_setInterrupt(interruptEnabled);
+}
+
+#endif // __MULTITASK_LOCKS_SEQLOCK_H
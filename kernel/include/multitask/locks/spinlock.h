@@ -3,11 +3,18 @@
 
 typedef struct Spinlock Spinlock;
 
+#include<interrupt/IDT.h>
+#include<kit/bit.h>
+#include<kit/config.h>
 #include<kit/types.h>
 #include<kit/atomic.h>
+#include<multitask/locks/lockProfile.h>
 
 typedef struct Spinlock {
     volatile Uint8 counter;
+#if defined(CONFIG_LOCK_PROFILE)   //Kept within 4 bytes, spinlocks are embedded in size sensitive structs, acquired tick is kept by profiler
+    LockClassIndex classIndex;  //Class of first lock site, LOCK_CLASS_INDEX_NONE until locked once
+#endif
 } Spinlock;
 
 #define SPINLOCK_UNLOCKED   (Spinlock) {1}
@@ -17,14 +24,23 @@ static inline bool spinlock_isLocked(Spinlock* lock) {
     return ATOMIC_LOAD(&lock->counter) == 0;
 }
 
-/**
- * @brief Lock a spinlock, spinning if lock is already locked
- * 
- * @param lock Spinlock to lock
- */
+#if defined(CONFIG_LOCK_PROFILE)
 
-static inline void spinlock_lock(Spinlock* lock) {
+static inline void __spinlock_profileLocked(Spinlock* lock, void* site, Uint64 beginTick, bool contended) {
+    if (lock->classIndex == LOCK_CLASS_INDEX_NONE) {
+        lock->classIndex = lockProfile_getClassIndex(lockProfile_getClass(site, LOCK_CLASS_TYPE_SPINLOCK));
+    }
+    lockProfile_pushHeld(lock, lockProfile_recordAcquire(lockProfile_getClassFromIndex(lock->classIndex), beginTick, contended));
+}
+
+#endif
+
+static inline void __spinlock_lock(Spinlock* lock, void* site) {
     Uint8 expected, desired = 0;
+#if defined(CONFIG_LOCK_PROFILE)
+    Uint64 beginTick = lockProfile_now();
+    bool contended = false;
+#endif
 
     while (true) {
         expected = 1;
@@ -40,10 +56,26 @@ static inline void spinlock_lock(Spinlock* lock) {
             break;
         }
 
+#if defined(CONFIG_LOCK_PROFILE)
+        contended = true;
+#endif
         while (ATOMIC_LOAD(&lock->counter) == 0) {
             asm volatile("pause;" ::: "memory");
         }
     }
+
+#if defined(CONFIG_LOCK_PROFILE)
+    __spinlock_profileLocked(lock, site, beginTick, contended);
+#endif
+}
+
+/**
+ * @brief Lock a spinlock, spinning if lock is already locked
+ * 
+ * @param lock Spinlock to lock
+ */
+static inline void spinlock_lock(Spinlock* lock) {
+    __spinlock_lock(lock, __builtin_return_address(0));
 }
 
 /**
@@ -62,6 +94,12 @@ static inline bool spinlock_tryLock(Spinlock* lock) {
         : "memory"
     );
 
+#if defined(CONFIG_LOCK_PROFILE)
+    if (val == 1) {
+        __spinlock_profileLocked(lock, __builtin_return_address(0), lockProfile_now(), false);
+    }
+#endif
+
     return val == 1;
 }
 
@@ -71,6 +109,12 @@ static inline bool spinlock_tryLock(Spinlock* lock) {
  * @param lock Spinlock to unlock
  */
 static inline void spinlock_unlock(Spinlock* lock) {
+#if defined(CONFIG_LOCK_PROFILE)
+    Uint64 acquiredTick;
+    if (lock->classIndex != LOCK_CLASS_INDEX_NONE && lockProfile_popHeld(lock, &acquiredTick)) {    //No class if initialized as SPINLOCK_LOCKED
+        lockProfile_recordRelease(lockProfile_getClassFromIndex(lock->classIndex), lockProfile_now() - acquiredTick);
+    }
+#endif
     asm volatile(
         "movb $1, %0"
         : "=m" (lock->counter)
@@ -79,4 +123,27 @@ static inline void spinlock_unlock(Spinlock* lock) {
     );
 }
 
+/**
+ * @brief Disable interrupt and lock a spinlock, for locks also taken in interrupt handlers
+ * 
+ * @param lock Spinlock to lock
+ * @return bool Is interrupt enabled before, pass to spinlock_unlockIrqRestore
+ */
+static inline bool spinlock_lockIrqSave(Spinlock* lock) {
+    bool interruptEnabled = idt_disableInterrupt();
+    __spinlock_lock(lock, __builtin_return_address(0));    //Class comes from caller, not from here
+    return interruptEnabled;
+}
+
+/**
+ * @brief Unlock a spinlock and restore interrupt state
+ * 
+ * @param lock Spinlock to unlock
+ * @param interruptEnabled Value returned by spinlock_lockIrqSave
+ */
+static inline void spinlock_unlockIrqRestore(Spinlock* lock, bool interruptEnabled) {
+    spinlock_unlock(lock);
+    idt_setInterrupt(interruptEnabled);
+}
+
 #endif // __MULTITASK_LOCKS_SPINLOCK_H
@@ -0,0 +1,79 @@
+#if !defined(__MULTITASK_LOCKS_TICKET_SPINLOCK_H)
+#define __MULTITASK_LOCKS_TICKET_SPINLOCK_H
+
+typedef struct TicketSpinlock TicketSpinlock;
+
+#include<kit/types.h>
+#include<kit/atomic.h>
+#include<multitask/locks/spinlock.h>
+
+/**
+ * @brief Spinlock granted in FIFO order, each locker takes a ticket and spins until owner reaches it
+ */
+typedef struct TicketSpinlock {
+    union {
+        struct {
+            volatile Uint16 owner;  //Ticket currently holding the lock
+            volatile Uint16 next;   //Ticket for next locker
+        };
+        volatile Uint32 raw;
+    };
+} TicketSpinlock;
+
+#define TICKET_SPINLOCK_UNLOCKED    (TicketSpinlock) { .raw = 0 }
+
+static inline bool ticketSpinlock_isLocked(TicketSpinlock* lock) {
+    Uint32 raw = ATOMIC_LOAD(&lock->raw);
+    return (Uint16)raw != (Uint16)(raw >> 16);
+}
+
+/**
+ * @brief Lock a ticket spinlock, spinning until all earlier lockers released it
+ * 
+ * @param lock Ticket spinlock to lock
+ */
+static inline void ticketSpinlock_lock(TicketSpinlock* lock) {
+    Uint16 ticket = ATOMIC_FETCH_INC(&lock->next);
+    while (ATOMIC_LOAD(&lock->owner) != ticket) {
+        asm volatile("pause;" ::: "memory");
+    }
+}
+
+/**
+ * @brief Try to lock a ticket spinlock, only succeeds when no one is holding or waiting
+ * 
+ * @param lock Ticket spinlock to lock
+ * @return bool True if lock succeeded
+ */
+static inline bool ticketSpinlock_tryLock(TicketSpinlock* lock) {
+    Uint32 raw = ATOMIC_LOAD(&lock->raw);
+    Uint16 owner = (Uint16)raw;
+    if (owner != (Uint16)(raw >> 16)) {
+        return false;
+    }
+
+    Uint32 desired = ((Uint32)(Uint16)(owner + 1) << 16) | owner;
+    return ATOMIC_COMPARE_EXCHANGE_N(&lock->raw, &raw, desired);
+}
+
+/**
+ * @brief Unlock a ticket spinlock, hands lock to next ticket
+ * 
+ * @param lock Ticket spinlock to unlock
+ */
+static inline void ticketSpinlock_unlock(TicketSpinlock* lock) {
+    ATOMIC_STORE(&lock->owner, (Uint16)(lock->owner + 1));  //Only owner writes this field
+}
+
+static inline bool ticketSpinlock_lockIrqSave(TicketSpinlock* lock) {
+    bool interruptEnabled = idt_disableInterrupt();
+    ticketSpinlock_lock(lock);
+    return interruptEnabled;
+}
+
+static inline void ticketSpinlock_unlockIrqRestore(TicketSpinlock* lock, bool interruptEnabled) {
+    ticketSpinlock_unlock(lock);
+    idt_setInterrupt(interruptEnabled);
+}
+
+#endif // __MULTITASK_LOCKS_TICKET_SPINLOCK_H
@@ -0,0 +1,105 @@
+#if !defined(__MULTITASK_MESSAGEQUEUE_H)
+#define __MULTITASK_MESSAGEQUEUE_H
+
+typedef struct MessageQueueAttribute MessageQueueAttribute;
+typedef struct MessageQueue MessageQueue;
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<kit/types.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+
+#define MESSAGE_QUEUE_NAME_MAX                  255
+#define MESSAGE_QUEUE_PRIORITY_NUM              32      //Priority 0 to 31, higher priority received first, FIFO in same priority
+#define MESSAGE_QUEUE_DEFAULT_MAX_MESSAGE_N     10
+#define MESSAGE_QUEUE_DEFAULT_MESSAGE_SIZE      8192
+#define MESSAGE_QUEUE_MAX_BUFFER_SIZE           (1ull << 20)    //Upper bound of max message number * message size
+
+typedef struct MessageQueueAttribute {
+    Int64 flags;        //FCNTL_OPEN_NONBLOCK only
+    Int64 maxMessageN;
+    Int64 messageSize;
+    Int64 messageN;     //Ignored when creating
+    Int64 reserved[4];
+} MessageQueueAttribute;    //Same layout as struct mq_attr in user space
+
+/**
+ * @brief Named queue of fixed-size messages, slots are allocated at creation so sending never allocates
+ */
+typedef struct MessageQueue {
+    LinkedListNode  node;           //Node in name list, valid until unlinked
+    RefCounter32    refCounter;     //Name list holds 1, each opened entry holds 1
+    Mutex           lock;           //Lock for messages
+    Size            maxMessageN;
+    Size            messageSize;
+    Size            messageN;
+    Flags32         priorityMask;   //Bit N set if priority N has messages, highest priority found in O(1)
+    LinkedList      messages[MESSAGE_QUEUE_PRIORITY_NUM];
+    LinkedList      freeSlots;
+    void*           slots;
+    PollWaitQueue   pollQueue;      //Senders, receivers and pollers, woken up when queue gets readable or writable
+    char            name[0];
+} MessageQueue;
+
+void messageQueue_init();
+
+/**
+ * @brief Open a named message queue
+ *
+ * @param name Name of queue
+ * @param flags Open flags of entry, FCNTL_OPEN_CREAT, FCNTL_OPEN_EXCL and FCNTL_OPEN_NONBLOCK are respected
+ * @param attribute Max message number and message size if queue is created, NULL for default
+ * @return fsEntry* Entry of queue, NULL if error happens
+ */
+fsEntry* messageQueue_open(ConstCstring name, FCNTLopenFlags flags, MessageQueueAttribute* attribute);
+
+/**
+ * @brief Remove name of message queue, queue is released after all entries closed
+ *
+ * @param name Name of queue
+ */
+void messageQueue_unlink(ConstCstring name);
+
+/**
+ * @brief Get message queue behind fs entry
+ *
+ * @param entry fs entry
+ * @return MessageQueue* Queue of entry, NULL if entry is not a message queue
+ */
+MessageQueue* messageQueue_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Send a message, wait if queue is full
+ *
+ * @param queue Message queue
+ * @param message Message to send
+ * @param length Length of message, not greater than message size of queue
+ * @param priority Priority of message
+ * @param timeout Timeout in nanosecond, 0 for not waiting (ERROR_ID_WOULD_BLOCK thrown), negative for infinite
+ */
+void messageQueue_send(MessageQueue* queue, const void* message, Size length, Uint32 priority, Int64 timeout);
+
+/**
+ * @brief Receive oldest message of highest priority, wait if queue is empty
+ *
+ * @param queue Message queue
+ * @param buffer Buffer for message
+ * @param n Size of buffer, not less than message size of queue
+ * @param priorityRet Priority of message returned, NULL if not needed
+ * @param timeout Timeout in nanosecond, 0 for not waiting (ERROR_ID_WOULD_BLOCK thrown), negative for infinite
+ * @return Size Length of message
+ */
+Size messageQueue_receive(MessageQueue* queue, void* buffer, Size n, Uint32* priorityRet, Int64 timeout);
+
+/**
+ * @brief Get attribute of message queue through an entry
+ *
+ * @param entry Entry of message queue
+ * @param attributeRet Attribute returned, flags come from entry
+ */
+void messageQueue_getAttribute(fsEntry* entry, MessageQueueAttribute* attributeRet);
+
+#endif // __MULTITASK_MESSAGEQUEUE_H
@@ -4,20 +4,34 @@
 #include<fs/fsEntry.h>
 #include<fs/vnode.h>
 #include<fs/fsNode.h>
+#include<fs/poll.h>
+#include<kit/types.h>
 #include<multitask/locks/conditionVar.h>
 #include<multitask/locks/mutex.h>
-#include<structs/fifo.h>
 #include<structs/refCounter.h>
+#include<system/pageTable.h>
 
 typedef struct Pipe Pipe;
 
+#define PIPE_DEFAULT_CAPACITY   (16 * PAGE_SIZE)
+#define PIPE_MAX_CAPACITY       (256 * PAGE_SIZE)
+#define PIPE_ATOMIC_WRITE_SIZE  PAGE_SIZE   //Writes not larger than this never interleave with other writers (Known as PIPE_BUF)
+
 typedef struct Pipe {
-    FIFO fifo;
     fsNode* dummyNode;
     vNode* vnode;
+    void* buffer;               //Ring buffer made of whole pages
+    Size capacity;
+    Index64 readIndex;
     Size dataByteN;
-    Mutex lock;
-    ConditionVar cond;
+    Size readerNum;             //Opened read ends, writing to pipe without reader fails
+    Size writerNum;             //Opened write ends, reading from pipe without writer and data returns EOF
+    Mutex lock;                 //Lock for ring buffer and ends, never held across I/O of other entries
+    bool readerBusy;            //Data being transferred out stays in ring until consumed, other readers and resizing wait on readableCond
+    bool writerBusy;            //Free space being transferred in is filled outside lock, other writers and resizing wait on writableCond
+    ConditionVar readableCond;  //Readers wait for data or EOF
+    ConditionVar writableCond;  //Writers wait for free space or readers gone
+    PollWaitQueue pollQueue;    //Pollers of both ends
 } Pipe;
 
 // void pipe_initStruct(Pipe* pipe);
@@ -28,4 +42,59 @@ Pipe* pipe_create(fsEntry** writeEndRet, fsEntry** readEndRet); //The only way t
 
 void pipe_getFSentries(Pipe* pipe, fsEntry** writeEndRet, fsEntry** readEndRet);
 
+/**
+ * @brief Get pipe behind fs entry
+ *
+ * @param entry fs entry
+ * @return Pipe* Pipe of entry, NULL if entry is not end of a pipe
+ */
+Pipe* pipe_getFromFSentry(fsEntry* entry);
+
+static inline Size pipe_getCapacity(Pipe* pipe) {
+    return pipe->capacity;
+}
+
+/**
+ * @brief Resize ring buffer of pipe, buffered data is kept, capacity is rounded up to pages
+ *
+ * @param pipe Pipe
+ * @param capacity New capacity, should not be less than buffered data or greater than PIPE_MAX_CAPACITY
+ * @return Size Actual capacity, 0 if error happens
+ */
+Size pipe_setCapacity(Pipe* pipe, Size capacity);
+
+/**
+ * @brief Move data from pipe to fs entry, written straight from ring buffer without holding pipe lock, only data written is consumed
+ *
+ * @param pipe Pipe
+ * @param readEnd Read end of pipe, blocks like reading it unless opened with FCNTL_OPEN_NONBLOCK
+ * @param to Entry to write, should not be end of a pipe
+ * @param n Max number of bytes to move
+ * @return Size Number of bytes moved, 0 means EOF
+ */
+Size pipe_transferTo(Pipe* pipe, fsEntry* readEnd, fsEntry* to, Size n);
+
+/**
+ * @brief Move data from fs entry to pipe, read straight into ring buffer without holding pipe lock
+ *
+ * @param pipe Pipe
+ * @param writeEnd Write end of pipe, blocks like writing it unless opened with FCNTL_OPEN_NONBLOCK
+ * @param from Entry to read, should not be end of a pipe
+ * @param n Max number of bytes to move
+ * @return Size Number of bytes moved, may be less than n if pipe is full or entry has less data
+ */
+Size pipe_transferFrom(Pipe* pipe, fsEntry* writeEnd, fsEntry* from, Size n);
+
+/**
+ * @brief Move data between two pipes, copied ring to ring with both pipes locked
+ *
+ * @param pipe Pipe to read
+ * @param readEnd Read end of pipe, blocks like reading it unless opened with FCNTL_OPEN_NONBLOCK
+ * @param toPipe Pipe to write, should not be same as pipe
+ * @param writeEnd Write end of toPipe, blocks like writing it unless opened with FCNTL_OPEN_NONBLOCK
+ * @param n Max number of bytes to move
+ * @return Size Number of bytes moved, 0 means EOF
+ */
+Size pipe_transferPipe(Pipe* pipe, fsEntry* readEnd, Pipe* toPipe, fsEntry* writeEnd, Size n);
+
 #endif // __MULTITASK_PIPE_H
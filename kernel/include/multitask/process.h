@@ -4,20 +4,22 @@
 typedef struct Process Process;
 
 #include<fs/fsEntry.h>
+#include<fs/poll.h>
 #include<kit/types.h>
 #include<memory/extendedPageTable.h>
 #include<memory/vms.h>
 #include<multitask/signal.h>
 #include<multitask/state.h>
 #include<multitask/thread.h>
+#include<structs/hashTable.h>
 #include<structs/linkedList.h>
 #include<structs/string.h>
 #include<structs/vector.h>
 #include<system/pageTable.h>
 
 typedef struct Process {
-    Uint16 pid;
-    Uint16 ppid;
+    Uint32 pid;
+    Uint32 ppid;
     String name;
     
     State state;
@@ -34,15 +36,17 @@ typedef struct Process {
     LinkedListNode childProcessNode;
 
     LinkedListNode scheduleNode;
+    HashChainNode scheduleHashNode; //Node in PID index
 
     bool isProcessActive;
 
     SignalHandler signalHandlers[32];
+    PollWaitQueue signalPollQueue;  //signalfds of this process, woken up when any thread gets a signal pending
 } Process;
 
-void process_initStruct(Process* process, Uint16 pid, ConstCstring name, ExtendedPageTableRoot* extendedTable);
+void process_initStruct(Process* process, Uint32 pid, ConstCstring name, ExtendedPageTableRoot* extendedTable);
 
-void process_clone(Process* process, Uint16 pid, Process* cloneFrom);
+void process_clone(Process* process, Uint32 pid, Process* cloneFrom);
 
 void process_clearStruct(Process* process);
 
@@ -58,7 +62,14 @@ void process_continue(Process* process);
 
 void process_addThread(Process* process, Thread* thread);
 
-Thread* process_getThreadFromTID(Process* process, Uint16 tid);
+/**
+ * @brief Find a thread of process by TID, must be called inside RCU read section if process is active
+ * 
+ * @param process Process to search
+ * @param tid TID of thread
+ * @return Thread* Thread found, only valid until caller leaves read section, NULL if not found
+ */
+Thread* process_getThreadFromTID(Process* process, Uint32 tid);
 
 void process_removeThread(Process* process, Thread* thread);
 
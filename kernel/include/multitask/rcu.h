@@ -0,0 +1,62 @@
+#if !defined(__MULTITASK_RCU_H)
+#define __MULTITASK_RCU_H
+
+typedef struct RCUhead RCUhead;
+
+#include<kit/atomic.h>
+#include<kit/types.h>
+#include<structs/queue.h>
+
+typedef void (*RCUcallback)(RCUhead* head);
+
+/**
+ * @brief Deferred callback of RCU, usually embedded in the object to free after readers are done with it
+ */
+typedef struct RCUhead {
+    QueueNode   node;
+    RCUcallback callback;
+} RCUhead;
+
+//Read a RCU protected pointer inside read section
+#define RCU_DEREFERENCE(__PTR)              ATOMIC_LOAD(&(__PTR))
+//Publish a RCU protected pointer, object must be fully initialized before
+#define RCU_ASSIGN_POINTER(__PTR, __VAL)    ATOMIC_STORE(&(__PTR), __VAL)
+
+void rcu_init();
+
+/**
+ * @brief Kernel thread invoking callbacks whose grace period has ended
+ */
+void rcu_daemon();
+
+/**
+ * @brief Enter a RCU read section, current thread will not be preempted until left, must not sleep inside
+ */
+void rcu_readLock();
+
+/**
+ * @brief Leave a RCU read section
+ */
+void rcu_readUnlock();
+
+bool rcu_isInReadSection();
+
+/**
+ * @brief Report current CPU passed a quiescent state, called on context switch and in idle, never inside read section
+ */
+void rcu_noteQuiescentState();
+
+/**
+ * @brief Invoke callback after all read sections running now are finished
+ * 
+ * @param head RCU head, must stay valid until callback invoked
+ * @param callback Callback, called in RCU daemon
+ */
+void rcu_call(RCUhead* head, RCUcallback callback);
+
+/**
+ * @brief Block current thread until all read sections running now are finished
+ */
+void rcu_synchronize();
+
+#endif // __MULTITASK_RCU_H
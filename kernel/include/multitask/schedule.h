@@ -11,9 +11,16 @@ void schedule_setEarlyStackBottom(void* stackBottom);
 
 void schedule_init();
 
-Uint16 schedule_allocateNewID();
+#define SCHEDULE_INVALID_ID INVALID_INDEX32
 
-void schedule_releaseID(Uint16 id);
+/**
+ * @brief Allocate a new ID for process or thread, IDs are allocated cyclically so released ID is not reused until all IDs after it are tried
+ * 
+ * @return Uint32 New ID, SCHEDULE_INVALID_ID if ID space exhausted
+ */
+Uint32 schedule_allocateNewID();
+
+void schedule_releaseID(Uint32 id);
 
 void schedule_tick();
 
@@ -33,13 +40,27 @@ void schedule_threadJoinSchedule(Thread* thread);
 
 void schedule_threadQuitSchedule(Thread* thread);
 
+Process* schedule_getRootProcess();
+
 Process* schedule_getCurrentProcess();
 
-Process* schedule_getProcessFromPID(Uint16 pid);
+/**
+ * @brief Find an active process by PID, must be called inside RCU read section
+ * 
+ * @param pid PID of process
+ * @return Process* Process found, only valid until caller leaves read section, NULL if not found
+ */
+Process* schedule_getProcessFromPID(Uint32 pid);
 
 Thread* schedule_getCurrentThread();
 
-Thread* schedule_getThreadFromTID(Uint16 tid);
+/**
+ * @brief Find an active thread by TID, must be called inside RCU read section
+ * 
+ * @param tid TID of thread
+ * @return Thread* Thread found, only valid until caller leaves read section, NULL if not found
+ */
+Thread* schedule_getThreadFromTID(Uint32 tid);
 
 void schedule_enterCritical();
 
@@ -0,0 +1,76 @@
+#if !defined(__MULTITASK_SHAREDMEMORY_H)
+#define __MULTITASK_SHAREDMEMORY_H
+
+typedef struct SharedMemory SharedMemory;
+
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/vnode.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/extendedPageTable.h>
+#include<memory/vms.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+
+#define SHARED_MEMORY_NAME_MAX  255
+
+/**
+ * @brief Named memory object, shared mappings of it map its frames directly, so all processes see same frames instead of copies
+ */
+typedef struct SharedMemory {
+    LinkedListNode  node;       //Node in name list, valid until unlinked
+    RefCounter32    refCounter; //Name list holds 1, opened vnode holds 1
+    Mutex           lock;       //Lock for size and frames
+    Size            size;
+    Size            frameCapacity;
+    void**          frames;     //Physical frame of each page, NULL if never touched, each frame is referred once by object
+    vNode*          vnode;      //Vnode shared by all opened entries, NULL if not opened
+    char            name[0];
+} SharedMemory;
+
+void sharedMemory_init();
+
+/**
+ * @brief Open a named shared memory object, its entries share size and data
+ *
+ * @param name Name of object
+ * @param flags Open flags of entry, FCNTL_OPEN_CREAT, FCNTL_OPEN_EXCL and FCNTL_OPEN_TRUNC are respected
+ * @return fsEntry* Entry of object, NULL if error happens
+ */
+fsEntry* sharedMemory_open(ConstCstring name, FCNTLopenFlags flags);
+
+/**
+ * @brief Remove name of shared memory object, object is released after all entries closed, mapped frames are kept until unmapped
+ *
+ * @param name Name of object
+ */
+void sharedMemory_unlink(ConstCstring name);
+
+/**
+ * @brief Get shared memory object behind fs entry
+ *
+ * @param entry fs entry
+ * @return SharedMemory* Object of entry, NULL if entry is not a shared memory object
+ */
+SharedMemory* sharedMemory_getFromFSentry(fsEntry* entry);
+
+/**
+ * @brief Resize shared memory object, new space reads as 0, frames cut off stay in existing mappings until unmapped
+ *
+ * @param sharedMemory Shared memory object
+ * @param size New size in byte
+ */
+void sharedMemory_resize(SharedMemory* sharedMemory, Size size);
+
+/**
+ * @brief Map frames of shared memory object to region, called by mapping_mmap after region drawn
+ *
+ * @param sharedMemory Shared memory object
+ * @param info Info of region, offset should be page aligned, range should not exceed object
+ * @param pageTable Page table to draw
+ */
+void sharedMemory_draw(SharedMemory* sharedMemory, VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable);
+
+#endif // __MULTITASK_SHAREDMEMORY_H
@@ -6,6 +6,7 @@ typedef union Sigval Sigval;
 typedef struct Siginfo Siginfo;
 typedef enum SignalDefaultHandler SignalDefaultHandler;
 
+#include<kit/bit.h>
 #include<kit/types.h>
 
 typedef Uint32 SignalQueue;
@@ -45,6 +46,8 @@ typedef Uint32 SignalQueue;
 #define SIGNAL_SIGSYS     31    /* Dump        Bad system call                      */
 #define SIGNAL_SIGUNUSED  31    /* Dump        Equivalent to SIGSYS                 */
 
+#define SIGNAL_MASK_UNBLOCKABLE (FLAG32(SIGNAL_SIGKILL) | FLAG32(SIGNAL_SIGSTOP))  //Always delivered, can not be blocked or read from signalfd
+
 typedef void (*SignalHandler)(int signal);
 typedef void (*SignalAction)(int signal, Siginfo* info, void* ucontext);    //TODO: ucontext not used yet
 
@@ -69,7 +72,7 @@ typedef struct Siginfo {
     int             errno;          /* An errno value */
     int             code;           /* Signal code */
     int             trapno;         /* Trap number that caused hardware-generated signal (unused on most architectures) */
-    Uint16          pid;            /* Sending process ID */
+    Uint32          pid;            /* Sending process ID */
     Uint16          uid;            /* Real user ID of sending process */
     int             status;         /* Exit value or signal */
     long            utime;          /* User time consumed */
@@ -118,4 +121,17 @@ void signalQueue_pend(SignalQueue* queue, int signal);
 
 int signalQueue_getPending(SignalQueue* queue);
 
+/**
+ * @brief Take lowest pending signal in mask out of queue
+ *
+ * @param queue Signal queue
+ * @param mask Signals allowed to be taken
+ * @return int Signal taken, 0 if no signal in mask is pending
+ */
+int signalQueue_takePending(SignalQueue* queue, Flags32 mask);
+
+static inline bool signalQueue_hasPending(SignalQueue* queue, Flags32 mask) {
+    return (*(volatile SignalQueue*)queue & mask) != 0;
+}
+
 #endif // __MULTITASK_SIGNAL_H
@@ -10,6 +10,7 @@ typedef void (*ThreadEntryPoint)();
 #include<multitask/state.h>
 #include<multitask/threadStack.h>
 #include<multitask/wait.h>
+#include<structs/hashTable.h>
 #include<structs/linkedList.h>
 #include<structs/queue.h>
 #include<structs/refCounter.h>
@@ -20,7 +21,7 @@ typedef void (*ThreadEntryPoint)();
 typedef struct Thread {
     Process* process;
 
-    Uint16 tid;
+    Uint32 tid;
     State state;
 
     ThreadStack kernelStack;
@@ -33,6 +34,7 @@ typedef struct Thread {
 
     LinkedListNode processNode;
     LinkedListNode scheduleNode;
+    HashChainNode scheduleHashNode; //Node in TID index
     LinkedListNode scheduleRunningNode;
     QueueNode reapNode;
 
@@ -48,17 +50,18 @@ typedef struct Thread {
     bool isThreadActive;
 
     SignalQueue signalQueue;
+    Flags32 signalMask; //Blocked signals stay pending until unblocked or read from signalfd
 } Thread;
 
-void thread_initStruct(Thread* thread, Uint16 tid, Process* process);
+void thread_initStruct(Thread* thread, Uint32 tid, Process* process);
 
-void thread_initFirstThread(Thread* thread, Uint16 tid, Process* process, void* stackBottom, Size stackSize);
+void thread_initFirstThread(Thread* thread, Uint32 tid, Process* process, void* stackBottom, Size stackSize);
 
-void thread_initNewThread(Thread* thread, Uint16 tid, Process* process, ThreadEntryPoint entry);
+void thread_initNewThread(Thread* thread, Uint32 tid, Process* process, ThreadEntryPoint entry);
 
 void thread_clearStruct(Thread* thread);
 
-void thread_clone(Thread* thread, Thread* cloneFrom, Uint16 tid, Process* newProcess, Context* retContext);
+void thread_clone(Thread* thread, Thread* cloneFrom, Uint32 tid, Process* newProcess, Context* retContext);
 
 void thread_die(Thread* thread);
 
@@ -84,4 +87,12 @@ void thread_handleSignal(Thread* thread, int signal);
 
 void thread_handleSignalIfAny(Thread* thread);
 
+/**
+ * @brief Set blocked signals of thread, unblocked pending signals are handled at once if thread is current one
+ *
+ * @param thread Thread
+ * @param mask Signals to block, SIGNAL_MASK_UNBLOCKABLE is ignored
+ */
+void thread_setSignalMask(Thread* thread, Flags32 mask);
+
 #endif // __MULTITASK_THREAD_H
@@ -45,6 +45,15 @@ void time_init();
 
 void time_getTimestamp(Timestamp* timestamp);
 
+/**
+ * @brief Get time of last clock beat, cheaper than time_getTimestamp since clock source is not read, precise to one beat
+ *
+ * @param timestamp Timestamp returned
+ */
+void time_getCoarseTimestamp(Timestamp* timestamp);
+
+void time_getMonotonicTimestamp(Timestamp* timestamp);
+
 #if defined(CONFIG_UNIT_TEST_TIME)
 TEST_EXPOSE_GROUP(time_testGroup);
 #define UNIT_TEST_GROUP_TIME    &time_testGroup
@@ -2,12 +2,16 @@
 #define __TIME_TIMER_H
 
 typedef struct Timer Timer;
+typedef struct TimerWheel TimerWheel;
 
 #include<devices/clock/clockSource.h>
 #include<kit/bit.h>
 #include<kit/oop.h>
 #include<kit/types.h>
-#include<structs/heap.h>
+#include<kit/util.h>
+#include<multitask/locks/spinlock.h>
+#include<multitask/wait.h>
+#include<structs/linkedList.h>
 #include<time/time.h>
 
 typedef void (*TimerHandler)(Timer* tiemr);
@@ -21,8 +25,27 @@ typedef struct Timer {
 #define TIMER_FLAGS_PRESENT     FLAG8(0)
 #define TIMER_FLAGS_REPEAT      FLAG8(1)
 #define TIMER_FLAGS_SYNCHRONIZE FLAG8(2)
+    LinkedListNode  node;   //Node in wheel slot
+    TimerWheel*     wheel;  //Wheel holding this timer, valid only when present
+    Wait            wait;   //Threads sleeping until this timer stops
 } Timer;
 
+#define TIMER_WHEEL_LEVEL_BITS  6
+#define TIMER_WHEEL_SLOT_NUM    POWER_2(TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_SLOT_MASK   (TIMER_WHEEL_SLOT_NUM - 1)
+#define TIMER_WHEEL_LEVEL_NUM   4
+#define TIMER_WHEEL_MAX_DELAY   (POWER_2(TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_LEVEL_NUM) - 1)   //Longer delays are parked in last level and cascaded again
+
+/**
+ * @brief Hierarchical timing wheel, level N slot covers 64^N ticks, timers are cascaded to lower level when their slot is reached
+ */
+typedef struct TimerWheel {
+    Uint64      currentTick;    //Next tick to process
+    Size        timerNum;
+    Spinlock    lock;
+    LinkedList  slots[TIMER_WHEEL_LEVEL_NUM][TIMER_WHEEL_SLOT_NUM];
+} TimerWheel;
+
 void timer_init(ClockSource* timerClockSource);
 
 void timer_initStruct(Timer* timer, Int64 time, TimeUnit unit);
@@ -33,4 +56,12 @@ void timer_stop(Timer* timer);
 
 void timer_updateTimers();
 
+/**
+ * @brief Put current thread to sleep for given time, thread will not be scheduled until woken up by timer
+ * 
+ * @param time Time to sleep
+ * @param unit Unit of time
+ */
+void timer_sleep(Int64 time, TimeUnit unit);
+
 #endif // __TIME_TIMER_H
@@ -18,14 +18,14 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_STAT              0x04
 #define SYSCALL_INDEX_FSTAT             0x05
 #define SYSCALL_INDEX_LSTAT             0x06    //TODO: Not implemented
-#define SYSCALL_INDEX_POLL              0x07    //TODO: Not implemented
+#define SYSCALL_INDEX_POLL              0x07
 #define SYSCALL_INDEX_LSEEK             0x08    //TODO: Not implemented
 #define SYSCALL_INDEX_MMAP              0x09
 #define SYSCALL_INDEX_MPROTECT          0x0A    //TODO: Not implemented
 #define SYSCALL_INDEX_MUNMAP            0x0B
 #define SYSCALL_INDEX_BRK               0x0C    //TODO: Not implemented
 #define SYSCALL_INDEX_RT_SIGACTION      0x0D    //TODO: Not implemented
-#define SYSCALL_INDEX_RT_SIGPROCMASK    0x0E    //TODO: Not implemented
+#define SYSCALL_INDEX_RT_SIGPROCMASK    0x0E
 #define SYSCALL_INDEX_RT_SIGRETURN      0x0F    //TODO: Not implemented
 #define SYSCALL_INDEX_IOCTL             0x10    //TODO: Not implemented
 #define SYSCALL_INDEX_PREAD64           0x11    //TODO: Not implemented
@@ -34,7 +34,7 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_WRITEV            0x14    //TODO: Not implemented
 #define SYSCALL_INDEX_ACCESS            0x15    //TODO: Not implemented
 #define SYSCALL_INDEX_PIPE              0x16
-#define SYSCALL_INDEX_SELECT            0x17    //TODO: Not implemented
+#define SYSCALL_INDEX_SELECT            0x17
 #define SYSCALL_INDEX_SCHED_YIELD       0x18
 #define SYSCALL_INDEX_MREMAP            0x19    //TODO: Not implemented
 #define SYSCALL_INDEX_MSYNC             0x1A    //TODO: flags not fully supported
@@ -45,11 +45,12 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_DUP               0x20    //TODO: Not implemented
 #define SYSCALL_INDEX_DUP2              0x21    //TODO: Not implemented
 #define SYSCALL_INDEX_PAUSE             0x22    //TODO: Not implemented
-#define SYSCALL_INDEX_NANOSLEEP         0x23    //TODO: Not implemented
+#define SYSCALL_INDEX_NANOSLEEP         0x23
 #define SYSCALL_INDEX_GETITIMER         0x24    //TODO: Not implemented
 #define SYSCALL_INDEX_ALARM             0x25    //TODO: Not implemented
 #define SYSCALL_INDEX_SETITIMER         0x26    //TODO: Not implemented
 #define SYSCALL_INDEX_GETPID            0x27
+#define SYSCALL_INDEX_SENDFILE          0x28
 #define SYSCALL_INDEX_SOCKET            0x29    //TODO: Not implemented
 #define SYSCALL_INDEX_CONNECT           0x2A    //TODO: Not implemented
 #define SYSCALL_INDEX_ACCEPT            0x2B    //TODO: Not implemented
@@ -72,11 +73,12 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_WAIT4             0x3D    //TODO: Not implemented
 #define SYSCALL_INDEX_KILL              0x3E    //TODO: Not implemented
 #define SYSCALL_INDEX_UNAME             0x3F    //TODO: Not implemented
+#define SYSCALL_INDEX_FCNTL             0x48
 #define SYSCALL_INDEX_FLOCK             0x49    //TODO: Not implemented
 #define SYSCALL_INDEX_FSYNC             0x4A    //TODO: Not implemented
 #define SYSCALL_INDEX_FDATASYNC         0x4B    //TODO: Not implemented
 #define SYSCALL_INDEX_TRUNCATE          0x4C    //TODO: Not implemented
-#define SYSCALL_INDEX_FTRUNCATE         0x4D    //TODO: Not implemented
+#define SYSCALL_INDEX_FTRUNCATE         0x4D
 #define SYSCALL_INDEX_GETDENTS          0x4E
 #define SYSCALL_INDEX_GETCWD            0x4F    //TODO: Not implemented
 #define SYSCALL_INDEX_CHDIR             0x50    //TODO: Not implemented
@@ -145,10 +147,10 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_GETTID            0xBA    //TODO: Not implemented
 #define SYSCALL_INDEX_TKILL             0xC8    //TODO: Not implemented
 #define SYSCALL_INDEX_TIME              0xC9    //TODO: Not implemented
-#define SYSCALL_INDEX_FUTEX             0xCA    //TODO: Not implemented
+#define SYSCALL_INDEX_FUTEX             0xCA
 #define SYSCALL_INDEX_SCHED_SETAFFINITY 0xCB    //TODO: Not implemented
 #define SYSCALL_INDEX_SCHED_GETAFFINITY 0xCC    //TODO: Not implemented
-#define SYSCALL_INDEX_EPOLL_CREATE      0xD5    //TODO: Not implemented
+#define SYSCALL_INDEX_EPOLL_CREATE      0xD5
 #define SYSCALL_INDEX_GETDENTS64        0xD9    //TODO: Not implemented
 #define SYSCALL_INDEX_TIMER_CREATE      0xDE    //TODO: Not implemented
 #define SYSCALL_INDEX_TIMER_SETTIME     0xDF    //TODO: Not implemented
@@ -156,12 +158,18 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_TIMER_GETOVERRUN  0xE1    //TODO: Not implemented
 #define SYSCALL_INDEX_TIMER_DELETE      0xE2    //TODO: Not implemented
 #define SYSCALL_INDEX_CLOCK_SETTIME     0xE3    //TODO: Not implemented
-#define SYSCALL_INDEX_CLOCK_GETTIME     0xE4    //TODO: Not implemented
+#define SYSCALL_INDEX_CLOCK_GETTIME     0xE4
 #define SYSCALL_INDEX_CLOCK_GETRES      0xE5    //TODO: Not implemented
-#define SYSCALL_INDEX_CLOCK_NANOSLEEP   0xE6    //TODO: Not implemented
-#define SYSCALL_INDEX_EPOLL_WAIT        0xE8    //TODO: Not implemented
-#define SYSCALL_INDEX_EPOLL_CTL         0xE9    //TODO: Not implemented
+#define SYSCALL_INDEX_CLOCK_NANOSLEEP   0xE6
+#define SYSCALL_INDEX_EPOLL_WAIT        0xE8
+#define SYSCALL_INDEX_EPOLL_CTL         0xE9
 #define SYSCALL_INDEX_UTIMES            0xEB    //TODO: Not implemented
+#define SYSCALL_INDEX_MQ_OPEN           0xF0
+#define SYSCALL_INDEX_MQ_UNLINK         0xF1
+#define SYSCALL_INDEX_MQ_TIMEDSEND      0xF2
+#define SYSCALL_INDEX_MQ_TIMEDRECEIVE   0xF3
+#define SYSCALL_INDEX_MQ_NOTIFY         0xF4    //TODO: Not implemented
+#define SYSCALL_INDEX_MQ_GETSETATTR     0xF5
 #define SYSCALL_INDEX_WAITID            0xF7    //TODO: Not implemented
 #define SYSCALL_INDEX_MKDIRAT           0x102   //TODO: Not implemented
 #define SYSCALL_INDEX_FSTATAT           0x106   //TODO: Not implemented
@@ -173,27 +181,33 @@ typedef struct SyscallUnit {
 #define SYSCALL_INDEX_FACCESSAT         0x10D   //TODO: Not implemented
 #define SYSCALL_INDEX_PSELECT6          0x10E   //TODO: Not implemented
 #define SYSCALL_INDEX_PPOLL             0x10F   //TODO: Not implemented
+#define SYSCALL_INDEX_SPLICE            0x113   //Flags are ignored
 #define SYSCALL_INDEX_UTIMENSAT         0x118   //TODO: Not implemented
 #define SYSCALL_INDEX_EPOLL_PWAIT       0x119   //TODO: Not implemented
-#define SYSCALL_INDEX_TIMERFD_CREATE    0x11B   //TODO: Not implemented
-#define SYSCALL_INDEX_EVENTFD           0x11C   //TODO: Not implemented
+#define SYSCALL_INDEX_SIGNALFD          0x11A
+#define SYSCALL_INDEX_TIMERFD_CREATE    0x11B
+#define SYSCALL_INDEX_EVENTFD           0x11C
 #define SYSCALL_INDEX_FALLOCATE         0x11D   //TODO: Not implemented
-#define SYSCALL_INDEX_TIMERFD_SETTIME   0x11E   //TODO: Not implemented
-#define SYSCALL_INDEX_TIMERFD_GETTIME   0x11F   //TODO: Not implemented
+#define SYSCALL_INDEX_TIMERFD_SETTIME   0x11E
+#define SYSCALL_INDEX_TIMERFD_GETTIME   0x11F
 #define SYSCALL_INDEX_ACCEPT4           0x120   //TODO: Not implemented
-#define SYSCALL_INDEX_EVENTFD2          0x122   //TODO: Not implemented
-#define SYSCALL_INDEX_EPOLL_CREATE1     0x123   //TODO: Not implemented
+#define SYSCALL_INDEX_SIGNALFD4         0x121
+#define SYSCALL_INDEX_EVENTFD2          0x122
+#define SYSCALL_INDEX_EPOLL_CREATE1     0x123
 #define SYSCALL_INDEX_DUP3              0x124   //TODO: Not implemented
 #define SYSCALL_INDEX_PIPE2             0x125   //TODO: Not implemented
 #define SYSCALL_INDEX_PREADV            0x127   //TODO: Not implemented
 #define SYSCALL_INDEX_PWRITEV           0x128   //TODO: Not implemented
 #define SYSCALL_INDEX_GETCPU            0x135   //TODO: Not implemented
 #define SYSCALL_INDEX_GETRANDOM         0x13E   //TODO: Not implemented
+#define SYSCALL_INDEX_COPY_FILE_RANGE   0x146
 #define SYSCALL_INDEX_PREADV2           0x147   //TODO: Not implemented
 #define SYSCALL_INDEX_PWRITEV2          0x148   //TODO: Not implemented
 #define SYSCALL_INDEX_STATX             0x14C   //TODO: Not implemented
 #define SYSCALL_INDEX_FACCESSAT2        0x15E   //TODO: Not implemented
 #define SYSCALL_INDEX_EPOLL_PWAIT2      0x160   //TODO: Not implemented
+#define SYSCALL_INDEX_SHM_OPEN          0x1F0   //Not in Linux, libc opens files under /dev/shm there
+#define SYSCALL_INDEX_SHM_UNLINK        0x1F1   //Not in Linux, libc unlinks files under /dev/shm there
 #define SYSCALL_INDEX_TEST              0x1FF   //TODO: REMOVE ME
 #define SYSCALL_MAX_INDEX               0x1FF
 
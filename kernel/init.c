@@ -62,6 +62,7 @@ static __Init_Task _initFuncs2[] = {
     { schedule_init             ,   "Schedule"      , NULL  },
     { time_init                 ,   "Time"          , UNIT_TEST_GROUP_SCHEDULE  },  //TODO: Timer relies on schedule, decouple it in the future
     { __init_dummy              ,   NULL            , UNIT_TEST_GROUP_TIME      },
+    { fs_startSyncDaemon        ,   "FS Sync"       , NULL  },
     { realmode_init             ,   "Realmode"      , NULL  },
     { usermode_init             ,   "User Mode"     , UNIT_TEST_GROUP_USERMODE  },
     { __init_initVideo          ,   "Video"         , NULL  },
@@ -74,6 +74,22 @@ void error_init() {
         ERROR_ID_VERIFICATION_FAILED, "Verification Failed"
     );
 
+    error_registerError(
+        ERROR_ID_TIMEOUT, "Timeout"
+    );
+
+    error_registerError(
+        ERROR_ID_WOULD_BLOCK, "Would Block"
+    );
+
+    error_registerError(
+        ERROR_ID_BROKEN_PIPE, "Broken Pipe"
+    );
+
+    error_registerError(
+        ERROR_ID_LOOP, "Loop"
+    );
+
     errorRecord_setError(ERROR_ID_OK);
 }
 
@@ -58,8 +58,6 @@ Index64 bitmap_findFirstSet(Bitmap* b, Index64 begin) {
         return INVALID_INDEX64;
     }
 
-    Uint64* ptr = (void*)&b->bitPtr[begin >> 3];
-
     Index64 i = begin, limit = CLEAR_VAL_SIMPLE(begin, 64, 6) + 64;
     for (; i < limit && i < b->bitNum; ++i) {
         if (__BITMAP_RAW_TEST(b->bitPtr, i)) {
@@ -67,9 +65,8 @@ Index64 bitmap_findFirstSet(Bitmap* b, Index64 begin) {
         }
     }
 
-    i += 64;
-
-    while (i < b->bitNum && *ptr == EMPTY_FLAGS) {
+    Uint64* ptr = (void*)&b->bitPtr[i >> 3];    //i is 64-aligned here
+    while (i + 64 <= b->bitNum && *ptr == EMPTY_FLAGS) {
         ++ptr;
         i += 64;
     }
@@ -88,8 +85,6 @@ Index64 bitmap_findFirstClear(Bitmap* b, Index64 begin) {
         return INVALID_INDEX64;
     }
 
-    Uint64* ptr = (void*)&b->bitPtr[begin >> 3];
-
     Index64 i = begin, limit = CLEAR_VAL_SIMPLE(begin, 64, 6) + 64;
     for (; i < limit && i < b->bitNum; ++i) {
         if (!__BITMAP_RAW_TEST(b->bitPtr, i)) {
@@ -97,9 +92,8 @@ Index64 bitmap_findFirstClear(Bitmap* b, Index64 begin) {
         }
     }
 
-    i += 64;
-
-    while (i < b->bitNum && *ptr == FULL_MASK(64)) {
+    Uint64* ptr = (void*)&b->bitPtr[i >> 3];    //i is 64-aligned here
+    while (i + 64 <= b->bitNum && *ptr == FULL_MASK(64)) {
         ++ptr;
         i += 64;
     }
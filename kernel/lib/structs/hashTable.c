@@ -3,6 +3,7 @@
 #include<kit/oop.h>
 #include<kit/types.h>
 #include<kit/util.h>
+#include<structs/rcuList.h>
 #include<structs/singlyLinkedList.h>
 #include<error.h>
 
@@ -80,5 +81,60 @@ HashChainNode* hashTable_find(HashTable* table, Object key) {
         }
     }
 
+    return NULL;
+}
+
+void hashTable_rcuInsert(HashTable* table, Object key, HashChainNode* newNode) {
+    Size hashKey = table->hashFunc(table, key);
+
+    SinglyLinkedList* chain = table->chains + hashKey;
+    for (SinglyLinkedListNode* node = chain->next; node != chain; node = node->next) {
+        HashChainNode* chainNode = HOST_POINTER(node, HashChainNode, node);
+
+        if (chainNode->key == key) {
+            ERROR_THROW(ERROR_ID_ALREADY_EXIST, 0);
+        }
+    }
+
+    newNode->key = key;
+    singlyLinkedList_rcuInsertNext(chain, &newNode->node);
+
+    ++table->size;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+HashChainNode* hashTable_rcuDelete(HashTable* table, Object key) {
+    Size hashKey = table->hashFunc(table, key);
+
+    SinglyLinkedList* chain = table->chains + hashKey;
+    for (SinglyLinkedListNode* node = chain->next, *last = chain; node != chain; last = node, node = node->next) {
+        HashChainNode* chainNode = HOST_POINTER(node, HashChainNode, node);
+
+        if (chainNode->key == key) {
+            singlyLinkedList_rcuDeleteNext(last);   //Keep node's next for readers on it
+            --table->size;
+
+            return chainNode;
+        }
+    }
+
+    ERROR_THROW_NO_GOTO(ERROR_ID_NOT_FOUND);
+    return NULL;
+}
+
+HashChainNode* hashTable_rcuFind(HashTable* table, Object key) {
+    Size hashKey = table->hashFunc(table, key);
+
+    SinglyLinkedList* chain = table->chains + hashKey;
+    for (SinglyLinkedListNode* node = singlyLinkedList_rcuGetNext(chain); node != chain; node = singlyLinkedList_rcuGetNext(node)) {
+        HashChainNode* chainNode = HOST_POINTER(node, HashChainNode, node);
+
+        if (chainNode->key == key) {
+            return chainNode;
+        }
+    }
+
     return NULL;
 }
\ No newline at end of file
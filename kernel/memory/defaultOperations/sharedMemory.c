@@ -0,0 +1,83 @@
+#include<memory/defaultOperations/sharedMemory.h>
+
+#include<kit/types.h>
+#include<memory/defaultOperations/generic.h>
+#include<memory/extendedPageTable.h>
+#include<memory/frameMetadata.h>
+#include<memory/frameReaper.h>
+#include<memory/memoryOperations.h>
+#include<memory/mm.h>
+#include<structs/refCounter.h>
+#include<system/pageTable.h>
+#include<error.h>
+#include<debug.h>
+
+//Frames are drawn when mapped (see sharedMemory_draw), each present entry refers its frame once, the shared memory object refers it once more
+
+static void __defaultMemoryOperations_sharedMemory_copyEntry(PagingLevel level, ExtendedPageTable* srcExtendedTable, ExtendedPageTable* desExtendedTable, Index16 index);
+
+static void __defaultMemoryOperations_sharedMemory_releaseEntry(PagingLevel level, ExtendedPageTable* extendedTable, Index16 index, void* v, FrameReaper* reaper);
+
+MemoryOperations defaultMemoryOperations_sharedMemory = (MemoryOperations) {
+    .copyPagingEntry    = __defaultMemoryOperations_sharedMemory_copyEntry,
+    .pageFaultHandler   = defaultMemoryOperations_genericFaultHandler,  //Never lazy, fault here is an access violation
+    .releasePagingEntry = __defaultMemoryOperations_sharedMemory_releaseEntry
+};
+
+static void __defaultMemoryOperations_sharedMemory_copyEntry(PagingLevel level, ExtendedPageTable* srcExtendedTable, ExtendedPageTable* desExtendedTable, Index16 index) {
+    PagingEntry* srcEntry = &srcExtendedTable->table.tableEntries[index], * desEntry = &desExtendedTable->table.tableEntries[index];
+    ExtraPageTableEntry* srcExtraEntry = &srcExtendedTable->extraTable.tableEntries[index], * desExtraEntry = &desExtendedTable->extraTable.tableEntries[index];
+
+    if (PAGING_IS_LEAF(level, *srcEntry)) {
+        if (TEST_FLAGS(*srcEntry, PAGING_ENTRY_FLAG_PRESENT)) {
+            void* mapToFrame = pageTable_getNextLevelPage(level, *srcEntry);
+            FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(mapToFrame));
+            if (unit == NULL) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+
+            REF_COUNTER_REFER(unit->refCounter);
+        }
+
+        *desEntry = *srcEntry;
+        *desExtraEntry = *srcExtraEntry;
+    } else {
+        void* newTableFrames = defaultMemoryOperations_genericCopyTableEntry(level, srcEntry, __defaultMemoryOperations_sharedMemory_copyEntry);
+        if (newTableFrames == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        *desEntry = BUILD_ENTRY_PAGING_TABLE(newTableFrames, FLAGS_FROM_PAGING_ENTRY(*srcEntry));
+        *desExtraEntry = *srcExtraEntry;
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __defaultMemoryOperations_sharedMemory_releaseEntry(PagingLevel level, ExtendedPageTable* extendedTable, Index16 index, void* v, FrameReaper* reaper) {
+    PagingEntry* entry = &extendedTable->table.tableEntries[index];
+
+    if (PAGING_IS_LEAF(level, *entry)) {
+        if (TEST_FLAGS(*entry, PAGING_ENTRY_FLAG_PRESENT)) {
+            void* mapToFrame = pageTable_getNextLevelPage(level, *entry);
+            FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(mapToFrame));
+            if (unit == NULL) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(0);
+            }
+
+            if (REF_COUNTER_DEREFER(unit->refCounter) == 0) {   //Object already dropped this frame (released or shrunk)
+                frameReaper_collect(reaper, mapToFrame, PAGING_SPAN(PAGING_NEXT_LEVEL(level)) / PAGE_SIZE);
+            }
+        }
+    } else {
+        defaultMemoryOperations_genericReleaseTableEntry(level, entry, v, reaper, __defaultMemoryOperations_sharedMemory_releaseEntry);
+    }
+
+    extendedPageTable_clearEntry(extendedTable, index);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include<memory/memory.h>
 #include<memory/mm.h>
 #include<memory/paging.h>
+#include<memory/tlbShootdown.h>
 #include<system/pageTable.h>
 #include<algorithms.h>
 #include<error.h>
@@ -60,16 +61,23 @@ Index8 extraPageTableContext_registerMemoryOperations(ExtraPageTableContext* con
 
 ExtendedPageTableRoot* extendedPageTableRoot_copyTable(ExtendedPageTableRoot* source) {
     ExtendedPageTableRoot* ret = mm_allocate(sizeof(ExtendedPageTableRoot));
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
     void* frames = extendedPageTable_allocateFrame();
     if (frames == NULL) {
         ERROR_ASSERT_ANY();
-        ERROR_GOTO(0);
+        ERROR_GOTO(1);
     }
 
     ret->context = source->context;
     ret->extendedTable = PAGING_CONVERT_KERNEL_MEMORY_P2V(frames);
     ret->pPageTable = PAGING_CONVERT_KERNEL_MEMORY_V2P(&ret->extendedTable->table);
     frameReaper_initStruct(&ret->reaper);
+    ret->activeCPUs = EMPTY_FLAGS;  //Not loaded anywhere until switched to
+    paging_assignPCID(ret);
 
     for (int i = 0; i < PAGING_TABLE_SIZE; ++i) {
         if (TEST_FLAGS_FAIL(source->extendedTable->table.tableEntries[i], PAGING_ENTRY_FLAG_PRESENT)) {
@@ -77,20 +85,29 @@ ExtendedPageTableRoot* extendedPageTableRoot_copyTable(ExtendedPageTableRoot* so
         }
 
         extendedPageTableRoot_copyEntry(ret, PAGING_LEVEL_PML4, source->extendedTable, ret->extendedTable, i);
-        ERROR_GOTO_IF_ERROR(0);
+        ERROR_GOTO_IF_ERROR(2);
     }
 
-    PAGING_FLUSH_TLB(); //Even copy may alter the table
+    paging_flushAddressSpace(source); //Even copy may alter the table
 
     return ret;
+    ERROR_FINAL_BEGIN(2);
+    paging_releasePCID(ret);
+    extendedPageTable_freeFrame(frames);
+    ERROR_FINAL_BEGIN(1);
+    mm_free(ret);
     ERROR_FINAL_BEGIN(0);
     return NULL;
 }
 
+void __extendedPageTableRoot_doErase(ExtendedPageTableRoot* root, PagingLevel level, ExtendedPageTable* currentTable, Uintptr currentV, Size subN, TLBshootdown* shootdown);
+
 void extendedPageTableRoot_releaseTable(ExtendedPageTableRoot* table) {
-    extendedPageTableRoot_erase(table, 0, 1ull << 36);
+    DEBUG_ASSERT_SILENT(table != mm->extendedTable);
+    __extendedPageTableRoot_doErase(table, PAGING_LEVEL_PML4, table->extendedTable, 0, 1ull << 36, NULL);   //No flush needed, PCID is flushed on next assignment
     ERROR_GOTO_IF_ERROR(0);
     
+    paging_releasePCID(table);
     frameReaper_reap(&table->reaper);
     extendedPageTable_freeFrame(PAGING_CONVERT_KERNEL_MEMORY_V2P(table->extendedTable));
     mm_free(table);
@@ -118,8 +135,9 @@ void extendedPageTableRoot_draw(ExtendedPageTableRoot* root, void* v, void* p, S
         CLEAR_FLAG_BACK(prot, PAGING_ENTRY_FLAG_PRESENT);
     }
     __extendedPageTableRoot_doDraw(root, PAGING_LEVEL_PML4, root->extendedTable, (Uintptr)v, (Uintptr)p, n, operationsID, prot, flags);
+    ERROR_GOTO_IF_ERROR(0);
 
-    PAGING_FLUSH_TLB();
+    paging_flushTLB(root, v, n);
     
     return;
     ERROR_FINAL_BEGIN(0);
@@ -221,13 +239,18 @@ void __extendedPageTableRoot_doDraw(ExtendedPageTableRoot* root, PagingLevel lev
     ERROR_FINAL_BEGIN(0);
 }
 
-void __extendedPageTableRoot_doErase(ExtendedPageTableRoot* root, PagingLevel level, ExtendedPageTable* currentTable, Uintptr currentV, Size subN);
-
 void extendedPageTableRoot_erase(ExtendedPageTableRoot* root, void* v, Size n) {
-    __extendedPageTableRoot_doErase(root, PAGING_LEVEL_PML4, root->extendedTable, (Uintptr)v, n);
+    TLBshootdown shootdown;
+    tlbShootdown_initStruct(&shootdown, root);
+    __extendedPageTableRoot_doErase(root, PAGING_LEVEL_PML4, root->extendedTable, (Uintptr)v, n, &shootdown);
+    tlbShootdown_flush(&shootdown); //Flush even if failed, some pages may be erased already
+    ERROR_GOTO_IF_ERROR(0);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
 }
 
-void __extendedPageTableRoot_doErase(ExtendedPageTableRoot* root, PagingLevel level, ExtendedPageTable* currentTable, Uintptr currentV, Size subN) {
+void __extendedPageTableRoot_doErase(ExtendedPageTableRoot* root, PagingLevel level, ExtendedPageTable* currentTable, Uintptr currentV, Size subN, TLBshootdown* shootdown) {
     Size span = PAGING_SPAN(PAGING_NEXT_LEVEL(level)), spanN = span >> PAGE_SIZE_SHIFT;
     Index16 begin = PAGING_INDEX(level, currentV), end = begin + DIVIDE_ROUND_UP(subN << PAGE_SIZE_SHIFT, span);
     DEBUG_ASSERT_SILENT(end <= PAGING_TABLE_SIZE);
@@ -244,12 +267,15 @@ void __extendedPageTableRoot_doErase(ExtendedPageTableRoot* root, PagingLevel le
             }
 
             if (IS_ALIGNED(currentV, span) && subSubN == spanN) {   //Release whole entry
+                if (shootdown != NULL && TEST_FLAGS(*entry, PAGING_ENTRY_FLAG_PRESENT)) {   //Only translations really present may be cached
+                    tlbShootdown_addPages(shootdown, (void*)currentV, subSubN);
+                }
                 extendedPageTableRoot_releaseEntry(root, level, currentTable, i, (void*)currentV, &root->reaper);
                 ERROR_GOTO_IF_ERROR(0);
             } else {                                                //Release partial entry
                 DEBUG_ASSERT_SILENT(level > PAGING_LEVEL_PAGE);
                 ExtendedPageTable* nextExtendedTable = extentedPageTable_extendedTableFromEntry(*entry);
-                __extendedPageTableRoot_doErase(root, PAGING_NEXT_LEVEL(level), nextExtendedTable, currentV, subSubN);
+                __extendedPageTableRoot_doErase(root, PAGING_NEXT_LEVEL(level), nextExtendedTable, currentV, subSubN, shootdown);
                 ERROR_GOTO_IF_ERROR(0);
 
                 Uint16 entryNum = 0;    //TODO: Rework these logic
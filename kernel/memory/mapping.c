@@ -2,6 +2,7 @@
 
 #include<fs/fs.h>
 #include<fs/fsEntry.h>
+#include<fs/tmpfs/vnode.h>
 #include<kit/bit.h>
 #include<kit/types.h>
 #include<kit/util.h>
@@ -13,6 +14,7 @@
 #include<memory/vms.h>
 #include<multitask/process.h>
 #include<multitask/schedule.h>
+#include<multitask/sharedMemory.h>
 #include<system/pageTable.h>
 #include<algorithms.h>
 #include<error.h>
@@ -73,6 +75,19 @@ void* mapping_mmap(void* prefer, Size length, Flags32 prot, Flags32 flags, File*
     // length = ALIGN_UP(length, PAGE_SIZE);
     __MAPPING_ROUND_RANGE(prefer, length);
 
+    SharedMemory* sharedMemory = NULL;
+    TmpfsVnode* tmpfsVnode = NULL;
+    if (file != NULL && TEST_FLAGS_FAIL(flags, MAPPING_MMAP_FLAGS_ANON) && MAPPING_MMAP_FLAGS_TYPE_EXTRACT(flags) == MAPPING_MMAP_FLAGS_TYPE_SHARED) {
+        sharedMemory = sharedMemory_getFromFSentry(file);   //Map frames of object directly instead of copying them through file
+        if (sharedMemory == NULL) {
+            tmpfsVnode = tmpfs_vNode_getFromFSentry(file);  //So are frames of tmpfs file
+        }
+
+        if ((sharedMemory != NULL || tmpfsVnode != NULL) && offset % PAGE_SIZE != 0) {
+            return NULL;
+        }
+    }
+
     VirtualMemorySpace* vms = &schedule_getCurrentProcess()->vms;
     
     void* addr = NULL;
@@ -89,10 +104,20 @@ void* mapping_mmap(void* prefer, Size length, Flags32 prot, Flags32 flags, File*
 
     VirtualMemoryRegionInfo info;
     __mapping_mmapSetupInfo(&info, addr, length, prot, flags, file, offset);
+    if (sharedMemory != NULL || tmpfsVnode != NULL) {
+        info.memoryOperationsID = DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY;
+        CLEAR_FLAG_BACK(info.flags, VIRTUAL_MEMORY_REGION_INFO_FLAGS_LAZY_LOAD);
+    }
 
     virtualMemorySpace_draw(vms, &info);
     ERROR_GOTO_IF_ERROR(0);
-    virtualMemoryRegionInfo_drawToExtendedTable(&info, vms->pageTable, NULL);
+    if (sharedMemory != NULL) {
+        sharedMemory_draw(sharedMemory, &info, vms->pageTable);
+    } else if (tmpfsVnode != NULL) {
+        tmpfs_vNode_draw(tmpfsVnode, &info, vms->pageTable);
+    } else {
+        virtualMemoryRegionInfo_drawToExtendedTable(&info, vms->pageTable, NULL);
+    }
     ERROR_GOTO_IF_ERROR(0);
 
     return addr;
@@ -139,7 +164,7 @@ void mapping_msync(void* addr, Size length, Flags8 flags) {
 
     while (currentPointer < end) {
         VirtualMemoryRegionInfo* info = &currentRegion->info;
-        if (VIRTUAL_MEMORY_REGION_INFO_FLAGS_EXTRACT_TYPE(info->flags) == VIRTUAL_MEMORY_REGION_INFO_FLAGS_TYPE_FILE && TEST_FLAGS(info->flags, VIRTUAL_MEMORY_REGION_INFO_FLAGS_WRITABLE | VIRTUAL_MEMORY_REGION_INFO_FLAGS_SHARED)) {
+        if (VIRTUAL_MEMORY_REGION_INFO_FLAGS_EXTRACT_TYPE(info->flags) == VIRTUAL_MEMORY_REGION_INFO_FLAGS_TYPE_FILE && TEST_FLAGS(info->flags, VIRTUAL_MEMORY_REGION_INFO_FLAGS_WRITABLE | VIRTUAL_MEMORY_REGION_INFO_FLAGS_SHARED) && info->memoryOperationsID != DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY) {  //Shared memory objects have no backing store
             DEBUG_ASSERT_SILENT(info->file != NULL);
             Uintptr regionEnd = algorithms_umin64(end, info->range.begin + info->range.length);
 
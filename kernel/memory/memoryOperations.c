@@ -6,6 +6,7 @@
 #include<memory/defaultOperations/file.h>
 #include<memory/defaultOperations/mixed.h>
 #include<memory/defaultOperations/share.h>
+#include<memory/defaultOperations/sharedMemory.h>
 #include<memory/extendedPageTable.h>
 #include<memory/mm.h>
 #include<debug.h>
@@ -19,7 +20,8 @@ static MemoryOperations* __memoryOperations_defaultOperations[DEFAULT_MEMORY_OPE
     [DEFAULT_MEMORY_OPERATIONS_TYPE_ANON_PRIVATE]   = &defaultMemoryOperations_anon_private,
     [DEFAULT_MEMORY_OPERATIONS_TYPE_ANON_SHARED]    = &defaultMemoryOperations_anon_shared,
     [DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE]   = &defaultMemoryOperations_file_private,
-    [DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED]    = &defaultMemoryOperations_file_shared
+    [DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED]    = &defaultMemoryOperations_file_shared,
+    [DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY]  = &defaultMemoryOperations_sharedMemory
 };
 
 void memoryOperations_registerDefault(ExtraPageTableContext* context) {
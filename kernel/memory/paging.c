@@ -11,9 +11,14 @@
 #include<memory/frameReaper.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
+#include<memory/tlbShootdown.h>
 #include<real/flags/cr0.h>
+#include<real/flags/cr4.h>
 #include<real/flags/msr.h>
+#include<real/cpuid.h>
 #include<real/simpleAsmLines.h>
+#include<multitask/locks/spinlock.h>
+#include<structs/bitmap.h>
 #include<system/memoryLayout.h>
 #include<system/pageTable.h>
 #include<algorithms.h>
@@ -49,7 +54,7 @@ ISR_FUNC_HEADER(__pageFaultHandler) { //TODO: This handler triggers double page
         });
 
         if (fixed) {
-            PAGING_FLUSH_TLB();
+            paging_flushTLB(mm->extendedTable, PAGING_PAGE_ALIGN(v), 1);
             return;
         }
 
@@ -68,6 +73,14 @@ ISR_FUNC_HEADER(__pageFaultHandler) { //TODO: This handler triggers double page
 
 static ExtendedPageTableRoot _extendedPageTableRoot;
 
+static bool _paging_pcidSupported, _paging_invpcidSupported;
+static Bitmap _paging_pcidBitmap;
+static Uint8 _paging_pcidBitmapBits[PAGING_PCID_NUM / 8];
+static Spinlock _paging_pcidLock;
+static Index64 _paging_lastAllocatedPCID;
+
+static void __paging_initPCID();
+
 void paging_init() {
     extraPageTableContext_initStruct(&mm->extraPageTableContext);
     ERROR_GOTO_IF_ERROR(0);
@@ -95,8 +108,11 @@ void paging_init() {
     );
     ERROR_GOTO_IF_ERROR(0);
 
+    mm->tlbGeneration = 1;
     mm_switchPageTable(&_extendedPageTableRoot);
 
+    __paging_initPCID();
+
     idt_registerISR(EXCEPTION_VEC_PAGE_FAULT, __pageFaultHandler, 1, IDT_FLAGS_PRESENT | IDT_FLAGS_TYPE_TRAP_GATE32); //Register default page fault handler, IST 1 in case of stack memory triggers error
 
     Uint32 eax, edx;
@@ -119,4 +135,82 @@ void* paging_fastTranslate(ExtendedPageTableRoot* pageTable, void* v) {
     }
 
     return p;
+}
+
+void paging_assignPCID(ExtendedPageTableRoot* root) {
+    root->pcid = PAGING_PCID_NONE;
+    root->tlbGeneration = 0;    //PCID may be used by released address space before, flush on first switch
+    if (!_paging_pcidSupported) {
+        return;
+    }
+
+    spinlock_lock(&_paging_pcidLock);
+    Index64 pcid = bitmap_findFirstClear(&_paging_pcidBitmap, _paging_lastAllocatedPCID);
+    if (pcid == INVALID_INDEX64) {
+        pcid = bitmap_findFirstClear(&_paging_pcidBitmap, 0);
+    }
+
+    if (pcid != INVALID_INDEX64) {
+        bitmap_setBit(&_paging_pcidBitmap, pcid);
+        _paging_lastAllocatedPCID = pcid;
+        root->pcid = pcid;
+    }
+    spinlock_unlock(&_paging_pcidLock);
+}
+
+void paging_releasePCID(ExtendedPageTableRoot* root) {
+    if (root->pcid == PAGING_PCID_NONE) {
+        return;
+    }
+
+    spinlock_lock(&_paging_pcidLock);
+    bitmap_clearBit(&_paging_pcidBitmap, root->pcid);
+    spinlock_unlock(&_paging_pcidLock);
+
+    root->pcid = PAGING_PCID_NONE;
+}
+
+bool paging_isInvpcidSupported() {
+    return _paging_invpcidSupported;
+}
+
+void paging_flushTLB(ExtendedPageTableRoot* root, void* v, Size n) {
+    TLBshootdown shootdown;
+    tlbShootdown_initStruct(&shootdown, root);
+    tlbShootdown_addPages(&shootdown, v, n);
+    tlbShootdown_flush(&shootdown);
+}
+
+void paging_flushAddressSpace(ExtendedPageTableRoot* root) {
+    if (root == mm->extendedTable) {
+        PAGING_FLUSH_TLB();
+    } else {
+        root->tlbGeneration = 0;
+    }
+}
+
+static void __paging_initPCID() {
+    _paging_pcidSupported = _paging_invpcidSupported = false;
+    _paging_pcidLock = SPINLOCK_UNLOCKED;
+    _paging_lastAllocatedPCID = 0;
+    memory_memset(_paging_pcidBitmapBits, 0, sizeof(_paging_pcidBitmapBits));
+    bitmap_initStruct(&_paging_pcidBitmap, PAGING_PCID_NUM, _paging_pcidBitmapBits);
+    bitmap_setBit(&_paging_pcidBitmap, PAGING_PCID_NONE);
+
+    Uint32 eax, ebx, ecx, edx;
+    CPUID(CPUID_INFO_AND_FEATURE, eax, ebx, ecx, edx);
+    if (TEST_FLAGS_FAIL(ecx, CPUID_INFO_AND_FEATURE_ECX_PCID)) {
+        return;
+    }
+
+    CPUID_WITH_SUB_PARAM(0x7, 0x0, eax, ebx, ecx, edx);
+    _paging_invpcidSupported = TEST_FLAGS(ebx, CPUID_EXTENDED_FEATURED1_EBX_INVPCID);
+
+    writeRegister_CR4_64(readRegister_CR4_64() | CR4_PCIDE);    //CR3 PCID must be 0 here
+    _paging_pcidSupported = true;
+
+    ExtendedPageTableRoot* root = mm->extendedTable;
+    paging_assignPCID(root);
+    root->tlbGeneration = mm->tlbGeneration;
+    writeRegister_CR3_64((Uint64)root->pPageTable | root->pcid);
 }
\ No newline at end of file
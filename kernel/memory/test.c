@@ -7,6 +7,7 @@
 #include<memory/mm.h>
 #include<memory/allocators/slabHeapAllocator.h>
 #include<memory/allocators/kernelHeapAllocator.h>
+#include<memory/tlbShootdown.h>
 #include<real/simpleAsmLines.h>
 #include<structs/singlyLinkedList.h>
 #include<system/pageTable.h>
@@ -232,10 +233,50 @@ TEST_SETUP_LIST(
     (1, __mm_test_kernelAllocator_clear)
 );
 
+static bool __mm_test_tlbShootdown_batch(void* arg) {
+    TLBshootdown shootdown;
+    tlbShootdown_initStruct(&shootdown, mm->extendedTable);
+
+    void* base = (void*)(16 * PAGE_SIZE);
+    tlbShootdown_addPages(&shootdown, base, 1);
+    tlbShootdown_addPages(&shootdown, base + PAGE_SIZE, 2); //Adjacent, merged
+    tlbShootdown_addPages(&shootdown, base + 8 * PAGE_SIZE, 1);
+    if (!(shootdown.rangeNum == 2 && shootdown.ranges[0].n == 3 && shootdown.pageNum == 4 && shootdown.flags == EMPTY_FLAGS)) {
+        return false;
+    }
+
+    tlbShootdown_flush(&shootdown);
+    if (!(shootdown.rangeNum == 0 && shootdown.pageNum == 0)) {
+        return false;
+    }
+
+    for (int i = 0; i <= TLB_SHOOTDOWN_RANGE_NUM; ++i) {    //Too many ranges
+        tlbShootdown_addPages(&shootdown, base + 2 * i * PAGE_SIZE, 1);
+    }
+    if (TEST_FLAGS_FAIL(shootdown.flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH)) {
+        return false;
+    }
+    tlbShootdown_flush(&shootdown);
+
+    tlbShootdown_addPages(&shootdown, base, TLB_SHOOTDOWN_FULL_FLUSH_LIMIT + 1);    //Too many pages
+    if (TEST_FLAGS_FAIL(shootdown.flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH)) {
+        return false;
+    }
+    tlbShootdown_flush(&shootdown);
+
+    return shootdown.flags == EMPTY_FLAGS;
+}
+
+TEST_SETUP_LIST(
+    MM_TLB_SHOOTDOWN,
+    (1, __mm_test_tlbShootdown_batch)
+);
+
 TEST_SETUP_LIST(
     MM,
     (0, &TEST_LIST_FULL_NAME(MM_SLAB_ALLOCATOR)),
-    (0, &TEST_LIST_FULL_NAME(MM_KERNEL_ALLOCATOR))
+    (0, &TEST_LIST_FULL_NAME(MM_KERNEL_ALLOCATOR)),
+    (0, &TEST_LIST_FULL_NAME(MM_TLB_SHOOTDOWN))
 );
 
 TEST_SETUP_GROUP(mm_testGroup, EMPTY_FLAGS, __mm_test_testGroupPrepare, MM, NULL);
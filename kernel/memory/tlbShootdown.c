@@ -0,0 +1,142 @@
+#include<memory/tlbShootdown.h>
+
+#include<kit/atomic.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/extendedPageTable.h>
+#include<memory/mm.h>
+#include<memory/paging.h>
+#include<real/simpleAsmLines.h>
+#include<system/memoryLayout.h>
+#include<system/pageTable.h>
+#include<debug.h>
+
+static void __tlbShootdown_reset(TLBshootdown* shootdown);
+
+static void __tlbShootdown_invalidatePages(TLBshootdown* shootdown, bool isActive);
+
+void tlbShootdown_initStruct(TLBshootdown* shootdown, ExtendedPageTableRoot* root) {
+    shootdown->root = root;
+    __tlbShootdown_reset(shootdown);
+}
+
+void tlbShootdown_addPages(TLBshootdown* shootdown, void* v, Size n) {
+    if (n == 0) {
+        return;
+    }
+
+    if ((Uintptr)v + (n << PAGE_SIZE_SHIFT) > MEMORY_LAYOUT_KERNEL_MEMORY_BEGIN) {   //Direct mapped kernel memory and kernel text are drawn once and shared by all address spaces, colorful space is per page table
+        SET_FLAG_BACK(shootdown->flags, TLB_SHOOTDOWN_FLAGS_SHARED);
+    }
+
+    shootdown->pageNum += n;
+    if (TEST_FLAGS(shootdown->flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH)) {
+        return;
+    }
+
+    if (shootdown->pageNum > TLB_SHOOTDOWN_FULL_FLUSH_LIMIT) {
+        SET_FLAG_BACK(shootdown->flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH);
+        return;
+    }
+
+    if (shootdown->rangeNum > 0) {
+        TLBshootdownRange* last = &shootdown->ranges[shootdown->rangeNum - 1];
+        if (last->begin + (last->n << PAGE_SIZE_SHIFT) == (Uintptr)v) {
+            last->n += n;
+            return;
+        }
+    }
+
+    if (shootdown->rangeNum == TLB_SHOOTDOWN_RANGE_NUM) {
+        SET_FLAG_BACK(shootdown->flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH);
+        return;
+    }
+
+    shootdown->ranges[shootdown->rangeNum++] = (TLBshootdownRange) {
+        .begin  = (Uintptr)v,
+        .n      = n
+    };
+}
+
+void tlbShootdown_flush(TLBshootdown* shootdown) {
+    if (shootdown->pageNum == 0) {
+        return;
+    }
+
+    ExtendedPageTableRoot* root = shootdown->root;
+    if (TEST_FLAGS(shootdown->flags, TLB_SHOOTDOWN_FLAGS_SHARED) && !paging_isInvpcidSupported()) {    //No way to reach translations of other PCIDs, flush them on next switch
+        ++mm->tlbGeneration;
+    }
+
+    Uint64 remoteCPUs = CLEAR_FLAG(root->activeCPUs, FLAG64(TLB_SHOOTDOWN_LOCAL_CPU));
+    DEBUG_ASSERT_SILENT(remoteCPUs == EMPTY_FLAGS);  //TODO: Send IPI to remote CPUs when SMP is supported
+    Uint32 pendingCPUnum = 1;
+    for (Uint64 cpus = remoteCPUs; cpus != 0; cpus &= (cpus - 1)) {
+        ++pendingCPUnum;
+    }
+    shootdown->pendingCPUnum = pendingCPUnum;
+
+    tlbShootdown_handleRequest(shootdown);
+    while (ATOMIC_LOAD(&shootdown->pendingCPUnum) != 0) {  //Wait for completion handshake from remote CPUs
+        asm volatile("pause;" ::: "memory");
+    }
+
+    __tlbShootdown_reset(shootdown);
+}
+
+void tlbShootdown_handleRequest(TLBshootdown* shootdown) {
+    ExtendedPageTableRoot* root = shootdown->root;
+    __tlbShootdown_invalidatePages(shootdown, root == mm->extendedTable);
+    ATOMIC_DEC_FETCH(&shootdown->pendingCPUnum);
+}
+
+static void __tlbShootdown_reset(TLBshootdown* shootdown) {
+    shootdown->rangeNum = shootdown->pageNum = 0;
+    shootdown->flags = EMPTY_FLAGS;
+    shootdown->pendingCPUnum = 0;
+}
+
+static void __tlbShootdown_invalidatePages(TLBshootdown* shootdown, bool isActive) {
+    ExtendedPageTableRoot* root = shootdown->root;
+    bool isFullFlush = TEST_FLAGS(shootdown->flags, TLB_SHOOTDOWN_FLAGS_FULL_FLUSH);
+
+    if (TEST_FLAGS(shootdown->flags, TLB_SHOOTDOWN_FLAGS_SHARED) && paging_isInvpcidSupported()) {   //Translations may be tagged by any PCID, drop them on this CPU instead of bumping generation
+        invpcid(INVPCID_TYPE_ALL_CONTEXT, 0, NULL);
+        if (isActive) {
+            root->tlbGeneration = mm->tlbGeneration;
+        }
+        return;
+    }
+
+    if (isActive) {
+        if (isFullFlush) {
+            PAGING_FLUSH_TLB();
+        } else {
+            for (int i = 0; i < shootdown->rangeNum; ++i) {
+                TLBshootdownRange* range = &shootdown->ranges[i];
+                for (Size j = 0; j < range->n; ++j) {
+                    invlpg((void*)(range->begin + (j << PAGE_SIZE_SHIFT)));
+                }
+            }
+        }
+        root->tlbGeneration = mm->tlbGeneration;
+        return;
+    }
+
+    //Inactive page table may still have translations tagged by its PCID
+    if (root->pcid == PAGING_PCID_NONE || TEST_FLAGS(shootdown->flags, TLB_SHOOTDOWN_FLAGS_SHARED)) {    //Flushed on next switch anyway
+        return;
+    }
+
+    if (isFullFlush || !paging_isInvpcidSupported()) {
+        root->tlbGeneration = 0;
+        return;
+    }
+
+    for (int i = 0; i < shootdown->rangeNum; ++i) {
+        TLBshootdownRange* range = &shootdown->ranges[i];
+        for (Size j = 0; j < range->n; ++j) {
+            invpcid(INVPCID_TYPE_INDIVIDUAL_ADDRESS, root->pcid, (void*)(range->begin + (j << PAGE_SIZE_SHIFT)));
+        }
+    }
+}
\ No newline at end of file
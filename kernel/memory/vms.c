@@ -3,14 +3,18 @@
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/extendedPageTable.h>
+#include<memory/frameMetadata.h>
 #include<memory/memoryOperations.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
+#include<multitask/locks/mutex.h>
 #include<structs/RBtree.h>
 #include<structs/refCounter.h>
 #include<structs/vector.h>
 #include<system/memoryLayout.h>
 #include<system/pageTable.h>
+#include<algorithms.h>
+#include<debug.h>
 #include<error.h>
 
 static void __virtualMemoryRegionSharedFrames_initStruct(VirtualMemoryRegionSharedFrames* frames, Uintptr vBase, Size frameN);
@@ -54,7 +58,7 @@ static inline bool __virtualMemoryRegionInfo_isValid(VirtualMemoryRegionInfo* in
         return false;
     }
 
-    if (type == VIRTUAL_MEMORY_REGION_INFO_FLAGS_TYPE_FILE && !(info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED)) {
+    if (type == VIRTUAL_MEMORY_REGION_INFO_FLAGS_TYPE_FILE && !(info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY)) {
         return false;
     }
     
@@ -89,6 +93,56 @@ static inline void __virtualMemorySpace_removeRegion(VirtualMemorySpace* vms, Vi
     --vms->regionNum;
 }
 
+void virtualMemoryRegionInfo_drawFrames(VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable, Mutex* lock, const Size* objectSize, VirtualMemoryRegionInfoGetFrameFunc getFrame, Object object) {
+    DEBUG_ASSERT_SILENT(info->offset % PAGE_SIZE == 0 && info->range.length % PAGE_SIZE == 0);
+    Flags64 prot = virtualMemoryRegionInfo_convertPagingProt(info);
+    Index64 beginPageIndex = info->offset / PAGE_SIZE;
+
+    mutex_acquire(lock);
+
+    Size objectPageN = DIVIDE_ROUND_UP(*objectSize, PAGE_SIZE);
+    Size pageN = beginPageIndex >= objectPageN ? 0 : algorithms_umin64(info->range.length / PAGE_SIZE, objectPageN - beginPageIndex);  //Pages beyond object are left unmapped, accessing them faults
+    for (Index64 i = 0; i < pageN;) {   //Draw physically continuous frames together
+        void* runBegin = getFrame(object, beginPageIndex + i);
+        if (runBegin == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+
+        Size runN = 1;
+        while (i + runN < pageN) {
+            void* frame = getFrame(object, beginPageIndex + i + runN);
+            if (frame == NULL) {
+                ERROR_ASSERT_ANY();
+                ERROR_GOTO(1);
+            }
+
+            if (frame != runBegin + runN * PAGE_SIZE) {
+                break;
+            }
+            ++runN;
+        }
+
+        extendedPageTableRoot_draw(pageTable, (void*)(info->range.begin + i * PAGE_SIZE), runBegin, runN, DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY, prot, EXTENDED_PAGE_TABLE_DRAW_FLAGS_ASSERT_DRAW_BLANK);
+        ERROR_GOTO_IF_ERROR(1);
+
+        for (Index64 j = 0; j < runN; ++j) {    //Mapping refers frames, released by shared memory operations when unmapped
+            FrameMetadataUnit* unit = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(runBegin + j * PAGE_SIZE));
+            DEBUG_ASSERT_SILENT(unit != NULL);
+            REF_COUNTER_REFER(unit->refCounter);
+        }
+
+        i += runN;
+    }
+
+    mutex_release(lock);
+
+    return;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(lock);
+    ERROR_FINAL_BEGIN(0);
+}
+
 Index32 virtualMemoryRegion_getFrameIndex(VirtualMemoryRegion* vmr, void* v) {
     VirtualMemoryRegionSharedFrames* sharedFrames = vmr->sharedFrames;
     if (sharedFrames == NULL) {
@@ -333,7 +387,7 @@ static void __virtualMemoryRegion_setFields(VirtualMemoryRegion* vmr, VirtualMem
 
     Flags16 type = VIRTUAL_MEMORY_REGION_INFO_FLAGS_EXTRACT_TYPE(info->flags);
     if (type == VIRTUAL_MEMORY_REGION_INFO_FLAGS_TYPE_FILE) {
-        DEBUG_ASSERT_SILENT(info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED);
+        DEBUG_ASSERT_SILENT(info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_PRIVATE || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_FILE_SHARED || info->memoryOperationsID == DEFAULT_MEMORY_OPERATIONS_TYPE_SHARED_MEMORY);
         desInfo->file = info->file;
         desInfo->offset = info->offset;
     } else {
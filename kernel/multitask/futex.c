@@ -0,0 +1,320 @@
+#include<multitask/futex.h>
+
+#include<kit/atomic.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/paging.h>
+#include<multitask/locks/spinlock.h>
+#include<multitask/locks/ticketSpinlock.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+#include<structs/linkedList.h>
+#include<time/timer.h>
+#include<debug.h>
+#include<error.h>
+
+typedef struct __FutexKey {
+    Uintptr address;    //Physical address for shared futex, virtual address for private futex
+    void*   space;      //Address space of private futex, NULL for shared futex
+} __FutexKey;
+
+#define __FUTEX_BUCKET_BITS 8
+#define __FUTEX_BUCKET_NUM  POWER_2(__FUTEX_BUCKET_BITS)
+
+typedef struct __FutexBucket {
+    TicketSpinlock  lock;   //Also taken in timer interrupt, always lock with interrupt disabled
+    LinkedList      waiters;
+} __FutexBucket;
+
+typedef struct __FutexWaiter {
+    LinkedListNode  node;
+    __FutexKey      key;
+    Uint32          bitset;
+    Thread*         thread;
+    __FutexBucket*  bucket; //Bucket queued in, NULL once dequeued
+    bool            timedOut;
+    Wait            wait;
+} __FutexWaiter;
+
+static __FutexBucket _futex_buckets[__FUTEX_BUCKET_NUM];
+
+static bool __futex_waitOperations_tryTake(Wait* wait, Thread* thread);
+
+static bool __futex_waitOperations_shouldWait(Wait* wait, Thread* thread);
+
+static void __futex_waitOperations_wait(Wait* wait, Thread* thread);
+
+static void __futex_waitOperations_quitWaitting(Wait* wait, Thread* thread);
+
+static WaitOperations _futex_waitOperations = {
+    .tryTake        = __futex_waitOperations_tryTake,
+    .shouldWait     = __futex_waitOperations_shouldWait,
+    .wait           = __futex_waitOperations_wait,
+    .quitWaitting   = __futex_waitOperations_quitWaitting
+};
+
+static void __futex_getKey(Uint32* uaddr, Flags8 flags, __FutexKey* key);
+
+static inline bool __futex_isKeyEqual(__FutexKey* key1, __FutexKey* key2) {
+    return key1->address == key2->address && key1->space == key2->space;
+}
+
+static inline __FutexBucket* __futex_getBucket(__FutexKey* key) {
+    Uint64 hash = (key->address >> 2) ^ ((Uintptr)key->space >> 4);
+    return &_futex_buckets[(hash * 0x9E3779B97F4A7C15ull) >> (64 - __FUTEX_BUCKET_BITS)];
+}
+
+static void __futex_wakeupWaiter(__FutexWaiter* waiter);
+
+static bool __futex_dequeueWaiter(__FutexWaiter* waiter);
+
+static void __futex_timeoutHandler(Timer* timer);
+
+void futex_init() {
+    for (int i = 0; i < __FUTEX_BUCKET_NUM; ++i) {
+        _futex_buckets[i].lock = TICKET_SPINLOCK_UNLOCKED;
+        linkedList_initStruct(&_futex_buckets[i].waiters);
+    }
+}
+
+void futex_wait(Uint32* uaddr, Uint32 val, Int64 timeout, Uint32 bitset, Flags8 flags) {
+    if (uaddr == NULL || ((Uintptr)uaddr & 3) != 0 || bitset == 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    if (ATOMIC_LOAD(uaddr) != val) {    //Also faults the page in before interrupt is disabled
+        ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+    }
+
+    if (timeout == 0) {
+        ERROR_THROW(ERROR_ID_TIMEOUT, 0);
+    }
+
+    __FutexWaiter waiter;
+    __futex_getKey(uaddr, flags, &waiter.key);
+    ERROR_GOTO_IF_ERROR(0);
+    linkedListNode_initStruct(&waiter.node);
+    waiter.bitset   = bitset;
+    waiter.thread   = schedule_getCurrentThread();
+    waiter.bucket   = NULL;
+    waiter.timedOut = false;
+    wait_initStruct(&waiter.wait, &_futex_waitOperations);
+
+    Timer timer;
+    if (timeout > 0) {
+        timer_initStruct(&timer, timeout, TIME_UNIT_NANOSECOND);
+        timer.handler = __futex_timeoutHandler;
+        timer.data = (Object)&waiter;
+    }
+
+    __FutexBucket* bucket = __futex_getBucket(&waiter.key);
+    schedule_enterCritical();   //Wakers must not slip in between checking word and sleeping
+    ticketSpinlock_lock(&bucket->lock);
+    if (ATOMIC_LOAD(uaddr) != val) {
+        ticketSpinlock_unlock(&bucket->lock);
+        schedule_leaveCritical();
+        ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+    }
+
+    linkedListNode_insertFront(&bucket->waiters, &waiter.node);    //Append to tail, woken in FIFO order
+    waiter.bucket = bucket;
+    ticketSpinlock_unlock(&bucket->lock);
+
+    if (timeout > 0) {
+        timer_start(&timer);
+    }
+    thread_sleep(waiter.thread, &waiter.wait);
+
+    if (timeout > 0) {
+        schedule_enterCritical();
+        if (TEST_FLAGS(timer.flags, TIMER_FLAGS_PRESENT)) {
+            timer_stop(&timer);
+        }
+        schedule_leaveCritical();
+    }
+
+    if (waiter.timedOut) {
+        ERROR_THROW(ERROR_ID_TIMEOUT, 0);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+Size futex_wake(Uint32* uaddr, Size n, Uint32 bitset, Flags8 flags) {
+    if (uaddr == NULL || ((Uintptr)uaddr & 3) != 0 || bitset == 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    __FutexKey key;
+    __futex_getKey(uaddr, flags, &key);
+    ERROR_GOTO_IF_ERROR(0);
+
+    __FutexBucket* bucket = __futex_getBucket(&key);
+    Size ret = 0;
+    bool interruptEnabled = ticketSpinlock_lockIrqSave(&bucket->lock);
+    for (LinkedListNode* node = linkedListNode_getNext(&bucket->waiters); node != &bucket->waiters && ret < n;) {
+        __FutexWaiter* waiter = HOST_POINTER(node, __FutexWaiter, node);
+        node = linkedListNode_getNext(node);
+
+        if (!__futex_isKeyEqual(&waiter->key, &key) || (waiter->bitset & bitset) == 0) {
+            continue;
+        }
+
+        __futex_wakeupWaiter(waiter);
+        ++ret;
+    }
+    ticketSpinlock_unlockIrqRestore(&bucket->lock, interruptEnabled);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+Size futex_requeue(Uint32* uaddr, Size nWake, Uint32* uaddr2, Size nRequeue, Uint32* cmpVal, Flags8 flags) {
+    if (uaddr == NULL || ((Uintptr)uaddr & 3) != 0 || uaddr2 == NULL || ((Uintptr)uaddr2 & 3) != 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Uint32 compareTo = 0;
+    if (cmpVal != NULL) {
+        compareTo = *cmpVal;
+        if (ATOMIC_LOAD(uaddr) != compareTo) {  //Also faults the page in before interrupt is disabled
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+        }
+    }
+
+    __FutexKey key1, key2;
+    __futex_getKey(uaddr, flags, &key1);
+    ERROR_GOTO_IF_ERROR(0);
+    __futex_getKey(uaddr2, flags, &key2);
+    ERROR_GOTO_IF_ERROR(0);
+
+    __FutexBucket* bucket1 = __futex_getBucket(&key1), * bucket2 = __futex_getBucket(&key2);
+    __FutexBucket* first = bucket1 < bucket2 ? bucket1 : bucket2, * second = bucket1 < bucket2 ? bucket2 : bucket1;   //Lock in address order
+    bool interruptEnabled = idt_disableInterrupt();
+    ticketSpinlock_lock(&first->lock);
+    if (second != first) {
+        ticketSpinlock_lock(&second->lock);
+    }
+
+    Size woken = 0, requeued = 0;
+    if (cmpVal != NULL && ATOMIC_LOAD(uaddr) != compareTo) {
+        ERROR_THROW_NO_GOTO(ERROR_ID_WOULD_BLOCK);
+    } else {
+        for (LinkedListNode* node = linkedListNode_getNext(&bucket1->waiters); node != &bucket1->waiters && (woken < nWake || requeued < nRequeue);) {
+            __FutexWaiter* waiter = HOST_POINTER(node, __FutexWaiter, node);
+            node = linkedListNode_getNext(node);
+
+            if (!__futex_isKeyEqual(&waiter->key, &key1)) {
+                continue;
+            }
+
+            if (woken < nWake) {
+                __futex_wakeupWaiter(waiter);
+                ++woken;
+                continue;
+            }
+
+            linkedListNode_delete(&waiter->node);
+            waiter->key = key2;
+            linkedListNode_insertFront(&bucket2->waiters, &waiter->node);
+            waiter->bucket = bucket2;
+            ++requeued;
+        }
+    }
+
+    if (second != first) {
+        ticketSpinlock_unlock(&second->lock);
+    }
+    ticketSpinlock_unlock(&first->lock);
+    idt_setInterrupt(interruptEnabled);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return woken + requeued;
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static bool __futex_waitOperations_tryTake(Wait* wait, Thread* thread) {
+    return false;
+}
+
+static bool __futex_waitOperations_shouldWait(Wait* wait, Thread* thread) {
+    __FutexWaiter* waiter = HOST_POINTER(wait, __FutexWaiter, wait);
+    return ATOMIC_LOAD(&waiter->bucket) != NULL;    //Still queued, woken up spuriously
+}
+
+static void __futex_waitOperations_wait(Wait* wait, Thread* thread) {
+    DEBUG_ASSERT_SILENT(thread == schedule_getCurrentThread());
+    DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+
+    if (schedule_isInCritical()) {
+        schedule_leaveCritical();
+        DEBUG_ASSERT_SILENT(!schedule_isInCritical());
+    }
+
+    schedule_yield();
+}
+
+static void __futex_waitOperations_quitWaitting(Wait* wait, Thread* thread) {
+    __futex_dequeueWaiter(HOST_POINTER(wait, __FutexWaiter, wait));
+}
+
+static void __futex_getKey(Uint32* uaddr, Flags8 flags, __FutexKey* key) {
+    ExtendedPageTableRoot* extendedTable = schedule_getCurrentProcess()->extendedTable;
+    if (TEST_FLAGS(flags, FUTEX_FLAGS_PRIVATE)) {
+        key->address = (Uintptr)uaddr;
+        key->space = extendedTable;
+        return;
+    }
+
+    void* p = paging_fastTranslate(extendedTable, uaddr);   //Same physical word may be mapped at different addresses in different processes
+    if (p == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    key->address = (Uintptr)p;
+    key->space = NULL;
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __futex_wakeupWaiter(__FutexWaiter* waiter) {
+    linkedListNode_delete(&waiter->node);
+    ATOMIC_STORE(&waiter->bucket, NULL);
+    thread_wakeup(waiter->thread);  //Waiter may be gone once it runs, do not touch it after
+}
+
+static bool __futex_dequeueWaiter(__FutexWaiter* waiter) {
+    while (true) {
+        __FutexBucket* bucket = ATOMIC_LOAD(&waiter->bucket);
+        if (bucket == NULL) {
+            return false;
+        }
+
+        bool interruptEnabled = ticketSpinlock_lockIrqSave(&bucket->lock);
+        bool ret = waiter->bucket == bucket;    //Not requeued to other bucket in between
+        if (ret) {
+            linkedListNode_delete(&waiter->node);
+            waiter->bucket = NULL;
+        }
+        ticketSpinlock_unlockIrqRestore(&bucket->lock, interruptEnabled);
+
+        if (ret) {
+            return true;
+        }
+    }
+}
+
+static void __futex_timeoutHandler(Timer* timer) {
+    __FutexWaiter* waiter = (__FutexWaiter*)timer->data;
+    if (__futex_dequeueWaiter(waiter)) {
+        waiter->timedOut = true;
+        thread_wakeup(waiter->thread);
+    }
+}
\ No newline at end of file
@@ -24,6 +24,9 @@ static WaitOperations _semaphore_waitOperations = {
 
 void conditionVar_initStruct(ConditionVar* cond) {
     wait_initStruct(&cond->wait, &_semaphore_waitOperations);
+#if defined(CONFIG_LOCK_PROFILE)
+    cond->lockClass = lockProfile_getClass(__builtin_return_address(0), LOCK_CLASS_TYPE_CONDITION_VAR);
+#endif
 }
 
 void conditionVar_wait(ConditionVar* cond, Mutex* lock, ConditionVariableFunc func, void* arg) {
@@ -37,11 +40,17 @@ void conditionVar_waitOnce(ConditionVar* cond, Mutex* lock) {
     
     DEBUG_ASSERT_SILENT(mutex_isLocked(lock) && lock->acquiredBy == currentThread);
     
+    Uint64 beginTick = lockProfile_now();
     schedule_enterCritical();
     
     mutex_release(lock);
 
     thread_sleep(currentThread, &cond->wait);
+#if defined(CONFIG_LOCK_PROFILE)
+    if (cond->lockClass != NULL) {
+        lockProfile_recordAcquire(cond->lockClass, beginTick, true);
+    }
+#endif
 
     mutex_acquire(lock);
 }
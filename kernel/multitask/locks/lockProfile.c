@@ -0,0 +1,250 @@
+#include<multitask/locks/lockProfile.h>
+
+#include<kit/config.h>
+
+#if defined(CONFIG_LOCK_PROFILE)
+
+#include<devices/clock/clockSource.h>
+#include<debug.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<multitask/locks/spinlock.h>
+#include<time/time.h>
+#include<print.h>
+
+static LockClass _lockProfile_classes[LOCK_PROFILE_CLASS_MAX];
+static LockClass _lockProfile_overflowClass = {
+    .key    = NULL,
+    .name   = "(overflow)",
+    .type   = LOCK_CLASS_TYPE_NUM
+};
+static Size _lockProfile_classN = 0;
+
+typedef struct __LockProfileHeld {
+    void*   lock;
+    Uint64  acquiredTick;
+} __LockProfileHeld;
+
+static __LockProfileHeld _lockProfile_held[LOCK_PROFILE_HELD_MAX];  //TODO: Per CPU when SMP is supported
+static Size _lockProfile_heldN = 0;
+
+static ConstCstring _lockProfile_typeNames[LOCK_CLASS_TYPE_NUM + 1] = {
+    [LOCK_CLASS_TYPE_SPINLOCK]      = "spinlock",
+    [LOCK_CLASS_TYPE_MUTEX]         = "mutex",
+    [LOCK_CLASS_TYPE_SEMAPHORE]     = "semaphore",
+    [LOCK_CLASS_TYPE_CONDITION_VAR] = "condvar",
+    [LOCK_CLASS_TYPE_NUM]           = "-"
+};
+
+static inline Index64 __lockProfile_hash(void* key);
+
+static Uint64 __lockProfile_tickToNanosecond(Uint64 tick);
+
+static bool __lockProfile_isHotter(LockClass* class1, LockClass* class2);
+
+LockClass* lockProfile_getClass(void* key, LockClassType type) {
+    bool interruptEnabled = idt_disableInterrupt(); //Profiler cannot use profiled locks, interrupt disabled is enough for single CPU
+
+    LockClass* ret = &_lockProfile_overflowClass;
+    Index64 index = __lockProfile_hash(key);
+    for (int i = 0; i < LOCK_PROFILE_CLASS_MAX; ++i, index = (index + 1) % LOCK_PROFILE_CLASS_MAX) {   //Linear probing, classes are never removed
+        LockClass* lockClass = &_lockProfile_classes[index];
+        if (lockClass->key == key && lockClass->type == type) {
+            ret = lockClass;
+            break;
+        }
+
+        if (lockClass->key == NULL) {
+            *lockClass = (LockClass) {
+                .key    = key,
+                .name   = NULL,
+                .type   = type
+            };
+            ++_lockProfile_classN;
+            ret = lockClass;
+            break;
+        }
+    }
+
+    idt_setInterrupt(interruptEnabled);
+
+    return ret;
+}
+
+LockClassIndex lockProfile_getClassIndex(LockClass* lockClass) {
+    return lockClass == &_lockProfile_overflowClass ? LOCK_PROFILE_CLASS_MAX + 1 : (lockClass - _lockProfile_classes) + 1;
+}
+
+LockClass* lockProfile_getClassFromIndex(LockClassIndex index) {
+    DEBUG_ASSERT_SILENT(index != LOCK_CLASS_INDEX_NONE && index <= LOCK_PROFILE_CLASS_MAX + 1);
+    return index == LOCK_PROFILE_CLASS_MAX + 1 ? &_lockProfile_overflowClass : &_lockProfile_classes[index - 1];
+}
+
+void lockProfile_nameClass(LockClass* lockClass, ConstCstring name) {
+    if (lockClass == &_lockProfile_overflowClass) {
+        return;
+    }
+
+    lockClass->name = name;
+}
+
+Uint64 lockProfile_recordAcquire(LockClass* lockClass, Uint64 beginTick, bool contended) {
+    Uint64 ret = lockProfile_now();
+    Uint64 waitTick = ret - beginTick;
+
+    bool interruptEnabled = idt_disableInterrupt();
+
+    ++lockClass->acquireNum;
+    if (contended) {
+        ++lockClass->contendedNum;
+        lockClass->waitTick += waitTick;
+        if (waitTick > lockClass->maxWaitTick) {
+            lockClass->maxWaitTick = waitTick;
+        }
+    }
+
+    idt_setInterrupt(interruptEnabled);
+
+    return ret;
+}
+
+void lockProfile_recordRelease(LockClass* lockClass, Uint64 holdTick) {
+    bool interruptEnabled = idt_disableInterrupt();
+
+    lockClass->holdTick += holdTick;
+    if (holdTick > lockClass->maxHoldTick) {
+        lockClass->maxHoldTick = holdTick;
+    }
+
+    idt_setInterrupt(interruptEnabled);
+}
+
+void lockProfile_pushHeld(void* lock, Uint64 acquiredTick) {
+    bool interruptEnabled = idt_disableInterrupt();
+
+    if (_lockProfile_heldN < LOCK_PROFILE_HELD_MAX) {
+        _lockProfile_held[_lockProfile_heldN++] = (__LockProfileHeld) {
+            .lock           = lock,
+            .acquiredTick   = acquiredTick
+        };
+    }
+
+    idt_setInterrupt(interruptEnabled);
+}
+
+bool lockProfile_popHeld(void* lock, Uint64* acquiredTickRet) {
+    bool interruptEnabled = idt_disableInterrupt();
+
+    bool ret = false;
+    for (int i = (int)_lockProfile_heldN - 1; i >= 0; --i) {    //Usually the last one
+        if (_lockProfile_held[i].lock != lock) {
+            continue;
+        }
+
+        *acquiredTickRet = _lockProfile_held[i].acquiredTick;
+        for (int j = i + 1; j < _lockProfile_heldN; ++j) {
+            _lockProfile_held[j - 1] = _lockProfile_held[j];
+        }
+        --_lockProfile_heldN;
+        ret = true;
+        break;
+    }
+
+    idt_setInterrupt(interruptEnabled);
+
+    return ret;
+}
+
+void lockProfile_reset() {
+    bool interruptEnabled = idt_disableInterrupt();
+
+    for (int i = 0; i <= LOCK_PROFILE_CLASS_MAX; ++i) {
+        LockClass* lockClass = i == LOCK_PROFILE_CLASS_MAX ? &_lockProfile_overflowClass : &_lockProfile_classes[i];
+        lockClass->acquireNum = lockClass->contendedNum = 0;
+        lockClass->waitTick = lockClass->maxWaitTick = 0;
+        lockClass->holdTick = lockClass->maxHoldTick = 0;
+    }
+
+    idt_setInterrupt(interruptEnabled);
+}
+
+Size lockProfile_report(Cstring buffer, Size n) {
+    static LockClass snapshot[LOCK_PROFILE_CLASS_MAX + 1];  //Copied with interrupt disabled, so report is consistent and printing does not block profiling
+    static LockClass* sorted[LOCK_PROFILE_CLASS_MAX + 1];
+
+    if (n == 0) {
+        return 0;
+    }
+
+    bool interruptEnabled = idt_disableInterrupt();
+
+    Size classN = 0;
+    for (int i = 0; i <= LOCK_PROFILE_CLASS_MAX; ++i) {
+        LockClass* lockClass = i == LOCK_PROFILE_CLASS_MAX ? &_lockProfile_overflowClass : &_lockProfile_classes[i];
+        if (lockClass->acquireNum == 0) {
+            continue;
+        }
+
+        memory_memcpy(&snapshot[classN], lockClass, sizeof(LockClass));
+        ++classN;
+    }
+
+    idt_setInterrupt(interruptEnabled);
+
+    for (int i = 0; i < classN; ++i) {  //Insertion sort, at most a few hundred classes
+        LockClass* lockClass = &snapshot[i];
+        int j = i;
+        for (; j > 0 && __lockProfile_isHotter(lockClass, sorted[j - 1]); --j) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = lockClass;
+    }
+
+    Size ret = 0;
+    ret += print_snprintf(buffer + ret, n - ret, "%-24s %-9s %12s %12s %14s %12s %14s %12s\n",
+        "class", "type", "acquired", "contended", "wait-total-ns", "wait-max-ns", "hold-total-ns", "hold-max-ns"
+    );
+
+    char keyBuffer[32];
+    for (int i = 0; i < classN && ret + 1 < n; ++i) {
+        LockClass* lockClass = sorted[i];
+        ConstCstring name = lockClass->name;
+        if (name == NULL) {
+            print_snprintf(keyBuffer, sizeof(keyBuffer), "%p", lockClass->key);
+            name = keyBuffer;
+        }
+
+        ret += print_snprintf(buffer + ret, n - ret, "%-24s %-9s %12llu %12llu %14llu %12llu %14llu %12llu\n",
+            name, _lockProfile_typeNames[lockClass->type], lockClass->acquireNum, lockClass->contendedNum,
+            __lockProfile_tickToNanosecond(lockClass->waitTick), __lockProfile_tickToNanosecond(lockClass->maxWaitTick),
+            __lockProfile_tickToNanosecond(lockClass->holdTick), __lockProfile_tickToNanosecond(lockClass->maxHoldTick)
+        );
+    }
+
+    return ret < n ? ret : n - 1;
+}
+
+static inline Index64 __lockProfile_hash(void* key) {
+    return (((Uint64)key >> 2) * 0x9E3779B97F4A7C15ull >> 32) % LOCK_PROFILE_CLASS_MAX;
+}
+
+static Uint64 __lockProfile_tickToNanosecond(Uint64 tick) {
+    ClockSource* clockSource = clockSource_getSource(CLOCK_SOURCE_TYPE_CPU);
+    Uint64 hz = clockSource == NULL ? 0 : clockSource->hz;
+    if (hz == 0) {  //TSC not calibrated yet, report raw ticks
+        return tick;
+    }
+
+    return tick / hz * TIME_UNIT_SECOND + tick % hz * TIME_UNIT_SECOND / hz;
+}
+
+static bool __lockProfile_isHotter(LockClass* class1, LockClass* class2) {
+    if (class1->contendedNum != class2->contendedNum) {
+        return class1->contendedNum > class2->contendedNum;
+    }
+
+    return class1->waitTick > class2->waitTick;
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,13 @@
 #include<kit/util.h>
 #include<multitask/schedule.h>
 #include<multitask/wait.h>
+#include<time/time.h>
+
+static inline void __mutex_profileAcquired(Mutex* mutex, Uint64 beginTick, bool contended);
+
+static inline bool __mutex_isOwnerOnCPU(Thread* owner);
+
+static bool __mutex_spinOnOwner(Mutex* mutex, Thread* thread);
 
 static bool __mutex_waitOperations_tryTake(Wait* wait, Thread* thread);
 
@@ -27,6 +34,12 @@ void mutex_initStruct(Mutex* mutex, Flags8 flags) {
     mutex->depth = 0;
     mutex->acquiredBy = NULL;
     mutex->flags = flags;
+    mutex->contendedNum = 0;
+    mutex->waitTime = 0;
+#if defined(CONFIG_LOCK_PROFILE)
+    mutex->lockClass = lockProfile_getClass(__builtin_return_address(0), LOCK_CLASS_TYPE_MUTEX);
+    mutex->acquiredTick = 0;
+#endif
 
     wait_initStruct(&mutex->wait, &_mutex_waitOperations);
 }
@@ -38,7 +51,9 @@ bool mutex_isLocked(Mutex* mutex) {
 bool mutex_acquire(Mutex* mutex) {
     Wait* wait = &mutex->wait;
     Thread* currentThread = schedule_getCurrentThread();
+    Uint64 beginTick = lockProfile_now();
     if (wait_rawTryTake(wait, currentThread)) {
+        __mutex_profileAcquired(mutex, beginTick, false);
         return true;
     }
 
@@ -46,9 +61,22 @@ bool mutex_acquire(Mutex* mutex) {
         return false;
     }
 
+    if (__mutex_spinOnOwner(mutex, currentThread)) {
+        __mutex_profileAcquired(mutex, beginTick, true);
+        return true;
+    }
+
+    Timestamp begin, end;
+    time_getMonotonicTimestamp(&begin);
+
     schedule_enterCritical();
     thread_sleep(currentThread, wait);
 
+    time_getMonotonicTimestamp(&end);
+    ATOMIC_INC_FETCH(&mutex->contendedNum);
+    ATOMIC_ADD_FETCH(&mutex->waitTime, (end.second - begin.second) * TIME_UNIT_SECOND + (end.nanosecond - begin.nanosecond));
+    __mutex_profileAcquired(mutex, beginTick, true);
+
     return true;
 }
 
@@ -61,6 +89,11 @@ bool mutex_release(Mutex* mutex) {
 
     bool ret = false;
     if (ATOMIC_DEC_FETCH(&mutex->depth) == 0) {
+#if defined(CONFIG_LOCK_PROFILE)
+        if (mutex->lockClass != NULL) {
+            lockProfile_recordRelease(mutex->lockClass, lockProfile_now() - mutex->acquiredTick);
+        }
+#endif
         mutex_forceRelease(mutex);
         ret = true;
     }
@@ -73,14 +106,49 @@ bool mutex_release(Mutex* mutex) {
 }
 
 void mutex_forceRelease(Mutex* mutex) {
-    ATOMIC_STORE(&mutex->acquiredBy, OBJECT_NULL);  //Ready for another thread
-
     Wait* wait = &mutex->wait;
-    if (!linkedList_isEmpty(&wait->waitList)) {
-        Thread* thread = HOST_POINTER(linkedListNode_getNext(&wait->waitList), Thread, waitNode);
-        linkedListNode_delete(&thread->waitNode);
-        thread_wakeup(thread);
+    if (linkedList_isEmpty(&wait->waitList)) {
+        ATOMIC_STORE(&mutex->acquiredBy, NULL);  //Ready for another thread
+        return;
+    }
+
+    Thread* thread = HOST_POINTER(linkedListNode_getNext(&wait->waitList), Thread, waitNode);   //Waiters are appended to tail, head is the oldest
+    linkedListNode_delete(&thread->waitNode);
+    //Hand-off: waiter owns mutex before it runs, and picks it up in shouldWait, otherwise it races with new comers
+    ATOMIC_STORE(&mutex->acquiredBy, TEST_FLAGS(mutex->flags, MUTEX_FLAG_HANDOFF) ? thread : NULL);
+    thread_wakeup(thread);
+}
+
+static inline void __mutex_profileAcquired(Mutex* mutex, Uint64 beginTick, bool contended) {
+#if defined(CONFIG_LOCK_PROFILE)
+    if (mutex->lockClass != NULL && ATOMIC_LOAD(&mutex->depth) == 1) {  //Recursive acquisitions are not counted
+        mutex->acquiredTick = lockProfile_recordAcquire(mutex->lockClass, beginTick, contended);
     }
+#endif
+}
+
+static inline bool __mutex_isOwnerOnCPU(Thread* owner) {
+    return owner == schedule_getCurrentThread();    //TODO: Check other CPUs when SMP is supported
+}
+
+static bool __mutex_spinOnOwner(Mutex* mutex, Thread* thread) {
+    for (int i = 0; i < MUTEX_SPIN_LIMIT; ++i) {
+        Thread* owner = ATOMIC_LOAD(&mutex->acquiredBy);
+        if (owner == NULL) {
+            if (wait_rawTryTake(&mutex->wait, thread)) {
+                return true;
+            }
+            continue;
+        }
+
+        if (owner == thread || !__mutex_isOwnerOnCPU(owner)) {  //Owner sleeping or preempted, spinning will not help
+            break;
+        }
+
+        asm volatile("pause;" ::: "memory");
+    }
+
+    return false;
 }
 
 static bool __mutex_waitOperations_tryTake(Wait* wait, Thread* thread) {
@@ -107,8 +175,11 @@ static bool __mutex_waitOperations_shouldWait(Wait* wait, Thread* thread) {
     Mutex* mutex = HOST_POINTER(wait, Mutex, wait);
     
     Thread* expected = NULL;
-    if (ATOMIC_COMPARE_EXCHANGE_N(&mutex->acquiredBy, &expected, thread) || expected == thread) { //No need to wait
+    if (ATOMIC_COMPARE_EXCHANGE_N(&mutex->acquiredBy, &expected, thread) || expected == thread) { //No need to wait, or mutex handed off to this thread
         ATOMIC_INC_FETCH(&mutex->depth);
+        if (TEST_FLAGS(mutex->flags, MUTEX_FLAG_CRITICAL)) {    //Critical entered in acquire is left before sleeping
+            schedule_enterCritical();
+        }
         return false;
     }
 
@@ -121,7 +192,7 @@ static void __mutex_waitOperations_wait(Wait* wait, Thread* thread) {
     Mutex* mutex = HOST_POINTER(wait, Mutex, wait);
     DEBUG_ASSERT_SILENT(TEST_FLAGS_FAIL(mutex->flags, MUTEX_FLAG_TRY));
     
-    linkedListNode_insertFront(&wait->waitList, &thread->waitNode);
+    linkedListNode_insertFront(&wait->waitList, &thread->waitNode);    //Append to tail
 
     if (schedule_isInCritical()) {
         schedule_leaveCritical();
@@ -0,0 +1,212 @@
+#include<multitask/locks/rwSemaphore.h>
+
+#include<kit/types.h>
+#include<kit/util.h>
+#include<multitask/locks/spinlock.h>
+#include<multitask/schedule.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+#include<structs/linkedList.h>
+#include<debug.h>
+
+static bool __rwSemaphore_readWaitOperations_tryTake(Wait* wait, Thread* thread);
+
+static bool __rwSemaphore_writeWaitOperations_tryTake(Wait* wait, Thread* thread);
+
+static bool __rwSemaphore_waitOperations_shouldWait(Wait* wait, Thread* thread);
+
+static void __rwSemaphore_readWaitOperations_wait(Wait* wait, Thread* thread);
+
+static void __rwSemaphore_writeWaitOperations_wait(Wait* wait, Thread* thread);
+
+static void __rwSemaphore_readWaitOperations_quitWaitting(Wait* wait, Thread* thread);
+
+static void __rwSemaphore_writeWaitOperations_quitWaitting(Wait* wait, Thread* thread);
+
+static WaitOperations _rwSemaphore_readWaitOperations = {
+    .tryTake        = __rwSemaphore_readWaitOperations_tryTake,
+    .shouldWait     = __rwSemaphore_waitOperations_shouldWait,
+    .wait           = __rwSemaphore_readWaitOperations_wait,
+    .quitWaitting   = __rwSemaphore_readWaitOperations_quitWaitting
+};
+
+static WaitOperations _rwSemaphore_writeWaitOperations = {
+    .tryTake        = __rwSemaphore_writeWaitOperations_tryTake,
+    .shouldWait     = __rwSemaphore_waitOperations_shouldWait,
+    .wait           = __rwSemaphore_writeWaitOperations_wait,
+    .quitWaitting   = __rwSemaphore_writeWaitOperations_quitWaitting
+};
+
+static bool __rwSemaphore_doTryDownRead(RWsemaphore* sem);
+
+static bool __rwSemaphore_doTryDownWrite(RWsemaphore* sem, Thread* thread);
+
+static void __rwSemaphore_down(Wait* wait);
+
+static void __rwSemaphore_wait(RWsemaphore* sem, Wait* wait, Thread* thread);
+
+static void __rwSemaphore_quitWaitting(RWsemaphore* sem, Wait* wait, Thread* thread);
+
+static void __rwSemaphore_grant(RWsemaphore* sem, bool readersFirst);
+
+void rwSemaphore_initStruct(RWsemaphore* sem) {
+    sem->queueLock = SPINLOCK_UNLOCKED;
+    sem->readerNum = 0;
+    sem->writer = NULL;
+    wait_initStruct(&sem->readWait, &_rwSemaphore_readWaitOperations);
+    wait_initStruct(&sem->writeWait, &_rwSemaphore_writeWaitOperations);
+}
+
+void rwSemaphore_downRead(RWsemaphore* sem) {
+    __rwSemaphore_down(&sem->readWait);
+}
+
+bool rwSemaphore_tryDownRead(RWsemaphore* sem) {
+    return __rwSemaphore_doTryDownRead(sem);
+}
+
+void rwSemaphore_upRead(RWsemaphore* sem) {
+    spinlock_lock(&sem->queueLock);
+    DEBUG_ASSERT_SILENT(sem->readerNum > 0 && sem->writer == NULL);
+    if (--sem->readerNum == 0) {
+        __rwSemaphore_grant(sem, false);
+    }
+    spinlock_unlock(&sem->queueLock);
+}
+
+void rwSemaphore_downWrite(RWsemaphore* sem) {
+    __rwSemaphore_down(&sem->writeWait);
+}
+
+bool rwSemaphore_tryDownWrite(RWsemaphore* sem) {
+    return __rwSemaphore_doTryDownWrite(sem, schedule_getCurrentThread());
+}
+
+void rwSemaphore_upWrite(RWsemaphore* sem) {
+    spinlock_lock(&sem->queueLock);
+    DEBUG_ASSERT_SILENT(sem->writer == schedule_getCurrentThread());
+    sem->writer = NULL;
+    __rwSemaphore_grant(sem, true);
+    spinlock_unlock(&sem->queueLock);
+}
+
+void rwSemaphore_downgrade(RWsemaphore* sem) {
+    spinlock_lock(&sem->queueLock);
+    DEBUG_ASSERT_SILENT(sem->writer == schedule_getCurrentThread());
+    sem->writer = NULL;
+    sem->readerNum = 1;
+    __rwSemaphore_grant(sem, true);
+    spinlock_unlock(&sem->queueLock);
+}
+
+static bool __rwSemaphore_readWaitOperations_tryTake(Wait* wait, Thread* thread) {
+    return __rwSemaphore_doTryDownRead(HOST_POINTER(wait, RWsemaphore, readWait));
+}
+
+static bool __rwSemaphore_writeWaitOperations_tryTake(Wait* wait, Thread* thread) {
+    return __rwSemaphore_doTryDownWrite(HOST_POINTER(wait, RWsemaphore, writeWait), thread);
+}
+
+static bool __rwSemaphore_waitOperations_shouldWait(Wait* wait, Thread* thread) {
+    return false;   //Semaphore is granted before waking up
+}
+
+static void __rwSemaphore_readWaitOperations_wait(Wait* wait, Thread* thread) {
+    __rwSemaphore_wait(HOST_POINTER(wait, RWsemaphore, readWait), wait, thread);
+}
+
+static void __rwSemaphore_writeWaitOperations_wait(Wait* wait, Thread* thread) {
+    __rwSemaphore_wait(HOST_POINTER(wait, RWsemaphore, writeWait), wait, thread);
+}
+
+static void __rwSemaphore_readWaitOperations_quitWaitting(Wait* wait, Thread* thread) {
+    __rwSemaphore_quitWaitting(HOST_POINTER(wait, RWsemaphore, readWait), wait, thread);
+}
+
+static void __rwSemaphore_writeWaitOperations_quitWaitting(Wait* wait, Thread* thread) {
+    __rwSemaphore_quitWaitting(HOST_POINTER(wait, RWsemaphore, writeWait), wait, thread);
+}
+
+static bool __rwSemaphore_doTryDownRead(RWsemaphore* sem) {
+    spinlock_lock(&sem->queueLock);
+    bool ret = sem->writer == NULL && linkedList_isEmpty(&sem->writeWait.waitList);  //Waiting writer blocks new readers
+    if (ret) {
+        ++sem->readerNum;
+    }
+    spinlock_unlock(&sem->queueLock);
+
+    return ret;
+}
+
+static bool __rwSemaphore_doTryDownWrite(RWsemaphore* sem, Thread* thread) {
+    spinlock_lock(&sem->queueLock);
+    bool ret = sem->writer == NULL && sem->readerNum == 0;
+    if (ret) {
+        sem->writer = thread;
+    }
+    spinlock_unlock(&sem->queueLock);
+
+    return ret;
+}
+
+static void __rwSemaphore_down(Wait* wait) {
+    Thread* currentThread = schedule_getCurrentThread();
+
+    schedule_enterCritical();   //Release must not slip in between failed try and joining wait list
+    if (wait_rawTryTake(wait, currentThread)) {
+        schedule_leaveCritical();
+        return;
+    }
+
+    thread_sleep(currentThread, wait);
+}
+
+static void __rwSemaphore_wait(RWsemaphore* sem, Wait* wait, Thread* thread) {
+    DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+
+    spinlock_lock(&sem->queueLock);
+    linkedListNode_insertFront(&wait->waitList, &thread->waitNode);    //Append to tail
+    spinlock_unlock(&sem->queueLock);
+
+    if (schedule_isInCritical()) {
+        schedule_leaveCritical();
+        DEBUG_ASSERT_SILENT(!schedule_isInCritical());
+    }
+
+    schedule_yield();
+}
+
+static void __rwSemaphore_quitWaitting(RWsemaphore* sem, Wait* wait, Thread* thread) {
+    spinlock_lock(&sem->queueLock);
+    if (thread->waittingFor != NULL) {
+        DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+        linkedListNode_delete(&thread->waitNode);
+        __rwSemaphore_grant(sem, false);    //Readers may be blocked only by this writer
+    }
+    spinlock_unlock(&sem->queueLock);
+}
+
+static void __rwSemaphore_grant(RWsemaphore* sem, bool readersFirst) {
+    if (sem->writer != NULL) {
+        return;
+    }
+
+    LinkedList* readList = &sem->readWait.waitList, * writeList = &sem->writeWait.waitList;
+    bool hasWriter = !linkedList_isEmpty(writeList);
+    if (!linkedList_isEmpty(readList) && (readersFirst || !hasWriter)) {    //Let all waiting readers in together
+        while (!linkedList_isEmpty(readList)) {
+            Thread* thread = HOST_POINTER(linkedListNode_getNext(readList), Thread, waitNode);
+            linkedListNode_delete(&thread->waitNode);
+            ++sem->readerNum;
+            thread_wakeup(thread);
+        }
+        return;
+    }
+
+    if (hasWriter && sem->readerNum == 0) {
+        Thread* thread = HOST_POINTER(linkedListNode_getNext(writeList), Thread, waitNode);
+        linkedListNode_delete(&thread->waitNode);
+        sem->writer = thread;
+        thread_wakeup(thread);
+    }
+}
\ No newline at end of file
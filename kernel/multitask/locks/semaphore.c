@@ -7,6 +7,8 @@
 #include<multitask/wait.h>
 #include<structs/linkedList.h>
 
+static inline void __semaphore_profileAcquired(Semaphore* sema, Uint64 beginTick, bool contended);
+
 static bool __semaphore_waitOperations_tryTake(Wait* wait, Thread* thread);
 
 static bool __semaphore_waitOperations_shouldWait(Wait* wait, Thread* thread);
@@ -28,22 +30,35 @@ void semaphore_initStruct(Semaphore* sema, int count) {
     sema->queueLock = SPINLOCK_UNLOCKED;
     wait_initStruct(&sema->wait, &_semaphore_waitOperations);
     sema->holdBy = NULL;
+#if defined(CONFIG_LOCK_PROFILE)
+    sema->lockClass = lockProfile_getClass(__builtin_return_address(0), LOCK_CLASS_TYPE_SEMAPHORE);
+    sema->acquiredTick = 0;
+#endif
 }
 
 void semaphore_down(Semaphore* sema) {
     Wait* wait = &sema->wait;
     Thread* currentThread = schedule_getCurrentThread();
+    Uint64 beginTick = lockProfile_now();
 
     if (wait_rawTryTake(wait, currentThread)) {
         sema->holdBy = currentThread;
+        __semaphore_profileAcquired(sema, beginTick, false);
         return;
     }
 
     schedule_enterCritical();
     thread_sleep(currentThread, wait);
+    __semaphore_profileAcquired(sema, beginTick, true);
 }
 
 void semaphore_up(Semaphore* sema) {
+#if defined(CONFIG_LOCK_PROFILE)
+    if (sema->lockClass != NULL && sema->holdBy == schedule_getCurrentThread()) {
+        lockProfile_recordRelease(sema->lockClass, lockProfile_now() - sema->acquiredTick);
+    }
+#endif
+
     if (ATOMIC_INC_FETCH(&sema->counter) <= 0) {
         spinlock_lock(&sema->queueLock);
         
@@ -61,6 +76,14 @@ void semaphore_up(Semaphore* sema) {
     }
 }
 
+static inline void __semaphore_profileAcquired(Semaphore* sema, Uint64 beginTick, bool contended) {
+#if defined(CONFIG_LOCK_PROFILE)
+    if (sema->lockClass != NULL) {
+        sema->acquiredTick = lockProfile_recordAcquire(sema->lockClass, beginTick, contended);
+    }
+#endif
+}
+
 static bool __semaphore_waitOperations_tryTake(Wait* wait, Thread* thread) {
     Semaphore* sema = HOST_POINTER(wait, Semaphore, wait);
     return ATOMIC_DEC_FETCH(&sema->counter) >= 0;
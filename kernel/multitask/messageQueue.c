@@ -0,0 +1,385 @@
+#include<multitask/messageQueue.h>
+
+typedef struct __MessageQueueSlot __MessageQueueSlot;
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/pollWaiter.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/locks/mutex.h>
+#include<real/simpleAsmLines.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<cstring.h>
+#include<debug.h>
+#include<error.h>
+
+typedef struct __MessageQueueSlot {
+    LinkedListNode  node;   //Node in message list or free list
+    Size            length;
+    Uint8           data[0];
+} __MessageQueueSlot;
+
+#define __MESSAGE_QUEUE_SLOT_SIZE(__MESSAGE_SIZE)   ALIGN_UP(sizeof(__MessageQueueSlot) + (__MESSAGE_SIZE), 16)
+
+static Mutex _messageQueue_lock;    //Lock for name list
+static LinkedList _messageQueue_list;
+
+static MessageQueue* __messageQueue_find(ConstCstring name);
+
+static MessageQueue* __messageQueue_create(ConstCstring name, Size nameLength, Size maxMessageN, Size messageSize);
+
+static void __messageQueue_derefer(MessageQueue* queue);
+
+static void __messageQueue_release(Object object);
+
+static bool __messageQueue_trySend(MessageQueue* queue, const void* message, Size length, Uint32 priority);
+
+static bool __messageQueue_tryReceive(MessageQueue* queue, void* buffer, Size* lengthRet, Uint32* priorityRet);
+
+static Index64 __messageQueue_fsEntry_seek(fsEntry* entry, Index64 seekTo);
+
+static Size __messageQueue_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __messageQueue_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __messageQueue_fsEntry_poll(fsEntry* entry, PollTable* table);
+
+static fsEntryOperations _messageQueue_fsEntry_operations = {
+    .seek   = __messageQueue_fsEntry_seek,
+    .read   = __messageQueue_fsEntry_read,
+    .write  = __messageQueue_fsEntry_write,
+    .poll   = __messageQueue_fsEntry_poll
+};
+
+void messageQueue_init() {
+    mutex_initStruct(&_messageQueue_lock, EMPTY_FLAGS);
+    linkedList_initStruct(&_messageQueue_list);
+}
+
+fsEntry* messageQueue_open(ConstCstring name, FCNTLopenFlags flags, MessageQueueAttribute* attribute) {
+    Size nameLength = cstring_strlen(name);
+    if (nameLength == 0 || nameLength > MESSAGE_QUEUE_NAME_MAX) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Size maxMessageN = MESSAGE_QUEUE_DEFAULT_MAX_MESSAGE_N, messageSize = MESSAGE_QUEUE_DEFAULT_MESSAGE_SIZE;
+    if (TEST_FLAGS(flags, FCNTL_OPEN_CREAT) && attribute != NULL) {
+        if (attribute->maxMessageN <= 0 || attribute->messageSize <= 0 || (Uint64)attribute->maxMessageN * __MESSAGE_QUEUE_SLOT_SIZE(attribute->messageSize) > MESSAGE_QUEUE_MAX_BUFFER_SIZE) {
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+        }
+        maxMessageN = attribute->maxMessageN;
+        messageSize = attribute->messageSize;
+    }
+
+    mutex_acquire(&_messageQueue_lock);
+    MessageQueue* queue = __messageQueue_find(name);
+    if (queue == NULL) {
+        if (TEST_FLAGS_FAIL(flags, FCNTL_OPEN_CREAT)) {
+            ERROR_THROW(ERROR_ID_NOT_FOUND, 1);
+        }
+
+        queue = __messageQueue_create(name, nameLength, maxMessageN, messageSize);
+        if (queue == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+        linkedListNode_insertFront(&_messageQueue_list, &queue->node);
+    } else if (TEST_FLAGS(flags, FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL)) {
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 1);
+    }
+
+    fsEntry* ret = anonymousFile_create(queue->name, &_messageQueue_fsEntry_operations, __messageQueue_release, (Object)queue, CLEAR_FLAG(flags, FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL));
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+    REF_COUNTER_REFER(queue->refCounter);   //Released with entry
+    mutex_release(&_messageQueue_lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&_messageQueue_lock);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+void messageQueue_unlink(ConstCstring name) {
+    mutex_acquire(&_messageQueue_lock);
+    MessageQueue* queue = __messageQueue_find(name);
+    if (queue == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+    linkedListNode_delete(&queue->node);
+    mutex_release(&_messageQueue_lock);
+
+    __messageQueue_derefer(queue);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&_messageQueue_lock);
+}
+
+MessageQueue* messageQueue_getFromFSentry(fsEntry* entry) {
+    return (MessageQueue*)anonymousFile_getObject(entry, &_messageQueue_fsEntry_operations);
+}
+
+void messageQueue_send(MessageQueue* queue, const void* message, Size length, Uint32 priority, Int64 timeout) {
+    if (length > queue->messageSize || priority >= MESSAGE_QUEUE_PRIORITY_NUM) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    PollWaiter waiter;
+    bool waiting = false;
+    while (!__messageQueue_trySend(queue, message, length, priority)) {
+        if (timeout == 0) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, receivers may come in between
+            pollWaiter_initStruct(&waiter, timeout);
+            waiting = true;
+            poll_wait(&waiter.table, &queue->pollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        if (!pollWaiter_sleep(&waiter)) {
+            ERROR_THROW(ERROR_ID_TIMEOUT, 1);
+        }
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+}
+
+Size messageQueue_receive(MessageQueue* queue, void* buffer, Size n, Uint32* priorityRet, Int64 timeout) {
+    if (n < queue->messageSize) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    PollWaiter waiter;
+    bool waiting = false;
+    Size ret = 0;
+    while (!__messageQueue_tryReceive(queue, buffer, &ret, priorityRet)) {
+        if (timeout == 0) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 1);
+        }
+
+        if (!waiting) { //Try again after registered, senders may come in between
+            pollWaiter_initStruct(&waiter, timeout);
+            waiting = true;
+            poll_wait(&waiter.table, &queue->pollQueue);
+            ERROR_GOTO_IF_ERROR(1);
+            continue;
+        }
+
+        if (!pollWaiter_sleep(&waiter)) {
+            ERROR_THROW(ERROR_ID_TIMEOUT, 1);
+        }
+    }
+
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    if (waiting) {
+        pollWaiter_clearStruct(&waiter);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+void messageQueue_getAttribute(fsEntry* entry, MessageQueueAttribute* attributeRet) {
+    MessageQueue* queue = messageQueue_getFromFSentry(entry);
+    memory_memset(attributeRet, 0, sizeof(MessageQueueAttribute));
+
+    mutex_acquire(&queue->lock);
+    attributeRet->flags = entry->flags & FCNTL_OPEN_NONBLOCK;
+    attributeRet->maxMessageN = queue->maxMessageN;
+    attributeRet->messageSize = queue->messageSize;
+    attributeRet->messageN = queue->messageN;
+    mutex_release(&queue->lock);
+}
+
+static MessageQueue* __messageQueue_find(ConstCstring name) {
+    for (LinkedListNode* node = linkedListNode_getNext(&_messageQueue_list); node != &_messageQueue_list; node = linkedListNode_getNext(node)) {
+        MessageQueue* queue = HOST_POINTER(node, MessageQueue, node);
+        if (cstring_strcmp(queue->name, name) == 0) {
+            return queue;
+        }
+    }
+
+    return NULL;
+}
+
+static MessageQueue* __messageQueue_create(ConstCstring name, Size nameLength, Size maxMessageN, Size messageSize) {
+    MessageQueue* ret = mm_allocate(sizeof(MessageQueue) + nameLength + 1);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Size slotSize = __MESSAGE_QUEUE_SLOT_SIZE(messageSize);
+    ret->slots = mm_allocate(maxMessageN * slotSize);
+    if (ret->slots == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+
+    linkedListNode_initStruct(&ret->node);
+    REF_COUNTER_INIT(ret->refCounter, 1);
+    mutex_initStruct(&ret->lock, EMPTY_FLAGS);
+    ret->maxMessageN = maxMessageN;
+    ret->messageSize = messageSize;
+    ret->messageN = 0;
+    ret->priorityMask = EMPTY_FLAGS;
+    for (int i = 0; i < MESSAGE_QUEUE_PRIORITY_NUM; ++i) {
+        linkedList_initStruct(&ret->messages[i]);
+    }
+
+    linkedList_initStruct(&ret->freeSlots);
+    for (int i = 0; i < maxMessageN; ++i) {
+        __MessageQueueSlot* slot = ret->slots + i * slotSize;
+        linkedListNode_insertFront(&ret->freeSlots, &slot->node);
+    }
+
+    pollWaitQueue_initStruct(&ret->pollQueue);
+    memory_memcpy(ret->name, name, nameLength + 1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_free(ret);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void __messageQueue_derefer(MessageQueue* queue) {
+    if (REF_COUNTER_DEREFER(queue->refCounter) != 0) {
+        return;
+    }
+
+    DEBUG_ASSERT_SILENT(linkedList_isEmpty(&queue->pollQueue.entries));
+    mm_free(queue->slots);
+    mm_free(queue);
+}
+
+static void __messageQueue_release(Object object) {
+    __messageQueue_derefer((MessageQueue*)object);
+}
+
+static bool __messageQueue_trySend(MessageQueue* queue, const void* message, Size length, Uint32 priority) {
+    mutex_acquire(&queue->lock);
+
+    if (queue->messageN == queue->maxMessageN) {
+        mutex_release(&queue->lock);
+        return false;
+    }
+
+    DEBUG_ASSERT_SILENT(!linkedList_isEmpty(&queue->freeSlots));
+    __MessageQueueSlot* slot = HOST_POINTER(linkedListNode_getNext(&queue->freeSlots), __MessageQueueSlot, node);
+    linkedListNode_delete(&slot->node);
+
+    slot->length = length;
+    memory_memcpy(slot->data, message, length);
+    linkedListNode_insertFront(&queue->messages[priority], &slot->node);    //Append to tail
+    SET_FLAG_BACK(queue->priorityMask, FLAG32(priority));
+    bool wasEmpty = queue->messageN++ == 0;
+
+    mutex_release(&queue->lock);
+
+    if (wasEmpty) {
+        pollWaitQueue_wakeup(&queue->pollQueue, POLL_EVENTS_IN);
+    }
+
+    return true;
+}
+
+static bool __messageQueue_tryReceive(MessageQueue* queue, void* buffer, Size* lengthRet, Uint32* priorityRet) {
+    mutex_acquire(&queue->lock);
+
+    if (queue->messageN == 0) {
+        mutex_release(&queue->lock);
+        return false;
+    }
+
+    Uint32 priority = bsrl(queue->priorityMask);
+    LinkedList* list = &queue->messages[priority];
+    __MessageQueueSlot* slot = HOST_POINTER(linkedListNode_getNext(list), __MessageQueueSlot, node);
+    linkedListNode_delete(&slot->node);
+    if (linkedList_isEmpty(list)) {
+        CLEAR_FLAG_BACK(queue->priorityMask, FLAG32(priority));
+    }
+
+    memory_memcpy(buffer, slot->data, slot->length);
+    *lengthRet = slot->length;
+    if (priorityRet != NULL) {
+        *priorityRet = priority;
+    }
+
+    linkedListNode_insertBack(&queue->freeSlots, &slot->node);  //Reuse recently touched slot first
+    bool wasFull = queue->messageN-- == queue->maxMessageN;
+
+    mutex_release(&queue->lock);
+
+    if (wasFull) {
+        pollWaitQueue_wakeup(&queue->pollQueue, POLL_EVENTS_OUT);
+    }
+
+    return true;
+}
+
+static Index64 __messageQueue_fsEntry_seek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __messageQueue_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);   //Go through messageQueue_receive
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static Size __messageQueue_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);   //Go through messageQueue_send
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static PollEvents __messageQueue_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    MessageQueue* queue = messageQueue_getFromFSentry(entry);
+    poll_wait(table, &queue->pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    mutex_acquire(&queue->lock);
+    Size messageN = queue->messageN;
+    mutex_release(&queue->lock);
+
+    PollEvents ret = EMPTY_FLAGS;
+    if (messageN > 0) {
+        SET_FLAG_BACK(ret, POLL_EVENTS_IN);
+    }
+
+    if (messageN < queue->maxMessageN) {
+        SET_FLAG_BACK(ret, POLL_EVENTS_OUT);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
\ No newline at end of file
@@ -4,20 +4,23 @@ typedef struct PipeVnode PipeVnode;
 
 #include<devices/device.h>
 #include<fs/fcntl.h>
+#include<fs/fs.h>
 #include<fs/fsEntry.h>
 #include<fs/fscore.h>
 #include<fs/fsNode.h>
+#include<fs/poll.h>
 #include<fs/fcntl.h>
 #include<fs/vnode.h>
+#include<kit/bit.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/mm.h>
 #include<memory/memory.h>
 #include<multitask/locks/conditionVar.h>
 #include<multitask/locks/mutex.h>
-#include<structs/fifo.h>
 #include<structs/hashTable.h>
 #include<structs/refCounter.h>
+#include<system/pageTable.h>
 #include<algorithms.h>
 #include<error.h>
 
@@ -32,23 +35,37 @@ static void __pipe_initStruct(Pipe* pipe);
 
 static void __pipe_clearStruct(Pipe* pipe);
 
-static bool __pipe_isReadyToRead(void* args);
+static void __pipe_ringRead(Pipe* pipe, void* buffer, Size byteN);
 
-static void __pipeVnode_readData(vNode* vnode, Index64 begin, void* buffer, Size byteN);
+static void __pipe_ringWrite(Pipe* pipe, const void* buffer, Size byteN);
 
-static void __pipeVnode_writeData(vNode* vnode, Index64 begin, const void* buffer, Size byteN);
+static void __pipe_waitReadable(Pipe* pipe, fsEntry* entry);
+
+static void __pipe_waitWritable(Pipe* pipe, fsEntry* entry, Size requiredByteN);
+
+static void __pipe_notifyRead(Pipe* pipe, Size freeByteNBefore);
+
+static void __pipe_notifyWritten(Pipe* pipe, bool wasEmpty);
 
 static Index64 __pipe_fsEntry_genericSeek(fsEntry* entry, Index64 seekTo);
 
+static Size __pipe_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __pipe_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static PollEvents __pipe_fsEntry_poll(fsEntry* entry, PollTable* table);
+
 static vNode* __pipe_fscore_openVnode(FScore* fscore, fsNode* node);
 
 static void __pipe_fscore_closeVnode(FScore* fscore, vNode* vnode);
 
 static fsEntry* __pipe_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLopenFlags flags);
 
-static vNodeOperations _pipe_vnode_operations = {
-    .readData = __pipeVnode_readData,
-    .writeData = __pipeVnode_writeData,
+static void __pipe_fscore_closeFSentry(FScore* fscore, fsEntry* entry);
+
+static vNodeOperations _pipe_vnode_operations = {   //Pipe data never goes through vnode, see _pipe_fsEntry_operations
+    .readData = NULL,
+    .writeData = NULL,
     .resize = NULL,
     .addDirectoryEntry = NULL,
     .removeDirectoryEntry = NULL,
@@ -58,8 +75,9 @@ static vNodeOperations _pipe_vnode_operations = {
 
 static fsEntryOperations _pipe_fsEntry_operations = {
     .seek   = __pipe_fsEntry_genericSeek,
-    .read   = fsEntry_genericRead,
-    .write  = fsEntry_genericWrite
+    .read   = __pipe_fsEntry_read,
+    .write  = __pipe_fsEntry_write,
+    .poll   = __pipe_fsEntry_poll
 };
 
 static FScoreOperations _pipe_fscore_oeprations = {
@@ -67,7 +85,7 @@ static FScoreOperations _pipe_fscore_oeprations = {
     .closeVnode = __pipe_fscore_closeVnode,
     .sync = NULL,
     .openFSentry = __pipe_fscore_openFSentry,
-    .closeFSentry = fscore_genericCloseFSentry,
+    .closeFSentry = __pipe_fscore_closeFSentry,
     .mount = NULL,
     .unmount = NULL
 };
@@ -87,11 +105,14 @@ Pipe* pipe_create(fsEntry** writeEndRet, fsEntry** readEndRet) {
         ERROR_GOTO(0);
     }
 
-    __pipe_initStruct(ret);
+    __pipe_initStruct(ret); //Frees buffer it took on failure
+    ERROR_GOTO_IF_ERROR(1);
     pipe_getFSentries(ret, writeEndRet, readEndRet);
     DEBUG_ASSERT_SILENT(ret->vnode != NULL);
     
     return ret;
+    ERROR_FINAL_BEGIN(1);
+    mm_free(ret);
     ERROR_FINAL_BEGIN(0);
     return NULL;
 }
@@ -104,8 +125,233 @@ void pipe_getFSentries(Pipe* pipe, fsEntry** writeEndRet, fsEntry** readEndRet)
     *readEndRet = fscore_rawOpenFSentry(&_pipe_fscore, vnode, FCNTL_OPEN_READ_ONLY);
 }
 
+Pipe* pipe_getFromFSentry(fsEntry* entry) {
+    vNode* vnode = entry->vnode;
+    if (vnode->fscore != &_pipe_fscore) {
+        return NULL;
+    }
+
+    return HOST_POINTER(vnode, PipeVnode, vnode)->pipe;
+}
+
+Size pipe_setCapacity(Pipe* pipe, Size capacity) {
+    void* newBuffer = NULL;
+    capacity = ALIGN_UP(algorithms_umax64(capacity, PAGE_SIZE), PAGE_SIZE);
+    if (capacity > PIPE_MAX_CAPACITY) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    mutex_acquire(&pipe->lock);
+    while (pipe->readerBusy || pipe->writerBusy) {  //Wait for transfers using old buffer outside lock
+        conditionVar_waitOnce(pipe->readerBusy ? &pipe->readableCond : &pipe->writableCond, &pipe->lock);
+    }
+
+    if (capacity < pipe->dataByteN) {
+        ERROR_THROW(ERROR_ID_STATE_ERROR, 1);
+    }
+
+    if (capacity != pipe->capacity) {
+        newBuffer = mm_allocatePages(capacity / PAGE_SIZE);
+        if (newBuffer == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+
+        Size dataByteN = pipe->dataByteN;
+        __pipe_ringRead(pipe, newBuffer, dataByteN);    //Linearize buffered data
+        mm_freePages(pipe->buffer);
+
+        pipe->buffer = newBuffer;
+        pipe->capacity = capacity;
+        pipe->readIndex = 0;
+        pipe->dataByteN = dataByteN;
+
+        conditionVar_notifyAll(&pipe->writableCond);
+        pollWaitQueue_wakeup(&pipe->pollQueue, POLL_EVENTS_OUT);
+    }
+
+    mutex_release(&pipe->lock);
+
+    return capacity;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&pipe->lock);
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+Size pipe_transferTo(Pipe* pipe, fsEntry* readEnd, fsEntry* to, Size n) {
+    Size ret = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    mutex_acquire(&pipe->lock);
+
+    __pipe_waitReadable(pipe, readEnd);
+    ERROR_GOTO_IF_ERROR(0);
+
+    pipe->readerBusy = true;
+    while (ret < n && pipe->dataByteN > 0) {    //No data here means all writers closed, return 0 as EOF
+        const void* segment = pipe->buffer + pipe->readIndex;
+        Size segmentByteN = algorithms_umin64(n - ret, algorithms_umin64(pipe->dataByteN, pipe->capacity - pipe->readIndex));   //Data may wrap around end of buffer
+        mutex_release(&pipe->lock); //Writing may block, segment is only consumed after written
+
+        Size writeByteN = fs_fileWrite(to, segment, segmentByteN);
+        mutex_acquire(&pipe->lock);
+        ERROR_GOTO_IF_ERROR(1);
+
+        Size freeByteNBefore = pipe->capacity - pipe->dataByteN;
+        pipe->readIndex = (pipe->readIndex + writeByteN) % pipe->capacity;
+        pipe->dataByteN -= writeByteN;
+        ret += writeByteN;
+        if (writeByteN > 0) {
+            __pipe_notifyRead(pipe, freeByteNBefore);
+        }
+
+        if (writeByteN < segmentByteN) {
+            break;
+        }
+    }
+    pipe->readerBusy = false;
+    conditionVar_notifyAll(&pipe->readableCond);
+
+    mutex_release(&pipe->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    pipe->readerBusy = false;
+    conditionVar_notifyAll(&pipe->readableCond);
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&pipe->lock);
+    if (ret > 0) {  //Data written before error is consumed and reported, error shows up again in next transfer
+        ERROR_CLEAR();
+    }
+    return ret;
+}
+
+Size pipe_transferFrom(Pipe* pipe, fsEntry* writeEnd, fsEntry* from, Size n) {
+    Size ret = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    mutex_acquire(&pipe->lock);
+
+    __pipe_waitWritable(pipe, writeEnd, TEST_FLAGS(writeEnd->flags, FCNTL_OPEN_NONBLOCK) ? 1 : algorithms_umin64(n, PIPE_ATOMIC_WRITE_SIZE));
+    ERROR_GOTO_IF_ERROR(0);
+
+    pipe->writerBusy = true;
+    while (ret < n && pipe->dataByteN < pipe->capacity) {
+        Index64 writeIndex = (pipe->readIndex + pipe->dataByteN) % pipe->capacity;
+        void* segment = pipe->buffer + writeIndex;
+        Size segmentByteN = algorithms_umin64(n - ret, algorithms_umin64(pipe->capacity - pipe->dataByteN, pipe->capacity - writeIndex));  //Free space may wrap around end of buffer
+        mutex_release(&pipe->lock); //Reading may block, readers never touch free space
+
+        Size readByteN = fs_fileRead(from, segment, segmentByteN);
+        mutex_acquire(&pipe->lock);
+        ERROR_GOTO_IF_ERROR(1);
+
+        bool wasEmpty = pipe->dataByteN == 0;
+        pipe->dataByteN += readByteN;
+        ret += readByteN;
+        if (readByteN > 0) {
+            __pipe_notifyWritten(pipe, wasEmpty);
+        }
+
+        if (readByteN < segmentByteN) {
+            break;
+        }
+    }
+    pipe->writerBusy = false;
+    conditionVar_notifyAll(&pipe->writableCond);
+
+    mutex_release(&pipe->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    pipe->writerBusy = false;
+    conditionVar_notifyAll(&pipe->writableCond);
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&pipe->lock);
+    if (ret > 0) {  //Data read before error is kept and reported, error shows up again in next transfer
+        ERROR_CLEAR();
+    }
+    return ret;
+}
+
+Size pipe_transferPipe(Pipe* pipe, fsEntry* readEnd, Pipe* toPipe, fsEntry* writeEnd, Size n) {
+    DEBUG_ASSERT_SILENT(pipe != toPipe);
+    Pipe* firstPipe = pipe < toPipe ? pipe : toPipe, * secondPipe = pipe < toPipe ? toPipe : pipe;
+    Size requiredByteN = TEST_FLAGS(writeEnd->flags, FCNTL_OPEN_NONBLOCK) ? 1 : algorithms_umin64(n, PIPE_ATOMIC_WRITE_SIZE);
+    Size ret = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    while (true) {  //Each pipe is waited with only its own lock held, both are locked only for copying
+        mutex_acquire(&pipe->lock);
+        __pipe_waitReadable(pipe, readEnd);
+        bool eof = pipe->dataByteN == 0;
+        mutex_release(&pipe->lock);
+        ERROR_GOTO_IF_ERROR(0);
+
+        if (eof) {
+            break;
+        }
+
+        mutex_acquire(&toPipe->lock);
+        __pipe_waitWritable(toPipe, writeEnd, requiredByteN);
+        mutex_release(&toPipe->lock);
+        ERROR_GOTO_IF_ERROR(0);
+
+        mutex_acquire(&firstPipe->lock);    //Lock both in address order
+        mutex_acquire(&secondPipe->lock);
+
+        if (toPipe->readerNum == 0) {
+            ERROR_THROW(ERROR_ID_BROKEN_PIPE, 1);
+        }
+
+        if (pipe->readerBusy || pipe->dataByteN == 0 || toPipe->writerBusy || toPipe->capacity - toPipe->dataByteN < requiredByteN) {  //Changed while unlocked, wait again
+            mutex_release(&secondPipe->lock);
+            mutex_release(&firstPipe->lock);
+            continue;
+        }
+
+        Size freeByteNBefore = pipe->capacity - pipe->dataByteN;
+        bool wasEmpty = toPipe->dataByteN == 0;
+        ret = algorithms_umin64(n, algorithms_umin64(pipe->dataByteN, toPipe->capacity - toPipe->dataByteN));
+        for (Size remaining = ret; remaining > 0;) {
+            Size segmentByteN = algorithms_umin64(remaining, pipe->capacity - pipe->readIndex); //Data may wrap around end of buffer
+            __pipe_ringWrite(toPipe, pipe->buffer + pipe->readIndex, segmentByteN);
+            pipe->readIndex = (pipe->readIndex + segmentByteN) % pipe->capacity;
+            pipe->dataByteN -= segmentByteN;
+            remaining -= segmentByteN;
+        }
+
+        __pipe_notifyRead(pipe, freeByteNBefore);
+        __pipe_notifyWritten(toPipe, wasEmpty);
+
+        mutex_release(&secondPipe->lock);
+        mutex_release(&firstPipe->lock);
+        break;
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&secondPipe->lock);
+    mutex_release(&firstPipe->lock);
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
 static void __pipe_initStruct(Pipe* pipe) {
-    fifo_initStruct(&pipe->fifo);
+    pipe->buffer = mm_allocatePages(PIPE_DEFAULT_CAPACITY / PAGE_SIZE);
+    if (pipe->buffer == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+    pipe->capacity = PIPE_DEFAULT_CAPACITY;
+    pipe->readIndex = 0;
 
     DirectoryEntry entry;
     memory_memset(&entry, 0, sizeof(DirectoryEntry));
@@ -118,63 +364,225 @@ static void __pipe_initStruct(Pipe* pipe) {
     memory_memset(&attribute, 0, sizeof(FSnodeAttribute));
     
     pipe->dummyNode = fsnode_create(&entry, 0, &attribute, NULL);
+    if (pipe->dummyNode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
     pipe->vnode = NULL;
 
     pipe->dataByteN = 0;
+    pipe->readerNum = pipe->writerNum = 0;
     mutex_initStruct(&pipe->lock, EMPTY_FLAGS);
-    conditionVar_initStruct(&pipe->cond);
+    pipe->readerBusy = pipe->writerBusy = false;
+    conditionVar_initStruct(&pipe->readableCond);
+    conditionVar_initStruct(&pipe->writableCond);
+    pollWaitQueue_initStruct(&pipe->pollQueue);
+
+    return;
+    ERROR_FINAL_BEGIN(1);
+    mm_freePages(pipe->buffer);
+    pipe->buffer = NULL;
+    ERROR_FINAL_BEGIN(0);
 }
 
 static void __pipe_clearStruct(Pipe* pipe) {
     DEBUG_ASSERT_SILENT(pipe->vnode == NULL);
+    DEBUG_ASSERT_SILENT(pipe->readerNum == 0 && pipe->writerNum == 0);
+    mm_freePages(pipe->buffer);
+    pipe->buffer = NULL;
     fsnode_derefer(pipe->dummyNode);
 }
 
-static bool __pipe_isReadyToRead(void* args) {
-    return ((Pipe*)args)->dataByteN > 0;
+static void __pipe_ringRead(Pipe* pipe, void* buffer, Size byteN) {
+    DEBUG_ASSERT_SILENT(byteN <= pipe->dataByteN);
+    Size firstByteN = algorithms_umin64(byteN, pipe->capacity - pipe->readIndex);   //Data may wrap around end of buffer
+    memory_memcpy(buffer, pipe->buffer + pipe->readIndex, firstByteN);
+    memory_memcpy(buffer + firstByteN, pipe->buffer, byteN - firstByteN);
+
+    pipe->readIndex = (pipe->readIndex + byteN) % pipe->capacity;
+    pipe->dataByteN -= byteN;
 }
 
-static void __pipeVnode_readData(vNode* vnode, Index64 begin, void* buffer, Size byteN) {   //TODO: Read EOF when all writers closed
-    PipeVnode* pipeVnode = HOST_POINTER(vnode, PipeVnode, vnode);
-    Pipe* pipe = pipeVnode->pipe;
+static void __pipe_ringWrite(Pipe* pipe, const void* buffer, Size byteN) {
+    DEBUG_ASSERT_SILENT(pipe->dataByteN + byteN <= pipe->capacity);
+    Index64 writeIndex = (pipe->readIndex + pipe->dataByteN) % pipe->capacity;
+    Size firstByteN = algorithms_umin64(byteN, pipe->capacity - writeIndex);
+    memory_memcpy(pipe->buffer + writeIndex, buffer, firstByteN);
+    memory_memcpy(pipe->buffer, buffer + firstByteN, byteN - firstByteN);
 
-    mutex_acquire(&pipe->lock);
+    pipe->dataByteN += byteN;
+}
 
-    conditionVar_wait(&pipe->cond, &pipe->lock, __pipe_isReadyToRead, (void*)pipe);
+static void __pipe_waitReadable(Pipe* pipe, fsEntry* entry) {
+    while (pipe->readerBusy || (pipe->dataByteN == 0 && pipe->writerNum > 0)) { //Busy reader is waited like a lock even for nonblocking end
+        if (!pipe->readerBusy && TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+        }
 
-    byteN = algorithms_umin64(byteN, pipe->dataByteN);
-    
-    fifo_read(&pipe->fifo, buffer, byteN);
+        conditionVar_waitOnce(&pipe->readableCond, &pipe->lock);
+    }
 
-    pipe->dataByteN -= byteN;
-    if (__pipe_isReadyToRead(pipe)) {
-        conditionVar_notify(&pipe->cond);
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __pipe_waitWritable(Pipe* pipe, fsEntry* entry, Size requiredByteN) {
+    while (true) {
+        if (pipe->readerNum == 0) {
+            ERROR_THROW(ERROR_ID_BROKEN_PIPE, 0);
+        }
+
+        if (!pipe->writerBusy && pipe->capacity - pipe->dataByteN >= requiredByteN) {
+            break;
+        }
+
+        if (!pipe->writerBusy && TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {   //Busy writer is waited like a lock even for nonblocking end
+            ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+        }
+
+        conditionVar_waitOnce(&pipe->writableCond, &pipe->lock);
     }
 
-    mutex_release(&pipe->lock);
+    return;
+    ERROR_FINAL_BEGIN(0);
 }
 
-static void __pipeVnode_writeData(vNode* vnode, Index64 begin, const void* buffer, Size byteN) {
-    PipeVnode* pipeVnode = HOST_POINTER(vnode, PipeVnode, vnode);
-    Pipe* pipe = pipeVnode->pipe;
+static void __pipe_notifyRead(Pipe* pipe, Size freeByteNBefore) {
+    if (freeByteNBefore < PIPE_ATOMIC_WRITE_SIZE) { //Writers only wait when free space is less than PIPE_ATOMIC_WRITE_SIZE, wake them all at once
+        conditionVar_notifyAll(&pipe->writableCond);
+        if (pipe->capacity - pipe->dataByteN >= PIPE_ATOMIC_WRITE_SIZE) {
+            pollWaitQueue_wakeup(&pipe->pollQueue, POLL_EVENTS_OUT);
+        }
+    }
+}
+
+static void __pipe_notifyWritten(Pipe* pipe, bool wasEmpty) {
+    if (wasEmpty) { //Readers only wait on empty pipe
+        conditionVar_notifyAll(&pipe->readableCond);
+        pollWaitQueue_wakeup(&pipe->pollQueue, POLL_EVENTS_IN);
+    }
+}
+
+static Index64 __pipe_fsEntry_genericSeek(fsEntry* entry, Index64 seekTo) {
+    return 0;
+}
+
+static Size __pipe_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    Pipe* pipe = pipe_getFromFSentry(entry);
+    Size ret = 0;
+    if (n == 0) {
+        return 0;
+    }
 
     mutex_acquire(&pipe->lock);
-    
-    fifo_write(&pipe->fifo, buffer, byteN);
 
-    pipe->dataByteN += byteN;
-    
+    __pipe_waitReadable(pipe, entry);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (pipe->dataByteN > 0) {  //No data here means all writers closed, return 0 as EOF
+        Size freeByteNBefore = pipe->capacity - pipe->dataByteN;
+        ret = algorithms_umin64(n, pipe->dataByteN);
+        __pipe_ringRead(pipe, buffer, ret);
+        __pipe_notifyRead(pipe, freeByteNBefore);
+    }
+
     mutex_release(&pipe->lock);
 
-    conditionVar_notify(&pipe->cond);
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&pipe->lock);
+    return 0;
 }
 
-static Index64 __pipe_fsEntry_genericSeek(fsEntry* entry, Index64 seekTo) {
+static Size __pipe_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    Pipe* pipe = pipe_getFromFSentry(entry);
+    bool nonblock = TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK);
+    Size ret = 0;
+
+    mutex_acquire(&pipe->lock);
+
+    while (ret < n) {
+        if (pipe->readerNum == 0) {
+            if (ret > 0) {  //Report bytes already written, next write sees broken pipe
+                break;
+            }
+            ERROR_THROW(ERROR_ID_BROKEN_PIPE, 0);
+        }
+
+        Size remainByteN = n - ret, freeByteN = pipe->capacity - pipe->dataByteN;
+        Size requiredByteN = remainByteN;   //Small writes are atomic, must be written at once
+        if (remainByteN > PIPE_ATOMIC_WRITE_SIZE) {
+            requiredByteN = nonblock ? 1 : PIPE_ATOMIC_WRITE_SIZE;  //Large writes go in chunks, avoid waking up for few bytes
+        }
+
+        if (pipe->writerBusy || freeByteN < requiredByteN) {
+            if (nonblock && !pipe->writerBusy) {
+                if (ret > 0) {
+                    break;
+                }
+                ERROR_THROW(ERROR_ID_WOULD_BLOCK, 0);
+            }
+
+            conditionVar_waitOnce(&pipe->writableCond, &pipe->lock);
+            continue;
+        }
+
+        Size writeByteN = algorithms_umin64(remainByteN, freeByteN);
+        bool wasEmpty = pipe->dataByteN == 0;
+        __pipe_ringWrite(pipe, buffer + ret, writeByteN);
+        ret += writeByteN;
+
+        __pipe_notifyWritten(pipe, wasEmpty);
+    }
+
+    mutex_release(&pipe->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&pipe->lock);
     return 0;
 }
 
+static PollEvents __pipe_fsEntry_poll(fsEntry* entry, PollTable* table) {
+    Pipe* pipe = pipe_getFromFSentry(entry);
+    poll_wait(table, &pipe->pollQueue);
+    ERROR_GOTO_IF_ERROR(0);
+
+    PollEvents ret = EMPTY_FLAGS;
+    mutex_acquire(&pipe->lock);
+    FCNTLopenFlags accessMode = FCNTL_OPEN_EXTRACL_ACCESS_MODE(entry->flags);
+    if (accessMode != FCNTL_OPEN_WRITE_ONLY) {
+        if (pipe->dataByteN > 0) {
+            SET_FLAG_BACK(ret, POLL_EVENTS_IN);
+        }
+
+        if (pipe->writerNum == 0) {
+            SET_FLAG_BACK(ret, POLL_EVENTS_HUP);
+        }
+    }
+
+    if (accessMode != FCNTL_OPEN_READ_ONLY) {
+        if (pipe->capacity - pipe->dataByteN >= PIPE_ATOMIC_WRITE_SIZE) {   //Same condition as writers waiting
+            SET_FLAG_BACK(ret, POLL_EVENTS_OUT);
+        }
+
+        if (pipe->readerNum == 0) {
+            SET_FLAG_BACK(ret, POLL_EVENTS_ERR);
+        }
+    }
+    mutex_release(&pipe->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return EMPTY_FLAGS;
+}
+
 static vNode* __pipe_fscore_openVnode(FScore* fscore, fsNode* node) {
     PipeVnode* pipeVnode = mm_allocate(sizeof(PipeVnode));
+    if (pipeVnode == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
     vNode* vnode = &pipeVnode->vnode;
 
     vNodeInitArgs args = {
@@ -193,14 +601,18 @@ static vNode* __pipe_fscore_openVnode(FScore* fscore, fsNode* node) {
     pipeVnode->pipe->vnode = vnode;
 
     return vnode;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
 }
 
 static void __pipe_fscore_closeVnode(FScore* fscore, vNode* vnode) {
     DEBUG_ASSERT_SILENT(REF_COUNTER_GET(vnode->refCounter) == 0);
-    PipeVnode* pipeVnode = mm_allocate(sizeof(PipeVnode));
+    PipeVnode* pipeVnode = HOST_POINTER(vnode, PipeVnode, vnode);
     Pipe* pipe = pipeVnode->pipe;
     mm_free(pipeVnode);
 
+    pipe->vnode = NULL;
+
     __pipe_clearStruct(pipe);
 }
 
@@ -210,7 +622,42 @@ static fsEntry* __pipe_fscore_openFSentry(FScore* fscore, vNode* vnode, FCNTLope
 
     ret->operations = &_pipe_fsEntry_operations;
 
+    Pipe* pipe = pipe_getFromFSentry(ret);
+    mutex_acquire(&pipe->lock);
+    FCNTLopenFlags accessMode = FCNTL_OPEN_EXTRACL_ACCESS_MODE(flags);
+    if (accessMode != FCNTL_OPEN_WRITE_ONLY) {
+        ++pipe->readerNum;
+    }
+
+    if (accessMode != FCNTL_OPEN_READ_ONLY) {
+        ++pipe->writerNum;
+    }
+    mutex_release(&pipe->lock);
+
     return ret;
     ERROR_FINAL_BEGIN(0);
     return NULL;
+}
+
+static void __pipe_fscore_closeFSentry(FScore* fscore, fsEntry* entry) {
+    Pipe* pipe = pipe_getFromFSentry(entry);
+    mutex_acquire(&pipe->lock);
+    FCNTLopenFlags accessMode = FCNTL_OPEN_EXTRACL_ACCESS_MODE(entry->flags);
+    if (accessMode != FCNTL_OPEN_WRITE_ONLY) {
+        DEBUG_ASSERT_SILENT(pipe->readerNum > 0);
+        --pipe->readerNum;
+    }
+
+    if (accessMode != FCNTL_OPEN_READ_ONLY) {
+        DEBUG_ASSERT_SILENT(pipe->writerNum > 0);
+        --pipe->writerNum;
+    }
+
+    //Let waiting peers notice EOF or broken pipe
+    conditionVar_notifyAll(&pipe->readableCond);
+    conditionVar_notifyAll(&pipe->writableCond);
+    pollWaitQueue_wakeup(&pipe->pollQueue, POLL_EVENTS_HUP | POLL_EVENTS_ERR);
+    mutex_release(&pipe->lock);
+
+    fscore_genericCloseFSentry(fscore, entry);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include<fs/fcntl.h>
 #include<fs/fs.h>
 #include<fs/fsEntry.h>
+#include<fs/poll.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/extendedPageTable.h>
@@ -18,12 +19,12 @@
 #include<system/pageTable.h>
 #include<error.h>
 
-static void __process_doClone(Process* process, Uint16 pid, Process* cloneFrom, Context* retContext);
+static void __process_doClone(Process* process, Uint32 pid, Process* cloneFrom, Context* retContext);
 
 __attribute__((naked))
-static void __process_cloneCurrent(Process* process, Uint16 pid, Process* cloneFrom);
+static void __process_cloneCurrent(Process* process, Uint32 pid, Process* cloneFrom);
 
-void process_initStruct(Process* process, Uint16 pid, ConstCstring name, ExtendedPageTableRoot* extendedTable) {
+void process_initStruct(Process* process, Uint32 pid, ConstCstring name, ExtendedPageTableRoot* extendedTable) {
     process->pid = pid;
     process->ppid = 0;
 
@@ -59,10 +60,12 @@ void process_initStruct(Process* process, Uint16 pid, ConstCstring name, Extende
     linkedListNode_initStruct(&process->childProcessNode);
 
     linkedListNode_initStruct(&process->scheduleNode);
+    hashChainNode_initStruct(&process->scheduleHashNode);
     
     process->isProcessActive = false;
 
     memory_memset(process->signalHandlers, 0, sizeof(process->signalHandlers));
+    pollWaitQueue_initStruct(&process->signalPollQueue);
 
     return;
     ERROR_FINAL_BEGIN(2);
@@ -78,7 +81,7 @@ void process_initStruct(Process* process, Uint16 pid, ConstCstring name, Extende
     }
 }
 
-void process_clone(Process* process, Uint16 pid, Process* cloneFrom) {
+void process_clone(Process* process, Uint32 pid, Process* cloneFrom) {
     if (cloneFrom == schedule_getCurrentProcess()) {
         __process_cloneCurrent(process, pid, cloneFrom);
     } else {
@@ -154,7 +157,7 @@ void process_signal(Process* process, int signal) {   //TODO: What if dead proce
     thread_lock(currentThread);
 
     if (process == schedule_getCurrentProcess()) {
-        thread_handleSignal(schedule_getCurrentThread(), signal);
+        thread_signal(currentThread, signal);   //Pended if blocked
     } else {
         Thread* threadHandlesSignal = HOST_POINTER(linkedListNode_getNext(&process->threads), Thread, processNode);
         thread_signal(threadHandlesSignal, signal);
@@ -213,7 +216,16 @@ void process_addThread(Process* process, Thread* thread) {
     }
 }
 
-Thread* process_getThreadFromTID(Process* process, Uint16 tid) {
+Thread* process_getThreadFromTID(Process* process, Uint32 tid) {
+    if (process->isProcessActive) { //Threads of active process are indexed
+        Thread* thread = schedule_getThreadFromTID(tid);
+        if (thread == NULL) {
+            ERROR_CLEAR();
+        }
+
+        return (thread != NULL && thread->process == process) ? thread : NULL;
+    }
+
     for (LinkedListNode* node = linkedListNode_getNext(&process->threads); node != &process->threads; node = node->next) {
         Thread* thread = HOST_POINTER(node, Thread, processNode);
         if (thread->tid == tid) {
@@ -244,7 +256,7 @@ Thread* process_createThread(Process* process, ThreadEntryPoint entry) {
         ERROR_GOTO(0);
     }
 
-    Uint16 tid = schedule_allocateNewID();
+    Uint32 tid = schedule_allocateNewID();
     thread_initNewThread(newThread, tid, process, entry);
     ERROR_GOTO_IF_ERROR(0);
 
@@ -325,7 +337,7 @@ fsEntry* process_removeFSentry(Process* process, int fd) {
     return NULL;
 }
 
-static void __process_doClone(Process* process, Uint16 pid, Process* cloneFrom, Context* retContext) {
+static void __process_doClone(Process* process, Uint32 pid, Process* cloneFrom, Context* retContext) {
     ExtendedPageTableRoot* newTable = extendedPageTableRoot_copyTable(cloneFrom->extendedTable);
     if (newTable == NULL) {
         ERROR_ASSERT_ANY();
@@ -366,7 +378,7 @@ static void __process_doClone(Process* process, Uint16 pid, Process* cloneFrom,
             ERROR_GOTO(0);
         }
     
-        Uint16 tid = schedule_allocateNewID();
+        Uint32 tid = schedule_allocateNewID();
         thread_clone(newThread, cloneFrom->lastActiveThread, tid, process, retContext);
         ERROR_GOTO_IF_ERROR(0);
 
@@ -380,7 +392,7 @@ static void __process_doClone(Process* process, Uint16 pid, Process* cloneFrom,
 }
 
 __attribute__((naked))
-static void __process_cloneCurrent(Process* process, Uint16 pid, Process* cloneFrom) {
+static void __process_cloneCurrent(Process* process, Uint32 pid, Process* cloneFrom) {
     CONTEXT_SAVE(__process_cloneReturn);
     Context* retContext = (Context*)readRegister_RSP_64();
     __process_doClone(process, pid, cloneFrom, retContext);
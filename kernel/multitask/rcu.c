@@ -0,0 +1,156 @@
+#include<multitask/rcu.h>
+
+#include<interrupt/IDT.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<multitask/locks/semaphore.h>
+#include<multitask/locks/spinlock.h>
+#include<structs/queue.h>
+#include<debug.h>
+
+#define __RCU_LOCAL_CPU_MASK    FLAG64(0)   //TODO: Track each CPU when SMP is supported
+#define __RCU_ALL_CPU_MASK      __RCU_LOCAL_CPU_MASK
+
+typedef struct __RCUstate {
+    Spinlock    lock;           //Protects queues and pending mask, also taken in scheduler with interrupt disabled
+    Queue       nextQueue;      //Callbacks waiting for a grace period to start
+    Queue       waitQueue;      //Callbacks waiting for current grace period to end
+    Queue       doneQueue;      //Callbacks ready to invoke
+    Uint64      qsPendingMask;  //CPUs not passed a quiescent state in current grace period, 0 if no grace period running
+    Uint64      gpNum;          //Grace periods started
+    Uint64      completedGPnum; //Grace periods ended
+    Semaphore   doneSema;
+} __RCUstate;
+
+typedef struct __RCUsynchronizer {
+    RCUhead     head;
+    Semaphore   sema;
+} __RCUsynchronizer;
+
+static __RCUstate _rcu;
+
+static Uint32 _rcu_readDepth;   //TODO: Per CPU when SMP is supported
+
+static void __rcu_spliceQueue(Queue* from, Queue* to);
+
+static void __rcu_startGracePeriod();
+
+static void __rcu_synchronizeCallback(RCUhead* head);
+
+void rcu_init() {
+    _rcu.lock = SPINLOCK_UNLOCKED;
+    queue_initStruct(&_rcu.nextQueue);
+    queue_initStruct(&_rcu.waitQueue);
+    queue_initStruct(&_rcu.doneQueue);
+    _rcu.qsPendingMask = 0;
+    _rcu.gpNum = _rcu.completedGPnum = 0;
+    semaphore_initStruct(&_rcu.doneSema, 0);
+
+    _rcu_readDepth = 0;
+}
+
+void rcu_daemon() {
+    idt_enableInterrupt();
+    while (true) {
+        semaphore_down(&_rcu.doneSema);
+
+        Queue done;
+        queue_initStruct(&done);
+        bool interruptEnabled = spinlock_lockIrqSave(&_rcu.lock);
+        __rcu_spliceQueue(&_rcu.doneQueue, &done);
+        spinlock_unlockIrqRestore(&_rcu.lock, interruptEnabled);
+
+        QueueNode* node;
+        while ((node = queue_peek(&done)) != NULL) {
+            queue_pop(&done);
+            RCUhead* head = HOST_POINTER(node, RCUhead, node);
+            head->callback(head);
+        }
+    }
+}
+
+void rcu_readLock() {
+    ATOMIC_INC_FETCH(&_rcu_readDepth);
+}
+
+void rcu_readUnlock() {
+    DEBUG_ASSERT_SILENT(rcu_isInReadSection());
+    ATOMIC_DEC_FETCH(&_rcu_readDepth);
+}
+
+bool rcu_isInReadSection() {
+    return ATOMIC_LOAD(&_rcu_readDepth) > 0;
+}
+
+void rcu_noteQuiescentState() {
+    DEBUG_ASSERT_SILENT(!rcu_isInReadSection());
+    if (TEST_FLAGS_NONE(ATOMIC_LOAD(&_rcu.qsPendingMask), __RCU_LOCAL_CPU_MASK)) {  //Nothing to report
+        return;
+    }
+
+    bool completed = false;
+    bool interruptEnabled = spinlock_lockIrqSave(&_rcu.lock);
+    if (TEST_FLAGS(_rcu.qsPendingMask, __RCU_LOCAL_CPU_MASK)) {
+        CLEAR_FLAG_BACK(_rcu.qsPendingMask, __RCU_LOCAL_CPU_MASK);
+        if (_rcu.qsPendingMask == 0) {
+            __rcu_spliceQueue(&_rcu.waitQueue, &_rcu.doneQueue);
+            ++_rcu.completedGPnum;
+            completed = true;
+
+            __rcu_startGracePeriod();   //Callbacks queued during last grace period, this quiescent state does not count for them
+        }
+    }
+    spinlock_unlockIrqRestore(&_rcu.lock, interruptEnabled);
+
+    if (completed) {
+        semaphore_up(&_rcu.doneSema);
+    }
+}
+
+void rcu_call(RCUhead* head, RCUcallback callback) {
+    head->callback = callback;
+    queueNode_initStruct(&head->node);
+
+    bool interruptEnabled = spinlock_lockIrqSave(&_rcu.lock);
+    queue_push(&_rcu.nextQueue, &head->node);
+    if (_rcu.qsPendingMask == 0) {
+        __rcu_startGracePeriod();
+    }
+    spinlock_unlockIrqRestore(&_rcu.lock, interruptEnabled);
+}
+
+void rcu_synchronize() {
+    DEBUG_ASSERT_SILENT(!rcu_isInReadSection());
+
+    __RCUsynchronizer synchronizer;
+    semaphore_initStruct(&synchronizer.sema, 0);
+    rcu_call(&synchronizer.head, __rcu_synchronizeCallback);
+    semaphore_down(&synchronizer.sema);
+}
+
+static void __rcu_spliceQueue(Queue* from, Queue* to) {
+    if (queue_isEmpty(from)) {
+        return;
+    }
+
+    to->qTail->next = from->q.next;
+    from->qTail->next = &to->q;
+    to->qTail = from->qTail;
+    queue_initStruct(from);
+}
+
+static void __rcu_startGracePeriod() {
+    if (queue_isEmpty(&_rcu.nextQueue)) {
+        return;
+    }
+
+    __rcu_spliceQueue(&_rcu.nextQueue, &_rcu.waitQueue);
+    ++_rcu.gpNum;
+    ATOMIC_STORE(&_rcu.qsPendingMask, __RCU_ALL_CPU_MASK);
+}
+
+static void __rcu_synchronizeCallback(RCUhead* head) {
+    __RCUsynchronizer* synchronizer = HOST_POINTER(head, __RCUsynchronizer, head);
+    semaphore_up(&synchronizer->sema);
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include<multitask/locks/semaphore.h>
 #include<multitask/locks/spinlock.h>
 #include<multitask/process.h>
+#include<multitask/rcu.h>
 #include<multitask/thread.h>
 #include<structs/queue.h>
 
@@ -30,6 +31,7 @@ void reaper_daemon() {
     while (true) {
         Thread* thread = __reaper_takeThread(&_reaper);
         process_notifyThreadDead(thread->process, thread);
+        rcu_synchronize();  //Lookups by TID may still be using it
         thread_clearStruct(thread);
     }
 }
@@ -6,10 +6,15 @@
 #include<memory/extendedPageTable.h>
 #include<memory/memory.h>
 #include<memory/mm.h>
+#include<multitask/futex.h>
 #include<multitask/locks/mutex.h>
 #include<multitask/locks/spinlock.h>
+#include<multitask/locks/ticketSpinlock.h>
+#include<multitask/messageQueue.h>
 #include<multitask/process.h>
+#include<multitask/rcu.h>
 #include<multitask/reaper.h>
+#include<multitask/sharedMemory.h>
 #include<multitask/thread.h>
 #include<real/simpleAsmLines.h>
 #include<real/flags/eflags.h>
@@ -33,11 +38,27 @@ static LinkedList _schedule_threads;
 static LinkedList _schedule_runningThreads;
 static Thread* _schedule_currentThread = NULL;
 
-static Uint16 _schedule_lastAllocatedID = 0;
+static Uint32 _schedule_lastAllocatedID = 0;
 static Bitmap _schedule_idBitmap;
-static Spinlock __schedule_idBitmapLock;
-#define __SCHEDULE_MAXIMUM_ID_NUM (1u << 16)
-static Uint8 _schedule_idBitmapBits[__SCHEDULE_MAXIMUM_ID_NUM / 8];
+static TicketSpinlock __schedule_idBitmapLock;
+#define __SCHEDULE_MAXIMUM_ID_NUM (1u << 22)    //Bitmap takes 512KB, allocated on init
+
+#define __SCHEDULE_ID_BATCH_SIZE    16
+
+typedef struct __ScheduleIDbatch {  //IDs reserved from bitmap in one go, taken without touching bitmap lock
+    Uint32 ids[__SCHEDULE_ID_BATCH_SIZE];
+    Uint8 begin, end;
+} __ScheduleIDbatch;
+
+static __ScheduleIDbatch _schedule_idBatch; //TODO: One batch per CPU when SMP is supported
+
+#define __SCHEDULE_ID_INDEX_CHAIN_NUM   1024
+static HashTable _schedule_processIndex;
+static SinglyLinkedList _schedule_processIndexChains[__SCHEDULE_ID_INDEX_CHAIN_NUM];
+static HashTable _schedule_threadIndex;
+static SinglyLinkedList _schedule_threadIndexChains[__SCHEDULE_ID_INDEX_CHAIN_NUM];
+
+static void __schedule_refillIDbatch(__ScheduleIDbatch* batch);
 
 static void __schedule_doYield();
 
@@ -55,9 +76,18 @@ void schedule_setEarlyStackBottom(void* stackBottom) {
 
 void schedule_init() {
     DEBUG_ASSERT_SILENT(!_schedule_started);
-    memory_memset(_schedule_idBitmapBits, 0, sizeof(_schedule_idBitmapBits));
-    bitmap_initStruct(&_schedule_idBitmap, __SCHEDULE_MAXIMUM_ID_NUM, &_schedule_idBitmap);
-    __schedule_idBitmapLock = SPINLOCK_UNLOCKED;
+    void* idBitmapBits = mm_allocate(__SCHEDULE_MAXIMUM_ID_NUM / 8);
+    if (idBitmapBits == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+    memory_memset(idBitmapBits, 0, __SCHEDULE_MAXIMUM_ID_NUM / 8);
+    bitmap_initStruct(&_schedule_idBitmap, __SCHEDULE_MAXIMUM_ID_NUM, idBitmapBits);
+    __schedule_idBitmapLock = TICKET_SPINLOCK_UNLOCKED;
+    _schedule_idBatch.begin = _schedule_idBatch.end = 0;
+
+    hashTable_initStruct(&_schedule_processIndex, __SCHEDULE_ID_INDEX_CHAIN_NUM, _schedule_processIndexChains, hashTable_defaultHashFunc);
+    hashTable_initStruct(&_schedule_threadIndex, __SCHEDULE_ID_INDEX_CHAIN_NUM, _schedule_threadIndexChains, hashTable_defaultHashFunc);
 
     linkedList_initStruct(&_schedule_processes);
     linkedList_initStruct(&_schedule_threads);
@@ -84,6 +114,12 @@ void schedule_init() {
     reaper_init();
     process_createThread(_schedule_rootProcess, reaper_daemon);
     ERROR_GOTO_IF_ERROR(0);
+    rcu_init();
+    process_createThread(_schedule_rootProcess, rcu_daemon);
+    ERROR_GOTO_IF_ERROR(0);
+    futex_init();
+    sharedMemory_init();
+    messageQueue_init();
     
     _schedule_initProcess = mm_allocate(sizeof(Process));
     if (_schedule_initProcess == NULL) {
@@ -107,21 +143,27 @@ void schedule_init() {
     ERROR_FINAL_BEGIN(0);
 }
 
-Uint16 schedule_allocateNewID() {
-    spinlock_lock(&__schedule_idBitmapLock);
-    Index64 ret = bitmap_findFirstClear(&_schedule_idBitmap, _schedule_lastAllocatedID);
-    if (ret != INVALID_INDEX64) {
-        bitmap_setBit(&_schedule_idBitmap, ret);
-        _schedule_lastAllocatedID = ret;
+Uint32 schedule_allocateNewID() {
+    __ScheduleIDbatch* batch = &_schedule_idBatch;
+
+    bool interruptEnabled = idt_disableInterrupt(); //Batch is only shared with interrupt on same CPU
+    if (batch->begin == batch->end) {
+        __schedule_refillIDbatch(batch);
+    }
+
+    Uint32 ret = SCHEDULE_INVALID_ID;
+    if (batch->begin != batch->end) {
+        ret = batch->ids[batch->begin++];
     }
-    spinlock_unlock(&__schedule_idBitmapLock);
+    idt_setInterrupt(interruptEnabled);
+
     return ret;
 }
 
-void schedule_releaseID(Uint16 id) {
-    spinlock_lock(&__schedule_idBitmapLock);
+void schedule_releaseID(Uint32 id) {
+    ticketSpinlock_lock(&__schedule_idBitmapLock);
     bitmap_clearBit(&_schedule_idBitmap, id);
-    spinlock_unlock(&__schedule_idBitmapLock);
+    ticketSpinlock_unlock(&__schedule_idBitmapLock);
 }
 
 void schedule_tick() {
@@ -130,6 +172,11 @@ void schedule_tick() {
     }
 
     if (--_schedule_currentThread->remainTick == 0) {
+        if (rcu_isInReadSection()) {    //Readers are not preempted, check again at next tick
+            _schedule_currentThread->remainTick = 1;
+            return;
+        }
+
         _schedule_currentThread->remainTick = THREAD_TICK;
         schedule_yield();
     }
@@ -158,6 +205,8 @@ void schedule_addProcess(Process* process) {
     mutex_acquire(&_schedule_queueLock);
     
     linkedListNode_insertBack(&_schedule_processes, &process->scheduleNode);
+    hashTable_rcuInsert(&_schedule_processIndex, (Object)process->pid, &process->scheduleHashNode);
+    ERROR_ASSERT_NONE();    //PID is never shared
     for (LinkedListNode* node = linkedListNode_getNext(&process->threads); node != &process->threads; node = node->next) {
         Thread* thread = HOST_POINTER(node, Thread, processNode);
         schedule_addThread(thread);
@@ -173,6 +222,7 @@ void schedule_removeProcess(Process* process) {
     mutex_acquire(&_schedule_queueLock);
 
     linkedListNode_delete(&process->scheduleNode);
+    hashTable_rcuDelete(&_schedule_processIndex, (Object)process->pid);
     for (LinkedListNode* node = linkedListNode_getNext(&process->threads); node != &process->threads; node = node->next) {
         Thread* thread = HOST_POINTER(node, Thread, processNode);
         schedule_removeThread(thread);
@@ -187,6 +237,8 @@ void schedule_addThread(Thread* thread) {
 
     mutex_acquire(&_schedule_queueLock);
     linkedListNode_insertBack(&_schedule_threads, &thread->scheduleNode);
+    hashTable_rcuInsert(&_schedule_threadIndex, (Object)thread->tid, &thread->scheduleHashNode);
+    ERROR_ASSERT_NONE();    //TID is never shared
 
     thread->isThreadActive = true;
 
@@ -206,6 +258,7 @@ void schedule_removeThread(Thread* thread) {
     }
 
     linkedListNode_delete(&thread->scheduleNode);
+    hashTable_rcuDelete(&_schedule_threadIndex, (Object)thread->tid);
 
     thread->isThreadActive = false;
 
@@ -230,21 +283,22 @@ void schedule_threadQuitSchedule(Thread* thread) {
     mutex_release(&_schedule_queueLock);
 }
 
+Process* schedule_getRootProcess() {
+    return _schedule_rootProcess;
+}
+
 Process* schedule_getCurrentProcess() {
     DEBUG_ASSERT_SILENT(_schedule_started);
     return _schedule_currentThread->process;
 }
 
-Process* schedule_getProcessFromPID(Uint16 pid) {
-    mutex_acquire(&_schedule_queueLock);
-    for (LinkedListNode* node = linkedListNode_getNext(&_schedule_processes); node != &_schedule_processes; node = node->next) {
-        Process* currentProcess = HOST_POINTER(node, Process, scheduleNode);
-        if (currentProcess->pid == pid) {
-            mutex_release(&_schedule_queueLock);
-            return currentProcess;
-        }
+Process* schedule_getProcessFromPID(Uint32 pid) {
+    DEBUG_ASSERT_SILENT(rcu_isInReadSection()); //Process is unindexed before torn down, only valid until caller leaves read section
+    HashChainNode* found = hashTable_rcuFind(&_schedule_processIndex, (Object)pid);
+
+    if (found != NULL) {
+        return HOST_POINTER(found, Process, scheduleHashNode);
     }
-    mutex_release(&_schedule_queueLock);
 
     ERROR_THROW_NO_GOTO(ERROR_ID_NOT_FOUND);
     return NULL;
@@ -255,16 +309,13 @@ Thread* schedule_getCurrentThread() {
     return _schedule_currentThread;
 }
 
-Thread* schedule_getThreadFromTID(Uint16 tid) {
-    mutex_acquire(&_schedule_queueLock);
-    for (LinkedListNode* node = linkedListNode_getNext(&_schedule_threads); node != &_schedule_threads; node = node->next) {
-        Thread* currentThread = HOST_POINTER(node, Thread, scheduleNode);
-        if (currentThread->tid == tid) {
-            mutex_release(&_schedule_queueLock);
-            return currentThread;
-        }
+Thread* schedule_getThreadFromTID(Uint32 tid) {
+    DEBUG_ASSERT_SILENT(rcu_isInReadSection()); //Reaper waits a grace period after unindexing before clearing thread
+    HashChainNode* found = hashTable_rcuFind(&_schedule_threadIndex, (Object)tid);
+
+    if (found != NULL) {
+        return HOST_POINTER(found, Thread, scheduleHashNode);
     }
-    mutex_release(&_schedule_queueLock);
 
     ERROR_THROW_NO_GOTO(ERROR_ID_NOT_FOUND);
     return NULL;
@@ -299,7 +350,7 @@ Process* schedule_fork() {
         ERROR_ASSERT_ANY();
     }
 
-    Uint16 tid = schedule_getCurrentThread()->tid, pid = schedule_allocateNewID();
+    Uint32 tid = schedule_getCurrentThread()->tid, pid = schedule_allocateNewID();
     
     Process* currentProcess = schedule_getCurrentProcess();
     process_clone(newProcess, pid, currentProcess);
@@ -324,6 +375,7 @@ Process* schedule_fork() {
 
 static void __schedule_doYield() {
     DEBUG_ASSERT_SILENT(!idt_isInISR());
+    rcu_noteQuiescentState();   //Read sections never cross a context switch
     mutex_acquire(&_schedule_lock);
 
     Thread* currentThread = _schedule_currentThread, * nextThread = __schedule_selectNextThread();
@@ -346,6 +398,7 @@ static void __schedule_idle() {
     idt_enableInterrupt();
     while (true) {
         hlt();
+        rcu_noteQuiescentState();
         // scheduler_yield(schedule_getCurrentScheduler());
         //No, no yield here, currently it will make system freezed for input
     }
@@ -382,7 +435,7 @@ static Thread* __schedule_initFirstThread() {
         ERROR_GOTO(0);
     }
 
-    Uint16 tid = schedule_allocateNewID();
+    Uint32 tid = schedule_allocateNewID();
     thread_initFirstThread(firstThread, tid, _schedule_initProcess, __schedule_earlyStackBottom, THREAD_DEFAULT_KERNEL_STACK_SIZE);
     ERROR_GOTO_IF_ERROR(0);
 
@@ -391,4 +444,24 @@ static Thread* __schedule_initFirstThread() {
     return firstThread;
     ERROR_FINAL_BEGIN(0);
     return NULL;
+}
+
+static void __schedule_refillIDbatch(__ScheduleIDbatch* batch) {
+    ticketSpinlock_lock(&__schedule_idBitmapLock);
+    batch->begin = batch->end = 0;
+    for (int i = 0; i < __SCHEDULE_ID_BATCH_SIZE; ++i) {
+        Index64 id = bitmap_findFirstClear(&_schedule_idBitmap, _schedule_lastAllocatedID + 1);
+        if (id == INVALID_INDEX64) {    //Wrap around, released IDs are reused only from here
+            id = bitmap_findFirstClear(&_schedule_idBitmap, 0);
+        }
+
+        if (id == INVALID_INDEX64) {
+            break;
+        }
+
+        bitmap_setBit(&_schedule_idBitmap, id);
+        _schedule_lastAllocatedID = id;
+        batch->ids[batch->end++] = id;
+    }
+    ticketSpinlock_unlock(&__schedule_idBitmapLock);
 }
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include<multitask/sharedMemory.h>
+
+#include<fs/anonymousFile.h>
+#include<fs/fcntl.h>
+#include<fs/fscore.h>
+#include<fs/fsEntry.h>
+#include<fs/vnode.h>
+#include<kit/atomic.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<kit/util.h>
+#include<memory/extendedPageTable.h>
+#include<memory/frameMetadata.h>
+#include<memory/memory.h>
+#include<memory/memoryOperations.h>
+#include<memory/mm.h>
+#include<memory/vms.h>
+#include<multitask/locks/mutex.h>
+#include<structs/linkedList.h>
+#include<structs/refCounter.h>
+#include<system/pageTable.h>
+#include<algorithms.h>
+#include<cstring.h>
+#include<debug.h>
+#include<error.h>
+
+static Mutex _sharedMemory_lock;    //Lock for name list
+static LinkedList _sharedMemory_list;
+
+static SharedMemory* __sharedMemory_find(ConstCstring name);
+
+static SharedMemory* __sharedMemory_create(ConstCstring name, Size nameLength);
+
+static void __sharedMemory_derefer(SharedMemory* sharedMemory);
+
+static fsEntry* __sharedMemory_openFSentry(SharedMemory* sharedMemory, FCNTLopenFlags flags);
+
+static bool __sharedMemory_tryReferVnode(vNode* vnode);
+
+static void __sharedMemory_release(Object object);
+
+static void __sharedMemory_doResize(SharedMemory* sharedMemory, Size size);
+
+static void* __sharedMemory_getFrame(SharedMemory* sharedMemory, Index64 pageIndex);
+
+static void* __sharedMemory_drawGetFrame(Object object, Index64 pageIndex);
+
+static FrameMetadataUnit* __sharedMemory_getFrameUnit(void* frame);
+
+static Size __sharedMemory_fsEntry_read(fsEntry* entry, void* buffer, Size n);
+
+static Size __sharedMemory_fsEntry_write(fsEntry* entry, const void* buffer, Size n);
+
+static fsEntryOperations _sharedMemory_fsEntry_operations = {
+    .seek   = fsEntry_genericSeek,
+    .read   = __sharedMemory_fsEntry_read,
+    .write  = __sharedMemory_fsEntry_write,
+    .poll   = NULL
+};
+
+void sharedMemory_init() {
+    mutex_initStruct(&_sharedMemory_lock, EMPTY_FLAGS);
+    linkedList_initStruct(&_sharedMemory_list);
+}
+
+fsEntry* sharedMemory_open(ConstCstring name, FCNTLopenFlags flags) {
+    Size nameLength = cstring_strlen(name);
+    if (nameLength == 0 || nameLength > SHARED_MEMORY_NAME_MAX) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    mutex_acquire(&_sharedMemory_lock);
+    SharedMemory* sharedMemory = __sharedMemory_find(name);
+    if (sharedMemory == NULL) {
+        if (TEST_FLAGS_FAIL(flags, FCNTL_OPEN_CREAT)) {
+            ERROR_THROW(ERROR_ID_NOT_FOUND, 1);
+        }
+
+        sharedMemory = __sharedMemory_create(name, nameLength);
+        if (sharedMemory == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+        linkedListNode_insertFront(&_sharedMemory_list, &sharedMemory->node);
+    } else if (TEST_FLAGS(flags, FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL)) {
+        ERROR_THROW(ERROR_ID_ALREADY_EXIST, 1);
+    }
+    REF_COUNTER_REFER(sharedMemory->refCounter);    //May be unlinked once name list unlocked
+    mutex_release(&_sharedMemory_lock);
+
+    fsEntry* ret = __sharedMemory_openFSentry(sharedMemory, CLEAR_FLAG(flags, FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL | FCNTL_OPEN_TRUNC));
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(2);
+    }
+
+    if (TEST_FLAGS(flags, FCNTL_OPEN_TRUNC) && FCNTL_OPEN_EXTRACL_ACCESS_MODE(flags) != FCNTL_OPEN_READ_ONLY) {
+        sharedMemory_resize(sharedMemory, 0);
+    }
+    __sharedMemory_derefer(sharedMemory);
+
+    return ret;
+    ERROR_FINAL_BEGIN(2);
+    __sharedMemory_derefer(sharedMemory);
+    return NULL;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&_sharedMemory_lock);
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+void sharedMemory_unlink(ConstCstring name) {
+    mutex_acquire(&_sharedMemory_lock);
+    SharedMemory* sharedMemory = __sharedMemory_find(name);
+    if (sharedMemory == NULL) {
+        ERROR_THROW(ERROR_ID_NOT_FOUND, 0);
+    }
+    linkedListNode_delete(&sharedMemory->node);
+    mutex_release(&_sharedMemory_lock);
+
+    __sharedMemory_derefer(sharedMemory);
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&_sharedMemory_lock);
+}
+
+SharedMemory* sharedMemory_getFromFSentry(fsEntry* entry) {
+    return (SharedMemory*)anonymousFile_getObject(entry, &_sharedMemory_fsEntry_operations);
+}
+
+void sharedMemory_resize(SharedMemory* sharedMemory, Size size) {
+    mutex_acquire(&sharedMemory->lock);
+    __sharedMemory_doResize(sharedMemory, size);
+    mutex_release(&sharedMemory->lock);
+}
+
+void sharedMemory_draw(SharedMemory* sharedMemory, VirtualMemoryRegionInfo* info, ExtendedPageTableRoot* pageTable) {
+    virtualMemoryRegionInfo_drawFrames(info, pageTable, &sharedMemory->lock, &sharedMemory->size, __sharedMemory_drawGetFrame, (Object)sharedMemory);
+}
+
+static SharedMemory* __sharedMemory_find(ConstCstring name) {
+    for (LinkedListNode* node = linkedListNode_getNext(&_sharedMemory_list); node != &_sharedMemory_list; node = linkedListNode_getNext(node)) {
+        SharedMemory* sharedMemory = HOST_POINTER(node, SharedMemory, node);
+        if (cstring_strcmp(sharedMemory->name, name) == 0) {
+            return sharedMemory;
+        }
+    }
+
+    return NULL;
+}
+
+static SharedMemory* __sharedMemory_create(ConstCstring name, Size nameLength) {
+    SharedMemory* ret = mm_allocate(sizeof(SharedMemory) + nameLength + 1);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    linkedListNode_initStruct(&ret->node);
+    REF_COUNTER_INIT(ret->refCounter, 1);
+    mutex_initStruct(&ret->lock, EMPTY_FLAGS);
+    ret->size = 0;
+    ret->frameCapacity = 0;
+    ret->frames = NULL;
+    ret->vnode = NULL;
+    memory_memcpy(ret->name, name, nameLength + 1);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void __sharedMemory_derefer(SharedMemory* sharedMemory) {
+    if (REF_COUNTER_DEREFER(sharedMemory->refCounter) != 0) {
+        return;
+    }
+
+    DEBUG_ASSERT_SILENT(sharedMemory->vnode == NULL);
+    __sharedMemory_doResize(sharedMemory, 0);   //Frames still mapped are released when unmapped
+    if (sharedMemory->frames != NULL) {
+        mm_free(sharedMemory->frames);
+    }
+    mm_free(sharedMemory);
+}
+
+static fsEntry* __sharedMemory_openFSentry(SharedMemory* sharedMemory, FCNTLopenFlags flags) {
+    mutex_acquire(&sharedMemory->lock);
+
+    fsEntry* ret = NULL;
+    vNode* vnode = sharedMemory->vnode;
+    if (vnode != NULL && __sharedMemory_tryReferVnode(vnode)) { //Entries share one vnode, so size seen by fs layer stays the same
+        ret = fscore_rawOpenFSentry(vnode->fscore, vnode, flags);
+        if (ret == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(1);
+        }
+    } else {
+        ret = anonymousFile_create(sharedMemory->name, &_sharedMemory_fsEntry_operations, __sharedMemory_release, (Object)sharedMemory, flags);
+        if (ret == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        REF_COUNTER_REFER(sharedMemory->refCounter);    //Released with vnode
+        sharedMemory->vnode = ret->vnode;
+        sharedMemory->vnode->size = sharedMemory->size;
+    }
+
+    mutex_release(&sharedMemory->lock);
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    mutex_release(&sharedMemory->lock);
+    fscore_releaseVnode(vnode);
+    return NULL;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&sharedMemory->lock);
+    return NULL;
+}
+
+static bool __sharedMemory_tryReferVnode(vNode* vnode) {
+    Uint32 refCount = REF_COUNTER_GET(vnode->refCounter);
+    while (refCount != 0) { //Vnode being closed, its release is waiting for lock of object
+        if (ATOMIC_COMPARE_EXCHANGE_N(&vnode->refCounter, &refCount, refCount + 1)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void __sharedMemory_release(Object object) {
+    SharedMemory* sharedMemory = (SharedMemory*)object;
+
+    mutex_acquire(&sharedMemory->lock);
+    if (sharedMemory->vnode != NULL && REF_COUNTER_GET(sharedMemory->vnode->refCounter) == 0) { //Not replaced by a newer vnode
+        sharedMemory->vnode = NULL;
+    }
+    mutex_release(&sharedMemory->lock);
+
+    __sharedMemory_derefer(sharedMemory);
+}
+
+static void __sharedMemory_doResize(SharedMemory* sharedMemory, Size size) {
+    Size oldPageN = DIVIDE_ROUND_UP(sharedMemory->size, PAGE_SIZE), newPageN = DIVIDE_ROUND_UP(size, PAGE_SIZE);
+    if (newPageN > sharedMemory->frameCapacity) {
+        Size newCapacity = algorithms_umax64(newPageN, sharedMemory->frameCapacity * 2);
+        void** newFrames = mm_allocate(newCapacity * sizeof(void*));
+        if (newFrames == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+
+        memory_memset(newFrames, 0, newCapacity * sizeof(void*));
+        if (sharedMemory->frames != NULL) {
+            memory_memcpy(newFrames, sharedMemory->frames, oldPageN * sizeof(void*));
+            mm_free(sharedMemory->frames);
+        }
+        sharedMemory->frames = newFrames;
+        sharedMemory->frameCapacity = newCapacity;
+    }
+
+    for (Index64 i = newPageN; i < oldPageN; ++i) { //Frames out of object, mappings may still refer them
+        void* frame = sharedMemory->frames[i];
+        if (frame == NULL) {
+            continue;
+        }
+
+        if (REF_COUNTER_DEREFER(__sharedMemory_getFrameUnit(frame)->refCounter) == 0) {
+            mm_freeFrames(frame, 1);
+        }
+        sharedMemory->frames[i] = NULL;
+    }
+
+    Index64 tailBegin = size % PAGE_SIZE;
+    if (size < sharedMemory->size && tailBegin != 0 && sharedMemory->frames[newPageN - 1] != NULL) {  //Data cut off reads as 0 if object grows again
+        memory_memset(PAGING_CONVERT_KERNEL_MEMORY_P2V(sharedMemory->frames[newPageN - 1]) + tailBegin, 0, PAGE_SIZE - tailBegin);
+    }
+
+    sharedMemory->size = size;
+    if (sharedMemory->vnode != NULL) {
+        sharedMemory->vnode->size = size;
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void* __sharedMemory_getFrame(SharedMemory* sharedMemory, Index64 pageIndex) {
+    DEBUG_ASSERT_SILENT(pageIndex < DIVIDE_ROUND_UP(sharedMemory->size, PAGE_SIZE));
+    void* ret = sharedMemory->frames[pageIndex];
+    if (ret != NULL) {
+        return ret;
+    }
+
+    ret = mm_allocateFrames(1);
+    if (ret == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    memory_memset(PAGING_CONVERT_KERNEL_MEMORY_P2V(ret), 0, PAGE_SIZE);
+    REF_COUNTER_INIT(__sharedMemory_getFrameUnit(ret)->refCounter, 1);
+    sharedMemory->frames[pageIndex] = ret;
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+static void* __sharedMemory_drawGetFrame(Object object, Index64 pageIndex) {
+    return __sharedMemory_getFrame((SharedMemory*)object, pageIndex);
+}
+
+static FrameMetadataUnit* __sharedMemory_getFrameUnit(void* frame) {
+    FrameMetadataUnit* ret = frameMetadata_getUnit(&mm->frameMetadata, FRAME_METADATA_FRAME_TO_INDEX(frame));
+    DEBUG_ASSERT_SILENT(ret != NULL);
+    return ret;
+}
+
+static Size __sharedMemory_fsEntry_read(fsEntry* entry, void* buffer, Size n) {
+    SharedMemory* sharedMemory = sharedMemory_getFromFSentry(entry);
+
+    mutex_acquire(&sharedMemory->lock);
+
+    Index64 pointer = entry->pointer;
+    Size ret = pointer >= sharedMemory->size ? 0 : algorithms_umin64(n, sharedMemory->size - pointer);
+    for (Size remaining = ret; remaining > 0;) {
+        Index64 offset = pointer % PAGE_SIZE;
+        Size copyN = algorithms_umin64(remaining, PAGE_SIZE - offset);
+        void* frame = sharedMemory->frames[pointer / PAGE_SIZE];
+        if (frame == NULL) {    //Never touched, reads as 0 without allocating
+            memory_memset(buffer, 0, copyN);
+        } else {
+            memory_memcpy(buffer, PAGING_CONVERT_KERNEL_MEMORY_P2V(frame) + offset, copyN);
+        }
+
+        buffer += copyN;
+        pointer += copyN;
+        remaining -= copyN;
+    }
+
+    mutex_release(&sharedMemory->lock);
+
+    return ret;
+}
+
+static Size __sharedMemory_fsEntry_write(fsEntry* entry, const void* buffer, Size n) {
+    SharedMemory* sharedMemory = sharedMemory_getFromFSentry(entry);
+
+    mutex_acquire(&sharedMemory->lock);
+
+    Index64 pointer = entry->pointer;
+    if (pointer + n > sharedMemory->size) {
+        __sharedMemory_doResize(sharedMemory, pointer + n);
+        ERROR_GOTO_IF_ERROR(0);
+    }
+
+    for (Size remaining = n; remaining > 0;) {
+        Index64 offset = pointer % PAGE_SIZE;
+        Size copyN = algorithms_umin64(remaining, PAGE_SIZE - offset);
+        void* frame = __sharedMemory_getFrame(sharedMemory, pointer / PAGE_SIZE);
+        if (frame == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        memory_memcpy(PAGING_CONVERT_KERNEL_MEMORY_P2V(frame) + offset, buffer, copyN);
+
+        buffer += copyN;
+        pointer += copyN;
+        remaining -= copyN;
+    }
+
+    mutex_release(&sharedMemory->lock);
+
+    return n;
+    ERROR_FINAL_BEGIN(0);
+    mutex_release(&sharedMemory->lock);
+    return 0;
+}
\ No newline at end of file
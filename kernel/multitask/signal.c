@@ -112,11 +112,14 @@ void signalQueue_pend(SignalQueue* queue, int signal) {
 }
 
 int signalQueue_getPending(SignalQueue* queue) {
-    int ret = 0;
+    return signalQueue_takePending(queue, FULL_MASK(32));
+}
+
+int signalQueue_takePending(SignalQueue* queue, Flags32 mask) {
     SignalQueue currentQueue = ATOMIC_LOAD(queue), newQueue;
     Flags32 pending;
     do {
-        pending = LOWER_BIT(currentQueue);
+        pending = LOWER_BIT(currentQueue & mask);
         newQueue = currentQueue ^ pending;
     } while (!ATOMIC_COMPARE_EXCHANGE_N(queue, &currentQueue, newQueue));
 
@@ -2,20 +2,47 @@
 
 #if defined(CONFIG_UNIT_TEST_SCHEDULE)
 
+#include<fs/epoll.h>
+#include<fs/eventfd.h>
+#include<fs/fcntl.h>
 #include<fs/fs.h>
 #include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<fs/signalfd.h>
+#include<fs/timerfd.h>
+#include<interrupt/IDT.h>
+#include<kit/atomic.h>
 #include<kit/types.h>
+#include<memory/mapping.h>
 #include<memory/memory.h>
 #include<memory/memoryOperations.h>
 #include<memory/mm.h>
+#include<multitask/futex.h>
 #include<multitask/ipc.h>
+#include<multitask/pipe.h>
 #include<multitask/locks/conditionVar.h>
+#include<multitask/locks/lockProfile.h>
+#include<multitask/locks/mcsSpinlock.h>
 #include<multitask/locks/mutex.h>
+#include<multitask/locks/rwSemaphore.h>
+#include<multitask/locks/rwSpinlock.h>
 #include<multitask/locks/spinlock.h>
 #include<multitask/locks/semaphore.h>
+#include<multitask/locks/seqlock.h>
+#include<multitask/locks/ticketSpinlock.h>
+#include<multitask/messageQueue.h>
 #include<multitask/process.h>
+#include<multitask/rcu.h>
 #include<multitask/schedule.h>
+#include<multitask/sharedMemory.h>
+#include<multitask/signal.h>
+#include<multitask/thread.h>
+#include<real/flags/eflags.h>
+#include<real/simpleAsmLines.h>
+#include<time/time.h>
+#include<cstring.h>
 #include<test.h>
+#include<error.h>
 
 typedef struct __ScheduleTestContext {
     Process* original, * forked;
@@ -224,7 +251,7 @@ bool __multitask_test_ipc_mutex(void* arg) {
             spinlock_unlock(&ctx->lock2);
         } else {
             mutex_initStruct(mutex, EMPTY_FLAGS);
-            if (mutex->depth != 0 || mutex->acquiredBy != NULL || mutex_isLocked(mutex)) {
+            if (mutex->depth != 0 || mutex->acquiredBy != NULL || mutex_isLocked(mutex) || mutex->contendedNum != 0 || mutex->waitTime != 0) {
                 ctx->success = false;
                 break;
             }
@@ -377,12 +404,267 @@ bool __multitask_test_ipc_pipe(void* arg) {
     __MULTITASK_TEST_SYNC_RETURN(ctx);
 }
 
+bool __multitask_test_ipc_pipeRing(void* arg) {
+    fsEntry* writeEnd, * readEnd;
+    Pipe* pipe = pipe_create(&writeEnd, &readEnd);
+    if (pipe == NULL) {
+        return false;
+    }
+
+    char buffer[16];
+    bool ret = true;
+    SET_FLAG_BACK(readEnd->flags, FCNTL_OPEN_NONBLOCK);
+    SET_FLAG_BACK(writeEnd->flags, FCNTL_OPEN_NONBLOCK);
+
+    fs_fileRead(readEnd, buffer, sizeof(buffer));   //Empty pipe with writer
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    ret = ret && pipe_setCapacity(pipe, 1) == PAGE_SIZE;
+    Size writeN = 0;
+    for (int i = 0; i < PAGE_SIZE / sizeof(buffer); ++i) {
+        writeN += fs_fileWrite(writeEnd, buffer, sizeof(buffer));
+    }
+    ret = ret && writeN == PAGE_SIZE;
+
+    fs_fileWrite(writeEnd, buffer, sizeof(buffer)); //Full pipe
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    ret = ret && fs_fileRead(readEnd, buffer, sizeof(buffer)) == sizeof(buffer);
+    ret = ret && fs_fileWrite(writeEnd, buffer, sizeof(buffer)) == sizeof(buffer);
+    ret = ret && pipe_setCapacity(pipe, 2 * PAGE_SIZE) == 2 * PAGE_SIZE;   //Buffered data wraps around, should be kept
+
+    fs_fileClose(writeEnd);
+    Size readN = 0, n;
+    while ((n = fs_fileRead(readEnd, buffer, sizeof(buffer))) > 0) {
+        readN += n;
+    }
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_OK && readN == PAGE_SIZE;  //All writers closed, EOF after data drained
+
+    fs_fileClose(readEnd);
+
+    return ret;
+}
+
+bool __multitask_test_ipc_poll(void* arg) {
+    fsEntry* writeEnd, * readEnd;
+    if (pipe_create(&writeEnd, &readEnd) == NULL) {
+        return false;
+    }
+
+    char buffer[16];
+    bool ret = true;
+    PollRequest requests[2] = {
+        { .entry = readEnd, .events = POLL_EVENTS_IN },
+        { .entry = writeEnd, .events = POLL_EVENTS_OUT }
+    };
+
+    ret = ret && poll_poll(requests, 2, 0) == 1 && requests[0].revents == EMPTY_FLAGS && requests[1].revents == POLL_EVENTS_OUT;  //Empty pipe is only writable
+    ret = ret && poll_poll(requests, 1, 10 * TIME_UNIT_MILLISECOND) == 0;    //Timed out
+
+    fsEntry* epollEntry = epoll_create();
+    Epoll* epoll = epollEntry == NULL ? NULL : epoll_getFromFSentry(epollEntry);
+    if (epoll == NULL) {
+        fs_fileClose(writeEnd);
+        fs_fileClose(readEnd);
+        return false;
+    }
+
+    EpollEvent event = { .events = POLL_EVENTS_IN, .data = 0x1234 }, events[2];
+    epoll_control(epoll, EPOLL_CONTROL_ADD, 0, readEnd, &event);
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_OK;
+    ret = ret && epoll_wait(epoll, events, 2, 0) == 0;
+
+    ret = ret && fs_fileWrite(writeEnd, buffer, sizeof(buffer)) == sizeof(buffer);
+    ret = ret && poll_poll(requests, 1, 0) == 1 && requests[0].revents == POLL_EVENTS_IN;
+    ret = ret && epoll_wait(epoll, events, 2, 0) == 1 && events[0].events == POLL_EVENTS_IN && events[0].data == 0x1234;
+    ret = ret && epoll_wait(epoll, events, 2, 0) == 1;  //Level triggered, reported until drained
+
+    ret = ret && fs_fileRead(readEnd, buffer, sizeof(buffer)) == sizeof(buffer);
+    ret = ret && epoll_wait(epoll, events, 2, 10 * TIME_UNIT_MILLISECOND) == 0;
+
+    epoll_control(epoll, EPOLL_CONTROL_DELETE, 0, readEnd, NULL);
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_OK;
+
+    fsEntry* outerEntry = epoll_create();
+    Epoll* outer = outerEntry == NULL ? NULL : epoll_getFromFSentry(outerEntry);
+    if (outer != NULL) {
+        epoll_control(outer, EPOLL_CONTROL_ADD, 1, epollEntry, &event);
+        ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_OK;
+        epoll_control(epoll, EPOLL_CONTROL_ADD, 2, outerEntry, &event); //Would watch each other
+        ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_LOOP;
+        ERROR_CLEAR();
+
+        epoll_control(outer, EPOLL_CONTROL_DELETE, 1, epollEntry, NULL);
+        ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_OK;
+        fs_fileClose(outerEntry);
+    } else {
+        ret = false;
+    }
+
+    fs_fileClose(epollEntry);
+    fs_fileClose(writeEnd);
+    ret = ret && poll_poll(requests, 1, 0) == 1 && requests[0].revents == POLL_EVENTS_HUP;  //All writers closed
+    fs_fileClose(readEnd);
+
+    return ret;
+}
+
+bool __multitask_test_ipc_notificationFDs(void* arg) {
+    bool ret = true;
+    Uint64 value = 3;
+
+    fsEntry* eventfdEntry = eventfd_create(0, EVENTFD_FLAGS_SEMAPHORE, FCNTL_OPEN_NONBLOCK);
+    if (eventfdEntry == NULL) {
+        return false;
+    }
+
+    fs_fileRead(eventfdEntry, &value, sizeof(Uint64));  //Counter is 0
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    ret = ret && fs_fileWrite(eventfdEntry, &value, sizeof(Uint64)) == sizeof(Uint64);
+    ret = ret && fs_filePoll(eventfdEntry, NULL) == (POLL_EVENTS_IN | POLL_EVENTS_OUT);
+    ret = ret && fs_fileRead(eventfdEntry, &value, sizeof(Uint64)) == sizeof(Uint64) && value == 1; //Semaphore mode takes 1 each time
+    ret = ret && eventfd_getFromFSentry(eventfdEntry)->counter == 2;
+    fs_fileClose(eventfdEntry);
+
+    fsEntry* timerfdEntry = timerfd_create(false, EMPTY_FLAGS);
+    if (timerfdEntry == NULL) {
+        return false;
+    }
+
+    Timerfd* timerfd = timerfd_getFromFSentry(timerfdEntry);
+    timerfd_setTime(timerfd, 10 * TIME_UNIT_MILLISECOND, 0, NULL, NULL);
+    PollRequest request = { .entry = timerfdEntry, .events = POLL_EVENTS_IN };
+    ret = ret && poll_poll(&request, 1, 0) == 0;
+    ret = ret && poll_poll(&request, 1, TIME_UNIT_SECOND) == 1;
+    ret = ret && fs_fileRead(timerfdEntry, &value, sizeof(Uint64)) == sizeof(Uint64) && value == 1;
+
+    Int64 remaining, interval;
+    timerfd_getTime(timerfd, &remaining, &interval);
+    ret = ret && remaining == 0 && interval == 0;   //One-shot timer disarmed after expired
+    fs_fileClose(timerfdEntry);
+
+    Thread* currentThread = schedule_getCurrentThread();
+    Flags32 oldMask = currentThread->signalMask;
+    fsEntry* signalfdEntry = signalfd_create(FLAG32(SIGNAL_SIGUSR1), FCNTL_OPEN_NONBLOCK);
+    if (signalfdEntry == NULL) {
+        return false;
+    }
+
+    SignalfdSiginfo info;
+    thread_setSignalMask(currentThread, SET_FLAG(oldMask, FLAG32(SIGNAL_SIGUSR1)));
+    ret = ret && fs_filePoll(signalfdEntry, NULL) == EMPTY_FLAGS;
+    thread_signal(currentThread, SIGNAL_SIGUSR1);   //Blocked, pended for signalfd
+    ret = ret && fs_filePoll(signalfdEntry, NULL) == POLL_EVENTS_IN;
+    ret = ret && fs_fileRead(signalfdEntry, &info, sizeof(SignalfdSiginfo)) == sizeof(SignalfdSiginfo) && info.signo == SIGNAL_SIGUSR1;
+
+    fs_fileRead(signalfdEntry, &info, sizeof(SignalfdSiginfo));
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    thread_setSignalMask(currentThread, oldMask);
+    fs_fileClose(signalfdEntry);
+
+    return ret;
+}
+
+bool __multitask_test_ipc_posixIPC(void* arg) {
+    bool ret = true;
+
+    fsEntry* shmEntry1 = sharedMemory_open("/test", FCNTL_OPEN_READ_WRITE | FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL);
+    if (shmEntry1 == NULL) {
+        return false;
+    }
+
+    ret = ret && sharedMemory_open("/test", FCNTL_OPEN_READ_WRITE | FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL) == NULL && error_getCurrentRecord()->errorID == ERROR_ID_ALREADY_EXIST;
+    ERROR_CLEAR();
+
+    fsEntry* shmEntry2 = sharedMemory_open("/test", FCNTL_OPEN_READ_WRITE);
+    if (shmEntry2 == NULL) {
+        fs_fileClose(shmEntry1);
+        return false;
+    }
+
+    SharedMemory* sharedMemory = sharedMemory_getFromFSentry(shmEntry1);
+    ret = ret && sharedMemory != NULL && sharedMemory_getFromFSentry(shmEntry2) == sharedMemory;
+    sharedMemory_resize(sharedMemory, 2 * PAGE_SIZE);
+    ret = ret && shmEntry2->vnode->size == 2 * PAGE_SIZE;   //Entries share vnode
+
+    Uint8* mapped1 = mapping_mmap(NULL, 2 * PAGE_SIZE, MAPPING_MMAP_PROT_READ | MAPPING_MMAP_PROT_WRITE, MAPPING_MMAP_FLAGS_TYPE_SHARED, shmEntry1, 0);
+    Uint8* mapped2 = mapping_mmap(NULL, PAGE_SIZE, MAPPING_MMAP_PROT_READ | MAPPING_MMAP_PROT_WRITE, MAPPING_MMAP_FLAGS_TYPE_SHARED, shmEntry2, PAGE_SIZE);
+    if (mapped1 == NULL || mapped2 == NULL) {
+        return false;
+    }
+
+    mapped1[PAGE_SIZE + 1] = 0x5A;  //Same frame behind both mappings
+    ret = ret && mapped2[1] == 0x5A;
+
+    Uint8 value = 0;
+    fs_fileSeek(shmEntry2, PAGE_SIZE + 1, FS_FILE_SEEK_BEGIN);
+    ret = ret && fs_fileRead(shmEntry2, &value, 1) == 1 && value == 0x5A;
+
+    value = 0xA5;
+    fs_fileSeek(shmEntry1, 0, FS_FILE_SEEK_BEGIN);
+    ret = ret && fs_fileWrite(shmEntry1, &value, 1) == 1 && mapped1[0] == 0xA5;
+
+    mapping_munmap(mapped1, 2 * PAGE_SIZE);
+    fs_fileClose(shmEntry1);
+    fs_fileClose(shmEntry2);
+    sharedMemory_unlink("/test");
+    ret = ret && mapped2[1] == 0x5A;    //Frame kept until unmapped
+    mapping_munmap(mapped2, PAGE_SIZE);
+
+    ret = ret && sharedMemory_open("/test", FCNTL_OPEN_READ_WRITE) == NULL && error_getCurrentRecord()->errorID == ERROR_ID_NOT_FOUND;
+    ERROR_CLEAR();
+
+    MessageQueueAttribute attribute = { .maxMessageN = 3, .messageSize = 8 };
+    fsEntry* mqEntry = messageQueue_open("/test", FCNTL_OPEN_READ_WRITE | FCNTL_OPEN_CREAT, &attribute);
+    if (mqEntry == NULL) {
+        return false;
+    }
+
+    MessageQueue* queue = messageQueue_getFromFSentry(mqEntry);
+    char buffer[8];
+    Uint32 priority;
+    messageQueue_receive(queue, buffer, sizeof(buffer), &priority, 0);
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    messageQueue_send(queue, "low1", 5, 1, 0);
+    messageQueue_send(queue, "high", 5, 5, 0);
+    messageQueue_send(queue, "low2", 5, 1, 0);
+    ret = ret && fs_filePoll(mqEntry, NULL) == POLL_EVENTS_IN;
+
+    messageQueue_send(queue, "full", 5, 1, 10 * TIME_UNIT_MILLISECOND);
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_TIMEOUT;
+    ERROR_CLEAR();
+
+    ret = ret && messageQueue_receive(queue, buffer, sizeof(buffer), &priority, 0) == 5 && priority == 5 && memory_memcmp(buffer, "high", 5) == 0;
+    ret = ret && messageQueue_receive(queue, buffer, sizeof(buffer), &priority, 0) == 5 && priority == 1 && memory_memcmp(buffer, "low1", 5) == 0;
+    ret = ret && messageQueue_receive(queue, buffer, sizeof(buffer), &priority, 0) == 5 && priority == 1 && memory_memcmp(buffer, "low2", 5) == 0;
+
+    messageQueue_getAttribute(mqEntry, &attribute);
+    ret = ret && attribute.messageN == 0 && attribute.maxMessageN == 3 && attribute.messageSize == 8;
+
+    messageQueue_unlink("/test");
+    fs_fileClose(mqEntry);
+
+    return ret;
+}
+
 TEST_SETUP_LIST(    //TODO: Test for signal system
     IPC,
     (1, __multitask_test_ipc_semaphore),
     (1, __multitask_test_ipc_mutex),
     (1, __multitask_test_ipc_conditionVar),
-    (1, __multitask_test_ipc_pipe)
+    (1, __multitask_test_ipc_pipe),
+    (1, __multitask_test_ipc_pipeRing),
+    (1, __multitask_test_ipc_poll),
+    (1, __multitask_test_ipc_notificationFDs),
+    (1, __multitask_test_ipc_posixIPC)
 );
 
 bool __multitask_test_basic(void* ctx) {
@@ -390,14 +672,14 @@ bool __multitask_test_basic(void* ctx) {
         return false;
     }
 
-    Uint16 id1 = schedule_allocateNewID();
-    if (id1 == INVALID_ID) {
+    Uint32 id1 = schedule_allocateNewID();
+    if (id1 == SCHEDULE_INVALID_ID) {
         return false;
     }
 
     schedule_releaseID(id1);
-    Uint16 id2 = schedule_allocateNewID();
-    if (id2 == INVALID_ID || id1 > id2) {  //ID only increaases
+    Uint32 id2 = schedule_allocateNewID();
+    if (id2 == SCHEDULE_INVALID_ID || id1 > id2) {  //ID only increaases
         return false;
     }
 
@@ -406,6 +688,249 @@ bool __multitask_test_basic(void* ctx) {
         return false;
     }
 
+    Thread* currentThread = schedule_getCurrentThread();
+    rcu_readLock();
+    bool found = schedule_getProcessFromPID(currentProcess->pid) == currentProcess && schedule_getThreadFromTID(currentThread->tid) == currentThread && process_getThreadFromTID(currentProcess, currentThread->tid) == currentThread;
+    rcu_readUnlock();
+    if (!found) {
+        return false;
+    }
+
+    return true;
+}
+
+bool __multitask_test_spinlocks(void* ctx) {
+    TicketSpinlock ticketLock = TICKET_SPINLOCK_UNLOCKED;
+    ticketSpinlock_lock(&ticketLock);
+    if (!ticketSpinlock_isLocked(&ticketLock) || ticketSpinlock_tryLock(&ticketLock)) {
+        return false;
+    }
+    ticketSpinlock_unlock(&ticketLock);
+    if (ticketSpinlock_isLocked(&ticketLock) || !ticketSpinlock_tryLock(&ticketLock)) {
+        return false;
+    }
+    ticketSpinlock_unlock(&ticketLock);
+
+    MCSspinlock mcsLock = MCS_SPINLOCK_UNLOCKED;
+    MCSspinlockNode node1, node2;
+    mcsSpinlock_lock(&mcsLock, &node1);
+    if (!mcsSpinlock_isLocked(&mcsLock) || mcsSpinlock_tryLock(&mcsLock, &node2)) {
+        return false;
+    }
+    mcsSpinlock_unlock(&mcsLock, &node1);
+    if (mcsSpinlock_isLocked(&mcsLock) || !mcsSpinlock_tryLock(&mcsLock, &node2)) {
+        return false;
+    }
+    mcsSpinlock_unlock(&mcsLock, &node2);
+
+    RWspinlock rwLock = RW_SPINLOCK_UNLOCKED;
+    rwSpinlock_readLock(&rwLock);
+    rwSpinlock_readLock(&rwLock);
+    if (rwSpinlock_getReaderNum(&rwLock) != 2 || rwSpinlock_isWriteLocked(&rwLock)) {
+        return false;
+    }
+    rwSpinlock_readUnlock(&rwLock);
+    rwSpinlock_readUnlock(&rwLock);
+    rwSpinlock_writeLock(&rwLock);
+    if (rwSpinlock_getReaderNum(&rwLock) != 0 || !rwSpinlock_isWriteLocked(&rwLock)) {
+        return false;
+    }
+    rwSpinlock_writeUnlock(&rwLock);
+
+    Spinlock lock = SPINLOCK_UNLOCKED;
+    bool interruptEnabled = spinlock_lockIrqSave(&lock);
+    bool disabledInside = TEST_FLAGS_NONE(readEFlags64(), EFLAGS_IF);
+    spinlock_unlockIrqRestore(&lock, interruptEnabled);
+    if (!disabledInside || TEST_FLAGS(readEFlags64(), EFLAGS_IF) != interruptEnabled) {
+        return false;
+    }
+
+    return true;
+}
+
+bool __multitask_test_rwLocks(void* ctx) {
+    RWsemaphore sem;
+    rwSemaphore_initStruct(&sem);
+
+    rwSemaphore_downRead(&sem);
+    if (!rwSemaphore_tryDownRead(&sem) || rwSemaphore_tryDownWrite(&sem) || sem.readerNum != 2) {
+        return false;
+    }
+    rwSemaphore_upRead(&sem);
+    rwSemaphore_upRead(&sem);
+
+    rwSemaphore_downWrite(&sem);
+    if (sem.writer != schedule_getCurrentThread() || rwSemaphore_tryDownRead(&sem) || rwSemaphore_tryDownWrite(&sem)) {
+        return false;
+    }
+    rwSemaphore_downgrade(&sem);
+    if (sem.writer != NULL || sem.readerNum != 1 || !rwSemaphore_tryDownRead(&sem)) {
+        return false;
+    }
+    rwSemaphore_upRead(&sem);
+    rwSemaphore_upRead(&sem);
+    if (sem.readerNum != 0 || !rwSemaphore_tryDownWrite(&sem)) {
+        return false;
+    }
+    rwSemaphore_upWrite(&sem);
+
+    Seqlock seqlock = SEQLOCK_UNLOCKED;
+    Uint32 sequence = seqlock_readBegin(&seqlock);
+    if (seqlock_readRetry(&seqlock, sequence)) {
+        return false;
+    }
+
+    seqlock_writeBegin(&seqlock);
+    seqlock_writeEnd(&seqlock);
+    if (!seqlock_readRetry(&seqlock, sequence)) {   //Write happened during read section
+        return false;
+    }
+
+    return true;
+}
+
+typedef struct {
+    RCUhead         head;
+    volatile bool   called;
+} __MultitaskTestRCUobject;
+
+static void __multitask_test_rcuCallback(RCUhead* head) {
+    HOST_POINTER(head, __MultitaskTestRCUobject, head)->called = true;
+}
+
+bool __multitask_test_rcu(void* ctx) {
+    rcu_readLock();
+    rcu_readLock();
+    rcu_readUnlock();
+    if (!rcu_isInReadSection()) {
+        return false;
+    }
+    rcu_readUnlock();
+    if (rcu_isInReadSection()) {
+        return false;
+    }
+
+    __MultitaskTestRCUobject object = { .called = false };
+    rcu_call(&object.head, __multitask_test_rcuCallback);
+    rcu_synchronize();  //Callbacks are invoked in order, previous one is done when this returns
+    
+    return object.called;
+}
+
+#define __MULTITASK_TEST_FUTEX_WAITER_NUM   4
+#define __MULTITASK_TEST_FUTEX_WAIT_ROUND   1000
+
+static Uint32 _multitask_test_futexWord1, _multitask_test_futexWord2;
+static volatile Uint32 _multitask_test_futexDoneNum;
+
+static void __multitask_test_futexWaiter() {
+    idt_enableInterrupt();
+    futex_wait(&_multitask_test_futexWord1, 0, -1, FUTEX_BITSET_MATCH_ANY, FUTEX_FLAGS_PRIVATE);    //May be requeued to word 2 before woken
+    ERROR_CLEAR();
+    ATOMIC_INC_FETCH(&_multitask_test_futexDoneNum);
+
+    thread_die(schedule_getCurrentThread());
+    die();
+}
+
+static bool __multitask_test_futexWaitDone(Uint32 doneNum) {
+    for (int i = 0; i < __MULTITASK_TEST_FUTEX_WAIT_ROUND && ATOMIC_LOAD(&_multitask_test_futexDoneNum) < doneNum; ++i) {
+        schedule_yield();
+    }
+
+    return ATOMIC_LOAD(&_multitask_test_futexDoneNum) == doneNum;
+}
+
+static bool __multitask_test_futexRequeue() {
+    Uint32* word1 = &_multitask_test_futexWord1, * word2 = &_multitask_test_futexWord2;
+    *word1 = *word2 = 0;
+    _multitask_test_futexDoneNum = 0;
+
+    for (int i = 0; i < __MULTITASK_TEST_FUTEX_WAITER_NUM; ++i) {
+        if (process_createThread(schedule_getCurrentProcess(), __multitask_test_futexWaiter) == NULL) {
+            return false;
+        }
+    }
+
+    Size queued = 0;    //Requeue only, moves waiters to word 2 as they sleep, none of them woken
+    for (int i = 0; i < __MULTITASK_TEST_FUTEX_WAIT_ROUND && queued < __MULTITASK_TEST_FUTEX_WAITER_NUM; ++i) {
+        queued += futex_requeue(word1, 0, word2, __MULTITASK_TEST_FUTEX_WAITER_NUM, NULL, FUTEX_FLAGS_PRIVATE);
+        schedule_yield();
+    }
+    if (queued != __MULTITASK_TEST_FUTEX_WAITER_NUM || !__multitask_test_futexWaitDone(0)) {
+        return false;
+    }
+
+    Uint32 cmpVal = 1;
+    futex_requeue(word2, 1, word1, 1, &cmpVal, FUTEX_FLAGS_PRIVATE);
+    if (error_getCurrentRecord()->errorID != ERROR_ID_WOULD_BLOCK) {
+        return false;
+    }
+    ERROR_CLEAR();
+
+    cmpVal = 0; //Mixed, wakes 1, moves 2 back to word 1, leaves 1 on word 2
+    if (futex_requeue(word2, 1, word1, 2, &cmpVal, FUTEX_FLAGS_PRIVATE) != 3 || !__multitask_test_futexWaitDone(1)) {
+        return false;
+    }
+
+    if (futex_requeue(word1, 2, word2, 0, NULL, FUTEX_FLAGS_PRIVATE) != 2 || !__multitask_test_futexWaitDone(3)) {    //Wake only
+        return false;
+    }
+
+    return futex_wake(word2, __MULTITASK_TEST_FUTEX_WAITER_NUM, FUTEX_BITSET_MATCH_ANY, FUTEX_FLAGS_PRIVATE) == 1 && __multitask_test_futexWaitDone(4);
+}
+
+bool __multitask_test_futex(void* ctx) {
+    Uint32 word = 1;
+    bool ret = true;
+
+    futex_wait(&word, 0, -1, FUTEX_BITSET_MATCH_ANY, FUTEX_FLAGS_PRIVATE);  //Word changed, should return at once
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_WOULD_BLOCK;
+    ERROR_CLEAR();
+
+    futex_wait(&word, 1, 10 * TIME_UNIT_MILLISECOND, FUTEX_BITSET_MATCH_ANY, FUTEX_FLAGS_PRIVATE);
+    ret = ret && error_getCurrentRecord()->errorID == ERROR_ID_TIMEOUT;
+    ERROR_CLEAR();
+
+    ret = ret && futex_wake(&word, 1, FUTEX_BITSET_MATCH_ANY, FUTEX_FLAGS_PRIVATE) == 0;    //Timed out waiter is dequeued
+    ret = ret && futex_wake(&word, 1, FUTEX_BITSET_MATCH_ANY, EMPTY_FLAGS) == 0;
+
+    ret = ret && __multitask_test_futexRequeue();
+    
+    return ret;
+}
+
+bool __multitask_test_lockProfile(void* ctx) {
+#if defined(CONFIG_LOCK_PROFILE)
+    static char report[LOCK_PROFILE_REPORT_SIZE];
+
+    Mutex mutex;
+    mutex_initStruct(&mutex, EMPTY_FLAGS);
+    LockClass* lockClass = mutex.lockClass;
+    Uint64 acquireNum = lockClass->acquireNum;  //Class is shared with previous runs of this test
+    mutex_acquire(&mutex);
+    mutex_acquire(&mutex);
+    mutex_release(&mutex);
+    mutex_release(&mutex);
+    if (lockClass->type != LOCK_CLASS_TYPE_MUTEX || lockClass->acquireNum != acquireNum + 1) {    //Recursive acquisition counted once
+        return false;
+    }
+
+    Spinlock lock = SPINLOCK_UNLOCKED;
+    spinlock_lock(&lock);
+    spinlock_unlock(&lock);
+    if (lock.classIndex == LOCK_CLASS_INDEX_NONE || lockProfile_getClassFromIndex(lock.classIndex)->acquireNum == 0) {
+        return false;
+    }
+
+    lockProfile_nameClass(lockClass, "lockProfileTest");
+    Size length = lockProfile_report(report, sizeof(report));
+    report[length] = '\0';
+    if (cstring_strstr(report, "lockProfileTest") == NULL) {
+        return false;
+    }
+#endif
+
     return true;
 }
 
@@ -427,6 +952,11 @@ bool __multitask_test_endForked(void* arg) {
 TEST_SETUP_LIST(
     SCHEDULE,
     (1, __multitask_test_basic),
+    (1, __multitask_test_spinlocks),
+    (1, __multitask_test_rwLocks),
+    (1, __multitask_test_rcu),
+    (1, __multitask_test_futex),
+    (1, __multitask_test_lockProfile),
     (0, &TEST_LIST_FULL_NAME(PROCESS)),
     (0, &TEST_LIST_FULL_NAME(IPC)),
     (1, __multitask_test_endForked)
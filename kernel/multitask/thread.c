@@ -1,6 +1,8 @@
 #include<multitask/thread.h>
 
+#include<fs/poll.h>
 #include<interrupt/IDT.h>
+#include<kit/bit.h>
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/extendedPageTable.h>
@@ -29,7 +31,7 @@ static void __thread_switchContext(Thread* from, Thread* to);
 
 static void __thread_setupKernelContext(Thread* thread, ThreadEntryPoint entry);
 
-void thread_initStruct(Thread* thread, Uint16 tid, Process* process) {
+void thread_initStruct(Thread* thread, Uint32 tid, Process* process) {
     thread->process = process;
     thread->tid = tid;
     thread->state = STATE_RUNNING;
@@ -43,6 +45,7 @@ void thread_initStruct(Thread* thread, Uint16 tid, Process* process) {
 
     linkedListNode_initStruct(&thread->processNode);
     linkedListNode_initStruct(&thread->scheduleNode);
+    hashChainNode_initStruct(&thread->scheduleHashNode);
     linkedListNode_initStruct(&thread->scheduleRunningNode);
     queueNode_initStruct(&thread->reapNode);
 
@@ -56,15 +59,18 @@ void thread_initStruct(Thread* thread, Uint16 tid, Process* process) {
     thread->userExitStackTop = NULL;
     thread->dead = false;
     thread->isThreadActive = false;
+
+    signalQueue_initStruct(&thread->signalQueue);
+    thread->signalMask = EMPTY_FLAGS;
 }
 
-void thread_initFirstThread(Thread* thread, Uint16 tid, Process* process, void* stackBottom, Size stackSize){
+void thread_initFirstThread(Thread* thread, Uint32 tid, Process* process, void* stackBottom, Size stackSize){
     thread_initStruct(thread, tid, process);
 
     threadStack_initStructFromExisting(&thread->kernelStack, stackBottom, stackSize, thread->process->extendedTable, DEFAULT_MEMORY_OPERATIONS_TYPE_COW, false);
 }
 
-void thread_initNewThread(Thread* thread, Uint16 tid, Process* process, ThreadEntryPoint entry) {
+void thread_initNewThread(Thread* thread, Uint32 tid, Process* process, ThreadEntryPoint entry) {
     thread_initStruct(thread, tid, process);
 
     threadStack_touch(&thread->kernelStack);
@@ -72,8 +78,6 @@ void thread_initNewThread(Thread* thread, Uint16 tid, Process* process, ThreadEn
 
     __thread_setupKernelContext(thread, entry);
 
-    signalQueue_initStruct(&thread->signalQueue);
-
     return;
     ERROR_FINAL_BEGIN(0);
 }
@@ -92,7 +96,7 @@ void thread_clearStruct(Thread* thread) {
     ERROR_FINAL_BEGIN(0);
 }
 
-void thread_clone(Thread* thread, Thread* cloneFrom, Uint16 tid, Process* newProcess, Context* retContext) {
+void thread_clone(Thread* thread, Thread* cloneFrom, Uint32 tid, Process* newProcess, Context* retContext) {
     thread_lock(cloneFrom);
 
     thread_initStruct(thread, tid, newProcess);
@@ -125,6 +129,7 @@ void thread_clone(Thread* thread, Thread* cloneFrom, Uint16 tid, Process* newPro
     }
 
     thread->userExitStackTop = cloneFrom->userExitStackTop;
+    thread->signalMask = cloneFrom->signalMask;
 
     thread_unlock(cloneFrom);
 
@@ -254,10 +259,11 @@ void thread_unlock(Thread* thread) {
 }
 
 void thread_signal(Thread* thread, int signal) {
-    if (thread == schedule_getCurrentThread()) {
+    if (thread == schedule_getCurrentThread() && TEST_FLAGS_NONE(thread->signalMask, FLAG32(signal))) {
         thread_handleSignal(thread, signal);
     } else {
         signalQueue_pend(&thread->signalQueue, signal);
+        pollWaitQueue_wakeup(&thread->process->signalPollQueue, POLL_EVENTS_IN);    //For signalfd
         //TODO: Interrupt thread from interruptable sleeping
     }
 }
@@ -281,13 +287,20 @@ void thread_handleSignal(Thread* thread, int signal) {
 }
 
 void thread_handleSignalIfAny(Thread* thread) {
-    int pendingSignal = signalQueue_getPending(&thread->signalQueue);
+    int pendingSignal = signalQueue_takePending(&thread->signalQueue, VAL_NOT(thread->signalMask));
     if (pendingSignal == 0) {
         return;
     }
     thread_handleSignal(thread, pendingSignal);
 }
 
+void thread_setSignalMask(Thread* thread, Flags32 mask) {
+    thread->signalMask = CLEAR_FLAG(mask, SIGNAL_MASK_UNBLOCKABLE);
+    if (thread == schedule_getCurrentThread()) {
+        thread_handleSignalIfAny(thread);
+    }
+}
+
 __attribute__((naked))
 static void __thread_switchContext(Thread* from, Thread* to) {
     CONTEXT_SAVE(__switch_return);
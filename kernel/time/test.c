@@ -2,21 +2,26 @@
 
 #if defined(CONFIG_UNIT_TEST_TIME)
 
+#include<memory/mm.h>
 #include<time/timer.h>
 #include<test.h>
 
 typedef struct __TimeTestContext {
-    Timer timer1, timer2;
-    int val1, val2;
+    Timer timer1, timer2, timer3;
+    int val1, val2, val3;
     bool success;
 } __TimeTestContext;
 
+#define __TIME_TEST_MANY_TIMER_NUM  2048    //More than old heap capacity
+
 static __TimeTestContext _time_test_context;
 
 static void __time_test_timerFunc1(Timer* timer);
 
 static void __time_test_timerFunc2(Timer* timer);
 
+static void __time_test_timerFunc3(Timer* timer);
+
 void* __time_timer_testGroupPrepare() {
     Timer* timer1 = &_time_test_context.timer1, * timer2 = &_time_test_context.timer2;
 
@@ -29,7 +34,7 @@ void* __time_timer_testGroupPrepare() {
     timer2->handler = __time_test_timerFunc2;
     timer2->data = (Object)&_time_test_context;
 
-    _time_test_context.val1 = _time_test_context.val2 = 0;
+    _time_test_context.val1 = _time_test_context.val2 = _time_test_context.val3 = 0;
     _time_test_context.success = true;
 
     return &_time_test_context;
@@ -50,9 +55,67 @@ static bool __time_test_timer_run(void* arg) {
     return ctx->success;
 }
 
+static bool __time_test_timer_cancel(void* arg) {
+    __TimeTestContext* ctx = (__TimeTestContext*)arg;
+
+    Timer* timer3 = &ctx->timer3;
+    timer_initStruct(timer3, 100, TIME_UNIT_MILLISECOND);
+    timer3->handler = __time_test_timerFunc3;
+    timer3->data = (Object)&ctx->val3;
+
+    ctx->val3 = 0;
+    timer_start(timer3);
+    timer_stop(timer3);
+    if (TEST_FLAGS(timer3->flags, TIMER_FLAGS_PRESENT)) {
+        return false;
+    }
+
+    timer_sleep(200, TIME_UNIT_MILLISECOND);
+
+    return ctx->val3 == 0;
+}
+
+static bool __time_test_timer_many(void* arg) {
+    Timer* timers = mm_allocate(sizeof(Timer) * __TIME_TEST_MANY_TIMER_NUM);
+    if (timers == NULL) {
+        return false;
+    }
+
+    int counter = 0;
+    for (int i = 0; i < __TIME_TEST_MANY_TIMER_NUM; ++i) {
+        Timer* timer = &timers[i];
+        timer_initStruct(timer, 10 + (i % 5) * 10, TIME_UNIT_MILLISECOND);
+        timer->handler = __time_test_timerFunc3;
+        timer->data = (Object)&counter;
+        timer_start(timer);
+    }
+
+    for (int i = 1; i < __TIME_TEST_MANY_TIMER_NUM; i += 2) {   //Cancel half of them
+        timer_stop(&timers[i]);
+    }
+
+    timer_sleep(200, TIME_UNIT_MILLISECOND);
+
+    mm_free(timers);
+
+    return counter == __TIME_TEST_MANY_TIMER_NUM / 2;
+}
+
+static bool __time_test_timer_sleep(void* arg) {
+    Timestamp begin, end;
+    time_getMonotonicTimestamp(&begin);
+    timer_sleep(100, TIME_UNIT_MILLISECOND);
+    time_getMonotonicTimestamp(&end);
+
+    return timestamp_compare(&end, &begin) >= 90 * TIME_UNIT_MILLISECOND;  //Beat clock granularity is 10ms
+}
+
 TEST_SETUP_LIST(
     TIME_TIMER,
-    (1, __time_test_timer_run)
+    (1, __time_test_timer_run),
+    (1, __time_test_timer_cancel),
+    (1, __time_test_timer_many),
+    (1, __time_test_timer_sleep)
 );
 
 TEST_SETUP_LIST(    //TODO: Add test for clocks
@@ -78,4 +141,8 @@ static void __time_test_timerFunc2(Timer* timer) {
     }
 }
 
+static void __time_test_timerFunc3(Timer* timer) {
+    ++*(int*)timer->data;
+}
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include<interrupt/ISR.h>
 #include<kit/bit.h>
 #include<kit/types.h>
+#include<multitask/locks/seqlock.h>
 #include<multitask/schedule.h>
 #include<time/timer.h>
 #include<error.h>
@@ -85,8 +86,9 @@ Int64 timestamp_compare(Timestamp* ts1, Timestamp* ts2) {
 
 typedef struct {
     Timestamp       time;
+    Timestamp       monotonicTime;  //Time since boot, never affected by wall clock changes
     Timestamp       expectedTime;
-    Spinlock        timeLock;   //TODO: Sequence lock?
+    Seqlock         timeLock;   //Written only in timer interrupt
     Uint64          lastMainTick;
     Uint64          beatTickTime;
     Int64           timeAdjust;
@@ -101,18 +103,19 @@ ISR_FUNC_HEADER(__time_timerHandler) {  //TODO: This timer is a little slower th
     rawClockSourceUpdateTick(beatClockSource);
     ERROR_GOTO_IF_ERROR(0);
 
-    spinlock_lock(&_clock.timeLock);
+    seqlock_writeBegin(&_clock.timeLock);
     Timestamp* time = &_clock.time, * expectedTime = &_clock.expectedTime;
 
     Uint64 currentMainTick = rawClockSourceReadTick(mainClockSource);
     Uint64 dNanosecond = CLOCK_SOURCE_CONVERT_TICK_TO_TIME(mainClockSource, currentMainTick - _clock.lastMainTick, TIME_UNIT_NANOSECOND) + _clock.timeAdjust;
     timestamp_step(time, dNanosecond, TIME_UNIT_NANOSECOND);
+    timestamp_step(&_clock.monotonicTime, dNanosecond, TIME_UNIT_NANOSECOND);
 
     timestamp_step(expectedTime, _clock.beatTickTime, TIME_UNIT_NANOSECOND);
     _clock.timeAdjust = (_clock.timeAdjust + timestamp_compare(expectedTime, time)) >> 1;
     _clock.lastMainTick = currentMainTick;
 
-    spinlock_unlock(&_clock.timeLock);
+    seqlock_writeEnd(&_clock.timeLock);
 
     timer_updateTimers();
     
@@ -137,9 +140,13 @@ void time_init() {
         .second     = CLOCK_SOURCE_CONVERT_TICK_TO_TIME(CMOSclockSource, rawClockSourceReadTick(CMOSclockSource), TIME_UNIT_SECOND),
         .nanosecond = 0
     };
+    _clock.monotonicTime        = (Timestamp) {
+        .second     = 0,
+        .nanosecond = 0
+    };
     _clock.expectedTime         = _clock.time;
 
-    _clock.timeLock             = SPINLOCK_UNLOCKED;
+    _clock.timeLock             = SEQLOCK_UNLOCKED;
     _clock.beatClockSource      = CLOCK_SOURCE_TYPE_I8254;
     _clock.mainClockSource      = CLOCK_SOURCE_TYPE_CPU;
 
@@ -179,10 +186,33 @@ void time_init() {
 }
 
 void time_getTimestamp(Timestamp* timestamp) {
-    spinlock_lock(&_clock.timeLock);
-    *timestamp = _clock.time;
     ClockSource* mainClockSource = clockSource_getSource(_clock.mainClockSource);
-    Uint64 step = CLOCK_SOURCE_CONVERT_TICK_TO_TIME(mainClockSource, rawClockSourceReadTick(mainClockSource) - _clock.lastMainTick, TIME_UNIT_NANOSECOND) + _clock.timeAdjust;
-    spinlock_unlock(&_clock.timeLock);
+    Uint64 step;
+    Uint32 sequence;
+    do {
+        sequence = seqlock_readBegin(&_clock.timeLock);
+        *timestamp = _clock.time;
+        step = CLOCK_SOURCE_CONVERT_TICK_TO_TIME(mainClockSource, rawClockSourceReadTick(mainClockSource) - _clock.lastMainTick, TIME_UNIT_NANOSECOND) + _clock.timeAdjust;
+    } while (seqlock_readRetry(&_clock.timeLock, sequence));
     timestamp_step(timestamp, step, TIME_UNIT_NANOSECOND);
 }
+
+void time_getCoarseTimestamp(Timestamp* timestamp) {
+    Uint32 sequence;
+    do {
+        sequence = seqlock_readBegin(&_clock.timeLock);
+        *timestamp = _clock.time;
+    } while (seqlock_readRetry(&_clock.timeLock, sequence));
+}
+
+void time_getMonotonicTimestamp(Timestamp* timestamp) {
+    ClockSource* mainClockSource = clockSource_getSource(_clock.mainClockSource);
+    Uint64 step;
+    Uint32 sequence;
+    do {
+        sequence = seqlock_readBegin(&_clock.timeLock);
+        *timestamp = _clock.monotonicTime;
+        step = CLOCK_SOURCE_CONVERT_TICK_TO_TIME(mainClockSource, rawClockSourceReadTick(mainClockSource) - _clock.lastMainTick, TIME_UNIT_NANOSECOND) + _clock.timeAdjust;
+    } while (seqlock_readRetry(&_clock.timeLock, sequence));
+    timestamp_step(timestamp, step, TIME_UNIT_NANOSECOND);
+}
\ No newline at end of file
@@ -5,25 +5,57 @@
 #include<kit/bit.h>
 #include<kit/oop.h>
 #include<kit/types.h>
-#include<multitask/locks/mutex.h>
+#include<kit/util.h>
+#include<multitask/locks/spinlock.h>
 #include<multitask/process.h>
 #include<multitask/schedule.h>
-#include<structs/heap.h>
+#include<multitask/thread.h>
+#include<multitask/wait.h>
+#include<structs/linkedList.h>
 #include<time/time.h>
 #include<error.h>
 
 static ClockSource* _timer_vlockSource;
-static Heap _timer_waitHeap;
-#define __TIMER_MAXIMUM_NUM 1023
-static Object _timer_heapObjects[1023 + 1];
-static Mutex _timer_heapMutex;
+static TimerWheel _timer_wheel; //TODO: One wheel per CPU when SMP is supported
 
-static Int64 __timer_compare(Object o1, Object o2);
+static void __timerWheel_initStruct(TimerWheel* wheel, Uint64 currentTick);
+
+static inline bool __timerWheel_lock(TimerWheel* wheel);
+
+static inline void __timerWheel_unlock(TimerWheel* wheel, bool interruptEnabled);
+
+static void __timerWheel_addTimer(TimerWheel* wheel, Timer* timer);
+
+static void __timerWheel_cascade(TimerWheel* wheel, int level);
+
+static void __timerWheel_update(TimerWheel* wheel, Uint64 nowTick);
+
+static void __timerWheel_wakeupWaitting(TimerWheel* wheel, Timer* timer);
+
+static void __timer_waitStopped(Timer* timer);
+
+static bool __timer_waitOperations_tryTake(Wait* wait, Thread* thread);
+
+static bool __timer_waitOperations_shouldWait(Wait* wait, Thread* thread);
+
+static void __timer_waitOperations_wait(Wait* wait, Thread* thread);
+
+static void __timer_waitOperations_quitWaitting(Wait* wait, Thread* thread);
+
+static WaitOperations _timer_waitOperations = {
+    .tryTake        = __timer_waitOperations_tryTake,
+    .shouldWait     = __timer_waitOperations_shouldWait,
+    .wait           = __timer_waitOperations_wait,
+    .quitWaitting   = __timer_waitOperations_quitWaitting
+};
+
+static inline TimerWheel* __timer_getLocalWheel() {
+    return &_timer_wheel;
+}
 
 void timer_init(ClockSource* timerClockSource) {
     _timer_vlockSource = timerClockSource;
-    heap_initStruct(&_timer_waitHeap, _timer_heapObjects, __TIMER_MAXIMUM_NUM, __timer_compare);
-    mutex_initStruct(&_timer_heapMutex, MUTEX_FLAG_CRITICAL);
+    __timerWheel_initStruct(&_timer_wheel, rawClockSourceReadTick(timerClockSource));
 }
 
 void timer_initStruct(Timer* timer, Int64 time, TimeUnit unit) {
@@ -32,6 +64,9 @@ void timer_initStruct(Timer* timer, Int64 time, TimeUnit unit) {
     timer->data     = OBJECT_NULL;
     timer->handler  = NULL;
     timer->flags    = EMPTY_FLAGS;
+    linkedListNode_initStruct(&timer->node);
+    timer->wheel    = NULL;
+    wait_initStruct(&timer->wait, &_timer_waitOperations);
 }
 
 void timer_start(Timer* timer) {
@@ -41,77 +76,237 @@ void timer_start(Timer* timer) {
 
     timer->until    = rawClockSourceReadTick(_timer_vlockSource) + timer->tick;
 
-    mutex_acquire(&_timer_heapMutex);
-    heap_push(&_timer_waitHeap, (Object)timer);
-    SET_FLAG_BACK(timer->flags, TIMER_FLAGS_PRESENT);
-    mutex_release(&_timer_heapMutex);
-    ERROR_GOTO_IF_ERROR(0);
-    
+    TimerWheel* wheel = __timer_getLocalWheel();
+    bool interruptEnabled = __timerWheel_lock(wheel);
+    __timerWheel_addTimer(wheel, timer);
+    __timerWheel_unlock(wheel, interruptEnabled);
+
     if (TEST_FLAGS(timer->flags, TIMER_FLAGS_SYNCHRONIZE)) {
-        while (TEST_FLAGS(timer->flags, TIMER_FLAGS_PRESENT)) { //TODO: Lock?
-            schedule_yield();
-        }
+        __timer_waitStopped(timer);
     }
 
     return;
     ERROR_FINAL_BEGIN(0);
 }
-                                                                                                                                                                                                                                                                                                                                                        
+
 void timer_stop(Timer* timer) {
+    TimerWheel* wheel = timer->wheel;
+    if (wheel == NULL) {
+        ERROR_THROW(ERROR_ID_STATE_ERROR, 0);
+    }
+
+    bool interruptEnabled = __timerWheel_lock(wheel);
     if (TEST_FLAGS_FAIL(timer->flags, TIMER_FLAGS_PRESENT)) {
+        __timerWheel_unlock(wheel, interruptEnabled);
         ERROR_THROW(ERROR_ID_STATE_ERROR, 0);
     }
-    
+
+    linkedListNode_delete(&timer->node);
+    --wheel->timerNum;
     CLEAR_FLAG_BACK(timer->flags, TIMER_FLAGS_PRESENT);
+    __timerWheel_wakeupWaitting(wheel, timer);
+    __timerWheel_unlock(wheel, interruptEnabled);
+
     return;
     ERROR_FINAL_BEGIN(0);
 }
 
 void timer_updateTimers() {
-    Timer* topTimer;
-    Uint64 currentTick = rawClockSourceReadTick(_timer_vlockSource);
-
-    while (_timer_waitHeap.size > 0) {
-        mutex_acquire(&_timer_heapMutex);
-        heap_top(&_timer_waitHeap, (Object*)&topTimer);
-        ERROR_GOTO_IF_ERROR(0);
-        if (topTimer->until > currentTick) {
-            mutex_release(&_timer_heapMutex);
-            break;
+    __timerWheel_update(__timer_getLocalWheel(), rawClockSourceReadTick(_timer_vlockSource));
+}
+
+void timer_sleep(Int64 time, TimeUnit unit) {
+    Timer timer;
+    timer_initStruct(&timer, time, unit);
+    SET_FLAG_BACK(timer.flags, TIMER_FLAGS_SYNCHRONIZE);
+    timer_start(&timer);
+}
+
+static void __timerWheel_initStruct(TimerWheel* wheel, Uint64 currentTick) {
+    wheel->currentTick = currentTick;
+    wheel->timerNum = 0;
+    wheel->lock = SPINLOCK_UNLOCKED;
+
+    for (int i = 0; i < TIMER_WHEEL_LEVEL_NUM; ++i) {
+        for (int j = 0; j < TIMER_WHEEL_SLOT_NUM; ++j) {
+            linkedList_initStruct(&wheel->slots[i][j]);
+        }
+    }
+}
+
+static inline bool __timerWheel_lock(TimerWheel* wheel) {
+    return spinlock_lockIrqSave(&wheel->lock);  //Wheel is updated in timer interrupt
+}
+
+static inline void __timerWheel_unlock(TimerWheel* wheel, bool interruptEnabled) {
+    spinlock_unlockIrqRestore(&wheel->lock, interruptEnabled);
+}
+
+static void __timerWheel_addTimer(TimerWheel* wheel, Timer* timer) {
+    Int64 delay = timer->until - (Int64)wheel->currentTick;
+    if (delay < 0) {    //Already expired, fire at next processed tick
+        delay = 0;
+    } else if (delay > TIMER_WHEEL_MAX_DELAY) {
+        delay = TIMER_WHEEL_MAX_DELAY;
+    }
+
+    Uint64 expire = wheel->currentTick + delay;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVEL_NUM - 1 && delay >= (Int64)POWER_2(TIMER_WHEEL_LEVEL_BITS * (level + 1))) {
+        ++level;
+    }
+
+    Index8 slot = (expire >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    linkedListNode_insertFront(&wheel->slots[level][slot], &timer->node);
+
+    timer->wheel = wheel;
+    SET_FLAG_BACK(timer->flags, TIMER_FLAGS_PRESENT);
+    ++wheel->timerNum;
+}
+
+static void __timerWheel_cascade(TimerWheel* wheel, int level) {
+    Index8 slot = (wheel->currentTick >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    LinkedList* list = &wheel->slots[level][slot];
+
+    while (!linkedList_isEmpty(list)) {
+        Timer* timer = HOST_POINTER(linkedListNode_getNext(list), Timer, node);
+        linkedListNode_delete(&timer->node);
+        --wheel->timerNum;
+        __timerWheel_addTimer(wheel, timer);    //Always lands in lower level unless parked for long delay
+    }
+
+    if (slot == 0 && level + 1 < TIMER_WHEEL_LEVEL_NUM) {
+        __timerWheel_cascade(wheel, level + 1);
+    }
+}
+
+static void __timerWheel_update(TimerWheel* wheel, Uint64 nowTick) {
+    bool interruptEnabled = __timerWheel_lock(wheel);
+
+    LinkedList expired;
+    while (wheel->currentTick <= nowTick) {
+        Index8 slot = wheel->currentTick & TIMER_WHEEL_SLOT_MASK;
+        if (slot == 0) {
+            __timerWheel_cascade(wheel, 1);
         }
-        
-        if (TEST_FLAGS(topTimer->flags, TIMER_FLAGS_PRESENT)) {
-            CLEAR_FLAG_BACK(topTimer->flags, TIMER_FLAGS_PRESENT);
-            if (topTimer->handler != NULL) {
-                mutex_release(&_timer_heapMutex);
-                topTimer->handler(topTimer);
-                mutex_acquire(&_timer_heapMutex);
+
+        LinkedList* list = &wheel->slots[0][slot];
+        if (linkedList_isEmpty(list)) {
+            ++wheel->currentTick;
+            continue;
+        }
+
+        //Take the whole slot out, so handlers restarting timers will not be processed in this round
+        linkedList_initStruct(&expired);
+        linkedListNode_insertBack(list, &expired);
+        linkedListNode_delete(list);
+        linkedList_initStruct(list);
+
+        ++wheel->currentTick;
+
+        while (!linkedList_isEmpty(&expired)) {
+            Timer* timer = HOST_POINTER(linkedListNode_getNext(&expired), Timer, node);
+            linkedListNode_delete(&timer->node);
+            --wheel->timerNum;
+            CLEAR_FLAG_BACK(timer->flags, TIMER_FLAGS_PRESENT);
+
+            if (timer->handler != NULL) {
+                spinlock_unlock(&wheel->lock);
+                timer->handler(timer);
+                __timerWheel_lock(wheel);   //Handler may enable interrupt, interrupt state is restored when leaving
             }
-            
-            heap_pop(&_timer_waitHeap);
-            ERROR_GOTO_IF_ERROR(0);
-
-            if (TEST_FLAGS(topTimer->flags, TIMER_FLAGS_REPEAT)) {
-                topTimer->until = currentTick + topTimer->tick;
-                SET_FLAG_BACK(topTimer->flags, TIMER_FLAGS_PRESENT);
-                heap_push(&_timer_waitHeap, (Object)topTimer);
-                ERROR_GOTO_IF_ERROR(0);
+
+            if (TEST_FLAGS(timer->flags, TIMER_FLAGS_REPEAT) && TEST_FLAGS_FAIL(timer->flags, TIMER_FLAGS_PRESENT)) {
+                timer->until = nowTick + timer->tick;
+                __timerWheel_addTimer(wheel, timer);
+            }
+
+            if (TEST_FLAGS_FAIL(timer->flags, TIMER_FLAGS_PRESENT)) {
+                __timerWheel_wakeupWaitting(wheel, timer);
             }
-        } else {
-            heap_pop(&_timer_waitHeap);
-            ERROR_GOTO_IF_ERROR(0);
         }
+    }
+
+    __timerWheel_unlock(wheel, interruptEnabled);
+}
 
-        mutex_release(&_timer_heapMutex);
+static void __timerWheel_wakeupWaitting(TimerWheel* wheel, Timer* timer) {
+    LinkedList* waitList = &timer->wait.waitList, woken;
+    if (linkedList_isEmpty(waitList)) {
+        return;
     }
 
-    return;
-    ERROR_FINAL_BEGIN(0);
-    if (mutex_isLocked(&_timer_heapMutex)) {
-        mutex_release(&_timer_heapMutex);
+    //Detach waitting threads first, timer may be released as soon as any of them runs
+    linkedList_initStruct(&woken);
+    linkedListNode_insertBack(waitList, &woken);
+    linkedListNode_delete(waitList);
+    linkedList_initStruct(waitList);
+
+    spinlock_unlock(&wheel->lock);
+    while (!linkedList_isEmpty(&woken)) {
+        Thread* thread = HOST_POINTER(linkedListNode_getNext(&woken), Thread, waitNode);
+        linkedListNode_delete(&thread->waitNode);
+        thread_wakeup(thread);
+    }
+    __timerWheel_lock(wheel);
+}
+
+static void __timer_waitStopped(Timer* timer) {
+    Wait* wait = &timer->wait;
+    Thread* currentThread = schedule_getCurrentThread();
+    if (wait_rawTryTake(wait, currentThread)) {
+        return;
     }
+
+    schedule_enterCritical();
+    thread_sleep(currentThread, wait);
 }
 
-static Int64 __timer_compare(Object o1, Object o2) {
-    return ((Timer*)o1)->until - ((Timer*)o2)->until;
+static bool __timer_waitOperations_tryTake(Wait* wait, Thread* thread) {
+    Timer* timer = HOST_POINTER(wait, Timer, wait);
+    return TEST_FLAGS_FAIL(timer->flags, TIMER_FLAGS_PRESENT);
+}
+
+static bool __timer_waitOperations_shouldWait(Wait* wait, Thread* thread) {
+    Timer* timer = HOST_POINTER(wait, Timer, wait);
+    return TEST_FLAGS(timer->flags, TIMER_FLAGS_PRESENT);
+}
+
+static void __timer_waitOperations_wait(Wait* wait, Thread* thread) {
+    DEBUG_ASSERT_SILENT(thread == schedule_getCurrentThread());
+    DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+    Timer* timer = HOST_POINTER(wait, Timer, wait);
+    TimerWheel* wheel = timer->wheel;
+
+    bool interruptEnabled = __timerWheel_lock(wheel);
+    bool expired = TEST_FLAGS_FAIL(timer->flags, TIMER_FLAGS_PRESENT);
+    if (!expired) {
+        linkedListNode_insertFront(&wait->waitList, &thread->waitNode);
+    }
+    __timerWheel_unlock(wheel, interruptEnabled);
+
+    if (expired) {  //Expired before joining wait list, nobody will wake it up
+        thread_wakeup(thread);
+    }
+
+    if (schedule_isInCritical()) {
+        schedule_leaveCritical();
+        DEBUG_ASSERT_SILENT(!schedule_isInCritical());
+    }
+
+    if (!expired) {
+        schedule_yield();
+    }
+}
+
+static void __timer_waitOperations_quitWaitting(Wait* wait, Thread* thread) {
+    Timer* timer = HOST_POINTER(wait, Timer, wait);
+    TimerWheel* wheel = timer->wheel;
+
+    bool interruptEnabled = __timerWheel_lock(wheel);
+    if (thread->waittingFor != NULL) {
+        DEBUG_ASSERT_SILENT(thread->waittingFor == wait);
+        linkedListNode_delete(&thread->waitNode);
+    }
+    __timerWheel_unlock(wheel, interruptEnabled);
 }
\ No newline at end of file
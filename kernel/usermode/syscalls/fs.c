@@ -5,8 +5,10 @@
 #include<kit/types.h>
 #include<kit/util.h>
 #include<memory/memory.h>
+#include<multitask/pipe.h>
 #include<multitask/process.h>
 #include<multitask/schedule.h>
+#include<multitask/sharedMemory.h>
 #include<usermode/syscall.h>
 #include<error.h>
 
@@ -22,6 +24,18 @@ static int __syscall_fs_stat(ConstCstring filename, FS_fileStat* stat);
 
 static int __syscall_fs_fstat(int fd, FS_fileStat* stat);
 
+static int __syscall_fs_fcntl(int fileDescriptor, int command, Uint64 arg);
+
+static int __syscall_fs_ftruncate(int fileDescriptor, Int64 length);
+
+static int __syscall_fs_sendfile(int outFileDescriptor, int inFileDescriptor, Int64* offset, Size n);
+
+static int __syscall_fs_splice(int inFileDescriptor, Int64* inOffset, int outFileDescriptor, Int64* outOffset, Size n, Uint32 flags);
+
+static int __syscall_fs_copyFileRange(int inFileDescriptor, Int64* inOffset, int outFileDescriptor, Int64* outOffset, Size n, Uint32 flags);
+
+static int __syscall_fs_transfer(File* to, Int64* toOffset, File* from, Int64* fromOffset, Size n);
+
 typedef struct __SyscallFSdirectoryEntry {
     unsigned long   vnodeID;
     unsigned long   off;
@@ -40,8 +54,16 @@ typedef enum __FsSyscallDirentType {
     __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_UNKNOWN
 } __FsSyscallDirentType;
 
+typedef struct __SyscallFSgetdentsBuffer {
+    void*   current;
+    Size    remainingN;
+    bool    full;   //An entry did not fit in the rest of buffer
+} __SyscallFSgetdentsBuffer;
+
 static int __syscall_fs_getdents(int fileDescriptor, void* buffer, Size n);
 
+static bool __syscall_fs_fillDirectoryEntry(Object arg, ConstCstring name, Size nameLength, fsEntryType type, ID vnodeID, Index64 nextCookie);
+
 static int __syscall_fs_read(int fileDescriptor, void* buffer, Size n) {
     Process* currentProcess = schedule_getCurrentProcess();
     File* file = process_getFSentry(currentProcess, fileDescriptor);
@@ -51,10 +73,10 @@ static int __syscall_fs_read(int fileDescriptor, void* buffer, Size n) {
     }
     DEBUG_ASSERT_SILENT(file->vnode->fsNode->entry.type != FS_ENTRY_TYPE_DIRECTORY);
 
-    fs_fileRead(file, buffer, n);
+    Size ret = fs_fileRead(file, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
 
-    return 0;
+    return ret;
     ERROR_FINAL_BEGIN(0);
     return -1;
 }
@@ -68,10 +90,10 @@ static int __syscall_fs_write(int fileDescriptor, const void* buffer, Size n) {
     }
     DEBUG_ASSERT_SILENT(file->vnode->fsNode->entry.type != FS_ENTRY_TYPE_DIRECTORY);
 
-    fs_fileWrite(file, buffer, n);
+    Size ret = fs_fileWrite(file, buffer, n);
     ERROR_GOTO_IF_ERROR(0);
 
-    return 0;
+    return ret;
     ERROR_FINAL_BEGIN(0);
     return -1;
 }
@@ -153,70 +175,227 @@ static int __syscall_fs_fstat(int fd, FS_fileStat* stat) {
 }
 
 static int __syscall_fs_getdents(int fileDescriptor, void* buffer, Size n) {
-    fsNode* node = NULL;
-    
     Process* currentProcess = schedule_getCurrentProcess();
     Directory* directory = process_getFSentry(currentProcess, fileDescriptor);
     if (directory == NULL) {
         ERROR_ASSERT_ANY();
         ERROR_GOTO(0);
     }
-    
-    node = directory->vnode->fsNode;
-    DEBUG_ASSERT_SILENT(node->entry.type == FS_ENTRY_TYPE_DIRECTORY);
-    DirFSnode* dirNode = FSNODE_GET_DIRFSNODE(node);
 
-    spinlock_lock(&node->lock);
-    fsnode_readDirectoryEntries(node);
+    if (directory->vnode->fsNode->entry.type != FS_ENTRY_TYPE_DIRECTORY) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    __SyscallFSgetdentsBuffer getdentsBuffer = (__SyscallFSgetdentsBuffer) {
+        .current    = buffer,
+        .remainingN = n,
+        .full       = false
+    };
+
+    Index64 cookie = vNode_iterateDirectoryEntries(directory->vnode, directory->pointer, __syscall_fs_fillDirectoryEntry, (Object)&getdentsBuffer);  //Pointer of directory keeps cookie between calls
     ERROR_GOTO_IF_ERROR(0);
-    
-    void* currentBuffer = buffer;
-    Size remainingN = n;
-    DEBUG_ASSERT_SILENT(dirNode->dirPart.childrenNum != FSNODE_DIR_PART_UNKNOWN_CHILDREN_NUM);
-    for (LinkedList* childNode = linkedListNode_getNext(&dirNode->dirPart.children); childNode != &dirNode->dirPart.children; childNode = linkedListNode_getNext(childNode)) {
-        fsNode* child = HOST_POINTER(childNode, fsNode, childNode);
-
-        Size entryLength = sizeof(__SyscallFSdirectoryEntry) + 2 + child->name.length;
-        if (entryLength > remainingN) {
+
+    Size ret = n - getdentsBuffer.remainingN;
+    if (ret == 0 && getdentsBuffer.full) {   //Buffer too small for even one entry
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+    directory->pointer = cookie;
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static bool __syscall_fs_fillDirectoryEntry(Object arg, ConstCstring name, Size nameLength, fsEntryType type, ID vnodeID, Index64 nextCookie) {
+    __SyscallFSgetdentsBuffer* getdentsBuffer = (__SyscallFSgetdentsBuffer*)arg;
+
+    Size entryLength = ALIGN_UP(offsetof(__SyscallFSdirectoryEntry, name) + nameLength + 2, sizeof(unsigned long));    //Name terminator and type byte at the end
+    if (entryLength > getdentsBuffer->remainingN) {
+        getdentsBuffer->full = true;
+        return false;
+    }
+
+    __SyscallFSdirectoryEntry* syscallEntry = (__SyscallFSdirectoryEntry*)getdentsBuffer->current;
+    syscallEntry->vnodeID = vnodeID;
+    syscallEntry->off = nextCookie;
+    syscallEntry->length = entryLength;
+    memory_memcpy(syscallEntry->name, name, nameLength);
+    syscallEntry->name[nameLength] = '\0';
+
+    char* typeOut = (char*)getdentsBuffer->current + entryLength - 1;
+    switch (type) {
+        case FS_ENTRY_TYPE_FILE: {
+            *typeOut = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_REGULAR;
             break;
         }
+        case FS_ENTRY_TYPE_DIRECTORY: {
+            *typeOut = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_DIRECTORY;
+            break;
+        }
+        case FS_ENTRY_TYPE_DEVICE: {    //TODO: Support for block device
+            *typeOut = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_CHARACTER;
+            break;
+        }
+        case FS_ENTRY_TYPE_PIPE: {
+            *typeOut = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_FIFO;
+            break;
+        }
+        default: {
+            *typeOut = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_UNKNOWN;
+            break;
+        }
+    }
 
-        __SyscallFSdirectoryEntry* syscallEntry = (__SyscallFSdirectoryEntry*)currentBuffer;
-        syscallEntry->vnodeID = child->entry.vnodeID;
-        syscallEntry->off = 0;  //TODO: Not figured out yet
-        cstring_strcpy(syscallEntry->name, child->name.data);
+    getdentsBuffer->current += entryLength;
+    getdentsBuffer->remainingN -= entryLength;
 
-        char* type = (char*)(currentBuffer + sizeof(__SyscallFSdirectoryEntry) + 1 + child->name.length);
-        switch (child->entry.type) {
-            case FS_ENTRY_TYPE_FILE: {
-                *type = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_REGULAR;
-                break;
-            }
-            case FS_ENTRY_TYPE_DIRECTORY: {
-                *type = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_DIRECTORY;
-                break;
-            }
-            case FS_ENTRY_TYPE_DEVICE: {    //TODO: Support for block device
-                *type = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_CHARACTER;
-                break;
+    return true;
+}
+
+static int __syscall_fs_fcntl(int fileDescriptor, int command, Uint64 arg) {
+    Process* currentProcess = schedule_getCurrentProcess();
+    File* file = process_getFSentry(currentProcess, fileDescriptor);
+    if (file == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Pipe* pipe = NULL;
+    switch (command) {
+        case FCNTL_COMMAND_GETFL:
+            return file->flags;
+        case FCNTL_COMMAND_SETFL:   //Only status flags can be changed, access mode and creation flags are kept
+            file->flags = CLEAR_FLAG(file->flags, FCNTL_OPEN_STATUS_FLAGS_MASK) | ((FCNTLopenFlags)arg & FCNTL_OPEN_STATUS_FLAGS_MASK);
+            return 0;
+        case FCNTL_COMMAND_SETPIPE_SZ:
+        case FCNTL_COMMAND_GETPIPE_SZ:
+            pipe = pipe_getFromFSentry(file);
+            if (pipe == NULL) {
+                ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
             }
-            default: {
-                *type = __FS_SYSCALL_DIRECTORY_ENTRY_TYPE_UNKNOWN;
-                break;
+
+            if (command == FCNTL_COMMAND_GETPIPE_SZ) {
+                return pipe_getCapacity(pipe);
             }
-        }
 
-        currentBuffer += entryLength;
-        remainingN -= entryLength;
+            Size capacity = pipe_setCapacity(pipe, arg);
+            ERROR_GOTO_IF_ERROR(0);
+            return capacity;
+        default:
+            ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
     }
-    spinlock_unlock(&node->lock);
+
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_fs_ftruncate(int fileDescriptor, Int64 length) {
+    File* file = process_getFSentry(schedule_getCurrentProcess(), fileDescriptor);
+    if (file == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    if (length < 0 || FCNTL_OPEN_EXTRACL_ACCESS_MODE(file->flags) == FCNTL_OPEN_READ_ONLY) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    SharedMemory* sharedMemory = sharedMemory_getFromFSentry(file);
+    if (sharedMemory != NULL) {
+        sharedMemory_resize(sharedMemory, length);
+    } else if (file->vnode->fsNode->entry.type == FS_ENTRY_TYPE_FILE) {
+        vNode_rawResize(file->vnode, length);
+    } else {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+    ERROR_GOTO_IF_ERROR(0);
 
     return 0;
     ERROR_FINAL_BEGIN(0);
-    if (node != NULL) {
-        spinlock_unlock(&node->lock);
+    return -1;
+}
+
+static int __syscall_fs_sendfile(int outFileDescriptor, int inFileDescriptor, Int64* offset, Size n) {
+    Process* currentProcess = schedule_getCurrentProcess();
+    File* out = process_getFSentry(currentProcess, outFileDescriptor), * in = process_getFSentry(currentProcess, inFileDescriptor);
+    if (out == NULL || in == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return __syscall_fs_transfer(out, NULL, in, offset, n);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_fs_splice(int inFileDescriptor, Int64* inOffset, int outFileDescriptor, Int64* outOffset, Size n, Uint32 flags) {
+    Process* currentProcess = schedule_getCurrentProcess();
+    File* in = process_getFSentry(currentProcess, inFileDescriptor), * out = process_getFSentry(currentProcess, outFileDescriptor);
+    if (in == NULL || out == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Pipe* inPipe = pipe_getFromFSentry(in), * outPipe = pipe_getFromFSentry(out);
+    if ((inPipe == NULL && outPipe == NULL) || (inPipe != NULL && inOffset != NULL) || (outPipe != NULL && outOffset != NULL)) { //At least one end is pipe, pipe has no offset
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    return __syscall_fs_transfer(out, outOffset, in, inOffset, n);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_fs_copyFileRange(int inFileDescriptor, Int64* inOffset, int outFileDescriptor, Int64* outOffset, Size n, Uint32 flags) {
+    Process* currentProcess = schedule_getCurrentProcess();
+    File* in = process_getFSentry(currentProcess, inFileDescriptor), * out = process_getFSentry(currentProcess, outFileDescriptor);
+    if (in == NULL || out == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    if (flags != 0 || in->vnode->fsNode->entry.type != FS_ENTRY_TYPE_FILE || out->vnode->fsNode->entry.type != FS_ENTRY_TYPE_FILE) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    return __syscall_fs_transfer(out, outOffset, in, inOffset, n);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_fs_transfer(File* to, Int64* toOffset, File* from, Int64* fromOffset, Size n) {  //Offset given is used and updated instead of pointer of file
+    if (to == from && toOffset == NULL && fromOffset == NULL) { //One pointer cannot be both ends
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
     }
 
+    File localTo, localFrom;    //Copies positioned at offset given, pointer shared by other users of file never moves
+    if (toOffset != NULL) {
+        memory_memcpy(&localTo, to, sizeof(File));
+        to = &localTo;
+    }
+
+    if (fromOffset != NULL) {
+        memory_memcpy(&localFrom, from, sizeof(File));
+        from = &localFrom;
+    }
+
+    if ((toOffset != NULL && fs_fileSeek(to, *toOffset, FS_FILE_SEEK_BEGIN) == INVALID_INDEX64) || (fromOffset != NULL && fs_fileSeek(from, *fromOffset, FS_FILE_SEEK_BEGIN) == INVALID_INDEX64)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Size ret = fs_fileTransfer(to, from, n);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (toOffset != NULL) {
+        *toOffset = to->pointer;
+    }
+
+    if (fromOffset != NULL) {
+        *fromOffset = from->pointer;
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
     return -1;
 }
 
@@ -226,4 +405,9 @@ SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_OPEN,      __syscall_fs_open);
 SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_CLOSE,     __syscall_fs_close);
 SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_STAT,      __syscall_fs_stat);
 SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_FSTAT,     __syscall_fs_fstat);
-SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_GETDENTS,  __syscall_fs_getdents);
\ No newline at end of file
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_GETDENTS,  __syscall_fs_getdents);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_FCNTL,     __syscall_fs_fcntl);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_FTRUNCATE, __syscall_fs_ftruncate);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SENDFILE,        __syscall_fs_sendfile);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SPLICE,          __syscall_fs_splice);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_COPY_FILE_RANGE, __syscall_fs_copyFileRange);
\ No newline at end of file
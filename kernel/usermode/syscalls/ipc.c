@@ -1,9 +1,307 @@
+#include<fs/eventfd.h>
+#include<fs/fcntl.h>
+#include<fs/fs.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<multitask/futex.h>
 #include<multitask/ipc.h>
+#include<multitask/messageQueue.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<multitask/sharedMemory.h>
+#include<time/time.h>
 #include<usermode/syscall.h>
+#include<error.h>
+
+#define __SYSCALL_IPC_FUTEX_OP_WAIT             0
+#define __SYSCALL_IPC_FUTEX_OP_WAKE             1
+#define __SYSCALL_IPC_FUTEX_OP_REQUEUE          3
+#define __SYSCALL_IPC_FUTEX_OP_CMP_REQUEUE      4
+#define __SYSCALL_IPC_FUTEX_OP_WAIT_BITSET      9
+#define __SYSCALL_IPC_FUTEX_OP_WAKE_BITSET      10
+#define __SYSCALL_IPC_FUTEX_OP_MASK             0x7F
+#define __SYSCALL_IPC_FUTEX_OP_PRIVATE          FLAG32(7)
+#define __SYSCALL_IPC_FUTEX_OP_CLOCK_REALTIME   FLAG32(8)
+
+#define __SYSCALL_IPC_EVENTFD_FLAGS_SEMAPHORE   FLAG32(0)
+#define __SYSCALL_IPC_EVENTFD_FLAGS_MASK        (__SYSCALL_IPC_EVENTFD_FLAGS_SEMAPHORE | FCNTL_OPEN_NONBLOCK | FCNTL_OPEN_CLOEXEC)
+
+#define __SYSCALL_IPC_SHM_OPEN_FLAGS_MASK       (0x3 | FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL | FCNTL_OPEN_TRUNC | FCNTL_OPEN_CLOEXEC)
+#define __SYSCALL_IPC_MQ_OPEN_FLAGS_MASK        (0x3 | FCNTL_OPEN_CREAT | FCNTL_OPEN_EXCL | FCNTL_OPEN_NONBLOCK | FCNTL_OPEN_CLOEXEC)
+
+static int __syscall_ipc_pipe(int pipefd[2]);
+
+static int __syscall_ipc_futex(Uint32* uaddr, int op, Uint32 val, const Timestamp* timeout, Uint32* uaddr2, Uint32 val3);
+
+static Int64 __syscall_ipc_timeout(const Timestamp* timeout, bool absolute, bool realtime);
+
+static int __syscall_ipc_eventfd(unsigned int initval);
+
+static int __syscall_ipc_eventfd2(unsigned int initval, int flags);
+
+static int __syscall_ipc_addFSentry(fsEntry* entry);
+
+static int __syscall_ipc_shmOpen(ConstCstring name, int flags);
+
+static int __syscall_ipc_shmUnlink(ConstCstring name);
+
+static int __syscall_ipc_mqOpen(ConstCstring name, int flags, Uint32 mode, MessageQueueAttribute* attribute);
+
+static int __syscall_ipc_mqUnlink(ConstCstring name);
+
+static int __syscall_ipc_mqTimedsend(int mqdes, const void* message, Size length, Uint32 priority, const Timestamp* absoluteTimeout);
+
+static Int64 __syscall_ipc_mqTimedreceive(int mqdes, void* buffer, Size n, Uint32* priorityRet, const Timestamp* absoluteTimeout);
+
+static int __syscall_ipc_mqGetsetattr(int mqdes, const MessageQueueAttribute* newAttribute, MessageQueueAttribute* oldAttributeRet);
+
+static MessageQueue* __syscall_ipc_mqGetQueue(int mqdes, FCNTLopenFlags deniedAccessMode, Int64* timeoutRet, const Timestamp* absoluteTimeout);
 
 static int __syscall_ipc_pipe(int pipefd[2]) {
     ipc_pipe(&pipefd[0], &pipefd[1]);
     return 0;   //TODO: Error handling
 }
 
-SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_PIPE,  __syscall_ipc_pipe);
\ No newline at end of file
+static int __syscall_ipc_futex(Uint32* uaddr, int op, Uint32 val, const Timestamp* timeout, Uint32* uaddr2, Uint32 val3) {
+    Flags8 flags = TEST_FLAGS(op, __SYSCALL_IPC_FUTEX_OP_PRIVATE) ? FUTEX_FLAGS_PRIVATE : EMPTY_FLAGS;
+    bool realtime = TEST_FLAGS(op, __SYSCALL_IPC_FUTEX_OP_CLOCK_REALTIME);
+    Size nRequeue = (Size)(Uintptr)timeout; //Argument 4 is a count for requeue operations
+    int ret = 0;
+
+    switch (op & __SYSCALL_IPC_FUTEX_OP_MASK) {
+        case __SYSCALL_IPC_FUTEX_OP_WAIT:
+        case __SYSCALL_IPC_FUTEX_OP_WAIT_BITSET: {
+            bool isBitset = (op & __SYSCALL_IPC_FUTEX_OP_MASK) == __SYSCALL_IPC_FUTEX_OP_WAIT_BITSET;
+            Int64 nanosecond = __syscall_ipc_timeout(timeout, isBitset, realtime); //Timeout of WAIT_BITSET is absolute
+            ERROR_GOTO_IF_ERROR(0);
+            futex_wait(uaddr, val, nanosecond, isBitset ? val3 : FUTEX_BITSET_MATCH_ANY, flags);
+            break;
+        }
+        case __SYSCALL_IPC_FUTEX_OP_WAKE:
+            ret = futex_wake(uaddr, val, FUTEX_BITSET_MATCH_ANY, flags);
+            break;
+        case __SYSCALL_IPC_FUTEX_OP_WAKE_BITSET:
+            ret = futex_wake(uaddr, val, val3, flags);
+            break;
+        case __SYSCALL_IPC_FUTEX_OP_REQUEUE:
+            ret = futex_requeue(uaddr, val, uaddr2, nRequeue, NULL, flags);
+            break;
+        case __SYSCALL_IPC_FUTEX_OP_CMP_REQUEUE:
+            ret = futex_requeue(uaddr, val, uaddr2, nRequeue, &val3, flags);
+            break;
+        default:
+            ERROR_THROW(ERROR_ID_NOT_SUPPORTED_OPERATION, 0);
+    }
+    ERROR_GOTO_IF_ERROR(0);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static Int64 __syscall_ipc_timeout(const Timestamp* timeout, bool absolute, bool realtime) {
+    if (timeout == NULL) {
+        return -1;
+    }
+
+    if (timeout->second < 0 || timeout->nanosecond < 0 || timeout->nanosecond >= TIME_UNIT_SECOND) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    if (!absolute) {
+        return timeout->second * TIME_UNIT_SECOND + timeout->nanosecond;
+    }
+
+    Timestamp now;
+    if (realtime) {
+        time_getTimestamp(&now);
+    } else {
+        time_getMonotonicTimestamp(&now);
+    }
+
+    Int64 ret = timestamp_compare((Timestamp*)timeout, &now);
+    return ret < 0 ? 0 : ret;
+    ERROR_FINAL_BEGIN(0);
+    return 0;
+}
+
+static int __syscall_ipc_eventfd(unsigned int initval) {
+    return __syscall_ipc_eventfd2(initval, 0);
+}
+
+static int __syscall_ipc_eventfd2(unsigned int initval, int flags) {
+    if (TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_IPC_EVENTFD_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Flags8 eventfdFlags = TEST_FLAGS(flags, __SYSCALL_IPC_EVENTFD_FLAGS_SEMAPHORE) ? EVENTFD_FLAGS_SEMAPHORE : EMPTY_FLAGS;
+    fsEntry* entry = eventfd_create(initval, eventfdFlags, flags & FCNTL_OPEN_NONBLOCK);
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return __syscall_ipc_addFSentry(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_addFSentry(fsEntry* entry) {
+    Index32 ret = process_addFSentry(schedule_getCurrentProcess(), entry);
+    if (ret == INVALID_INDEX32) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    fs_fileClose(entry);
+    return -1;
+}
+
+static int __syscall_ipc_shmOpen(ConstCstring name, int flags) {
+    if (TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_IPC_SHM_OPEN_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    fsEntry* entry = sharedMemory_open(name, CLEAR_FLAG(flags, FCNTL_OPEN_CLOEXEC));
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return __syscall_ipc_addFSentry(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_shmUnlink(ConstCstring name) {
+    sharedMemory_unlink(name);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_mqOpen(ConstCstring name, int flags, Uint32 mode, MessageQueueAttribute* attribute) {
+    if (TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_IPC_MQ_OPEN_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    fsEntry* entry = messageQueue_open(name, CLEAR_FLAG(flags, FCNTL_OPEN_CLOEXEC), attribute);   //TODO: Mode not supported
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    return __syscall_ipc_addFSentry(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_mqUnlink(ConstCstring name) {
+    messageQueue_unlink(name);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_mqTimedsend(int mqdes, const void* message, Size length, Uint32 priority, const Timestamp* absoluteTimeout) {
+    Int64 timeout;
+    MessageQueue* queue = __syscall_ipc_mqGetQueue(mqdes, FCNTL_OPEN_READ_ONLY, &timeout, absoluteTimeout);
+    if (queue == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    messageQueue_send(queue, message, length, priority, timeout);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static Int64 __syscall_ipc_mqTimedreceive(int mqdes, void* buffer, Size n, Uint32* priorityRet, const Timestamp* absoluteTimeout) {
+    Int64 timeout;
+    MessageQueue* queue = __syscall_ipc_mqGetQueue(mqdes, FCNTL_OPEN_WRITE_ONLY, &timeout, absoluteTimeout);
+    if (queue == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Size ret = messageQueue_receive(queue, buffer, n, priorityRet, timeout);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_ipc_mqGetsetattr(int mqdes, const MessageQueueAttribute* newAttribute, MessageQueueAttribute* oldAttributeRet) {
+    fsEntry* entry = process_getFSentry(schedule_getCurrentProcess(), mqdes);
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    if (messageQueue_getFromFSentry(entry) == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    if (oldAttributeRet != NULL) {
+        messageQueue_getAttribute(entry, oldAttributeRet);
+    }
+
+    if (newAttribute != NULL) { //Only nonblocking flag can be changed
+        entry->flags = CLEAR_FLAG(entry->flags, FCNTL_OPEN_NONBLOCK) | (newAttribute->flags & FCNTL_OPEN_NONBLOCK);
+    }
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static MessageQueue* __syscall_ipc_mqGetQueue(int mqdes, FCNTLopenFlags deniedAccessMode, Int64* timeoutRet, const Timestamp* absoluteTimeout) {
+    fsEntry* entry = process_getFSentry(schedule_getCurrentProcess(), mqdes);
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    MessageQueue* ret = messageQueue_getFromFSentry(entry);
+    if (ret == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    if (FCNTL_OPEN_EXTRACL_ACCESS_MODE(entry->flags) == deniedAccessMode) {   //Same as reading write only file or writing read only file
+        ERROR_THROW(ERROR_ID_PERMISSION_ERROR, 0);
+    }
+
+    if (TEST_FLAGS(entry->flags, FCNTL_OPEN_NONBLOCK)) {
+        *timeoutRet = 0;
+    } else {
+        Int64 timeout = __syscall_ipc_timeout(absoluteTimeout, true, true);
+        ERROR_GOTO_IF_ERROR(0);
+        *timeoutRet = timeout == 0 ? 1 : timeout;   //Deadline passed, still times out instead of failing as nonblocking
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_PIPE,      __syscall_ipc_pipe);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_FUTEX,     __syscall_ipc_futex);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EVENTFD,   __syscall_ipc_eventfd);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EVENTFD2,  __syscall_ipc_eventfd2);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_MQ_OPEN,           __syscall_ipc_mqOpen);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_MQ_UNLINK,         __syscall_ipc_mqUnlink);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_MQ_TIMEDSEND,      __syscall_ipc_mqTimedsend);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_MQ_TIMEDRECEIVE,   __syscall_ipc_mqTimedreceive);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_MQ_GETSETATTR,     __syscall_ipc_mqGetsetattr);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SHM_OPEN,          __syscall_ipc_shmOpen);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SHM_UNLINK,        __syscall_ipc_shmUnlink);
\ No newline at end of file
@@ -15,7 +15,7 @@ static void* __syscall_memory_mmap(void* addr, Size length, int prot, int flags,
     File* file = NULL;
     if (fd >= 0) {
         Process* currentProcess = schedule_getCurrentProcess();
-        File* file = process_getFSentry(currentProcess, fd);
+        file = process_getFSentry(currentProcess, fd);
     }
     
     return mapping_mmap(addr, length, prot | MAPPING_MMAP_PROT_USER, flags, file, offset);
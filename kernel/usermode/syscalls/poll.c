@@ -0,0 +1,291 @@
+#include<fs/epoll.h>
+#include<fs/fcntl.h>
+#include<fs/fs.h>
+#include<fs/fsEntry.h>
+#include<fs/poll.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<memory/memory.h>
+#include<memory/mm.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<time/time.h>
+#include<usermode/syscall.h>
+#include<error.h>
+
+typedef struct __SyscallPollFD {
+    int     fd;
+    short   events;
+    short   revents;
+} __SyscallPollFD;
+
+#define __SYSCALL_POLL_FD_SET_SIZE  1024
+
+typedef struct __SyscallPollFDset {
+    Uint64 bits[__SYSCALL_POLL_FD_SET_SIZE / 64];
+} __SyscallPollFDset;
+
+typedef struct __SyscallPollTimeval {
+    long second;
+    long microsecond;
+} __SyscallPollTimeval;
+
+#define __SYSCALL_POLL_SELECT_READ_EVENTS   (POLL_EVENTS_IN | POLL_EVENTS_HUP | POLL_EVENTS_ERR)
+#define __SYSCALL_POLL_SELECT_WRITE_EVENTS  (POLL_EVENTS_OUT | POLL_EVENTS_ERR)
+#define __SYSCALL_POLL_SELECT_EXCEPT_EVENTS POLL_EVENTS_PRI
+
+#define __SYSCALL_POLL_EPOLL_CREATE1_FLAGS_MASK FCNTL_OPEN_CLOEXEC
+
+static int __syscall_poll_poll(__SyscallPollFD* fds, Size nfds, int timeout);
+
+static int __syscall_poll_select(int nfds, __SyscallPollFDset* readfds, __SyscallPollFDset* writefds, __SyscallPollFDset* exceptfds, __SyscallPollTimeval* timeout);
+
+static int __syscall_poll_epollCreate(int size);
+
+static int __syscall_poll_epollCreate1(int flags);
+
+static int __syscall_poll_epollControl(int epfd, int op, int fd, EpollEvent* event);
+
+static int __syscall_poll_epollWait(int epfd, EpollEvent* events, int maxevents, int timeout);
+
+static inline Int64 __syscall_poll_convertTimeout(int timeout) {
+    return timeout < 0 ? -1 : (Int64)timeout * TIME_UNIT_MILLISECOND;
+}
+
+static inline bool __syscall_poll_testFDset(__SyscallPollFDset* set, int fd) {
+    return set != NULL && TEST_FLAGS(set->bits[fd / 64], FLAG64(fd % 64));
+}
+
+static int __syscall_poll_poll(__SyscallPollFD* fds, Size nfds, int timeout) {
+    if (nfds > 0 && fds == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Process* currentProcess = schedule_getCurrentProcess();
+    PollRequest* requests = NULL;
+    if (nfds > 0) {
+        requests = mm_allocate(nfds * sizeof(PollRequest));
+        if (requests == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+    }
+
+    Size requestNum = 0, invalidNum = 0;
+    for (int i = 0; i < nfds; ++i) {
+        fds[i].revents = 0;
+        if (fds[i].fd < 0) {    //Ignored
+            continue;
+        }
+
+        fsEntry* entry = process_getFSentry(currentProcess, fds[i].fd);
+        if (entry == NULL) {
+            fds[i].revents = POLL_EVENTS_NVAL;
+            ++invalidNum;
+            continue;
+        }
+
+        requests[requestNum].entry = entry;
+        requests[requestNum].events = fds[i].events;
+        requests[requestNum].revents = EMPTY_FLAGS;
+        ++requestNum;
+    }
+
+    Size readyNum = poll_poll(requests, requestNum, invalidNum > 0 ? 0 : __syscall_poll_convertTimeout(timeout));   //Invalid entries are events already
+    ERROR_GOTO_IF_ERROR(1);
+
+    for (int i = 0, j = 0; i < nfds && j < requestNum; ++i) {
+        if (fds[i].fd < 0 || fds[i].revents == POLL_EVENTS_NVAL) {
+            continue;
+        }
+
+        fds[i].revents = requests[j++].revents;
+    }
+
+    if (requests != NULL) {
+        mm_free(requests);
+    }
+
+    return readyNum + invalidNum;
+    ERROR_FINAL_BEGIN(1);
+    if (requests != NULL) {
+        mm_free(requests);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_poll_select(int nfds, __SyscallPollFDset* readfds, __SyscallPollFDset* writefds, __SyscallPollFDset* exceptfds, __SyscallPollTimeval* timeout) {
+    if (nfds < 0 || nfds > __SYSCALL_POLL_FD_SET_SIZE) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Int64 nanosecond = -1;
+    if (timeout != NULL) {
+        if (timeout->second < 0 || timeout->microsecond < 0) {
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+        }
+        nanosecond = timeout->second * TIME_UNIT_SECOND + timeout->microsecond * TIME_UNIT_MICROSECOND;
+    }
+
+    Process* currentProcess = schedule_getCurrentProcess();
+    PollRequest* requests = NULL;
+    int* requestFDs = NULL;
+    if (nfds > 0) {
+        requests = mm_allocate(nfds * (sizeof(PollRequest) + sizeof(int)));    //Requests followed by their fds
+        if (requests == NULL) {
+            ERROR_ASSERT_ANY();
+            ERROR_GOTO(0);
+        }
+        requestFDs = (int*)(requests + nfds);
+    }
+
+    Size requestNum = 0;
+    for (int fd = 0; fd < nfds; ++fd) {
+        PollEvents events = EMPTY_FLAGS;
+        if (__syscall_poll_testFDset(readfds, fd)) {
+            SET_FLAG_BACK(events, POLL_EVENTS_IN);
+        }
+
+        if (__syscall_poll_testFDset(writefds, fd)) {
+            SET_FLAG_BACK(events, POLL_EVENTS_OUT);
+        }
+
+        if (__syscall_poll_testFDset(exceptfds, fd)) {
+            SET_FLAG_BACK(events, POLL_EVENTS_PRI);
+        }
+
+        if (events == EMPTY_FLAGS) {
+            continue;
+        }
+
+        fsEntry* entry = process_getFSentry(currentProcess, fd);
+        if (entry == NULL) {
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 1);
+        }
+
+        requests[requestNum].entry = entry;
+        requests[requestNum].events = events;
+        requests[requestNum].revents = EMPTY_FLAGS;
+        requestFDs[requestNum] = fd;
+        ++requestNum;
+    }
+
+    poll_poll(requests, requestNum, nanosecond);
+    ERROR_GOTO_IF_ERROR(1);
+
+    __SyscallPollFDset* sets[3] = { readfds, writefds, exceptfds };
+    static const PollEvents requestEvents[3] = { POLL_EVENTS_IN, POLL_EVENTS_OUT, POLL_EVENTS_PRI };
+    static const PollEvents resultEvents[3] = { __SYSCALL_POLL_SELECT_READ_EVENTS, __SYSCALL_POLL_SELECT_WRITE_EVENTS, __SYSCALL_POLL_SELECT_EXCEPT_EVENTS };
+    for (int i = 0; i < 3; ++i) {
+        if (sets[i] != NULL) {
+            memory_memset(sets[i]->bits, 0, DIVIDE_ROUND_UP(nfds, 64) * sizeof(Uint64));
+        }
+    }
+
+    int ret = 0;
+    for (int i = 0; i < requestNum; ++i) {
+        PollRequest* request = &requests[i];
+        int fd = requestFDs[i];
+        for (int j = 0; j < 3; ++j) {
+            if (TEST_FLAGS_FAIL(request->events, requestEvents[j]) || TEST_FLAGS_NONE(request->revents, resultEvents[j])) {
+                continue;
+            }
+
+            SET_FLAG_BACK(sets[j]->bits[fd / 64], FLAG64(fd % 64));
+            ++ret;
+        }
+    }
+
+    if (requests != NULL) {
+        mm_free(requests);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    if (requests != NULL) {
+        mm_free(requests);
+    }
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_poll_epollCreate(int size) {
+    if (size <= 0) {    //Size is only a hint, but must be positive
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    return __syscall_poll_epollCreate1(0);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_poll_epollCreate1(int flags) {
+    if (TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_POLL_EPOLL_CREATE1_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    fsEntry* entry = epoll_create();
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Index32 ret = process_addFSentry(schedule_getCurrentProcess(), entry);
+    if (ret == INVALID_INDEX32) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    fs_fileClose(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_poll_epollControl(int epfd, int op, int fd, EpollEvent* event) {
+    Process* currentProcess = schedule_getCurrentProcess();
+    fsEntry* epollEntry = process_getFSentry(currentProcess, epfd), * target = process_getFSentry(currentProcess, fd);
+    if (epollEntry == NULL || target == NULL || epollEntry == target) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Epoll* epoll = epoll_getFromFSentry(epollEntry);
+    if (epoll == NULL || (op != EPOLL_CONTROL_DELETE && event == NULL)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    epoll_control(epoll, op, fd, target, event);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_poll_epollWait(int epfd, EpollEvent* events, int maxevents, int timeout) {
+    fsEntry* epollEntry = process_getFSentry(schedule_getCurrentProcess(), epfd);
+    if (epollEntry == NULL || events == NULL || maxevents <= 0) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Epoll* epoll = epoll_getFromFSentry(epollEntry);
+    if (epoll == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Size ret = epoll_wait(epoll, events, maxevents, __syscall_poll_convertTimeout(timeout));
+    ERROR_GOTO_IF_ERROR(0);
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_POLL,          __syscall_poll_poll);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SELECT,        __syscall_poll_select);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EPOLL_CREATE,  __syscall_poll_epollCreate);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EPOLL_WAIT,    __syscall_poll_epollWait);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EPOLL_CTL,     __syscall_poll_epollControl);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_EPOLL_CREATE1, __syscall_poll_epollCreate1);
\ No newline at end of file
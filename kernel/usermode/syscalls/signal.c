@@ -0,0 +1,115 @@
+#include<fs/fcntl.h>
+#include<fs/fs.h>
+#include<fs/fsEntry.h>
+#include<fs/signalfd.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<multitask/signal.h>
+#include<multitask/thread.h>
+#include<usermode/syscall.h>
+#include<error.h>
+
+#define __SYSCALL_SIGNAL_SIGPROCMASK_HOW_BLOCK      0
+#define __SYSCALL_SIGNAL_SIGPROCMASK_HOW_UNBLOCK    1
+#define __SYSCALL_SIGNAL_SIGPROCMASK_HOW_SETMASK    2
+
+#define __SYSCALL_SIGNAL_SIGNALFD_FLAGS_MASK        (FCNTL_OPEN_NONBLOCK | FCNTL_OPEN_CLOEXEC)
+
+typedef Uint64 __SyscallSignalSigset;   //Signal N is bit N - 1
+
+static int __syscall_signal_rtSigprocmask(int how, const __SyscallSignalSigset* set, __SyscallSignalSigset* oldset, Size sigsetsize);
+
+static int __syscall_signal_signalfd(int fd, const __SyscallSignalSigset* mask, Size sizemask);
+
+static int __syscall_signal_signalfd4(int fd, const __SyscallSignalSigset* mask, Size sizemask, int flags);
+
+static inline Flags32 __syscall_signal_convertSigset(__SyscallSignalSigset sigset) {
+    return (Flags32)(sigset << 1);  //Only 31 standard signals supported
+}
+
+static inline __SyscallSignalSigset __syscall_signal_convertMask(Flags32 mask) {
+    return (__SyscallSignalSigset)mask >> 1;
+}
+
+static int __syscall_signal_rtSigprocmask(int how, const __SyscallSignalSigset* set, __SyscallSignalSigset* oldset, Size sigsetsize) {
+    if (sigsetsize != sizeof(__SyscallSignalSigset)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Thread* currentThread = schedule_getCurrentThread();
+    Flags32 currentMask = currentThread->signalMask;
+    if (oldset != NULL) {
+        *oldset = __syscall_signal_convertMask(currentMask);
+    }
+
+    if (set == NULL) {
+        return 0;
+    }
+
+    Flags32 mask = __syscall_signal_convertSigset(*set);
+    switch (how) {
+        case __SYSCALL_SIGNAL_SIGPROCMASK_HOW_BLOCK:
+            mask = SET_FLAG(currentMask, mask);
+            break;
+        case __SYSCALL_SIGNAL_SIGPROCMASK_HOW_UNBLOCK:
+            mask = CLEAR_FLAG(currentMask, mask);
+            break;
+        case __SYSCALL_SIGNAL_SIGPROCMASK_HOW_SETMASK:
+            break;
+        default:
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    thread_setSignalMask(currentThread, mask);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_signal_signalfd(int fd, const __SyscallSignalSigset* mask, Size sizemask) {
+    return __syscall_signal_signalfd4(fd, mask, sizemask, 0);
+}
+
+static int __syscall_signal_signalfd4(int fd, const __SyscallSignalSigset* mask, Size sizemask, int flags) {
+    if (mask == NULL || sizemask != sizeof(__SyscallSignalSigset) || TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_SIGNAL_SIGNALFD_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Process* currentProcess = schedule_getCurrentProcess();
+    Flags32 signalMask = __syscall_signal_convertSigset(*mask);
+    if (fd != -1) { //Update mask of existing signalfd
+        fsEntry* entry = process_getFSentry(currentProcess, fd);
+        Signalfd* signalfd = entry == NULL ? NULL : signalfd_getFromFSentry(entry);
+        if (signalfd == NULL) {
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+        }
+
+        signalfd_setMask(signalfd, signalMask);
+        return fd;
+    }
+
+    fsEntry* entry = signalfd_create(signalMask, flags & FCNTL_OPEN_NONBLOCK);
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Index32 ret = process_addFSentry(currentProcess, entry);
+    if (ret == INVALID_INDEX32) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    fs_fileClose(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_RT_SIGPROCMASK,    __syscall_signal_rtSigprocmask);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SIGNALFD,          __syscall_signal_signalfd);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_SIGNALFD4,         __syscall_signal_signalfd4);
\ No newline at end of file
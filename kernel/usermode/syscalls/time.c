@@ -0,0 +1,225 @@
+#include<fs/fcntl.h>
+#include<fs/fs.h>
+#include<fs/timerfd.h>
+#include<kit/bit.h>
+#include<kit/types.h>
+#include<multitask/process.h>
+#include<multitask/schedule.h>
+#include<time/time.h>
+#include<time/timer.h>
+#include<usermode/syscall.h>
+#include<error.h>
+
+typedef enum __SyscallTimeClockID {
+    __SYSCALL_TIME_CLOCK_ID_REALTIME    = 0,
+    __SYSCALL_TIME_CLOCK_ID_MONOTONIC   = 1
+} __SyscallTimeClockID;
+
+#define __SYSCALL_TIME_CLOCK_NANOSLEEP_FLAGS_ABSTIME    FLAG32(0)
+
+#define __SYSCALL_TIME_TIMERFD_CREATE_FLAGS_MASK        (FCNTL_OPEN_NONBLOCK | FCNTL_OPEN_CLOEXEC)
+#define __SYSCALL_TIME_TIMERFD_SETTIME_FLAGS_ABSTIME    FLAG32(0)
+
+typedef struct __SyscallTimeItimerspec {
+    Timestamp interval;
+    Timestamp value;
+} __SyscallTimeItimerspec;
+
+static int __syscall_time_nanosleep(const Timestamp* req, Timestamp* rem);
+
+static int __syscall_time_clockGettime(int clockID, Timestamp* tp);
+
+static int __syscall_time_clockNanosleep(int clockID, int flags, const Timestamp* req, Timestamp* rem);
+
+static void __syscall_time_readClock(int clockID, Timestamp* timestamp);
+
+static void __syscall_time_sleep(Int64 nanosecond, Timestamp* rem);
+
+static int __syscall_time_timerfdCreate(int clockID, int flags);
+
+static int __syscall_time_timerfdSettime(int fd, int flags, const __SyscallTimeItimerspec* newValue, __SyscallTimeItimerspec* oldValue);
+
+static int __syscall_time_timerfdGettime(int fd, __SyscallTimeItimerspec* currentValue);
+
+static Timerfd* __syscall_time_getTimerfd(int fd);
+
+static inline bool __syscall_time_isTimestampValid(const Timestamp* timestamp) {
+    return timestamp->second >= 0 && timestamp->nanosecond >= 0 && timestamp->nanosecond < TIME_UNIT_SECOND;
+}
+
+static inline Int64 __syscall_time_convertTimestamp(const Timestamp* timestamp) {
+    return timestamp->second * TIME_UNIT_SECOND + timestamp->nanosecond;
+}
+
+static inline void __syscall_time_convertNanosecond(Int64 nanosecond, Timestamp* timestamp) {
+    timestamp->second       = nanosecond / TIME_UNIT_SECOND;
+    timestamp->nanosecond   = nanosecond % TIME_UNIT_SECOND;
+}
+
+static int __syscall_time_nanosleep(const Timestamp* req, Timestamp* rem) {
+    if (req == NULL || req->second < 0 || req->nanosecond < 0 || req->nanosecond >= TIME_UNIT_SECOND) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    __syscall_time_sleep(req->second * TIME_UNIT_SECOND + req->nanosecond, rem);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_time_clockGettime(int clockID, Timestamp* tp) {
+    if (tp == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    __syscall_time_readClock(clockID, tp);
+    ERROR_GOTO_IF_ERROR(0);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_time_clockNanosleep(int clockID, int flags, const Timestamp* req, Timestamp* rem) {
+    if (req == NULL || req->second < 0 || req->nanosecond < 0 || req->nanosecond >= TIME_UNIT_SECOND) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Timestamp now;
+    __syscall_time_readClock(clockID, &now);    //Validates clock ID as well
+    ERROR_GOTO_IF_ERROR(0);
+
+    Int64 nanosecond = req->second * TIME_UNIT_SECOND + req->nanosecond;
+    if (TEST_FLAGS(flags, __SYSCALL_TIME_CLOCK_NANOSLEEP_FLAGS_ABSTIME)) {
+        nanosecond = timestamp_compare((Timestamp*)req, &now);
+    }
+
+    __syscall_time_sleep(nanosecond, rem);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static void __syscall_time_readClock(int clockID, Timestamp* timestamp) {
+    switch (clockID) {
+        case __SYSCALL_TIME_CLOCK_ID_REALTIME:
+            time_getTimestamp(timestamp);
+            break;
+        case __SYSCALL_TIME_CLOCK_ID_MONOTONIC:
+            time_getMonotonicTimestamp(timestamp);
+            break;
+        default:
+            ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    return;
+    ERROR_FINAL_BEGIN(0);
+}
+
+static void __syscall_time_sleep(Int64 nanosecond, Timestamp* rem) {
+    if (nanosecond > 0) {
+        timer_sleep(nanosecond, TIME_UNIT_NANOSECOND);  //Sleeping thread is parked on timer, no CPU consumed
+    }
+
+    if (rem != NULL) {  //Signals do not interrupt sleep yet, whole request is always consumed
+        rem->second     = 0;
+        rem->nanosecond = 0;
+    }
+}
+
+static int __syscall_time_timerfdCreate(int clockID, int flags) {
+    if (TEST_FLAGS_CONTAIN(flags, VAL_NOT(__SYSCALL_TIME_TIMERFD_CREATE_FLAGS_MASK))) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Timestamp now;
+    __syscall_time_readClock(clockID, &now);    //Validates clock ID
+    ERROR_GOTO_IF_ERROR(0);
+
+    fsEntry* entry = timerfd_create(clockID == __SYSCALL_TIME_CLOCK_ID_REALTIME, flags & FCNTL_OPEN_NONBLOCK);
+    if (entry == NULL) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(0);
+    }
+
+    Index32 ret = process_addFSentry(schedule_getCurrentProcess(), entry);
+    if (ret == INVALID_INDEX32) {
+        ERROR_ASSERT_ANY();
+        ERROR_GOTO(1);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(1);
+    fs_fileClose(entry);
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_time_timerfdSettime(int fd, int flags, const __SyscallTimeItimerspec* newValue, __SyscallTimeItimerspec* oldValue) {
+    Timerfd* timerfd = __syscall_time_getTimerfd(fd);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (newValue == NULL || !__syscall_time_isTimestampValid(&newValue->value) || !__syscall_time_isTimestampValid(&newValue->interval)) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Int64 value = __syscall_time_convertTimestamp(&newValue->value), interval = __syscall_time_convertTimestamp(&newValue->interval);
+    if (value > 0 && TEST_FLAGS(flags, __SYSCALL_TIME_TIMERFD_SETTIME_FLAGS_ABSTIME)) {
+        Timestamp now;
+        __syscall_time_readClock(timerfd->realtime ? __SYSCALL_TIME_CLOCK_ID_REALTIME : __SYSCALL_TIME_CLOCK_ID_MONOTONIC, &now);
+        value = timestamp_compare((Timestamp*)&newValue->value, &now);
+        value = value > 0 ? value : 1;  //Passed already, expires at once
+    }
+
+    Int64 oldValueNanosecond, oldIntervalNanosecond;
+    timerfd_setTime(timerfd, value, interval, &oldValueNanosecond, &oldIntervalNanosecond);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (oldValue != NULL) {
+        __syscall_time_convertNanosecond(oldValueNanosecond, &oldValue->value);
+        __syscall_time_convertNanosecond(oldIntervalNanosecond, &oldValue->interval);
+    }
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static int __syscall_time_timerfdGettime(int fd, __SyscallTimeItimerspec* currentValue) {
+    Timerfd* timerfd = __syscall_time_getTimerfd(fd);
+    ERROR_GOTO_IF_ERROR(0);
+
+    if (currentValue == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    Int64 value, interval;
+    timerfd_getTime(timerfd, &value, &interval);
+    __syscall_time_convertNanosecond(value, &currentValue->value);
+    __syscall_time_convertNanosecond(interval, &currentValue->interval);
+
+    return 0;
+    ERROR_FINAL_BEGIN(0);
+    return -1;
+}
+
+static Timerfd* __syscall_time_getTimerfd(int fd) {
+    fsEntry* entry = process_getFSentry(schedule_getCurrentProcess(), fd);
+    Timerfd* ret = entry == NULL ? NULL : timerfd_getFromFSentry(entry);
+    if (ret == NULL) {
+        ERROR_THROW(ERROR_ID_ILLEGAL_ARGUMENTS, 0);
+    }
+
+    return ret;
+    ERROR_FINAL_BEGIN(0);
+    return NULL;
+}
+
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_NANOSLEEP,         __syscall_time_nanosleep);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_CLOCK_GETTIME,     __syscall_time_clockGettime);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_CLOCK_NANOSLEEP,   __syscall_time_clockNanosleep);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_TIMERFD_CREATE,    __syscall_time_timerfdCreate);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_TIMERFD_SETTIME,   __syscall_time_timerfdSettime);
+SYSCALL_TABLE_REGISTER(SYSCALL_INDEX_TIMERFD_GETTIME,   __syscall_time_timerfdGettime);
\ No newline at end of file
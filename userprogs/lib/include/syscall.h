@@ -10,13 +10,40 @@
 #define SYSCALL_STAT        0x04
 #define SYSCALL_FSTAT       0x05
 #define SYSCALL_MMAP        0x09
+#define SYSCALL_POLL        0x07
 #define SYSCALL_MUNMAP      0x0B
+#define SYSCALL_RT_SIGPROCMASK  0x0E
 #define SYSCALL_PIPE        0x16
+#define SYSCALL_SELECT      0x17
 #define SYSCALL_SCHED_YIELD 0x18
+#define SYSCALL_NANOSLEEP   0x23
 #define SYSCALL_GETPID      0x27
 #define SYSCALL_FORK        0x39
 #define SYSCALL_EXECVE      0x3B
 #define SYSCALL_EXIT        0x3C
+#define SYSCALL_FCNTL       0x48
+#define SYSCALL_FTRUNCATE   0x4D
+#define SYSCALL_FUTEX       0xCA
+#define SYSCALL_EPOLL_CREATE    0xD5
+#define SYSCALL_CLOCK_GETTIME   0xE4
+#define SYSCALL_CLOCK_NANOSLEEP 0xE6
+#define SYSCALL_EPOLL_WAIT      0xE8
+#define SYSCALL_EPOLL_CTL       0xE9
+#define SYSCALL_MQ_OPEN         0xF0
+#define SYSCALL_MQ_UNLINK       0xF1
+#define SYSCALL_MQ_TIMEDSEND    0xF2
+#define SYSCALL_MQ_TIMEDRECEIVE 0xF3
+#define SYSCALL_MQ_GETSETATTR   0xF5
+#define SYSCALL_SIGNALFD        0x11A
+#define SYSCALL_TIMERFD_CREATE  0x11B
+#define SYSCALL_EVENTFD         0x11C
+#define SYSCALL_TIMERFD_SETTIME 0x11E
+#define SYSCALL_TIMERFD_GETTIME 0x11F
+#define SYSCALL_SIGNALFD4       0x121
+#define SYSCALL_EVENTFD2        0x122
+#define SYSCALL_EPOLL_CREATE1   0x123
+#define SYSCALL_SHM_OPEN        0x1F0
+#define SYSCALL_SHM_UNLINK      0x1F1
 #define SYSCALL_TEST        0x1FF
 
 static inline uint64_t syscall6(int syscall, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t arg5, uint64_t arg6) {